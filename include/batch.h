@@ -0,0 +1,37 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_batch_h
+#define INCLUDED_batch_h
+
+/*
+ * Exit codes of "ald -batch"; a script may also choose its own with
+ * "exit <code>"
+ */
+#define BATCH_OK          0  /* every command succeeded */
+#define BATCH_FAILED      1  /* at least one command failed */
+#define BATCH_BADSCRIPT   2  /* script could not be read or is malformed */
+#define BATCH_INTERRUPTED 3  /* ^C */
+#define BATCH_NOPROGRAM   4  /* program given on command line not loaded */
+
+#define BATCH_MAXDEPTH    32 /* deepest nesting of if/while blocks */
+
+/*
+ * Prototypes
+ */
+
+struct aldWorkspace;
+
+int runBatch(struct aldWorkspace *ws, char *filename);
+
+#endif /* INCLUDED_batch_h */
@@ -0,0 +1,35 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_blocks_h
+#define INCLUDED_blocks_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Number of blocks shown on each line of a coverage bitmap
+ */
+#define BLOCKS_PER_LINE   64
+
+/*
+ * Prototypes
+ */
+
+long findBlocks(struct aldWorkspace *ws, unsigned long start,
+                unsigned long bytes, unsigned long **blocks);
+void reportCoverage(struct aldWorkspace *ws);
+
+#endif /* INCLUDED_blocks_h */
@@ -44,6 +44,7 @@ struct commandWorkspace
 #define C_AMBIGUOUS          (1 << 3) /* command is ambiguous */
 #define C_PTRACE             (1 << 4) /* command uses ptrace call */
 #define C_PROCESS_RUNNING    (1 << 5) /* command requires running process */
+#define C_CORE               (1 << 6) /* may use a core file instead of a process */
 
 /*
  * Prototypes
@@ -52,15 +53,23 @@ struct commandWorkspace
 struct commandWorkspace *initCommand();
 void termCommand(struct commandWorkspace *ws);
 int procCommand(struct aldWorkspace *main_p);
+int ProcessCommand(struct aldWorkspace *ws, char *command);
 
 struct Command *FindCommand(struct Command *cmdlist, char *name,
                             unsigned int *flags);
 
+int c_advance(struct aldWorkspace *ws, int ac, char **av);
 int c_attach(struct aldWorkspace *ws, int ac, char **av);
 int c_break(struct aldWorkspace *ws, int ac, char **av);
+int c_catch(struct aldWorkspace *ws, int ac, char **av);
+int c_checkpoint(struct aldWorkspace *ws, int ac, char **av);
 int c_continue(struct aldWorkspace *ws, int ac, char **av);
+int c_core(struct aldWorkspace *ws, int ac, char **av);
+int c_coverage(struct aldWorkspace *ws, int ac, char **av);
 int c_dbreak(struct aldWorkspace *ws, int ac, char **av);
+int c_dcheckpoint(struct aldWorkspace *ws, int ac, char **av);
 int c_detach(struct aldWorkspace *ws, int ac, char **av);
+int c_diff(struct aldWorkspace *ws, int ac, char **av);
 int c_disable(struct aldWorkspace *ws, int ac, char **av);
 int c_disassemble(struct aldWorkspace *ws, int ac, char **av);
 int c_display(struct aldWorkspace *ws, int ac, char **av);
@@ -68,20 +77,39 @@ int c_enable(struct aldWorkspace *ws, int ac, char **av);
 int c_enter(struct aldWorkspace *ws, int ac, char **av);
 int c_examine(struct aldWorkspace *ws, int ac, char **av);
 int c_file(struct aldWorkspace *ws, int ac, char **av);
+int c_finish(struct aldWorkspace *ws, int ac, char **av);
+int c_ftrace(struct aldWorkspace *ws, int ac, char **av);
+int c_handle(struct aldWorkspace *ws, int ac, char **av);
 int c_help(struct aldWorkspace *ws, int ac, char **av);
 int c_ignore(struct aldWorkspace *ws, int ac, char **av);
 int c_lbreak(struct aldWorkspace *ws, int ac, char **av);
+int c_lcheckpoint(struct aldWorkspace *ws, int ac, char **av);
 int c_ldisplay(struct aldWorkspace *ws, int ac, char **av);
 int c_load(struct aldWorkspace *ws, int ac, char **av);
 int c_next(struct aldWorkspace *ws, int ac, char **av);
+int c_profile(struct aldWorkspace *ws, int ac, char **av);
 int c_quit(struct aldWorkspace *ws, int ac, char **av);
+int c_rcontinue(struct aldWorkspace *ws, int ac, char **av);
 int c_register(struct aldWorkspace *ws, int ac, char **av);
+int c_restart(struct aldWorkspace *ws, int ac, char **av);
+int c_rstep(struct aldWorkspace *ws, int ac, char **av);
 int c_run(struct aldWorkspace *ws, int ac, char **av);
+int c_search(struct aldWorkspace *ws, int ac, char **av);
 int c_set(struct aldWorkspace *ws, int ac, char **av);
+int c_snapshot(struct aldWorkspace *ws, int ac, char **av);
 int c_step(struct aldWorkspace *ws, int ac, char **av);
+int c_stepb(struct aldWorkspace *ws, int ac, char **av);
+int c_strings(struct aldWorkspace *ws, int ac, char **av);
 int c_tbreak(struct aldWorkspace *ws, int ac, char **av);
+int c_tdump(struct aldWorkspace *ws, int ac, char **av);
+int c_trace(struct aldWorkspace *ws, int ac, char **av);
+int c_tsave(struct aldWorkspace *ws, int ac, char **av);
+int c_tstatus(struct aldWorkspace *ws, int ac, char **av);
 int c_undisplay(struct aldWorkspace *ws, int ac, char **av);
 int c_unload(struct aldWorkspace *ws, int ac, char **av);
+int c_until(struct aldWorkspace *ws, int ac, char **av);
+int c_watch(struct aldWorkspace *ws, int ac, char **av);
+int c_xref(struct aldWorkspace *ws, int ac, char **av);
 
 /*
  * External declarations
@@ -0,0 +1,38 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_core_h
+#define INCLUDED_core_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Is there a core file to answer queries while no process is running?
+ */
+#define useCore(x)      (awIsCoreLoaded(x) && \
+                         !isRunningDebug((x)->debugWorkspace_p))
+
+/*
+ * Prototypes
+ */
+
+int loadCore(struct aldWorkspace *ws, char *filename);
+void unloadCore(struct aldWorkspace *ws);
+int selectCoreRegisters(struct aldWorkspace *ws);
+long readCoreMemory(struct aldWorkspace *ws, unsigned long address,
+                    unsigned long len, unsigned char **ptr);
+
+#endif /* INCLUDED_core_h */
@@ -19,6 +19,14 @@
 #define INCLUDED_main_h
 #endif
 
+/*
+ * What doStepDisplay() outputs each time the program stops
+ * (see "set step-display-mode")
+ */
+#define STEPDISP_FULL        0  /* all selected registers and memory */
+#define STEPDISP_CHANGED     1  /* only what changed since last time */
+#define STEPDISP_NONE        2  /* only the next instruction */
+
 struct stepDisplay
 {
   unsigned long startaddr;   /* address to begin memory dump */
@@ -26,6 +34,9 @@ struct stepDisplay
   long elsize;               /* size of each element */
   unsigned char output;      /* output type */
   unsigned int number;       /* number of this node */
+
+  unsigned char *prev;       /* memory contents at last display */
+  long prevbytes;            /* number of valid bytes in prev */
 };
 
 /*
@@ -35,6 +46,7 @@ struct stepDisplay
 int addStepDisplay(struct aldWorkspace *ws, unsigned long startaddr,
                    long numbytes, long elsize, unsigned char output);
 void doStepDisplay(struct aldWorkspace *ws);
+void resetStepDisplay(struct aldWorkspace *ws);
 struct genericList *findStepDisplayByNumber(struct aldWorkspace *ws,
                                             unsigned int num);
 
@@ -0,0 +1,32 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_frame_h
+#define INCLUDED_frame_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Prototypes
+ */
+
+unsigned long readStackPointer(struct aldWorkspace *ws);
+int getReturnAddress(struct aldWorkspace *ws, unsigned long *retaddr,
+                     unsigned long *frame);
+int resolveAddress(struct aldWorkspace *ws, char *str,
+                   unsigned long *address);
+
+#endif /* INCLUDED_frame_h */
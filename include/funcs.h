@@ -0,0 +1,33 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_funcs_h
+#define INCLUDED_funcs_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Prefix of recovered function names - the address follows
+ */
+#define FUNC_PREFIX     "sub_"
+
+/*
+ * Prototypes
+ */
+
+unsigned long recoverFunctions(struct aldWorkspace *ws);
+
+#endif /* INCLUDED_funcs_h */
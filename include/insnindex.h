@@ -0,0 +1,59 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_insnindex_h
+#define INCLUDED_insnindex_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Instruction starts of one executable section: bit n of the bitmap
+ * is set if an instruction begins at address + n
+ */
+struct insnIndexSection
+{
+  unsigned long address;             /* section address */
+  unsigned long size;                /* section size */
+  unsigned char *bitmap;             /* instruction start bits */
+};
+
+/*
+ * Instruction boundary index of the loaded file, with sections
+ * sorted by address
+ */
+struct insnIndex
+{
+  struct insnIndexSection *sections;
+  int nsections;
+};
+
+#define insnIndexIsStart(sec, off) \
+  ((sec)->bitmap[(off) >> 3] & (1 << ((off) & 7)))
+
+/*
+ * Prototypes
+ */
+
+struct insnIndex *getInsnIndex(struct aldWorkspace *ws);
+void freeInsnIndex(struct aldWorkspace *ws);
+struct insnIndexSection *findInsnIndexSection(struct insnIndex *index,
+                                              unsigned long address);
+int snapInsnIndex(struct aldWorkspace *ws, unsigned long address,
+                  unsigned long *result);
+long backInsnIndex(struct aldWorkspace *ws, unsigned long address,
+                   long count, unsigned long *result);
+
+#endif /* INCLUDED_insnindex_h */
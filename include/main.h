@@ -59,9 +59,30 @@ struct aldWorkspace
   unsigned int objectFileOffset;     /* file offset */
   unsigned int virtualObjectFileOffset; /* virtual address of current offset */
 
+  /*
+   * Core file parameters (see "help core")
+   */
+  void *CorePtr;                     /* pointer to mapped core file */
+  size_t CoreSize;                   /* size of mapped core file */
+  int coreFileDescriptor;            /* core file descriptor */
+  char *coreFileName;                /* name of core file */
+  int coreSignal;                    /* signal which caused the dump */
+  struct offWorkspace *coreWorkspace_p; /* core file layout */
+
+  /*
+   * How the program last stopped - the arguments of the last
+   * analyzeTraceResult() call, tested by batch scripts
+   */
+  int lastTraceResult;
+  int lastTraceData;
+
+  char *batchFile;                   /* script given with -batch */
+  char *batchOutput;                 /* output file given with -o */
+
   unsigned int settings;             /* boolean settings (see set.h) */
   unsigned int flags;                /* bitmask flags (AW_xxx) */
   unsigned int stepDisplayFlags;     /* regs to display on singlesteps (DB_REGFL_xxx) */
+  unsigned int stepDisplayMode;      /* what to display on singlesteps (STEPDISP_xxx) */
 
   /*
    * Disassemble variables
@@ -69,6 +90,24 @@ struct aldWorkspace
   unsigned long nextInstruction;     /* next instruction to disassemble */
   unsigned int currentSectionStart;  /* start of current section */
 
+  /*
+   * Instruction starts in the loaded file, built when first needed
+   * (see insnindex.c)
+   */
+  struct insnIndex *insnIndex_p;
+
+  /*
+   * Calls, jumps and address operands in the loaded file, built
+   * when first needed (see xref.c)
+   */
+  struct xrefIndex *xrefIndex_p;
+
+  /*
+   * Printable strings in the loaded file, built when first needed
+   * (see strindex.c)
+   */
+  struct strIndex *strIndex_p;
+
   /*
    * This list contains pointers to memory which need to
    * be freed in case the path of execution takes an
@@ -91,6 +130,17 @@ struct aldWorkspace
   struct genericList *stepDisplayList;
   unsigned int stepDisplayNum;
 
+  /*
+   * Register contents as of the last step display, used by
+   * "set step-display-mode changed"
+   */
+  struct registerSnapshot *stepRegisters;
+
+  /*
+   * Saved memory regions (struct snapshot), see "help snapshot"
+   */
+  struct genericList *snapshotList;
+
   struct commandWorkspace *commandWorkspace_p;
   struct printWorkspace *printWorkspace_p;
   struct rcWorkspace *rcWorkspace_p;
@@ -103,15 +153,19 @@ struct aldWorkspace
 
 #define AW_ATTACHED           (1 << 0)  /* attached to running process */
 #define AW_FILELOADED         (1 << 1)  /* file loaded into memory */
+#define AW_CORELOADED         (1 << 2)  /* core file loaded */
 
 #define awSetAttached(x)      ((x)->flags |= AW_ATTACHED)
 #define awSetFileLoaded(x)    ((x)->flags |= AW_FILELOADED)
+#define awSetCoreLoaded(x)    ((x)->flags |= AW_CORELOADED)
 
 #define awIsAttached(x)       ((x)->flags & AW_ATTACHED)
 #define awIsFileLoaded(x)     ((x)->flags & AW_FILELOADED)
+#define awIsCoreLoaded(x)     ((x)->flags & AW_CORELOADED)
 
 #define awClearAttached(x)    ((x)->flags &= ~AW_ATTACHED)
 #define awClearFileLoaded(x)  ((x)->flags &= ~AW_FILELOADED)
+#define awClearCoreLoaded(x)  ((x)->flags &= ~AW_CORELOADED)
 
 /*
  * Prototypes
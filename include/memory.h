@@ -28,6 +28,13 @@ struct MemFormat
   int cpe;             /* number of characters per element */
 };
 
+/*
+ * Longest line of a memory dump, and size of the blocks in which
+ * dump lines are handed to PrintBlock()
+ */
+#define MEM_MAXLINE    256
+#define MEM_BLOCKSIZE  8192
+
 /*
  * MF_xxx - array indices of the OutputFormats[] array
  */
@@ -48,5 +55,9 @@ struct MemFormat
 unsigned long GetElementSize(char *str);
 void OutputMemory(struct aldWorkspace *ws, unsigned char *buf, unsigned long start,
                   long bytes, long size, unsigned char output);
+long OutputChangedMemory(struct aldWorkspace *ws, unsigned char *buf,
+                         unsigned char *prev, long prevbytes,
+                         unsigned long start, long bytes, long size,
+                         unsigned char output);
 
 #endif /* INCLUDED_memory_h */
@@ -27,11 +27,18 @@
 #define MSG_INVSYM          "Invalid symbol: %s"
 #define MSG_PTERR           "Error in ptrace(): %s"
 #define MSG_BKPTENCOUNTERED "Breakpoint %d encountered at 0x%08lX"
+#define MSG_WATCHHIT        "Watchpoint %d: 0x%08lX written by instruction at 0x%08lX"
+#define MSG_CATCHSYSCALL    "Caught system call %s\nLocation: 0x%08lX"
 #define MSG_GOTSIGNAL       "\nProgram received signal %s (%s)\nLocation: 0x%08lX"
 #define MSG_GOTUNKNOWNSIG   "\nProgram received unknown signal %d\nLocation: 0x%08lX"
+#define MSG_PASSSIGNAL      "Program received signal %s (%s) at 0x%08lX, %s"
+#define MSG_PASSUNKNOWNSIG  "Program received unknown signal %d at 0x%08lX, %s"
 #define MSG_NOACCESS        "Unable to access memory at location 0x%08X: %s"
 #define MSG_NOPROCESS       "No process is currently being debugged"
 #define MSG_PROGTERMSIG     "Program terminated with signal %s (%s)"
 #define MSG_PROGTERMUNKNOWNSIG "Program terminated with unknown signal %d"
+#define MSG_OUTPUTDROPPED   "(%lu bytes of program output discarded)"
+#define MSG_NORECORD        "Execution is not being recorded (see help set record)"
+#define MSG_HISTORYSTART    "Reached start of recorded history"
 
 #endif /* INCLUDED_msg_h */
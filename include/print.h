@@ -29,6 +29,11 @@
 #define INCLUDED_alddefs_h
 #endif
 
+/*
+ * Size of the buffer which collects output during a print burst
+ */
+#define PRINT_BUFSIZE  32768
+
 struct printWorkspace
 {
   int PausePrint;              /* print bursts will be paused after each pageful */
@@ -36,6 +41,11 @@ struct printWorkspace
   unsigned long PrintLineCnt;  /* number of printed lines during burst */
   FILE *file_p;                /* alternate output file (from "set output") */
   char *filename;              /* filename corresponding to file_p */
+
+  int IsTTY;                   /* set if stdout is a terminal */
+  int Buffering;               /* set if output is being buffered */
+  char *OutBuf;                /* buffered output (PRINT_BUFSIZE bytes) */
+  long OutLen;                 /* number of bytes in OutBuf */
 };
 
 #define P_DEBUG       (1 << 0) /* DebugFrame */
@@ -57,8 +67,11 @@ void termPrint(struct printWorkspace *ws);
 
 void startPrintBurst(struct printWorkspace *ws);
 void endPrintBurst(struct printWorkspace *ws);
+void flushPrint(struct printWorkspace *ws);
 void Print(struct aldWorkspace *main_p, int flags, const char *format, ...);
 void RawPrint(struct aldWorkspace *main_p, int flags, const char *format, ...);
+void PrintBlock(struct aldWorkspace *main_p, int flags, const char *buf,
+                long len);
 void PrintWindow(struct aldWorkspace *main_p, int raw,
                  const char *format, va_list args);
 
@@ -30,11 +30,38 @@
  */
 #define NOREG      (-1)
 
+/*
+ * Register classes kept in a registerSnapshot
+ */
+#define SNAP_GENERAL    0
+#define SNAP_FPU        1
+#define SNAP_MMX        2
+#define SNAP_CLASSES    3
+
+#define SNAP_MAXREGS    24  /* maximum registers per class */
+#define SNAP_HEXLEN     32  /* room for the hex value of an fpu register */
+
+/*
+ * Register contents as of the last "changed" step display, so the
+ * next one can print only the registers which differ
+ */
+struct registerSnapshot
+{
+  int valid[SNAP_CLASSES];                       /* class has been recorded */
+  unsigned long values[SNAP_CLASSES][SNAP_MAXREGS];
+  char hexvalues[SNAP_CLASSES][SNAP_MAXREGS][SNAP_HEXLEN];
+};
+
 struct callbackArgs
 {
   struct aldWorkspace *main_p;  /* pointer to main workspace */
   int regcount;                 /* number of registers printed to current line */
   char scratch[MAXLINE];        /* scratch buffer */
+
+  struct registerSnapshot *snapshot; /* snapshot to compare against */
+  int snapclass;                /* SNAP_xxx class being displayed */
+  int snapindex;                /* index of next register in class */
+  int flagschanged;             /* eflags differs from snapshot */
 };
 
 /*
@@ -43,5 +70,6 @@ struct callbackArgs
 
 void displayRegisters(struct aldWorkspace *ws, int regindex, int compact,
                       unsigned int flgs);
+void displayChangedRegisters(struct aldWorkspace *ws, unsigned int flgs);
 
 #endif /* INCLUDED_registers_h */
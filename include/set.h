@@ -23,21 +23,29 @@
 #define SET_DISPLAY_FP_REGS    (1 << 1)
 #define SET_DISPLAY_MMX_REGS   (1 << 2)
 #define SET_DISASM_SHOW_SYMS   (1 << 3)
+#define SET_CAPTURE_OUTPUT     (1 << 4)
+#define SET_STEP_BLOCK         (1 << 5)
 
 #define SetStepDisplayRegs(x)       ((x)->settings |= SET_DISPLAY_REGS)
 #define SetStepDisplayFpRegs(x)     ((x)->settings |= SET_DISPLAY_FP_REGS)
 #define SetStepDisplayMmxRegs(x)    ((x)->settings |= SET_DISPLAY_MMX_REGS)
 #define SetDisasmShowSyms(x)        ((x)->settings |= SET_DISASM_SHOW_SYMS)
+#define SetCaptureOutput(x)         ((x)->settings |= SET_CAPTURE_OUTPUT)
+#define SetStepBlock(x)             ((x)->settings |= SET_STEP_BLOCK)
 
 #define IsSetStepDisplayRegs(x)     ((x)->settings & SET_DISPLAY_REGS)
 #define IsSetStepDisplayFpRegs(x)   ((x)->settings & SET_DISPLAY_FP_REGS)
 #define IsSetStepDisplayMmxRegs(x)  ((x)->settings & SET_DISPLAY_MMX_REGS)
 #define IsSetDisasmShowSyms(x)      ((x)->settings & SET_DISASM_SHOW_SYMS)
+#define IsSetCaptureOutput(x)       ((x)->settings & SET_CAPTURE_OUTPUT)
+#define IsSetStepBlock(x)           ((x)->settings & SET_STEP_BLOCK)
 
 #define UnsetStepDisplayRegs(x)     ((x)->settings &= ~SET_DISPLAY_REGS)
 #define UnsetStepDisplayFpRegs(x)   ((x)->settings &= ~SET_DISPLAY_FP_REGS)
 #define UnsetStepDisplayMmxRegs(x)  ((x)->settings &= ~SET_DISPLAY_MMX_REGS)
 #define UnsetDisasmShowSyms(x)      ((x)->settings &= ~SET_DISASM_SHOW_SYMS)
+#define UnsetCaptureOutput(x)       ((x)->settings &= ~SET_CAPTURE_OUTPUT)
+#define UnsetStepBlock(x)           ((x)->settings &= ~SET_STEP_BLOCK)
 
 /*
  * These SETSYN_xxx are indices into the array setCmdsSyntax[]
@@ -45,15 +53,22 @@
 enum
 {
   SETSYN_ARGS,
+  SETSYN_CAPTURE_OUTPUT,
+  SETSYN_CATCH_LOG,
   SETSYN_DISASM_SHOW_SYMS,
   SETSYN_ENTRY,
   SETSYN_OFFSET,
   SETSYN_OUTPUT,
   SETSYN_PAUSEPRINT,
   SETSYN_PROMPT,
+  SETSYN_RECORD,
+  SETSYN_RECORD_SIZE,
   SETSYN_STEP_DISP_REGS,
   SETSYN_STEP_DISP_FPREGS,
-  SETSYN_STEP_DISP_MMXREGS
+  SETSYN_STEP_DISP_MMXREGS,
+  SETSYN_STEP_DISP_MODE,
+  SETSYN_STEP_GRANULARITY,
+  SETSYN_TRACE_SIZE
 };
 
 /*
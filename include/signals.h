@@ -62,6 +62,8 @@ struct aSignal
  * Prototypes
  */
 struct aSignal *GetSignal(int signum);
+int FindSignal(char *name);
+void NotifySignal(void *args, int sig);
 void SetupSignals();
 void SigHandler(int sig);
 
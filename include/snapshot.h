@@ -0,0 +1,68 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_snapshot_h
+#define INCLUDED_snapshot_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+#define SNAPSHOT_NAMELEN     32  /* longest snapshot name */
+#define SNAPSHOT_MAXREGIONS  16  /* most regions in one snapshot */
+
+/*
+ * Equal memory is skipped this many bytes at a time when diffing
+ */
+#define SNAPSHOT_BLOCKSIZE   64
+
+/*
+ * Changes separated by fewer unchanged bytes than this are reported
+ * as a single run
+ */
+#define SNAPSHOT_MAXGAP      4
+
+/*
+ * Number of old/new bytes shown for each changed run
+ */
+#define SNAPSHOT_SHOWBYTES   16
+
+struct snapshotRegion
+{
+  unsigned long start;     /* start address */
+  unsigned long size;      /* number of bytes */
+  unsigned char *data;     /* saved contents */
+};
+
+/*
+ * A snapshot is allocated in one block: the structure, followed by
+ * its regions, followed by their contents
+ */
+struct snapshot
+{
+  char name[SNAPSHOT_NAMELEN + 1];
+  int nregions;
+  struct snapshotRegion *regions;
+};
+
+/*
+ * Prototypes
+ */
+
+struct genericList *findSnapshot(struct aldWorkspace *ws, char *name);
+struct snapshot *takeSnapshot(struct aldWorkspace *ws, char *name,
+                              struct snapshotRegion *regions, int nregions);
+unsigned long diffSnapshot(struct aldWorkspace *ws, struct snapshot *snap);
+
+#endif /* INCLUDED_snapshot_h */
@@ -0,0 +1,73 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_strindex_h
+#define INCLUDED_strindex_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Shortest run of printable characters which is recorded
+ */
+#define STR_MINLEN      4
+
+/*
+ * Longest part of a string shown on one line
+ */
+#define STR_SHOWLEN     200
+
+/*
+ * A section of the file, for annotating strings
+ */
+struct strSection
+{
+  char *name;                        /* section name */
+  unsigned long address;             /* section address */
+  unsigned long size;                /* section size */
+};
+
+/*
+ * A run of printable characters in the file
+ */
+struct strEntry
+{
+  unsigned long offset;              /* file offset */
+  unsigned long length;              /* number of characters */
+  int section;                       /* index into sections, or -1 */
+};
+
+/*
+ * Printable strings of the loaded file, sorted by offset
+ */
+struct strIndex
+{
+  struct strEntry *entries;
+  long count;
+
+  struct strSection *sections;       /* sorted by address */
+  int nsections;
+};
+
+/*
+ * Prototypes
+ */
+
+struct strIndex *getStrIndex(struct aldWorkspace *ws);
+void freeStrIndex(struct aldWorkspace *ws);
+long findStringIndex(struct strIndex *index, unsigned long offset);
+struct strEntry *findString(struct aldWorkspace *ws, unsigned long address);
+
+#endif /* INCLUDED_strindex_h */
@@ -0,0 +1,35 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_systrace_h
+#define INCLUDED_systrace_h
+
+/*
+ * Arguments with an absolute value below this are shown in decimal,
+ * others (most likely addresses) in hex
+ */
+#define SYSTRACE_DECIMAL   0x10000
+
+/*
+ * Prototypes
+ */
+
+struct aldWorkspace;
+struct syscallEvent;
+
+int FindSyscall(struct aldWorkspace *ws, char *name);
+char *FormatSyscall(struct aldWorkspace *ws, struct syscallEvent *event,
+                    char *buf);
+void NotifySyscall(void *args, struct syscallEvent *event);
+
+#endif /* INCLUDED_systrace_h */
@@ -21,6 +21,7 @@
 struct aldWorkspace;
 
 int analyzeTraceResult(struct aldWorkspace *ws, int result, int data);
+void DisplayProcessOutput(struct aldWorkspace *ws);
 
 
 #endif /* INCLUDED_traceresult_h */
@@ -0,0 +1,67 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_xref_h
+#define INCLUDED_xref_h
+
+#ifndef INCLUDED_main_h
+#include "main.h"       /* struct aldWorkspace */
+#define INCLUDED_main_h
+#endif
+
+/*
+ * Kinds of reference
+ */
+#define XREF_CALL     0  /* relative call */
+#define XREF_JUMP     1  /* relative jump or conditional branch */
+#define XREF_DATA     2  /* absolute address in an operand */
+
+/*
+ * One reference from the instruction at source to target
+ */
+struct xref
+{
+  unsigned long source;              /* address of instruction */
+  unsigned long target;              /* address referenced */
+  int kind;                          /* XREF_xxx */
+};
+
+/*
+ * Cross reference index of the loaded file: the same references
+ * sorted by target and by source
+ */
+struct xrefIndex
+{
+  struct xref *byTarget;
+  struct xref *bySource;
+  long count;
+};
+
+/*
+ * Prototypes
+ */
+
+struct xrefIndex *getXrefIndex(struct aldWorkspace *ws);
+void freeXrefIndex(struct aldWorkspace *ws);
+long findXrefsTo(struct aldWorkspace *ws, unsigned long start,
+                 unsigned long end, struct xref **refs);
+long findXrefsFrom(struct aldWorkspace *ws, unsigned long start,
+                   unsigned long end, struct xref **refs);
+
+/*
+ * External declarations
+ */
+
+extern char *XrefKindNames[];
+
+#endif /* INCLUDED_xref_h */
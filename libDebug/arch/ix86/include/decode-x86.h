@@ -0,0 +1,97 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_decode_x86_h
+#define INCLUDED_decode_x86_h
+
+/*
+ * Longest possible instruction
+ */
+#define X86_MAXINSN       15
+
+/*
+ * Most memory ranges a single instruction may write to
+ */
+#define X86_MAXWRITES     3
+
+/*
+ * Bits of eflags
+ */
+#define X86_EFLAGS_CF     (1 << 0)  /* carry */
+#define X86_EFLAGS_PF     (1 << 2)  /* parity */
+#define X86_EFLAGS_AF     (1 << 4)  /* auxiliary carry */
+#define X86_EFLAGS_ZF     (1 << 6)  /* zero */
+#define X86_EFLAGS_SF     (1 << 7)  /* sign */
+#define X86_EFLAGS_TF     (1 << 8)  /* trap */
+#define X86_EFLAGS_DF     (1 << 10) /* direction */
+#define X86_EFLAGS_OF     (1 << 11) /* overflow */
+
+/*
+ * Prefix flags
+ */
+#define X86_PX_OPSIZE     (1 << 0)  /* 0x66 operand size override */
+#define X86_PX_ADDRSIZE   (1 << 1)  /* 0x67 address size override */
+#define X86_PX_REP        (1 << 2)  /* 0xF3 rep/repe */
+#define X86_PX_REPNE      (1 << 3)  /* 0xF2 repne */
+#define X86_PX_LOCK       (1 << 4)  /* 0xF0 lock */
+
+/*
+ * The parts of an instruction up to (not including) its immediate
+ * operand. Two byte opcodes are stored as 0x0Fxx, three byte ones as
+ * 0x0F38xx or 0x0F3Axx.
+ */
+struct x86Insn
+{
+  unsigned int prefixes;  /* X86_PX_xxx */
+  int segment;            /* segment override (REG_xS), -1 if none */
+  unsigned long opcode;   /* opcode */
+
+  int modrm;              /* 1 if there is a ModR/M byte */
+  int mod, reg, rm;       /* its fields */
+
+  int mem;                /* 1 if there is a memory operand */
+  int base, index;        /* its registers (REG_xxx), -1 if none */
+  int scale;              /* index multiplier */
+  long disp;              /* displacement */
+
+  int length;             /* bytes decoded */
+};
+
+/*
+ * A range of memory an instruction writes to
+ */
+struct x86MemWrite
+{
+  unsigned long address;
+  unsigned long size;
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int x86decodeInsn(unsigned char *buf, int len, struct x86Insn *insn);
+unsigned long x86effectiveAddress(struct debugWorkspace *ws,
+                                  struct x86Insn *insn);
+int x86memoryWrites(struct debugWorkspace *ws, unsigned char *buf, int len,
+                    struct x86MemWrite *writes);
+
+/*
+ * External declarations
+ */
+
+extern int x86ModRMRegs[];
+
+#endif /* INCLUDED_decode_x86_h */
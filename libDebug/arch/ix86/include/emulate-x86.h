@@ -0,0 +1,56 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_emulate_x86_h
+#define INCLUDED_emulate_x86_h
+
+/*
+ * Access rights of a mapped region
+ */
+#define EMU_MAP_READ   (1 << 0)
+#define EMU_MAP_WRITE  (1 << 1)
+#define EMU_MAP_EXEC   (1 << 2)
+
+/*
+ * A region of the process' address space
+ */
+struct x86MapRegion
+{
+  unsigned long start;    /* first address */
+  unsigned long end;      /* address following the region */
+  unsigned int perms;     /* EMU_MAP_xxx */
+};
+
+/*
+ * Copy of the process' memory map. Memory is accessed through
+ * /proc/<pid>/mem, which ignores page protections, so the emulator
+ * checks an access against this first - one the cpu would fault on
+ * is left to a real single step. It is read at most once per stop.
+ */
+struct x86MemoryMap
+{
+  struct x86MapRegion *regions; /* sorted by address */
+  int count;                    /* number of regions */
+  int size;                     /* number of regions allocated */
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int x86emulateStep(struct debugWorkspace *ws);
+void x86clearMemoryMap(struct debugWorkspace *ws);
+
+#endif /* INCLUDED_emulate_x86_h */
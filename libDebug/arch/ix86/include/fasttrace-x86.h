@@ -0,0 +1,31 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_fasttrace_x86_h
+#define INCLUDED_fasttrace_x86_h
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+struct fastTracepoint;
+
+int x86insertFastTracepoint(struct debugWorkspace *ws,
+                            struct fastTracepoint *ptr);
+void x86removeFastTracepoint(struct debugWorkspace *ws,
+                             struct fastTracepoint *ptr, int restore);
+void x86harvestFastTracepoint(struct debugWorkspace *ws,
+                              struct fastTracepoint *ptr);
+
+#endif /* INCLUDED_fasttrace_x86_h */
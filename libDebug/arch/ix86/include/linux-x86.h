@@ -92,6 +92,18 @@
 #  define PT_SYSCALL PTRACE_SYSCALL
 #endif
 
+#if !defined(PT_STEPBLOCK) && defined(PTRACE_SINGLEBLOCK)
+#  define PT_STEPBLOCK PTRACE_SINGLEBLOCK
+#endif
+
+#if !defined(PT_SETOPTIONS) && defined(PTRACE_SETOPTIONS)
+#  define PT_SETOPTIONS PTRACE_SETOPTIONS
+#endif
+
+#if !defined(PT_GETEVENTMSG) && defined(PTRACE_GETEVENTMSG)
+#  define PT_GETEVENTMSG PTRACE_GETEVENTMSG
+#endif
+
 /*
  * Prototypes
  */
@@ -102,6 +114,11 @@ int x86initRegistersDebug(struct debugWorkspace *ws);
 unsigned long x86getCurrentInstruction(struct debugWorkspace *ws, int *err);
 int x86setCurrentInstruction(struct debugWorkspace *ws, unsigned long address);
 int x86getRegistersDebug(struct debugWorkspace *ws);
+int x86getFPRegistersDebug(struct debugWorkspace *ws);
+int x86flushRegistersDebug(struct debugWorkspace *ws);
+int x86loadCoreRegistersDebug(struct debugWorkspace *ws, void *prstatus,
+                              size_t size, void *fpregs, size_t fpsize,
+                              int *sig);
 int x86readFPUDebug(struct debugWorkspace *ws, struct x86fpuInfo *fpuState);
 int x86writeRegisterDebug(struct debugWorkspace *ws, struct x86RegInfo *rptr,
                           struct x86RegValue *regVal);
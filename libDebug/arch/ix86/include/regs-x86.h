@@ -196,8 +196,25 @@ struct x86RegisterContents
 
 #endif
 
+  unsigned int cache;   /* RC_xxx - state of our copy of the registers */
 };
 
+/*
+ * Register cache flags. Each class of registers is fetched from the
+ * process the first time it is needed after a stop and kept until the
+ * process is resumed. Modified classes are marked dirty and written
+ * back in one go by x86flushRegistersDebug() right before resuming.
+ * The emulator's copy of the memory map goes stale at the same time,
+ * so its state is kept here as well.
+ */
+#define RC_GENERAL_VALID   (1 << 0) /* general registers are up to date */
+#define RC_GENERAL_DIRTY   (1 << 1) /* general registers were modified */
+#define RC_FPU_VALID       (1 << 2) /* fpu/mmx registers are up to date */
+#define RC_FPU_DIRTY       (1 << 3) /* fpu/mmx registers were modified */
+#define RC_MAPS_VALID      (1 << 4) /* memory map (emulate-x86.c) is up to date */
+
+#define x86invalidateRegistersDebug(x)  ((x)->regContents.cache = 0)
+
 /*
  * Prototypes
  */
@@ -0,0 +1,32 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_syscalls_x86_h
+#define INCLUDED_syscalls_x86_h
+
+struct x86Syscall
+{
+  int number;   /* system call number */
+  char *name;   /* name */
+  int nargs;    /* number of arguments */
+};
+
+/*
+ * Prototypes
+ */
+
+int x86findSyscall(char *name);
+char *x86getSyscallName(int number);
+int x86getSyscallArgs(int number);
+
+#endif /* INCLUDED_syscalls_x86_h */
@@ -24,6 +24,16 @@
  */
 #define BRKPT_INSN    0xCC
 
+/*
+ * INT 0x80 (system call) instruction, as a little endian word
+ */
+#define SYSCALL_INSN  0x80CD
+
+/*
+ * Most arguments passed to a system call
+ */
+#define X86_SYSCALL_MAXARGS  6
+
 #if defined(OS_BSD) /* FreeBSD, OpenBSD, NetBSD */
 
 /*
@@ -37,6 +47,11 @@
 #define PtraceWrite(pid, addr, data) \
   ptrace(PT_WRITE_D, (pid), (caddr_t) (addr), (data))
 
+/*
+ * waitpid() option to wait for a traced process which is not our child
+ */
+#define WAIT_TRACED  0
+
 #elif defined(OS_LINUX)
 
 #define CONTADDR   (0)
@@ -47,6 +62,12 @@
 #define PtraceWrite(pid, addr, data) \
   ptrace(PT_WRITE_D, (pid), (addr), (data))
 
+/*
+ * waitpid() option to wait for a traced process which is not our
+ * child, such as a copy of a checkpoint (see x86forkDebug())
+ */
+#define WAIT_TRACED  __WALL
+
 #else
 
 # error No supported operating system found
@@ -58,20 +79,44 @@
  */
 
 struct debugWorkspace;
+struct Coverage;
+struct Watch;
 
 int x86execDebug(struct debugWorkspace *ws);
 int x86stepIntoDebug(struct debugWorkspace *ws, int num, int *data);
+int x86stepBlockDebug(struct debugWorkspace *ws, int num, int *data);
 int x86stepOverDebug(struct debugWorkspace *ws, int num, int *data);
+int x86runToDebug(struct debugWorkspace *ws, unsigned long *addrs, int num,
+                  unsigned long frame, int *data);
 int x86continueDebug(struct debugWorkspace *ws, int *data);
+int x86profileDebug(struct debugWorkspace *ws, long duration, long interval,
+                    void (*callback)(void *, unsigned long *, int),
+                    void *args, int *data);
 int x86attachDebug(struct debugWorkspace *ws, int pid);
 int x86detachDebug(struct debugWorkspace *ws);
 int x86killDebug(struct debugWorkspace *ws);
+pid_t x86forkDebug(struct debugWorkspace *ws, pid_t pid);
 int x86saveBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr);
 int x86enableBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr);
 int x86disableBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr);
+long x86readMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                        unsigned char *buf, unsigned long bytes);
+long x86writeMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                         unsigned char *buf, unsigned long bytes);
+int x86openProcMem(struct debugWorkspace *ws);
+int x86syscallDebug(struct debugWorkspace *ws, long number, long *args,
+                    long *result);
+int x86traverseMapsDebug(struct debugWorkspace *ws,
+                         void (*callback)(void *, unsigned long,
+                                          unsigned long, char *),
+                         void *args);
 long x86dumpMemoryDebug(struct debugWorkspace *ws, unsigned char **buf,
                         unsigned long start, unsigned long bytes);
 int x86setMemoryDebug(struct debugWorkspace *ws, unsigned long address,
                       unsigned long value);
+int x86insertCoverage(struct debugWorkspace *ws, struct Coverage *cov);
+int x86removeCoverage(struct debugWorkspace *ws, struct Coverage *cov);
+int x86insertWatch(struct debugWorkspace *ws, struct Watch *watch);
+int x86removeWatch(struct debugWorkspace *ws, struct Watch *watch);
 
 #endif /* INCLUDED_trace_x86_h */
@@ -0,0 +1,599 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <string.h>
+
+#include "libDebug.h"
+#include "decode-x86.h"
+
+/*
+ * Bytes saved at the address of a memory operand - enough for any
+ * operand except fxsave, which is handled separately
+ */
+#define X86_SAVESIZE      16
+
+/*
+ * Longest repeated string instruction whose destination is saved
+ */
+#define X86_MAXSTRING     65536
+
+static int x86Prefix(unsigned char byte, struct x86Insn *insn);
+static int x86TwoByteModRM(unsigned char byte);
+static long x86GetLong(unsigned char *buf);
+static int x86PureLoad(struct x86Insn *insn);
+static int x86VectorState(struct x86Insn *insn);
+
+/*
+ * ModR/M register numbers in REG_xxx terms
+ */
+int x86ModRMRegs[] = {
+  REG_EAX,
+  REG_ECX,
+  REG_EDX,
+  REG_EBX,
+  REG_ESP,
+  REG_EBP,
+  REG_ESI,
+  REG_EDI
+};
+
+/*
+ * One byte opcodes which take a ModR/M byte: bit n of entry x is
+ * set for opcode 0xXn
+ */
+static unsigned short OneByteModRM[] = {
+  0x0F0F, /* 0x00 - 0x0F: add, or */
+  0x0F0F, /* 0x10 - 0x1F: adc, sbb */
+  0x0F0F, /* 0x20 - 0x2F: and, sub */
+  0x0F0F, /* 0x30 - 0x3F: xor, cmp */
+  0x0000, /* 0x40 - 0x4F */
+  0x0000, /* 0x50 - 0x5F */
+  0x0A0C, /* 0x60 - 0x6F: bound, arpl, imul */
+  0x0000, /* 0x70 - 0x7F */
+  0xFFFF, /* 0x80 - 0x8F: group 1, test, xchg, mov, lea, pop */
+  0x0000, /* 0x90 - 0x9F */
+  0x0000, /* 0xA0 - 0xAF */
+  0x0000, /* 0xB0 - 0xBF */
+  0x00F3, /* 0xC0 - 0xCF: group 2, les, lds, mov */
+  0xFF0F, /* 0xD0 - 0xDF: group 2, fpu */
+  0x0000, /* 0xE0 - 0xEF */
+  0xC0C0  /* 0xF0 - 0xFF: group 3, group 4, group 5 */
+};
+
+/*
+x86Prefix()
+  Record an instruction prefix
+
+Inputs: byte - byte to check
+        insn - instruction being decoded
+
+Return: 1 if byte is a prefix
+        0 if not
+*/
+
+static int
+x86Prefix(unsigned char byte, struct x86Insn *insn)
+
+{
+  switch (byte)
+  {
+    case 0x66: insn->prefixes |= X86_PX_OPSIZE; break;
+    case 0x67: insn->prefixes |= X86_PX_ADDRSIZE; break;
+    case 0xF3: insn->prefixes |= X86_PX_REP; break;
+    case 0xF2: insn->prefixes |= X86_PX_REPNE; break;
+    case 0xF0: insn->prefixes |= X86_PX_LOCK; break;
+    case 0x26: insn->segment = REG_ES; break;
+    case 0x2E: insn->segment = REG_CS; break;
+    case 0x36: insn->segment = REG_SS; break;
+    case 0x3E: insn->segment = REG_DS; break;
+    case 0x64: insn->segment = REG_FS; break;
+    case 0x65: insn->segment = REG_GS; break;
+
+    default: return (0);
+  }
+
+  return (1);
+} /* x86Prefix() */
+
+/*
+x86TwoByteModRM()
+  Determine whether a two byte (0x0F xx) opcode takes a ModR/M byte
+
+Inputs: byte - second opcode byte
+
+Return: 1 if so
+        0 if not
+*/
+
+static int
+x86TwoByteModRM(unsigned char byte)
+
+{
+  if (((byte >= 0x30) && (byte <= 0x37)) ||
+      ((byte >= 0x80) && (byte <= 0x8F)) ||
+      ((byte >= 0xC8) && (byte <= 0xCF)))
+    return (0);
+
+  switch (byte)
+  {
+    case 0x05: /* syscall */
+    case 0x06: /* clts */
+    case 0x07: /* sysret */
+    case 0x08: /* invd */
+    case 0x09: /* wbinvd */
+    case 0x0B: /* ud2 */
+    case 0x0E: /* femms */
+    case 0x77: /* emms */
+    case 0xA0: /* push fs */
+    case 0xA1: /* pop fs */
+    case 0xA2: /* cpuid */
+    case 0xA8: /* push gs */
+    case 0xA9: /* pop gs */
+    case 0xAA: /* rsm */
+      return (0);
+  }
+
+  return (1);
+} /* x86TwoByteModRM() */
+
+/*
+x86GetLong()
+  Read a little endian 32 bit value
+*/
+
+static long
+x86GetLong(unsigned char *buf)
+
+{
+  return ((long) ((unsigned long) buf[0] |
+                  ((unsigned long) buf[1] << 8) |
+                  ((unsigned long) buf[2] << 16) |
+                  ((unsigned long) buf[3] << 24)));
+} /* x86GetLong() */
+
+/*
+x86decodeInsn()
+  Decode the prefixes, opcode and memory operand of an instruction.
+Only 32 bit addressing is understood.
+
+Inputs: buf  - instruction bytes
+        len  - number of bytes in buf
+        insn - modified to contain the decoded instruction
+
+Return: 1 if successful
+        0 if the instruction is truncated or uses 16 bit addressing
+*/
+
+int
+x86decodeInsn(unsigned char *buf, int len, struct x86Insn *insn)
+
+{
+  int pos;
+  unsigned char byte,
+                sib;
+
+  memset(insn, '\0', sizeof(struct x86Insn));
+  insn->segment = -1;
+  insn->base = -1;
+  insn->index = -1;
+  insn->scale = 1;
+
+  if (len > X86_MAXINSN)
+    len = X86_MAXINSN;
+
+  for (pos = 0; (pos < len) && x86Prefix(buf[pos], insn); ++pos)
+    ;
+
+  if ((pos >= len) || (insn->prefixes & X86_PX_ADDRSIZE))
+    return (0);
+
+  byte = buf[pos++];
+  if (byte == 0x0F)
+  {
+    if (pos >= len)
+      return (0);
+
+    byte = buf[pos++];
+    if ((byte == 0x38) || (byte == 0x3A))
+    {
+      if (pos >= len)
+        return (0);
+
+      insn->opcode = 0x0F0000 | ((unsigned long) byte << 8) | buf[pos++];
+      insn->modrm = 1;
+    }
+    else
+    {
+      insn->opcode = 0x0F00 | byte;
+      insn->modrm = x86TwoByteModRM(byte);
+    }
+  }
+  else
+  {
+    insn->opcode = byte;
+    insn->modrm = (OneByteModRM[byte >> 4] >> (byte & 0x0F)) & 1;
+  }
+
+  if (!insn->modrm)
+  {
+    /*
+     * mov between the accumulator and an absolute address
+     */
+    if ((insn->opcode >= 0xA0) && (insn->opcode <= 0xA3))
+    {
+      if (pos + 4 > len)
+        return (0);
+
+      insn->mem = 1;
+      insn->disp = x86GetLong(buf + pos);
+      pos += 4;
+    }
+
+    insn->length = pos;
+    return (1);
+  }
+
+  if (pos >= len)
+    return (0);
+
+  byte = buf[pos++];
+  insn->mod = (byte >> 6) & 0x03;
+  insn->reg = (byte >> 3) & 0x07;
+  insn->rm = byte & 0x07;
+
+  if (insn->mod == 3)
+  {
+    insn->length = pos;
+    return (1);
+  }
+
+  insn->mem = 1;
+
+  if (insn->rm == 4)
+  {
+    if (pos >= len)
+      return (0);
+
+    sib = buf[pos++];
+    insn->scale = 1 << ((sib >> 6) & 0x03);
+
+    if (((sib >> 3) & 0x07) != 4)
+      insn->index = x86ModRMRegs[(sib >> 3) & 0x07];
+
+    if (((sib & 0x07) == 5) && (insn->mod == 0))
+    {
+      if (pos + 4 > len)
+        return (0);
+
+      insn->disp = x86GetLong(buf + pos);
+      pos += 4;
+    }
+    else
+      insn->base = x86ModRMRegs[sib & 0x07];
+  }
+  else if ((insn->rm == 5) && (insn->mod == 0))
+  {
+    if (pos + 4 > len)
+      return (0);
+
+    insn->disp = x86GetLong(buf + pos);
+    pos += 4;
+  }
+  else
+    insn->base = x86ModRMRegs[insn->rm];
+
+  if (insn->mod == 1)
+  {
+    if (pos >= len)
+      return (0);
+
+    insn->disp = (long) (signed char) buf[pos++];
+  }
+  else if (insn->mod == 2)
+  {
+    if (pos + 4 > len)
+      return (0);
+
+    insn->disp = x86GetLong(buf + pos);
+    pos += 4;
+  }
+
+  insn->length = pos;
+
+  return (1);
+} /* x86decodeInsn() */
+
+/*
+x86effectiveAddress()
+  Compute the address of an instruction's memory operand from the
+current register contents. Segment bases are not added.
+
+Inputs: ws   - debug workspace
+        insn - decoded instruction
+
+Return: operand address
+*/
+
+unsigned long
+x86effectiveAddress(struct debugWorkspace *ws, struct x86Insn *insn)
+
+{
+  unsigned long address;
+
+  address = (unsigned long) insn->disp;
+
+  if (insn->base >= 0)
+    address += (unsigned long) x86readIntRegisterDebug(ws, insn->base);
+
+  if (insn->index >= 0)
+  {
+    address += (unsigned long) x86readIntRegisterDebug(ws, insn->index) *
+               insn->scale;
+  }
+
+  return (address);
+} /* x86effectiveAddress() */
+
+/*
+x86PureLoad()
+  Determine whether an instruction only reads its memory operand
+
+Inputs: insn - decoded instruction
+
+Return: 1 if so
+        0 if it may write to it
+*/
+
+static int
+x86PureLoad(struct x86Insn *insn)
+
+{
+  switch (insn->opcode)
+  {
+    case 0x02: case 0x03: case 0x0A: case 0x0B: /* add, or */
+    case 0x12: case 0x13: case 0x1A: case 0x1B: /* adc, sbb */
+    case 0x22: case 0x23: case 0x2A: case 0x2B: /* and, sub */
+    case 0x32: case 0x33:                       /* xor */
+    case 0x38: case 0x39: case 0x3A: case 0x3B: /* cmp */
+    case 0x69: case 0x6B:                       /* imul */
+    case 0x84: case 0x85:                       /* test */
+    case 0x8A: case 0x8B:                       /* mov */
+    case 0xA0: case 0xA1:                       /* mov */
+    case 0x0FA3:                                /* bt */
+    case 0x0FAF:                                /* imul */
+    case 0x0FB6: case 0x0FB7:                   /* movzx */
+    case 0x0FBE: case 0x0FBF:                   /* movsx */
+      return (1);
+
+    case 0x80: case 0x81: case 0x83:            /* cmp */
+      return (insn->reg == 7);
+
+    case 0xF6: case 0xF7:                       /* test, mul, div */
+      return ((insn->reg != 2) && (insn->reg != 3));
+
+    case 0xFF:                                  /* call, jmp, push */
+      return ((insn->reg >= 2) && (insn->reg <= 6));
+  }
+
+  return (0);
+} /* x86PureLoad() */
+
+/*
+x86VectorState()
+  Determine whether an instruction changes the fpu, mmx or sse
+state. Records only hold the general registers, so such instructions
+cannot be undone.
+
+Inputs: insn - decoded instruction
+
+Return: 1 if so
+        0 if not
+*/
+
+static int
+x86VectorState(struct x86Insn *insn)
+
+{
+  unsigned long op;
+
+  op = insn->opcode;
+
+  if ((op >= 0xD8) && (op <= 0xDF))
+    return (1);                       /* x87 */
+
+  /*
+   * Three byte opcodes, apart from movbe and crc32
+   */
+  if (((op & 0xFFFF00) == 0x0F3800) || ((op & 0xFFFF00) == 0x0F3A00))
+    return ((op & 0xFF) < 0xF0);
+
+  if ((op == 0x0F0E) || (op == 0x0F0F) ||        /* femms, 3dnow */
+      ((op >= 0x0F10) && (op <= 0x0F17)) ||
+      ((op >= 0x0F28) && (op <= 0x0F2F)) ||
+      ((op >= 0x0F50) && (op <= 0x0F7F)) ||
+      (op == 0x0FC2) ||
+      ((op >= 0x0FC4) && (op <= 0x0FC6)) ||
+      ((op >= 0x0FD0) && (op <= 0x0FFE)))
+    return (1);
+
+  /*
+   * fxrstor, ldmxcsr, xrstor
+   */
+  if ((op == 0x0FAE) && insn->mem &&
+      ((insn->reg == 1) || (insn->reg == 2) || (insn->reg == 5)))
+    return (1);
+
+  return (0);
+} /* x86VectorState() */
+
+/*
+x86memoryWrites()
+  Work out which memory an instruction is about to write to, so it
+can be saved beforehand. Ranges are generous rather than exact - an
+instruction's memory operand is assumed to be as large as any operand
+can be - so the same few rules cover the whole instruction set.
+
+Inputs: ws     - debug workspace (registers must be those the
+                 instruction will execute with)
+        buf    - instruction bytes
+        len    - number of bytes in buf
+        writes - array of X86_MAXWRITES ranges, modified to contain
+                 the ranges written
+
+Return: number of ranges
+        -1 if the instruction's effects cannot be determined (system
+           calls, fpu/mmx/sse instructions, 16 bit addressing, fs/gs
+           relative stores, ...)
+*/
+
+int
+x86memoryWrites(struct debugWorkspace *ws, unsigned char *buf, int len,
+                struct x86MemWrite *writes)
+
+{
+  struct x86Insn insn;
+  unsigned long op,
+                size,
+                count,
+                elem,
+                address;
+  int num;
+
+  if (!x86decodeInsn(buf, len, &insn))
+    return (-1);
+
+  op = insn.opcode;
+  num = 0;
+
+  /*
+   * Interrupts and system calls let the kernel change anything.
+   * In 32 bit code, les, lds and bound with a register operand are
+   * the VEX and EVEX prefixes, which we do not decode.
+   */
+  if ((op == 0xCC) || (op == 0xCD) || (op == 0xCE) || (op == 0xF1) ||
+      (op == 0x0F05) || (op == 0x0F34))
+    return (-1);
+
+  if (((op == 0xC4) || (op == 0xC5) || (op == 0x62)) && !insn.mem)
+    return (-1);
+
+  if (x86VectorState(&insn))
+    return (-1);
+
+  /*
+   * The memory operand - lea only computes its address
+   */
+  if (insn.mem && (op != 0x8D))
+  {
+    size = X86_SAVESIZE;
+
+    if ((op == 0x0FAE) && (insn.reg == 0))
+      size = 512;                     /* fxsave */
+    else if (op == 0x8F)
+      size += 4;                      /* pop - esp based addresses are
+                                         computed after the pop */
+    else if (((op == 0x0FAE) && ((insn.reg == 4) || (insn.reg == 6))) ||
+             ((op == 0x0FC7) && ((insn.reg == 4) || (insn.reg == 5))))
+      return (-1);                    /* xsave - size depends on cpu */
+    else if ((op == 0x0FAB) || (op == 0x0FB3) || (op == 0x0FBB))
+      return (-1);                    /* bts, btr, btc - the register
+                                         offset may be anywhere */
+
+    /*
+     * We do not know the fs and gs segment bases, which is fine as
+     * long as nothing is written there
+     */
+    if ((insn.segment == REG_FS) || (insn.segment == REG_GS))
+    {
+      if (!x86PureLoad(&insn))
+        return (-1);
+    }
+    else
+    {
+      writes[num].address = x86effectiveAddress(ws, &insn);
+      writes[num].size = size;
+      ++num;
+    }
+  }
+
+  /*
+   * Pushes and calls
+   */
+  size = 0;
+
+  if (((op >= 0x50) && (op <= 0x57)) ||
+      (op == 0x06) || (op == 0x0E) || (op == 0x16) || (op == 0x1E) ||
+      (op == 0x68) || (op == 0x6A) || (op == 0x9C) || (op == 0xE8) ||
+      (op == 0x0FA0) || (op == 0x0FA8) ||
+      ((op == 0xFF) && ((insn.reg == 2) || (insn.reg == 6))))
+    size = 4;
+  else if ((op == 0x9A) || ((op == 0xFF) && (insn.reg == 3)))
+    size = 8;                         /* far call */
+  else if (op == 0x60)
+    size = 32;                        /* pusha */
+  else if (op == 0xC8)
+  {
+    /*
+     * enter - the nesting level follows the 16 bit frame size
+     */
+    if (insn.length + 3 > len)
+      return (-1);
+
+    size = 4 * ((buf[insn.length + 2] & 0x1F) + 1);
+  }
+
+  if (size)
+  {
+    address = (unsigned long) x86readIntRegisterDebug(ws, REG_ESP);
+
+    writes[num].address = address - size;
+    writes[num].size = size;
+    ++num;
+  }
+
+  /*
+   * String instructions store at es:edi
+   */
+  if ((op == 0xA4) || (op == 0xA5) ||   /* movs */
+      (op == 0xAA) || (op == 0xAB) ||   /* stos */
+      (op == 0x6C) || (op == 0x6D))     /* ins */
+  {
+    if (!(op & 1))
+      elem = 1;
+    else if (insn.prefixes & X86_PX_OPSIZE)
+      elem = 2;
+    else
+      elem = 4;
+
+    count = 1;
+    if (insn.prefixes & (X86_PX_REP | X86_PX_REPNE))
+    {
+      count = (unsigned long) x86readIntRegisterDebug(ws, REG_ECX);
+      if (count > X86_MAXSTRING / elem)
+        return (-1);
+    }
+
+    if (count)
+    {
+      address = (unsigned long) x86readIntRegisterDebug(ws, REG_EDI);
+      if (x86readIntRegisterDebug(ws, REG_EFLAGS) & X86_EFLAGS_DF)
+        address -= (count - 1) * elem;
+
+      writes[num].address = address;
+      writes[num].size = count * elem;
+      ++num;
+    }
+  }
+
+  return (num);
+} /* x86memoryWrites() */
@@ -0,0 +1,1131 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "libDebug.h"
+#include "coverage.h"
+#include "decode-x86.h"
+#include "emulate-x86.h"
+#include "watch.h"
+
+/*
+ * Arithmetic operations, numbered as in the opcode map
+ */
+#define ALU_ADD    0
+#define ALU_OR     1
+#define ALU_ADC    2
+#define ALU_SBB    3
+#define ALU_AND    4
+#define ALU_SUB    5
+#define ALU_XOR    6
+#define ALU_CMP    7
+
+/*
+ * Flags set by arithmetic operations
+ */
+#define EMU_FLAGS  (X86_EFLAGS_CF | X86_EFLAGS_PF | X86_EFLAGS_AF | \
+                    X86_EFLAGS_ZF | X86_EFLAGS_SF | X86_EFLAGS_OF)
+
+#define emuReg(n)  ((unsigned long *) x86Registers[x86ModRMRegs[(n)]].valptr)
+#define emuMask(size)  (((size) == 4) ? 0xFFFFFFFFUL : \
+                        ((1UL << ((size) * 8)) - 1))
+
+/*
+ * An operand of the instruction being emulated
+ */
+struct emuOperand
+{
+  int mem;                /* 1 if in memory, 0 if a register */
+  unsigned long address;  /* memory address */
+  int reg;                /* ModR/M register number */
+  int size;               /* 1, 2 or 4 bytes */
+};
+
+/*
+ * State of one emulated step
+ */
+struct emuState
+{
+  struct debugWorkspace *ws;
+  int fd;                         /* /proc/<pid>/mem */
+  unsigned char buf[X86_MAXINSN]; /* instruction bytes */
+  int len;                        /* number of bytes in buf */
+  int pos;                        /* offset of next immediate operand */
+};
+
+static int emuExecute(struct emuState *st, unsigned long eip);
+static unsigned long emuGetReg(int reg, int size);
+static void emuSetReg(int reg, int size, unsigned long value);
+static int emuAccessible(struct emuState *st, unsigned long address,
+                         int size, unsigned int perm);
+static void emuAddRegion(void *args, unsigned long start, unsigned long end,
+                         char *perms);
+static struct x86MapRegion *emuFindRegion(struct x86MemoryMap *map,
+                                          unsigned long address);
+static int emuRead(struct emuState *st, unsigned long address, int size,
+                   unsigned long *value);
+static int emuWrite(struct emuState *st, unsigned long address, int size,
+                    unsigned long value);
+static int emuGetOperand(struct emuState *st, struct emuOperand *op,
+                         unsigned long *value);
+static int emuPutOperand(struct emuState *st, struct emuOperand *op,
+                         unsigned long value);
+static int emuImmediate(struct emuState *st, int size, unsigned long *value);
+static int emuPush(struct emuState *st, unsigned long value);
+static unsigned long emuAlu(int alu, unsigned long a, unsigned long b,
+                            int size, unsigned long *eflags);
+static int emuCondition(int cc, unsigned long eflags);
+
+/*
+x86emulateStep()
+  Carry out the next instruction ourselves instead of single stepping
+the process, if it is one of a common subset of integer instructions
+(mov, lea, arithmetic and logic, push and pop, jumps, calls and
+returns). Registers are changed in our copy only and written to the
+process when it is next resumed, so a run of emulated instructions
+costs a few reads and writes of its memory each, and no trips
+through the scheduler.
+
+Inputs: ws - debug workspace
+
+Return: 1 if the instruction was emulated
+        0 if it must be single stepped - nothing was changed
+*/
+
+int
+x86emulateStep(struct debugWorkspace *ws)
+
+{
+  struct emuState st;
+  unsigned long eflags;
+  int ret;
+
+  /*
+   * A pending signal must be delivered by the kernel, and a program
+   * which single steps itself expects its trap
+   */
+  if (ws->lastSignal || !x86getRegistersDebug(ws))
+    return (0);
+
+  eflags = *(unsigned long *) x86Registers[REG_EFLAGS].valptr;
+  if (eflags & X86_EFLAGS_TF)
+    return (0);
+
+  /*
+   * A coverage site is hit by executing it
+   */
+  if (coverageActive(ws) &&
+      findCoverageSite(&(ws->coverage), ws->instructionPointer))
+    return (0);
+
+  st.ws = ws;
+  st.fd = x86openProcMem(ws);
+  if (st.fd < 0)
+    return (0);
+
+  ret = emuExecute(&st, ws->instructionPointer);
+
+  close(st.fd);
+
+  return (ret);
+} /* x86emulateStep() */
+
+/*
+emuExecute()
+  Decode and emulate the instruction at eip
+
+Inputs: st  - step state
+        eip - address of instruction
+
+Return: 1 if emulated
+        0 if not - memory writes come before any register changes,
+          so nothing was changed
+*/
+
+static int
+emuExecute(struct emuState *st, unsigned long eip)
+
+{
+  struct x86Insn insn;
+  struct emuOperand dst,
+                    src;
+  unsigned long *esp,
+                *eflags;
+  unsigned long op,
+                flags,
+                target,
+                a,
+                b,
+                res;
+  ssize_t cnt;
+  int branch,
+      alu,
+      size;
+
+  cnt = pread(st->fd, st->buf, X86_MAXINSN, (off_t) eip);
+  if (cnt <= 0)
+    return (0);
+
+  st->len = (int) cnt;
+
+  if (coverageActive(st->ws))
+    hideCoverage(&(st->ws->coverage), st->buf, eip, (unsigned long) cnt);
+
+  if (!x86decodeInsn(st->buf, st->len, &insn))
+    return (0);
+
+  if (!emuAccessible(st, eip, insn.length, EMU_MAP_EXEC))
+    return (0);
+
+  /*
+   * Only plain 32 bit forms
+   */
+  if (insn.prefixes || (insn.segment >= 0))
+    return (0);
+
+  st->pos = insn.length;
+
+  op = insn.opcode;
+  esp = emuReg(4);
+  eflags = (unsigned long *) x86Registers[REG_EFLAGS].valptr;
+  flags = *eflags;
+
+  branch = 0;
+  target = 0;
+
+  /*
+   * The r/m operand and the reg operand of a ModR/M byte
+   */
+  size = (op & 1) ? 4 : 1;
+
+  dst.mem = insn.mem;
+  dst.address = insn.mem ? x86effectiveAddress(st->ws, &insn) : 0;
+  dst.reg = insn.rm;
+  dst.size = size;
+
+  src.mem = 0;
+  src.address = 0;
+  src.reg = insn.reg;
+  src.size = size;
+
+  if ((op < 0x40) && ((op & 7) < 6))
+  {
+    /*
+     * add, or, adc, sbb, and, sub, xor, cmp
+     */
+    alu = (int) (op >> 3);
+
+    switch (op & 7)
+    {
+      case 2:
+      case 3:
+      {
+        /*
+         * Register destination
+         */
+        dst.mem = 0;
+        dst.reg = insn.reg;
+        src.mem = insn.mem;
+        src.address = dst.address;
+        src.reg = insn.rm;
+
+        break;
+      }
+
+      case 4:
+      case 5:
+      {
+        /*
+         * Accumulator and immediate
+         */
+        dst.mem = 0;
+        dst.reg = 0;
+
+        if (!emuImmediate(st, size, &b))
+          return (0);
+
+        break;
+      }
+    }
+
+    if (!emuGetOperand(st, &dst, &a))
+      return (0);
+
+    if (((op & 7) < 4) && !emuGetOperand(st, &src, &b))
+      return (0);
+
+    res = emuAlu(alu, a, b, size, &flags);
+    if ((alu != ALU_CMP) && !emuPutOperand(st, &dst, res))
+      return (0);
+  }
+  else if ((op >= 0x40) && (op <= 0x4F))
+  {
+    /*
+     * inc, dec - carry is left alone
+     */
+    dst.mem = 0;
+    dst.reg = (int) (op & 7);
+    dst.size = 4;
+
+    emuGetOperand(st, &dst, &a);
+    res = emuAlu((op < 0x48) ? ALU_ADD : ALU_SUB, a, 1, 4, &flags);
+    flags = (flags & ~X86_EFLAGS_CF) | (*eflags & X86_EFLAGS_CF);
+
+    emuPutOperand(st, &dst, res);
+  }
+  else if ((op >= 0x50) && (op <= 0x57))
+  {
+    /*
+     * push reg
+     */
+    if (!emuPush(st, emuGetReg((int) (op & 7), 4)))
+      return (0);
+  }
+  else if ((op >= 0x58) && (op <= 0x5F))
+  {
+    /*
+     * pop reg
+     */
+    if (!emuRead(st, *esp, 4, &a))
+      return (0);
+
+    *esp += 4;
+    emuSetReg((int) (op & 7), 4, a);
+  }
+  else if ((op == 0x68) || (op == 0x6A))
+  {
+    /*
+     * push imm
+     */
+    if (!emuImmediate(st, (op == 0x68) ? 4 : -1, &a) || !emuPush(st, a))
+      return (0);
+  }
+  else if (((op >= 0x70) && (op <= 0x7F)) || (op == 0xEB))
+  {
+    /*
+     * jcc, jmp rel8
+     */
+    if (!emuImmediate(st, -1, &a))
+      return (0);
+
+    if ((op == 0xEB) || emuCondition((int) (op & 0x0F), flags))
+    {
+      branch = 1;
+      target = eip + st->pos + a;
+    }
+  }
+  else if ((op >= 0x0F80) && (op <= 0x0F8F))
+  {
+    /*
+     * jcc rel32
+     */
+    if (!emuImmediate(st, 4, &a))
+      return (0);
+
+    if (emuCondition((int) (op & 0x0F), flags))
+    {
+      branch = 1;
+      target = eip + st->pos + a;
+    }
+  }
+  else if ((op >= 0x80) && (op <= 0x83) && (op != 0x82))
+  {
+    /*
+     * Arithmetic with an immediate operand
+     */
+    if (op == 0x80)
+      size = 1;
+    else
+      size = 4;
+
+    dst.size = size;
+
+    if (!emuImmediate(st, (op == 0x81) ? 4 : ((op == 0x83) ? -1 : 1), &b) ||
+        !emuGetOperand(st, &dst, &a))
+      return (0);
+
+    res = emuAlu(insn.reg, a, b, size, &flags);
+    if ((insn.reg != ALU_CMP) && !emuPutOperand(st, &dst, res))
+      return (0);
+  }
+  else if ((op == 0x84) || (op == 0x85))
+  {
+    /*
+     * test r/m, reg
+     */
+    if (!emuGetOperand(st, &dst, &a) || !emuGetOperand(st, &src, &b))
+      return (0);
+
+    emuAlu(ALU_AND, a, b, size, &flags);
+  }
+  else if ((op >= 0x88) && (op <= 0x8B))
+  {
+    /*
+     * mov
+     */
+    if (op & 2)
+    {
+      if (!emuGetOperand(st, &dst, &a))
+        return (0);
+
+      emuPutOperand(st, &src, a);
+    }
+    else
+    {
+      emuGetOperand(st, &src, &a);
+      if (!emuPutOperand(st, &dst, a))
+        return (0);
+    }
+  }
+  else if (op == 0x8D)
+  {
+    /*
+     * lea
+     */
+    if (!insn.mem)
+      return (0);
+
+    emuSetReg(insn.reg, 4, dst.address);
+  }
+  else if (op == 0x90)
+  {
+    /*
+     * nop
+     */
+  }
+  else if ((op >= 0xA0) && (op <= 0xA3))
+  {
+    /*
+     * mov between the accumulator and an absolute address
+     */
+    src.reg = 0;
+
+    if (op & 2)
+    {
+      emuGetOperand(st, &src, &a);
+      if (!emuPutOperand(st, &dst, a))
+        return (0);
+    }
+    else
+    {
+      if (!emuGetOperand(st, &dst, &a))
+        return (0);
+
+      emuPutOperand(st, &src, a);
+    }
+  }
+  else if ((op == 0xA8) || (op == 0xA9))
+  {
+    /*
+     * test accumulator, imm
+     */
+    if (!emuImmediate(st, size, &b))
+      return (0);
+
+    emuAlu(ALU_AND, emuGetReg(0, size), b, size, &flags);
+  }
+  else if ((op >= 0xB0) && (op <= 0xBF))
+  {
+    /*
+     * mov reg, imm
+     */
+    size = (op < 0xB8) ? 1 : 4;
+
+    if (!emuImmediate(st, size, &a))
+      return (0);
+
+    emuSetReg((int) (op & 7), size, a);
+  }
+  else if ((op == 0xC2) || (op == 0xC3))
+  {
+    /*
+     * ret [imm16]
+     */
+    b = 0;
+    if ((op == 0xC2) && !emuImmediate(st, 2, &b))
+      return (0);
+
+    if (!emuRead(st, *esp, 4, &a))
+      return (0);
+
+    *esp += 4 + b;
+
+    branch = 1;
+    target = a;
+  }
+  else if (((op == 0xC6) || (op == 0xC7)) && (insn.reg == 0))
+  {
+    /*
+     * mov r/m, imm
+     */
+    if (!emuImmediate(st, size, &a) || !emuPutOperand(st, &dst, a))
+      return (0);
+  }
+  else if (op == 0xC9)
+  {
+    /*
+     * leave
+     */
+    if (!emuRead(st, *emuReg(5), 4, &a))
+      return (0);
+
+    *esp = *emuReg(5) + 4;
+    emuSetReg(5, 4, a);
+  }
+  else if ((op == 0xE8) || (op == 0xE9))
+  {
+    /*
+     * call, jmp rel32
+     */
+    if (!emuImmediate(st, 4, &a))
+      return (0);
+
+    if ((op == 0xE8) && !emuPush(st, eip + st->pos))
+      return (0);
+
+    branch = 1;
+    target = eip + st->pos + a;
+  }
+  else if (((op == 0xF6) || (op == 0xF7)) && (insn.reg == 0))
+  {
+    /*
+     * test r/m, imm
+     */
+    if (!emuImmediate(st, size, &b) || !emuGetOperand(st, &dst, &a))
+      return (0);
+
+    emuAlu(ALU_AND, a, b, size, &flags);
+  }
+  else if (((op == 0xFE) && (insn.reg <= 1)) ||
+           ((op == 0xFF) && (insn.reg <= 1)))
+  {
+    /*
+     * inc, dec r/m
+     */
+    if (!emuGetOperand(st, &dst, &a))
+      return (0);
+
+    res = emuAlu(insn.reg ? ALU_SUB : ALU_ADD, a, 1, size, &flags);
+    flags = (flags & ~X86_EFLAGS_CF) | (*eflags & X86_EFLAGS_CF);
+
+    if (!emuPutOperand(st, &dst, res))
+      return (0);
+  }
+  else if ((op == 0xFF) &&
+           ((insn.reg == 2) || (insn.reg == 4) || (insn.reg == 6)))
+  {
+    /*
+     * call, jmp, push r/m
+     */
+    if (!emuGetOperand(st, &dst, &a))
+      return (0);
+
+    if (insn.reg == 6)
+    {
+      if (!emuPush(st, a))
+        return (0);
+    }
+    else
+    {
+      if ((insn.reg == 2) && !emuPush(st, eip + st->pos))
+        return (0);
+
+      branch = 1;
+      target = a;
+    }
+  }
+  else if ((op == 0x0FB6) || (op == 0x0FB7) ||
+           (op == 0x0FBE) || (op == 0x0FBF))
+  {
+    /*
+     * movzx, movsx
+     */
+    dst.size = (op & 1) ? 2 : 1;
+
+    if (!emuGetOperand(st, &dst, &a))
+      return (0);
+
+    if ((op >= 0x0FBE) && (a & (1UL << (dst.size * 8 - 1))))
+      a |= ~emuMask(dst.size);
+
+    emuSetReg(insn.reg, 4, a);
+  }
+  else
+    return (0);
+
+  /*
+   * The instruction is done - update eflags and eip
+   */
+  *eflags = (*eflags & ~EMU_FLAGS) | (flags & EMU_FLAGS);
+
+  x86setCurrentInstruction(st->ws,
+                           (branch ? target : eip + st->pos) & 0xFFFFFFFFUL);
+
+  return (1);
+} /* emuExecute() */
+
+/*
+emuGetReg()
+  Read a general register
+
+Inputs: reg  - ModR/M register number
+        size - operand size - byte registers 4 to 7 are ah, ch, dh
+               and bh
+
+Return: register contents
+*/
+
+static unsigned long
+emuGetReg(int reg, int size)
+
+{
+  if ((size == 1) && (reg >= 4))
+    return ((*emuReg(reg - 4) >> 8) & 0xFF);
+
+  return (*emuReg(reg) & emuMask(size));
+} /* emuGetReg() */
+
+/*
+emuSetReg()
+  Write a general register, leaving the bits outside the operand
+size alone
+
+Inputs: reg   - ModR/M register number
+        size  - operand size
+        value - value to write
+*/
+
+static void
+emuSetReg(int reg, int size, unsigned long value)
+
+{
+  unsigned long *ptr;
+
+  if ((size == 1) && (reg >= 4))
+  {
+    ptr = emuReg(reg - 4);
+    *ptr = (*ptr & ~0xFF00UL) | ((value & 0xFF) << 8);
+    return;
+  }
+
+  ptr = emuReg(reg);
+  *ptr = (*ptr & ~emuMask(size)) | (value & emuMask(size));
+} /* emuSetReg() */
+
+/*
+emuRead()
+  Read a little endian value from the process' memory
+
+Inputs: st      - step state
+        address - address of value
+        size    - size of value
+        value   - modified to contain the value
+
+Return: 1 if successful
+        0 if the memory cannot be read
+*/
+
+static int
+emuRead(struct emuState *st, unsigned long address, int size,
+        unsigned long *value)
+
+{
+  unsigned char buf[4];
+  int ii;
+
+  if (!emuAccessible(st, address, size, EMU_MAP_READ))
+    return (0);
+
+  if (pread(st->fd, buf, size, (off_t) address) != size)
+    return (0);
+
+  if (coverageActive(st->ws))
+    hideCoverage(&(st->ws->coverage), buf, address, (unsigned long) size);
+
+  *value = 0;
+  for (ii = size - 1; ii >= 0; --ii)
+    *value = (*value << 8) | buf[ii];
+
+  return (1);
+} /* emuRead() */
+
+/*
+emuWrite()
+  Write a little endian value to the process' memory
+
+Inputs: st      - step state
+        address - address of value
+        size    - size of value
+        value   - value to write
+
+Return: 1 if successful
+        0 if the memory cannot be written, is not writable by the
+          program, or lies on a watched page (the write has to fault
+          for the watchpoint to see it)
+*/
+
+static int
+emuWrite(struct emuState *st, unsigned long address, int size,
+         unsigned long value)
+
+{
+  unsigned char buf[4];
+  int ii;
+
+  if (!emuAccessible(st, address, size, EMU_MAP_WRITE))
+    return (0);
+
+  if (watchActive(st->ws) &&
+      (findWatchPage(&(st->ws->watch), address) ||
+       findWatchPage(&(st->ws->watch), address + size - 1)))
+    return (0);
+
+  for (ii = 0; ii < size; ++ii)
+    buf[ii] = (unsigned char) ((value >> (ii * 8)) & 0xFF);
+
+  if (pwrite(st->fd, buf, size, (off_t) address) != size)
+    return (0);
+
+  return (1);
+} /* emuWrite() */
+
+/*
+emuAccessible()
+  Determine whether the program itself may access memory. Writes
+through /proc/<pid>/mem succeed even on read only or PROT_NONE pages,
+where the real instruction would fault.
+
+Inputs: st      - step state
+        address - address of access
+        size    - number of bytes accessed
+        perm    - EMU_MAP_xxx access needed
+
+Return: 1 if the access is allowed
+        0 if not, or if the memory map is not available
+*/
+
+static int
+emuAccessible(struct emuState *st, unsigned long address, int size,
+              unsigned int perm)
+
+{
+  struct debugWorkspace *ws;
+  struct x86MapRegion *region;
+  unsigned long last;
+
+  ws = st->ws;
+
+  /*
+   * The map can only change while the process runs
+   */
+  if (!(ws->regContents.cache & RC_MAPS_VALID))
+  {
+    ws->memoryMap.count = 0;
+    if (!x86traverseMapsDebug(ws, emuAddRegion, (void *) &(ws->memoryMap)))
+      return (0);
+
+    ws->regContents.cache |= RC_MAPS_VALID;
+  }
+
+  last = address + (unsigned long) size - 1;
+  if (last < address)
+    return (0);
+
+  region = emuFindRegion(&(ws->memoryMap), address);
+  if (!region || !(region->perms & perm))
+    return (0);
+
+  if (last >= region->end)
+  {
+    region = emuFindRegion(&(ws->memoryMap), last);
+    if (!region || !(region->perms & perm))
+      return (0);
+  }
+
+  return (1);
+} /* emuAccessible() */
+
+/*
+emuAddRegion()
+  Add a region of the process' address space to the memory map -
+called by x86traverseMapsDebug() in address order
+
+Inputs: args  - memory map
+        start - first address
+        end   - address following the region
+        perms - permission string, like "r-xp"
+*/
+
+static void
+emuAddRegion(void *args, unsigned long start, unsigned long end,
+             char *perms)
+
+{
+  struct x86MemoryMap *map;
+  struct x86MapRegion *ptr;
+  struct x86MapRegion *region;
+
+  map = (struct x86MemoryMap *) args;
+
+  if (map->count == map->size)
+  {
+    ptr = (struct x86MapRegion *) realloc(map->regions,
+                                          sizeof(struct x86MapRegion) *
+                                          (map->size + 64));
+    if (!ptr)
+      return; /* the region is treated as unmapped */
+
+    map->regions = ptr;
+    map->size += 64;
+  }
+
+  region = map->regions + map->count++;
+
+  region->start = start;
+  region->end = end;
+  region->perms = 0;
+
+  if (perms[0] == 'r')
+    region->perms |= EMU_MAP_READ;
+  if (perms[1] == 'w')
+    region->perms |= EMU_MAP_WRITE;
+  if (perms[2] == 'x')
+    region->perms |= EMU_MAP_EXEC;
+} /* emuAddRegion() */
+
+/*
+emuFindRegion()
+  Find the region of the memory map containing an address
+
+Inputs: map     - memory map
+        address - address to find
+
+Return: pointer to region, or 0 if the address is not mapped
+*/
+
+static struct x86MapRegion *
+emuFindRegion(struct x86MemoryMap *map, unsigned long address)
+
+{
+  int low,
+      high,
+      mid;
+
+  low = 0;
+  high = map->count - 1;
+
+  while (low <= high)
+  {
+    mid = (low + high) / 2;
+
+    if (address < map->regions[mid].start)
+      high = mid - 1;
+    else if (address >= map->regions[mid].end)
+      low = mid + 1;
+    else
+      return (map->regions + mid);
+  }
+
+  return (0);
+} /* emuFindRegion() */
+
+/*
+x86clearMemoryMap()
+  Free the emulator's copy of the memory map
+
+Inputs: ws - debug workspace
+*/
+
+void
+x86clearMemoryMap(struct debugWorkspace *ws)
+
+{
+  if (ws->memoryMap.regions)
+    free(ws->memoryMap.regions);
+
+  ws->memoryMap.regions = 0;
+  ws->memoryMap.count = 0;
+  ws->memoryMap.size = 0;
+
+  ws->regContents.cache &= ~RC_MAPS_VALID;
+} /* x86clearMemoryMap() */
+
+/*
+emuGetOperand()
+  Read an operand
+
+Inputs: st    - step state
+        op    - operand
+        value - modified to contain its value
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+emuGetOperand(struct emuState *st, struct emuOperand *op,
+              unsigned long *value)
+
+{
+  if (op->mem)
+    return (emuRead(st, op->address, op->size, value));
+
+  *value = emuGetReg(op->reg, op->size);
+
+  return (1);
+} /* emuGetOperand() */
+
+/*
+emuPutOperand()
+  Write an operand
+
+Inputs: st    - step state
+        op    - operand
+        value - value to write
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+emuPutOperand(struct emuState *st, struct emuOperand *op,
+              unsigned long value)
+
+{
+  if (op->mem)
+    return (emuWrite(st, op->address, op->size, value));
+
+  emuSetReg(op->reg, op->size, value);
+
+  return (1);
+} /* emuPutOperand() */
+
+/*
+emuImmediate()
+  Fetch the next immediate operand of the instruction
+
+Inputs: st    - step state
+        size  - size of immediate, -1 for a byte which is sign
+                extended
+        value - modified to contain the immediate
+
+Return: 1 if successful
+        0 if the instruction is truncated
+*/
+
+static int
+emuImmediate(struct emuState *st, int size, unsigned long *value)
+
+{
+  int bytes,
+      ii;
+
+  bytes = (size < 0) ? 1 : size;
+  if (st->pos + bytes > st->len)
+    return (0);
+
+  *value = 0;
+  for (ii = bytes - 1; ii >= 0; --ii)
+    *value = (*value << 8) | st->buf[st->pos + ii];
+
+  st->pos += bytes;
+
+  if ((size < 0) && (*value & 0x80))
+    *value |= ~0xFFUL;
+
+  return (1);
+} /* emuImmediate() */
+
+/*
+emuPush()
+  Push a value onto the process' stack
+
+Inputs: st    - step state
+        value - value to push
+
+Return: 1 if successful
+        0 if the stack cannot be written
+*/
+
+static int
+emuPush(struct emuState *st, unsigned long value)
+
+{
+  unsigned long *esp;
+
+  esp = emuReg(4);
+
+  if (!emuWrite(st, (*esp - 4) & 0xFFFFFFFFUL, 4, value))
+    return (0);
+
+  *esp = (*esp - 4) & 0xFFFFFFFFUL;
+
+  return (1);
+} /* emuPush() */
+
+/*
+emuAlu()
+  Perform an arithmetic or logic operation and work out the flags
+it sets
+
+Inputs: alu    - operation (ALU_xxx)
+        a      - first (destination) operand
+        b      - second operand
+        size   - operand size
+        eflags - flags - the carry flag is used by adc and sbb, and
+                 the arithmetic flags are modified to reflect the
+                 result
+
+Return: result
+*/
+
+static unsigned long
+emuAlu(int alu, unsigned long a, unsigned long b, int size,
+       unsigned long *eflags)
+
+{
+  unsigned long mask,
+                sign,
+                res,
+                carry,
+                cf,
+                of,
+                flags;
+  int parity,
+      ii;
+
+  mask = emuMask(size);
+  sign = 1UL << (size * 8 - 1);
+
+  a &= mask;
+  b &= mask;
+  carry = (*eflags & X86_EFLAGS_CF) ? 1 : 0;
+
+  cf = 0;
+  of = 0;
+
+  switch (alu)
+  {
+    case ALU_ADD:
+    case ALU_ADC:
+    {
+      if (alu == ALU_ADD)
+        carry = 0;
+
+      res = (a + b + carry) & mask;
+      cf = (a & b) | ((a | b) & ~res);
+      of = (a ^ res) & (b ^ res);
+
+      break;
+    }
+
+    case ALU_SUB:
+    case ALU_SBB:
+    case ALU_CMP:
+    {
+      if (alu != ALU_SBB)
+        carry = 0;
+
+      res = (a - b - carry) & mask;
+      cf = (~a & b) | ((~a | b) & res);
+      of = (a ^ b) & (a ^ res);
+
+      break;
+    }
+
+    case ALU_OR:
+      res = a | b;
+      break;
+
+    case ALU_AND:
+      res = a & b;
+      break;
+
+    default:
+      res = a ^ b;
+      break;
+  }
+
+  flags = 0;
+
+  if (cf & sign)
+    flags |= X86_EFLAGS_CF;
+
+  if (of & sign)
+    flags |= X86_EFLAGS_OF;
+
+  if ((alu != ALU_OR) && (alu != ALU_AND) && (alu != ALU_XOR) &&
+      ((a ^ b ^ res) & 0x10))
+    flags |= X86_EFLAGS_AF;
+
+  if (res == 0)
+    flags |= X86_EFLAGS_ZF;
+
+  if (res & sign)
+    flags |= X86_EFLAGS_SF;
+
+  parity = 1;
+  for (ii = 0; ii < 8; ++ii)
+    parity ^= (res >> ii) & 1;
+
+  if (parity)
+    flags |= X86_EFLAGS_PF;
+
+  *eflags = (*eflags & ~EMU_FLAGS) | flags;
+
+  return (res);
+} /* emuAlu() */
+
+/*
+emuCondition()
+  Evaluate the condition of a conditional jump
+
+Inputs: cc     - condition code (low 4 bits of the opcode)
+        eflags - flags
+
+Return: 1 if the condition holds
+        0 if not
+*/
+
+static int
+emuCondition(int cc, unsigned long eflags)
+
+{
+  int cf,
+      zf,
+      sf,
+      of,
+      ret;
+
+  cf = (eflags & X86_EFLAGS_CF) != 0;
+  zf = (eflags & X86_EFLAGS_ZF) != 0;
+  sf = (eflags & X86_EFLAGS_SF) != 0;
+  of = (eflags & X86_EFLAGS_OF) != 0;
+
+  switch (cc >> 1)
+  {
+    case 0:  ret = of; break;                   /* jo */
+    case 1:  ret = cf; break;                   /* jb */
+    case 2:  ret = zf; break;                   /* je */
+    case 3:  ret = cf || zf; break;             /* jbe */
+    case 4:  ret = sf; break;                   /* js */
+    case 5:  ret = (eflags & X86_EFLAGS_PF) != 0; break; /* jp */
+    case 6:  ret = (sf != of); break;           /* jl */
+    default: ret = zf || (sf != of); break;     /* jle */
+  }
+
+  return (ret ^ (cc & 1));
+} /* emuCondition() */
@@ -0,0 +1,616 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>        /* SYS_mmap2, SYS_open, SYS_close */
+
+#include "libDebug.h"
+#include "fasttrace-x86.h"
+#include "tracepoint.h"
+
+/*
+ * The ring starts with a header holding the number of hits so far
+ * (incremented by the program), followed by the frames
+ */
+#define FAST_HEADER    16
+
+/*
+ * A frame starts with the registers as saved by pushfd/pushad,
+ * followed by the memory ranges collected
+ */
+#define FAST_REGSIZE   36
+
+/*
+ * Longest code we generate for a tracepoint: the fixed part, the
+ * memory ranges, the displaced instructions and the jump back
+ */
+#define FAST_MAXCODE   (64 + TRACE_MAXMEM * 20 + TRACE_MAXDISPLACE)
+
+/*
+ * Where the temporary file holding the ring is created
+ */
+#define FAST_TEMPLATE  "/tmp/aldtraceXXXXXX"
+
+/*
+ * Offset of each general register in the frame saved by pushfd and
+ * pushad, -1 if it is not saved
+ */
+static int FastRegOffsets[] = {
+  28,   /* REG_EAX */
+  16,   /* REG_EBX */
+  24,   /* REG_ECX */
+  20,   /* REG_EDX */
+  12,   /* REG_ESP */
+  8,    /* REG_EBP */
+  4,    /* REG_ESI */
+  0,    /* REG_EDI */
+  -1,   /* REG_DS */
+  -1,   /* REG_ES */
+  -1,   /* REG_FS */
+  -1,   /* REG_GS */
+  -1,   /* REG_SS */
+  -1,   /* REG_CS */
+  -1,   /* REG_EIP - the tracepoint address */
+  32    /* REG_EFLAGS */
+};
+
+static unsigned long fastRegister(struct fastTracepoint *ptr,
+                                  unsigned char *slot, int regindex);
+
+/*
+ * Code is only generated and mapped where the process can be made
+ * to mmap2() it (see x86insertFastTracepoint())
+ */
+#if defined(OS_LINUX) && defined(SYS_mmap2)
+static void fastPut32(unsigned char *buf, int *len, unsigned long value);
+static int fastGenerate(struct fastTracepoint *ptr, unsigned char *buf);
+static int fastSyscall(struct debugWorkspace *ws, long number,
+                       long arg1, long arg2, long arg3, long arg4,
+                       long arg5, long *result);
+#endif
+
+#if defined(OS_LINUX) && defined(SYS_mmap2)
+
+/*
+fastPut32()
+  Append a 32 bit little endian value to generated code
+
+Inputs: buf   - code buffer
+        len   - current length, advanced
+        value - value
+*/
+
+static void
+fastPut32(unsigned char *buf, int *len, unsigned long value)
+
+{
+  buf[(*len)++] = (unsigned char) (value & 0xff);
+  buf[(*len)++] = (unsigned char) ((value >> 8) & 0xff);
+  buf[(*len)++] = (unsigned char) ((value >> 16) & 0xff);
+  buf[(*len)++] = (unsigned char) ((value >> 24) & 0xff);
+} /* fastPut32() */
+
+/*
+fastGenerate()
+  Generate the code a fast tracepoint jumps to. It saves the
+registers, bumps the hit count in the ring, copies the registers and
+memory ranges into the frame the count selects, restores the
+registers, runs the displaced instructions and jumps back:
+
+    pushfd
+    pushad
+    cld
+    mov  eax, 1
+    lock xadd [ring], eax       ; eax = hit number
+    xor  edx, edx
+    mov  ecx, nslots
+    div  ecx                    ; edx = frame number
+    imul edi, edx, slotsize
+    add  edi, ring + header
+    mov  esi, esp
+    mov  ecx, 36
+    rep  movsb                  ; registers
+    mov  esi, [esp + reg]       ; for each range: base register,
+    add  esi, offset            ;   or mov esi, address
+    mov  ecx, size
+    rep  movsb
+    popad
+    popfd
+    <displaced instructions>
+    jmp  address + length
+
+Inputs: ptr - fast tracepoint, with its code and ring addresses set
+        buf - where to store the code (FAST_MAXCODE bytes)
+
+Return: length of code
+*/
+
+static int
+fastGenerate(struct fastTracepoint *ptr, unsigned char *buf)
+
+{
+  struct traceRange *range;
+  unsigned long offset;
+  int len,
+      ii;
+
+  len = 0;
+
+  buf[len++] = 0x9C;                      /* pushfd */
+  buf[len++] = 0x60;                      /* pushad */
+  buf[len++] = 0xFC;                      /* cld */
+
+  buf[len++] = 0xB8;                      /* mov eax, 1 */
+  fastPut32(buf, &len, 1);
+
+  buf[len++] = 0xF0;                      /* lock xadd [ring], eax */
+  buf[len++] = 0x0F;
+  buf[len++] = 0xC1;
+  buf[len++] = 0x05;
+  fastPut32(buf, &len, ptr->ringAddress);
+
+  buf[len++] = 0x31;                      /* xor edx, edx */
+  buf[len++] = 0xD2;
+
+  buf[len++] = 0xB9;                      /* mov ecx, nslots */
+  fastPut32(buf, &len, ptr->nslots);
+
+  buf[len++] = 0xF7;                      /* div ecx */
+  buf[len++] = 0xF1;
+
+  buf[len++] = 0x69;                      /* imul edi, edx, slotsize */
+  buf[len++] = 0xFA;
+  fastPut32(buf, &len, ptr->slotSize);
+
+  buf[len++] = 0x81;                      /* add edi, ring + header */
+  buf[len++] = 0xC7;
+  fastPut32(buf, &len, ptr->ringAddress + FAST_HEADER);
+
+  buf[len++] = 0x89;                      /* mov esi, esp */
+  buf[len++] = 0xE6;
+
+  buf[len++] = 0xB9;                      /* mov ecx, FAST_REGSIZE */
+  fastPut32(buf, &len, FAST_REGSIZE);
+
+  buf[len++] = 0xF3;                      /* rep movsb */
+  buf[len++] = 0xA4;
+
+  for (ii = 0; ii < ptr->collect.nmem; ++ii)
+  {
+    range = &(ptr->collect.mem[ii]);
+    offset = (unsigned long) range->offset;
+
+    if (range->base >= 0)
+    {
+      /*
+       * The saved esp is 4 below the program's, due to pushfd
+       */
+      if (range->base == REG_ESP)
+        offset += 4;
+
+      buf[len++] = 0x8B;                  /* mov esi, [esp + reg] */
+      buf[len++] = 0x74;
+      buf[len++] = 0x24;
+      buf[len++] = (unsigned char) FastRegOffsets[range->base];
+
+      buf[len++] = 0x81;                  /* add esi, offset */
+      buf[len++] = 0xC6;
+      fastPut32(buf, &len, offset);
+    }
+    else
+    {
+      buf[len++] = 0xBE;                  /* mov esi, address */
+      fastPut32(buf, &len, offset);
+    }
+
+    buf[len++] = 0xB9;                    /* mov ecx, size */
+    fastPut32(buf, &len, range->size);
+
+    buf[len++] = 0xF3;                    /* rep movsb */
+    buf[len++] = 0xA4;
+  }
+
+  buf[len++] = 0x61;                      /* popad */
+  buf[len++] = 0x9D;                      /* popfd */
+
+  memcpy(buf + len, ptr->saved, ptr->length);
+  len += (int) ptr->length;
+
+  buf[len++] = 0xE9;                      /* jmp address + length */
+  fastPut32(buf,
+            &len,
+            (ptr->address + ptr->length) - (ptr->code + len + 4));
+
+  return (len);
+} /* fastGenerate() */
+
+/*
+fastSyscall()
+  Make the debugged process execute a system call
+
+Inputs: ws     - debug workspace
+        number - system call number
+        argN   - arguments
+        result - where to store the return value
+
+Return: 1 if the call was made and succeeded
+        0 if not (errno is set)
+*/
+
+static int
+fastSyscall(struct debugWorkspace *ws, long number, long arg1, long arg2,
+            long arg3, long arg4, long arg5, long *result)
+
+{
+  long args[X86_SYSCALL_MAXARGS];
+
+  memset(args, '\0', sizeof(args));
+  args[0] = arg1;
+  args[1] = arg2;
+  args[2] = arg3;
+  args[3] = arg4;
+  args[4] = arg5;
+
+  if (!x86syscallDebug(ws, number, args, result))
+    return (0);
+
+  /*
+   * The kernel returns -errno on failure
+   */
+  if ((*result < 0) && (*result >= -4095))
+  {
+    errno = (int) -*result;
+    return (0);
+  }
+
+  return (1);
+} /* fastSyscall() */
+
+#endif /* OS_LINUX && SYS_mmap2 */
+
+/*
+x86insertFastTracepoint()
+  Put a fast tracepoint into the debugged process: map a page for
+our code and the ring (from a temporary file, which we map too) into
+it, write the code, and replace the instructions at the address with
+a jump to it
+
+Inputs: ws  - debug workspace
+        ptr - fast tracepoint, with its address, length and collect
+              list set
+
+Return: 1 if successful
+        0 if not (errno is set)
+*/
+
+int
+x86insertFastTracepoint(struct debugWorkspace *ws,
+                        struct fastTracepoint *ptr)
+
+{
+#if defined(OS_LINUX) && defined(SYS_mmap2)
+
+  unsigned char code[FAST_MAXCODE];
+  unsigned char jump[TRACE_MAXDISPLACE];
+  char path[sizeof(FAST_TEMPLATE)];
+  unsigned long pagesize,
+                slotSize;
+  long result,
+       tfd;
+  int len,
+      fd,
+      err,
+      ii;
+
+  /*
+   * Only the registers saved by pushad and pushfd can be collected
+   */
+  for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+  {
+    if ((ptr->collect.regmask & (1UL << ii)) &&
+        (FastRegOffsets[ii] < 0) && (ii != REG_EIP))
+    {
+      errno = EINVAL;
+      return (0);
+    }
+  }
+
+  slotSize = FAST_REGSIZE;
+  for (ii = 0; ii < ptr->collect.nmem; ++ii)
+  {
+    if ((ptr->collect.mem[ii].base >= 0) &&
+        (FastRegOffsets[ptr->collect.mem[ii].base] < 0))
+    {
+      errno = EINVAL;
+      return (0);
+    }
+
+    slotSize += ptr->collect.mem[ii].size;
+  }
+
+  pagesize = (unsigned long) sysconf(_SC_PAGESIZE);
+
+  ptr->slotSize = (slotSize + 3) & ~3UL;
+  ptr->nslots = (TRACE_FASTRING - FAST_HEADER) / ptr->slotSize;
+  ptr->ringSize = TRACE_FASTRING;
+
+  if (x86readMemoryDebug(ws, ptr->address, ptr->saved, ptr->length) !=
+      (long) ptr->length)
+    return (0);
+
+  /*
+   * The system calls are made with the registers as the process
+   * has them
+   */
+  if (!x86flushRegistersDebug(ws))
+    return (0);
+
+  strcpy(path, FAST_TEMPLATE);
+  fd = mkstemp(path);
+  if (fd < 0)
+    return (0);
+
+  ptr->ring = 0;
+  ptr->code = 0;
+
+  if (ftruncate(fd, (off_t) ptr->ringSize) != 0)
+    goto fail;
+
+  ptr->ring = (unsigned char *) mmap(0,
+                                     ptr->ringSize,
+                                     PROT_READ | PROT_WRITE,
+                                     MAP_SHARED,
+                                     fd,
+                                     0);
+  if (ptr->ring == (unsigned char *) MAP_FAILED)
+  {
+    ptr->ring = 0;
+    goto fail;
+  }
+
+  /*
+   * A page for the code - it holds the file name until the file
+   * is opened
+   */
+  if (!fastSyscall(ws,
+                   SYS_mmap2,
+                   0,
+                   (long) pagesize,
+                   PROT_READ | PROT_WRITE | PROT_EXEC,
+                   MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1,
+                   &result))
+    goto fail;
+
+  ptr->code = (unsigned long) result;
+
+  if (x86writeMemoryDebug(ws,
+                          ptr->code,
+                          (unsigned char *) path,
+                          strlen(path) + 1) != (long) (strlen(path) + 1))
+    goto fail;
+
+  if (!fastSyscall(ws, SYS_open, (long) ptr->code, O_RDWR, 0, 0, 0, &tfd))
+    goto fail;
+
+  if (!fastSyscall(ws,
+                   SYS_mmap2,
+                   0,
+                   (long) ptr->ringSize,
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED,
+                   tfd,
+                   &result))
+  {
+    err = errno;
+    fastSyscall(ws, SYS_close, tfd, 0, 0, 0, 0, &result);
+    errno = err;
+    goto fail;
+  }
+
+  ptr->ringAddress = (unsigned long) result;
+
+  fastSyscall(ws, SYS_close, tfd, 0, 0, 0, 0, &result);
+
+  unlink(path);
+  close(fd);
+
+  len = fastGenerate(ptr, code);
+  if (x86writeMemoryDebug(ws, ptr->code, code, (unsigned long) len) != len)
+  {
+    x86removeFastTracepoint(ws, ptr, 0);
+    return (0);
+  }
+
+  /*
+   * jmp to our code, padded with nops to the end of the last
+   * displaced instruction
+   */
+  jump[0] = 0xE9;
+  len = 1;
+  fastPut32(jump, &len, ptr->code - (ptr->address + 5));
+  while ((unsigned long) len < ptr->length)
+    jump[len++] = 0x90;
+
+  if (x86writeMemoryDebug(ws, ptr->address, jump, ptr->length) !=
+      (long) ptr->length)
+  {
+    x86removeFastTracepoint(ws, ptr, 1);
+    return (0);
+  }
+
+  return (1);
+
+fail:
+
+  err = errno;
+
+  if (ptr->ring)
+    munmap(ptr->ring, ptr->ringSize);
+
+  ptr->ring = 0;
+
+  unlink(path);
+  close(fd);
+
+  errno = err;
+  return (0);
+
+#else
+
+  errno = ENOSYS;
+  return (0);
+
+#endif /* OS_LINUX && SYS_mmap2 */
+} /* x86insertFastTracepoint() */
+
+/*
+x86removeFastTracepoint()
+  Take a fast tracepoint out of the debugged process. Our code and
+the ring stay mapped in the process - it may be stopped inside the
+code, and will finish it and jump back.
+
+Inputs: ws      - debug workspace
+        ptr     - fast tracepoint
+        restore - if set, put the original instructions back
+*/
+
+void
+x86removeFastTracepoint(struct debugWorkspace *ws,
+                        struct fastTracepoint *ptr, int restore)
+
+{
+  if (restore)
+    x86writeMemoryDebug(ws, ptr->address, ptr->saved, ptr->length);
+
+  if (ptr->ring)
+    munmap(ptr->ring, ptr->ringSize);
+
+  ptr->ring = 0;
+} /* x86removeFastTracepoint() */
+
+/*
+fastRegister()
+  Return the value of a register saved in a frame of the ring
+
+Inputs: ptr      - fast tracepoint
+        slot     - frame
+        regindex - register (REG_xxx)
+
+Return: register value
+*/
+
+static unsigned long
+fastRegister(struct fastTracepoint *ptr, unsigned char *slot, int regindex)
+
+{
+  unsigned char *val;
+  unsigned long value;
+
+  if (regindex == REG_EIP)
+    return (ptr->address);
+
+  val = slot + FastRegOffsets[regindex];
+  value = (unsigned long) val[0] |
+          ((unsigned long) val[1] << 8) |
+          ((unsigned long) val[2] << 16) |
+          ((unsigned long) val[3] << 24);
+
+  /*
+   * pushfd had already moved esp when pushad saved it
+   */
+  if (regindex == REG_ESP)
+    value += 4;
+
+  return (value);
+} /* fastRegister() */
+
+/*
+x86harvestFastTracepoint()
+  Copy the frames written to a fast tracepoint's ring since the last
+call into the trace buffer. Frames overwritten in the ring before we
+got to them are counted as discarded.
+
+Inputs: ws  - debug workspace
+        ptr - fast tracepoint
+*/
+
+void
+x86harvestFastTracepoint(struct debugWorkspace *ws,
+                         struct fastTracepoint *ptr)
+
+{
+  struct traceFrame frame;
+  struct traceRange *range;
+  unsigned char *slot;
+  unsigned long count,
+                offset;
+  int ii;
+
+  if (!ptr->ring)
+    return;
+
+  count = (unsigned long) ptr->ring[0] |
+          ((unsigned long) ptr->ring[1] << 8) |
+          ((unsigned long) ptr->ring[2] << 16) |
+          ((unsigned long) ptr->ring[3] << 24);
+
+  if (count - ptr->harvested > ptr->nslots)
+  {
+    ws->trace.dropped += count - ptr->harvested - ptr->nslots;
+    ptr->harvested = count - ptr->nslots;
+  }
+
+  while (ptr->harvested != count)
+  {
+    slot = ptr->ring + FAST_HEADER +
+           (ptr->harvested % ptr->nslots) * ptr->slotSize;
+
+    frame.number = ptr->number;
+    frame.address = ptr->address;
+    frame.regmask = ptr->collect.regmask;
+
+    for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+    {
+      if (frame.regmask & (1UL << ii))
+        frame.regs[ii] = fastRegister(ptr, slot, ii);
+    }
+
+    frame.nmem = ptr->collect.nmem;
+
+    offset = FAST_REGSIZE;
+    for (ii = 0; ii < frame.nmem; ++ii)
+    {
+      range = &(ptr->collect.mem[ii]);
+
+      frame.memaddr[ii] = (unsigned long) range->offset;
+      if (range->base >= 0)
+        frame.memaddr[ii] += fastRegister(ptr, slot, range->base);
+
+      frame.memsize[ii] = range->size;
+      frame.membytes[ii] = slot + offset;
+
+      offset += range->size;
+    }
+
+    addTraceFrame(ws, &frame);
+
+    ++(ptr->harvested);
+  }
+} /* x86harvestFastTracepoint() */
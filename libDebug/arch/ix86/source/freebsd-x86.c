@@ -160,7 +160,7 @@ x86getCurrentInstruction(struct debugWorkspace *ws, int *err)
    * register contents with old ones when it calls
    * x86SetCurrentInstruction()
    */
-  if (ptrace(PT_GETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
+  if (!x86getRegistersDebug(ws))
     *err = 1;
 
   return ((unsigned long) ws->regContents.Regs.r_eip);
@@ -168,7 +168,8 @@ x86getCurrentInstruction(struct debugWorkspace *ws, int *err)
 
 /*
 x86setCurrentInstruction()
-  Set eip to the given address
+  Set eip to the given address. The change is written to the
+process by x86flushRegistersDebug() before it is resumed.
 
 Return: 1 if successful
         0 if not
@@ -180,11 +181,12 @@ x86setCurrentInstruction(struct debugWorkspace *ws, unsigned long address)
 {
   assert(ws->pid != NOPID);
 
-  ws->regContents.Regs.r_eip = address;
-
-  if (ptrace(PT_SETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
+  if (!x86getRegistersDebug(ws))
     return (0);
 
+  ws->regContents.Regs.r_eip = address;
+  ws->regContents.cache |= RC_GENERAL_DIRTY;
+
   /*
    * Keep our instruction pointer updated
    */
@@ -195,7 +197,8 @@ x86setCurrentInstruction(struct debugWorkspace *ws, unsigned long address)
 
 /*
 x86getRegistersDebug()
-  Update our local copy of the debugged process' registers
+  Update our local copy of the debugged process' general registers,
+unless it is already current
 
 Inputs: ws - debug workspace
 
@@ -207,11 +210,13 @@ int
 x86getRegistersDebug(struct debugWorkspace *ws)
 
 {
-  if (ptrace(PT_GETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
-    return (0); /* something went wrong */
+  if (!(ws->regContents.cache & RC_GENERAL_VALID))
+  {
+    if (ptrace(PT_GETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
+      return (0); /* something went wrong */
 
-  if (ptrace(PT_GETFPREGS, ws->pid, (caddr_t) &(ws->regContents.fpRegs), 0) != 0)
-    return (0); /* something went wrong */
+    ws->regContents.cache |= RC_GENERAL_VALID;
+  }
 
   /*
    * Save the location of our next instruction
@@ -221,6 +226,87 @@ x86getRegistersDebug(struct debugWorkspace *ws)
   return (1);
 } /* x86getRegistersDebug() */
 
+/*
+x86getFPRegistersDebug()
+  Update our local copy of the debugged process' fpu and mmx
+registers, unless it is already current. These are only needed
+when displaying or modifying them, so they are not fetched at
+every stop.
+
+Inputs: ws - debug workspace
+
+Return: 1 if successful
+        0 upon ptrace error
+*/
+
+int
+x86getFPRegistersDebug(struct debugWorkspace *ws)
+
+{
+  if (ws->regContents.cache & RC_FPU_VALID)
+    return (1);
+
+  if (ptrace(PT_GETFPREGS, ws->pid, (caddr_t) &(ws->regContents.fpRegs), 0) != 0)
+    return (0); /* something went wrong */
+
+  ws->regContents.cache |= RC_FPU_VALID;
+
+  return (1);
+} /* x86getFPRegistersDebug() */
+
+/*
+x86flushRegistersDebug()
+  Write any modified registers back to the process and invalidate
+our copy. This must be called before the process is resumed.
+
+Inputs: ws - debug workspace
+
+Return: 1 if successful
+        0 upon ptrace error
+*/
+
+int
+x86flushRegistersDebug(struct debugWorkspace *ws)
+
+{
+  int ret;
+
+  ret = 1;
+
+  if (ws->regContents.cache & RC_GENERAL_DIRTY)
+  {
+    if (ptrace(PT_SETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
+      ret = 0;
+  }
+
+  if (ws->regContents.cache & RC_FPU_DIRTY)
+  {
+    if (ptrace(PT_SETFPREGS, ws->pid, (caddr_t) &(ws->regContents.fpRegs), 0) != 0)
+      ret = 0;
+  }
+
+  x86invalidateRegistersDebug(ws);
+
+  return (ret);
+} /* x86flushRegistersDebug() */
+
+/*
+x86loadCoreRegistersDebug()
+  Fill our register cache from the register notes of a core file.
+The layout of these notes is not known on this platform.
+
+Return: 0
+*/
+
+int
+x86loadCoreRegistersDebug(struct debugWorkspace *ws, void *prstatus,
+                          size_t size, void *fpregs, size_t fpsize,
+                          int *sig)
+
+{
+  return (0);
+} /* x86loadCoreRegistersDebug() */
+
 #if 0
 
 /*
@@ -355,15 +441,17 @@ x86readFPUDebug(struct debugWorkspace *ws, struct x86fpuInfo *fpuState)
 
 /*
 x86writeRegisterDebug()
-  Update our local copy of the register with the given value and call ptrace
-to write the changes to the process' registers
+  Update our local copy of the register with the given value and mark
+it dirty so x86flushRegistersDebug() writes the change to the process'
+registers before it is resumed. The register class must have been
+fetched already.
 
 Inputs: ws     - debug workspace
         rptr   - pointer to register in x86Registers[]
         regVal - contains new value for register
 
 Return: 1 if successful
-        0 upon ptrace error
+        0 if not
 */
 
 int
@@ -388,14 +476,10 @@ x86writeRegisterDebug(struct debugWorkspace *ws, struct x86RegInfo *rptr,
     memcpy((unsigned char *)rptr->valptr, regVal->stptr, FPU_DATA_REG_SIZE);
   }
 
-  /*
-   * Call ptrace to set the actual register
-   */
-  if (ptrace(PT_SETREGS, ws->pid, (caddr_t) &(ws->regContents.Regs), 0) != 0)
-    return (0); /* error */
-
-  if (ptrace(PT_SETFPREGS, ws->pid, (caddr_t) &(ws->regContents.fpRegs), 0) != 0)
-    return (0); /* error */
+  if (rptr->flags & R_GENERAL)
+    ws->regContents.cache |= RC_GENERAL_DIRTY;
+  else
+    ws->regContents.cache |= RC_FPU_DIRTY;
 
   return (1);
 } /* x86writeRegistersDebug() */
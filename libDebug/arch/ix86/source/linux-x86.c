@@ -17,6 +17,7 @@
 #include <sys/ptrace.h>
 #include <sys/wait.h>
 #include <sys/user.h>
+#include <sys/procfs.h>
 #include <assert.h>
 #include <string.h>
 #include <signal.h>
@@ -163,7 +164,7 @@ x86getCurrentInstruction(struct debugWorkspace *ws, int *err)
    * x86Continue() will overwrite new register contents with old ones when it calls
    * x86SetCurrentInstruction()
    */
-  if (ptrace(PT_GETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
+  if (!x86getRegistersDebug(ws))
     *err = 1;
 
   return ((unsigned long) ws->regContents.Regs.regs.eip);
@@ -171,7 +172,8 @@ x86getCurrentInstruction(struct debugWorkspace *ws, int *err)
 
 /*
 x86setCurrentInstruction()
-  Set eip to the given address
+  Set eip to the given address. The change is written to the
+process by x86flushRegistersDebug() before it is resumed.
 
 Return: 1 if successful
         0 if not
@@ -183,11 +185,12 @@ x86setCurrentInstruction(struct debugWorkspace *ws, unsigned long address)
 {
   assert(ws->pid != NOPID);
 
-  ws->regContents.Regs.regs.eip = address;
-
-  if (ptrace(PT_SETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
+  if (!x86getRegistersDebug(ws))
     return (0);
 
+  ws->regContents.Regs.regs.eip = address;
+  ws->regContents.cache |= RC_GENERAL_DIRTY;
+
   /*
    * Keep our instruction pointer updated
    */
@@ -198,7 +201,8 @@ x86setCurrentInstruction(struct debugWorkspace *ws, unsigned long address)
 
 /*
 x86getRegistersDebug()
-  Update our local copy of the debugged process' registers
+  Update our local copy of the debugged process' general registers,
+unless it is already current
 
 Inputs: ws - debug workspace
 
@@ -210,8 +214,41 @@ int
 x86getRegistersDebug(struct debugWorkspace *ws)
 
 {
-  if (ptrace(PT_GETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
-    return (0); /* something went wrong */
+  if (!(ws->regContents.cache & RC_GENERAL_VALID))
+  {
+    if (ptrace(PT_GETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
+      return (0); /* something went wrong */
+
+    ws->regContents.cache |= RC_GENERAL_VALID;
+  }
+
+  /*
+   * Save the location of our next instruction
+   */
+  ws->instructionPointer = ws->regContents.Regs.regs.eip;
+
+  return (1);
+} /* x86getRegistersDebug() */
+
+/*
+x86getFPRegistersDebug()
+  Update our local copy of the debugged process' fpu and mmx
+registers, unless it is already current. These are only needed
+when displaying or modifying them, so they are not fetched at
+every stop.
+
+Inputs: ws - debug workspace
+
+Return: 1 if successful
+        0 upon ptrace error
+*/
+
+int
+x86getFPRegistersDebug(struct debugWorkspace *ws)
+
+{
+  if (ws->regContents.cache & RC_FPU_VALID)
+    return (1);
 
 #if 1
 
@@ -225,13 +262,99 @@ x86getRegistersDebug(struct debugWorkspace *ws)
 
 #endif
 
-  /*
-   * Save the location of our next instruction
-   */
+  ws->regContents.cache |= RC_FPU_VALID;
+
+  return (1);
+} /* x86getFPRegistersDebug() */
+
+/*
+x86flushRegistersDebug()
+  Write any modified registers back to the process and invalidate
+our copy. This must be called before the process is resumed.
+
+Inputs: ws - debug workspace
+
+Return: 1 if successful
+        0 upon ptrace error
+*/
+
+int
+x86flushRegistersDebug(struct debugWorkspace *ws)
+
+{
+  int ret;
+
+  ret = 1;
+
+  if (ws->regContents.cache & RC_GENERAL_DIRTY)
+  {
+    if (ptrace(PT_SETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
+      ret = 0;
+  }
+
+  if (ws->regContents.cache & RC_FPU_DIRTY)
+  {
+    if (ptrace(PT_SETFPREGS, ws->pid, 0, &(ws->regContents.Regs.i387)) != 0)
+      ret = 0;
+  }
+
+  x86invalidateRegistersDebug(ws);
+
+  return (ret);
+} /* x86flushRegistersDebug() */
+
+/*
+x86loadCoreRegistersDebug()
+  Fill our register cache from the register notes of a core file,
+so the usual register queries can be answered without a process.
+The cache is marked valid but not dirty - it is discarded as soon
+as a real process is started or attached to.
+
+Inputs: ws      - debug workspace
+        prstatus - NT_PRSTATUS note contents
+        size     - size of prstatus
+        fpregs   - NT_PRFPREG note contents (may be 0)
+        fpsize   - size of fpregs
+        sig      - where to store the signal which killed the process
+
+Return: 1 if successful
+        0 if the notes do not have the expected layout
+*/
+
+int
+x86loadCoreRegistersDebug(struct debugWorkspace *ws, void *prstatus,
+                          size_t size, void *fpregs, size_t fpsize,
+                          int *sig)
+
+{
+  struct elf_prstatus *status;
+
+  if (!prstatus || (size < sizeof(struct elf_prstatus)))
+    return (0);
+
+  status = (struct elf_prstatus *) prstatus;
+
+  x86invalidateRegistersDebug(ws);
+
+  memcpy(&(ws->regContents.Regs.regs),
+         status->pr_reg,
+         sizeof(ws->regContents.Regs.regs));
+  ws->regContents.cache |= RC_GENERAL_VALID;
+
+  if (fpregs && (fpsize >= sizeof(ws->regContents.Regs.i387)))
+  {
+    memcpy(&(ws->regContents.Regs.i387),
+           fpregs,
+           sizeof(ws->regContents.Regs.i387));
+    ws->regContents.cache |= RC_FPU_VALID;
+  }
+
   ws->instructionPointer = ws->regContents.Regs.regs.eip;
 
+  *sig = status->pr_cursig;
+
   return (1);
-} /* x86getRegistersDebug() */
+} /* x86loadCoreRegistersDebug() */
 
 /*
 x86readFPUDebug()
@@ -289,15 +412,17 @@ x86readFPUDebug(struct debugWorkspace *ws, struct x86fpuInfo *fpuState)
 
 /*
 x86writeRegisterDebug()
-  Update our local copy of the register with the given value and call ptrace
-to write the changes to the process' registers
+  Update our local copy of the register with the given value and mark
+it dirty so x86flushRegistersDebug() writes the change to the process'
+registers before it is resumed. The register class must have been
+fetched already.
 
 Inputs: ws     - debug workspace
         rptr   - pointer to register in x86Registers[]
         regVal - contains new value for register
 
 Return: 1 if successful
-        0 upon ptrace error
+        0 if not
 */
 
 int
@@ -322,14 +447,10 @@ x86writeRegisterDebug(struct debugWorkspace *ws, struct x86RegInfo *rptr,
     memcpy((unsigned char *)rptr->valptr, regVal->stptr, FPU_DATA_REG_SIZE);
   }
 
-  /*
-   * Call ptrace to set the actual register
-   */
-  if (ptrace(PT_SETREGS, ws->pid, 0, &(ws->regContents.Regs.regs)) != 0)
-    return (0); /* error */
-
-  if (ptrace(PT_SETFPREGS, ws->pid, 0, &(ws->regContents.Regs.i387)) != 0)
-    return (0); /* error */
+  if (rptr->flags & R_GENERAL)
+    ws->regContents.cache |= RC_GENERAL_DIRTY;
+  else
+    ws->regContents.cache |= RC_FPU_DIRTY;
 
   return (1);
 } /* x86writeRegistersDebug() */
@@ -147,8 +147,9 @@ x86findRegisterDebug(struct debugWorkspace *ws, char *name)
 /*
 x86readRegisterDebug()
   Read the contents of a specified register. Before calling this
-function, x86getRegistersDebug() should be called to obtain the
-latest register contents via ptrace
+function, x86getRegistersDebug() (or x86getFPRegistersDebug() for
+fpu and mmx registers) should be called to obtain the latest
+register contents via ptrace
 
 Inputs: ws     - debug workspace
         rptr   - pointer to a register in x86Registers[]
@@ -254,13 +255,23 @@ x86printRegistersDebug(struct debugWorkspace *ws, int regindex,
   struct x86RegValue regVal;
   unsigned int regFlags;
   int needbreak;
+  int needfpu;
 
   /*
-   * Grab the process' registers
+   * Grab the process' registers - the fpu/mmx registers are only
+   * fetched if we are going to display them
    */
   if (!x86getRegistersDebug(ws))
     return (0);
 
+  if (regindex < 0)
+    needfpu = flags & (DB_REGFL_DISPLAY_FPREGS | DB_REGFL_DISPLAY_MMXREGS);
+  else
+    needfpu = x86Registers[regindex].flags & (R_FPU | R_MMX);
+
+  if (needfpu && !x86getFPRegistersDebug(ws))
+    return (0);
+
   needbreak = 0;
 
   if (regindex < 0)
@@ -563,6 +574,16 @@ x86setRegisterDebug(struct debugWorkspace *ws, int regindex, char *value)
 
   rptr = x86Registers + regindex;
 
+  /*
+   * Make sure our copy of the register is current before we
+   * modify part of it
+   */
+  if (!x86getRegistersDebug(ws))
+    return (-1);
+
+  if ((rptr->flags & (R_FPU | R_MMX)) && !x86getFPRegistersDebug(ws))
+    return (-1);
+
   if ((rptr->flags & R_GENERAL) ||
       ((rptr->flags & R_FPU) && !(rptr->flags & R_FPU_DATA)))
   {
@@ -687,6 +708,9 @@ x86getFlagsDebug(struct debugWorkspace *ws, char *flags)
   if (ridx == (-1))
     return (0);
 
+  if (!x86getRegistersDebug(ws))
+    return (0);
+
   size = x86readRegisterDebug(ws, x86Registers + ridx, &regVal);
   flval = regVal.lvalue;
 
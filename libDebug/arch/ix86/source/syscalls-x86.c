@@ -0,0 +1,283 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "libDebug.h"
+#include "syscalls-x86.h"
+
+/*
+ * Linux i386 system calls, sorted by number: number, name and
+ * number of arguments. Calls missing from the table are shown by
+ * number.
+ */
+static struct x86Syscall x86Syscalls[] = {
+  {   1, "exit",                1 },
+  {   2, "fork",                0 },
+  {   3, "read",                3 },
+  {   4, "write",               3 },
+  {   5, "open",                3 },
+  {   6, "close",               1 },
+  {   7, "waitpid",             3 },
+  {   8, "creat",               2 },
+  {   9, "link",                2 },
+  {  10, "unlink",              1 },
+  {  11, "execve",              3 },
+  {  12, "chdir",               1 },
+  {  13, "time",                1 },
+  {  14, "mknod",               3 },
+  {  15, "chmod",               2 },
+  {  19, "lseek",               3 },
+  {  20, "getpid",              0 },
+  {  21, "mount",               5 },
+  {  23, "setuid",              1 },
+  {  24, "getuid",              0 },
+  {  27, "alarm",               1 },
+  {  29, "pause",               0 },
+  {  33, "access",              2 },
+  {  34, "nice",                1 },
+  {  36, "sync",                0 },
+  {  37, "kill",                2 },
+  {  38, "rename",              2 },
+  {  39, "mkdir",               2 },
+  {  40, "rmdir",               1 },
+  {  41, "dup",                 1 },
+  {  42, "pipe",                1 },
+  {  43, "times",               1 },
+  {  45, "brk",                 1 },
+  {  46, "setgid",              1 },
+  {  47, "getgid",              0 },
+  {  48, "signal",              2 },
+  {  49, "geteuid",             0 },
+  {  50, "getegid",             0 },
+  {  54, "ioctl",               3 },
+  {  55, "fcntl",               3 },
+  {  57, "setpgid",             2 },
+  {  60, "umask",               1 },
+  {  61, "chroot",              1 },
+  {  63, "dup2",                2 },
+  {  64, "getppid",             0 },
+  {  65, "getpgrp",             0 },
+  {  66, "setsid",              0 },
+  {  67, "sigaction",           3 },
+  {  75, "setrlimit",           2 },
+  {  76, "getrlimit",           2 },
+  {  77, "getrusage",           2 },
+  {  78, "gettimeofday",        2 },
+  {  79, "settimeofday",        2 },
+  {  83, "symlink",             2 },
+  {  85, "readlink",            3 },
+  {  90, "mmap",                1 },
+  {  91, "munmap",              2 },
+  {  92, "truncate",            2 },
+  {  93, "ftruncate",           2 },
+  {  94, "fchmod",              2 },
+  {  96, "getpriority",         2 },
+  {  97, "setpriority",         3 },
+  {  99, "statfs",              2 },
+  { 100, "fstatfs",             2 },
+  { 102, "socketcall",          2 },
+  { 104, "setitimer",           3 },
+  { 105, "getitimer",           2 },
+  { 106, "stat",                2 },
+  { 107, "lstat",               2 },
+  { 108, "fstat",               2 },
+  { 114, "wait4",               4 },
+  { 116, "sysinfo",             1 },
+  { 117, "ipc",                 6 },
+  { 118, "fsync",               1 },
+  { 119, "sigreturn",           0 },
+  { 120, "clone",               5 },
+  { 122, "uname",               1 },
+  { 125, "mprotect",            3 },
+  { 126, "sigprocmask",         3 },
+  { 132, "getpgid",             1 },
+  { 133, "fchdir",              1 },
+  { 136, "personality",         1 },
+  { 140, "_llseek",             5 },
+  { 141, "getdents",            3 },
+  { 142, "_newselect",          5 },
+  { 143, "flock",               2 },
+  { 144, "msync",               3 },
+  { 145, "readv",               3 },
+  { 146, "writev",              3 },
+  { 147, "getsid",              1 },
+  { 148, "fdatasync",           1 },
+  { 150, "mlock",               2 },
+  { 151, "munlock",             2 },
+  { 158, "sched_yield",         0 },
+  { 162, "nanosleep",           2 },
+  { 163, "mremap",              5 },
+  { 168, "poll",                3 },
+  { 172, "prctl",               5 },
+  { 173, "rt_sigreturn",        0 },
+  { 174, "rt_sigaction",        4 },
+  { 175, "rt_sigprocmask",      4 },
+  { 176, "rt_sigpending",       2 },
+  { 179, "rt_sigsuspend",       2 },
+  { 180, "pread64",             4 },
+  { 181, "pwrite64",            4 },
+  { 182, "chown",               3 },
+  { 183, "getcwd",              2 },
+  { 186, "sigaltstack",         2 },
+  { 190, "vfork",               0 },
+  { 191, "ugetrlimit",          2 },
+  { 192, "mmap2",               6 },
+  { 193, "truncate64",          3 },
+  { 194, "ftruncate64",         3 },
+  { 195, "stat64",              2 },
+  { 196, "lstat64",             2 },
+  { 197, "fstat64",             2 },
+  { 199, "getuid32",            0 },
+  { 200, "getgid32",            0 },
+  { 201, "geteuid32",           0 },
+  { 202, "getegid32",           0 },
+  { 213, "setuid32",            1 },
+  { 214, "setgid32",            1 },
+  { 219, "madvise",             3 },
+  { 220, "getdents64",          3 },
+  { 221, "fcntl64",             3 },
+  { 224, "gettid",              0 },
+  { 240, "futex",               6 },
+  { 242, "sched_getaffinity",   3 },
+  { 243, "set_thread_area",     1 },
+  { 244, "get_thread_area",     1 },
+  { 252, "exit_group",          1 },
+  { 255, "epoll_ctl",           4 },
+  { 256, "epoll_wait",          4 },
+  { 258, "set_tid_address",     1 },
+  { 265, "clock_gettime",       2 },
+  { 267, "clock_nanosleep",     4 },
+  { 268, "statfs64",            3 },
+  { 269, "fstatfs64",           3 },
+  { 270, "tgkill",              3 },
+  { 295, "openat",              4 },
+  { 296, "mkdirat",             3 },
+  { 300, "fstatat64",           4 },
+  { 301, "unlinkat",            3 },
+  { 302, "renameat",            4 },
+  { 305, "readlinkat",          4 },
+  { 307, "faccessat",           3 },
+  { 308, "pselect6",            6 },
+  { 309, "ppoll",               5 },
+  { 311, "set_robust_list",     2 },
+  { 329, "epoll_create1",       1 },
+  { 330, "dup3",                3 },
+  { 331, "pipe2",               2 },
+  { 340, "prlimit64",           4 },
+  { 355, "getrandom",           3 },
+  { 359, "socket",              3 },
+  { 361, "bind",                3 },
+  { 362, "connect",             3 },
+  { 363, "listen",              2 },
+  { 364, "accept4",             4 },
+  { 369, "sendto",              6 },
+  { 371, "recvfrom",            6 },
+  { 373, "shutdown",            2 },
+  { 383, "statx",               5 },
+  { 403, "clock_gettime64",     2 },
+  { 0, 0, 0 }
+};
+
+static struct x86Syscall *x86lookupSyscall(int number);
+
+/*
+x86lookupSyscall()
+  Find a system call in the table by number
+
+Inputs: number - system call number
+
+Return: pointer to entry, or 0 if not found
+*/
+
+static struct x86Syscall *
+x86lookupSyscall(int number)
+
+{
+  struct x86Syscall *sptr;
+
+  for (sptr = x86Syscalls; sptr->name; ++sptr)
+  {
+    if (sptr->number == number)
+      return (sptr);
+  }
+
+  return (0);
+} /* x86lookupSyscall() */
+
+/*
+x86findSyscall()
+  Find a system call by name
+
+Inputs: name - system call name
+
+Return: system call number
+        -1 if not found
+*/
+
+int
+x86findSyscall(char *name)
+
+{
+  struct x86Syscall *sptr;
+
+  for (sptr = x86Syscalls; sptr->name; ++sptr)
+  {
+    if (!strcmp(sptr->name, name))
+      return (sptr->number);
+  }
+
+  return (-1);
+} /* x86findSyscall() */
+
+/*
+x86getSyscallName()
+  Return the name of a system call
+
+Inputs: number - system call number
+
+Return: name, or 0 if the call is not in the table
+*/
+
+char *
+x86getSyscallName(int number)
+
+{
+  struct x86Syscall *sptr;
+
+  sptr = x86lookupSyscall(number);
+
+  return (sptr ? sptr->name : 0);
+} /* x86getSyscallName() */
+
+/*
+x86getSyscallArgs()
+  Return the number of arguments a system call takes
+
+Inputs: number - system call number
+
+Return: number of arguments (X86_SYSCALL_MAXARGS if the call is not
+        in the table)
+*/
+
+int
+x86getSyscallArgs(int number)
+
+{
+  struct x86Syscall *sptr;
+
+  sptr = x86lookupSyscall(number);
+
+  return (sptr ? sptr->nargs : X86_SYSCALL_MAXARGS);
+} /* x86getSyscallArgs() */
@@ -22,19 +22,77 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/syscall.h>        /* SYS_fork, SYS_mprotect */
+#include <sys/mman.h>           /* PROT_xxx */
+#include <fcntl.h>
 
 /*
  * Top-level includes
  */
 #include "args.h"
 #include "break.h"
+#include "catch.h"
 #include "libDebug.h"
+#include "record.h"
+#include "tracepoint.h"
+#include "watch.h"
+
+/*
+ * The seccomp headers are only looked for once we know the system
+ */
+#ifdef OS_LINUX
+#include <stddef.h>             /* offsetof */
+#include <sys/prctl.h>          /* PR_SET_NO_NEW_PRIVS, PR_SET_SECCOMP */
+#include <linux/filter.h>       /* struct sock_filter */
+#include <linux/seccomp.h>      /* SECCOMP_xxx */
+#include <linux/audit.h>        /* AUDIT_ARCH_I386 */
+#endif
+
+/*
+ * Most protected pages a single instruction may write to
+ */
+#define WATCH_MAXSTEP  4
+
+/*
+ * System calls are caught with a seccomp filter and
+ * PTRACE_O_TRACESECCOMP
+ */
+#if defined(OS_LINUX) && defined(PT_SETOPTIONS) && defined(PT_SYSCALL) && \
+    defined(SECCOMP_MODE_FILTER) && defined(PR_SET_NO_NEW_PRIVS)
+#  define CATCH_SECCOMP
+#endif
 
 static int x86GetDebugProcessStatus(struct debugWorkspace *ws,
                                     int ptfunc, int waitval,
                                     int *data);
+static int x86StepBreakpoint(struct debugWorkspace *ws, int *data);
 static int x86DoSingleStep(struct debugWorkspace *ws, int *data);
+static int x86RecordedStep(struct debugWorkspace *ws, int *data);
+static int x86RecordedStepOver(struct debugWorkspace *ws, int *data);
+static int x86DoBlockStep(struct debugWorkspace *ws, int *data);
 static int x86DoContinue(struct debugWorkspace *ws, int *data);
+static int x86CoverageTrap(struct debugWorkspace *ws, int waitval, int ptfunc,
+                           unsigned long start);
+static void x86readCoverage(struct debugWorkspace *ws, struct Coverage *cov);
+static int x86writeCoverage(struct debugWorkspace *ws, struct Coverage *cov,
+                            int insert);
+static int x86protectWatchPages(struct debugWorkspace *ws,
+                                struct watchPage *pages,
+                                unsigned long npages, int restore);
+static void x86mapWatchPages(void *args, unsigned long start,
+                             unsigned long end, char *perms);
+static int x86comparePages(const void *a, const void *b);
+static void x86resumeWatch(struct debugWorkspace *ws);
+static int x86WatchTrap(struct debugWorkspace *ws, int *waitval, int *data);
+static void x86installCatchFilter(struct debugWorkspace *ws);
+static long x86ptraceOptions(struct debugWorkspace *ws);
+#ifdef OS_LINUX
+static int x86stepInjected(pid_t pid, int *waitval);
+static void x86deferSignal(struct debugWorkspace *ws, pid_t pid, int sig,
+                           int *requeue);
+#endif
+static int x86CatchTrap(struct debugWorkspace *ws, int waitval, int *data);
+static int x86FinishSyscall(struct debugWorkspace *ws, int *data);
 
 /*
 x86execDebug()
@@ -114,6 +172,16 @@ x86execDebug(struct debugWorkspace *ws)
     }
 #endif
 
+    if (ws->catch.count)
+    {
+      /*
+       * Give the parent a chance to set PTRACE_O_TRACESECCOMP
+       * before the filter can stop us
+       */
+      kill(getpid(), SIGSTOP);
+      x86installCatchFilter(ws);
+    }
+
     execv(ws->path, ws->args);
 
     /*
@@ -133,13 +201,56 @@ x86execDebug(struct debugWorkspace *ws)
     ws->pid = pid;
 
     /*
-     * wait for child to stop (execv)
+     * Fast tracepoints were written into the previous program
+     */
+    clearFastTracepoints(ws, 0);
+
+    if (dbIsRedirect(ws))
+    {
+      /*
+       * Only the child writes to the pipe - closing our copy of
+       * the write end lets us see end of file when it exits. The
+       * read end now belongs to the capture buffer, which drains
+       * it while we wait on the child.
+       */
+      close(ws->pipes[1]);
+      startCaptureDebug(&(ws->capture), ws->pipes[0]);
+    }
+
+    ws->catch.active = 0;
+    ws->catch.pending = 0;
+
+    if (ws->catch.count)
+    {
+      /*
+       * The child stops itself before putting in its catch filter
+       */
+      waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+
+      ws->catch.active = 1;
+      if (ptrace(PT_SETOPTIONS, ws->pid, 0, x86ptraceOptions(ws)) != 0)
+        ws->catch.active = 0;
+
+      ptrace(PT_CONTINUE, ws->pid, CONTADDR, 0);
+    }
+
+    /*
+     * wait for child to stop (execv) - a caught execve() stops
+     * first, which is of no interest yet
      */
-    wait(&waitval);
+    waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+
+    while (ws->catch.active && WIFSTOPPED(waitval) &&
+           ((waitval >> 16) != 0))
+    {
+      ptrace(PT_CONTINUE, ws->pid, CONTADDR, 0);
+      waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+    }
 
     /*
      * Set the instruction pointer to the program's entry point
      */
+    x86invalidateRegistersDebug(ws);
     err = 0;
     ws->instructionPointer = x86getCurrentInstruction(ws, &err);
     if (err)
@@ -184,6 +295,7 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
                          int waitval, int *data)
 
 {
+  pid_t pid;
   int sig;
 
   if (WIFEXITED(waitval))
@@ -191,6 +303,7 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
     /*
      * Process exited normally
      */
+    pid = ws->pid;
     endDebug(ws);
 
     *data = WEXITSTATUS(waitval);
@@ -198,9 +311,10 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
     /*
      * When a program exits, it sends two signals to the parent -
      * one for the exit status and the other is a SIGCHLD, so
-     * make sure we catch the second.
+     * make sure we catch the second. Only wait on this process:
+     * checkpoints are stopped children which would block wait().
      */
-    wait(&waitval);
+    waitpid(pid, &waitval, WAIT_TRACED);
 
     return (4);
   }
@@ -212,6 +326,7 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
     {
       unsigned long addr;
       struct Breakpoint *bptr;
+      int ret;
 
       /*
        * InstructionPointer should be set appropriately by the
@@ -225,32 +340,9 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
          * A SIGTRAP is generated after every singlestep call
          * so check before declaring it a user-defined breakpoint
          */
-        if ((bptr = findBreakpoint(ws, addr)))
-        {
-          if (bptr->flags & BK_STEPOVER)
-            printf("HIT A STEP OVER BRKPT\n");
-
-          *data = bptr->number;
-
-          if (bptr->ignorecnt > 0)
-          {
-            /*
-             * Ignore this breakpoint for now and continue
-             * running the process
-             */
-            --bptr->ignorecnt;
-            return (1);
-          }
-
-          /*
-           * Check if breakpoint should be deleted
-           */
-          checkBreakpoint(ws, bptr);
-
-          dbSetHitBreakpoint(ws);
-
-          return (3);
-        }
+        ret = x86StepBreakpoint(ws, data);
+        if (ret)
+          return (ret);
 
         /*
          * If we get here, the SIGTRAP is the normal response
@@ -288,6 +380,17 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
          */
         x86setCurrentInstruction(ws, addr);
 
+        /*
+         * A tracepoint collects its frame and lets the program
+         * run on
+         */
+        if (bptr->flags & BK_TRACE)
+        {
+          ++(bptr->hitcnt);
+          collectTrace(ws, bptr);
+          return (1);
+        }
+
         if (bptr->ignorecnt > 0)
         {
           /*
@@ -318,11 +421,12 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
       *data = sig;
 
       /*
-       * If we received a SIGINT, do not pass it to the process the
-       * next time we continue ptracing, because it was probably
-       * caused by the user debugging the process
+       * Pass the signal to the process the next time we continue
+       * ptracing, unless the policy says otherwise (by default,
+       * a SIGINT was probably caused by the user debugging the
+       * process, and is not passed)
        */
-      if (sig != SIGINT)
+      if (getSignalPolicy(ws, sig) & SP_PASS)
         ws->lastSignal = sig;
 
       return (2);
@@ -343,6 +447,51 @@ x86GetDebugProcessStatus(struct debugWorkspace *ws, int ptfunc,
   return (1);
 } /* x86GetDebugProcessStatus() */
 
+/*
+x86StepBreakpoint()
+  Called after a single step, whether by the cpu or emulated, to see
+if the process stopped on a user breakpoint
+
+Inputs: ws   - debug workspace
+        data - modified to contain the breakpoint number
+
+Return: 0 if there is no breakpoint at the current instruction
+        1 if the breakpoint is being ignored (see ignorecnt)
+        3 if the breakpoint was hit
+*/
+
+static int
+x86StepBreakpoint(struct debugWorkspace *ws, int *data)
+
+{
+  struct Breakpoint *bptr;
+
+  bptr = findBreakpoint(ws, ws->instructionPointer);
+  if (!bptr || (bptr->flags & BK_TRACE))
+    return (0);
+
+  *data = bptr->number;
+
+  if (bptr->ignorecnt > 0)
+  {
+    /*
+     * Ignore this breakpoint for now and continue
+     * running the process
+     */
+    --bptr->ignorecnt;
+    return (1);
+  }
+
+  /*
+   * Check if breakpoint should be deleted
+   */
+  checkBreakpoint(ws, bptr);
+
+  dbSetHitBreakpoint(ws);
+
+  return (3);
+} /* x86StepBreakpoint() */
+
 /*
 x86DoSingleStep()
   Singlestep one instruction in the process being debugged
@@ -359,17 +508,47 @@ Return: 0 if something goes wrong
         5 if program writes to stdout or stderr and we are
           redirecting output - the calling function can read the
           output using GetDebugOutput()
+        8 if program writes to a watched range (watchpoint number
+          goes in data)
+        9 if program makes a caught system call (system call number
+          goes in data)
 */
 
 static int
 x86DoSingleStep(struct debugWorkspace *ws, int *data)
 
 {
+  unsigned long start; /* address we step from */
   int waitval;
+  int ret;
   int err;
 
   assert(ws->pid != NOPID);
 
+  /*
+   * Stopped at a caught system call - the step is the call itself
+   */
+  if (ws->catch.pending)
+    return (x86FinishSyscall(ws, data));
+
+  /*
+   * Simple instructions are carried out by us, which is much
+   * cheaper than a trip through the kernel. The cpu would not trap
+   * on landing at a breakpoint either, so check as for PT_STEP.
+   */
+  if (x86emulateStep(ws))
+  {
+    ret = x86StepBreakpoint(ws, data);
+    return (ret ? ret : 1);
+  }
+
+  start = ws->instructionPointer;
+
+  if (!x86flushRegistersDebug(ws))
+    return (0); /* something went wrong */
+
+  x86resumeWatch(ws);
+
   if (ptrace(PT_STEP, ws->pid, CONTADDR, ws->lastSignal) != 0)
     return (0); /* something went wrong */
 
@@ -381,14 +560,248 @@ x86DoSingleStep(struct debugWorkspace *ws, int *data)
   /*
    * Wait for child to stop
    */
-  wait(&waitval);
+  waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
 
   err = 0;
   ws->instructionPointer = x86getCurrentInstruction(ws, &err);
 
+  /*
+   * Stepping into a caught system call stops at its entry - either
+   * report it, or log it and let the call finish the step
+   */
+  if (x86CatchTrap(ws, waitval, data))
+  {
+    if (!ws->catch.log)
+      return (9);
+
+    return (x86FinishSyscall(ws, data));
+  }
+
+  /*
+   * A coverage breakpoint is removed when it is hit, so stepping
+   * again executes the real instruction
+   */
+  if (x86CoverageTrap(ws, waitval, PT_STEP, start))
+    return (x86DoSingleStep(ws, data));
+
+  /*
+   * A write to a watched page faults - x86WatchTrap() steps it
+   * for us
+   */
+  ret = x86WatchTrap(ws, &waitval, data);
+  if (ret == 2)
+    return (8);
+
   return (x86GetDebugProcessStatus(ws, PT_STEP, waitval, data));
 } /* x86DoSingleStep() */
 
+/*
+x86RecordedStep()
+  Singlestep one instruction, adding it to the execution history if
+recording is on
+
+Inputs: ws   - debug workspace
+        data - modified to contain info depending on the return
+               result
+
+Return: same as x86DoSingleStep()
+*/
+
+static int
+x86RecordedStep(struct debugWorkspace *ws, int *data)
+
+{
+  int ret;
+
+  if (!recordActive(ws))
+    return (x86DoSingleStep(ws, data));
+
+  beginRecord(ws);
+  ret = x86DoSingleStep(ws, data);
+  endRecord(ws, ret);
+
+  return (ret);
+} /* x86RecordedStep() */
+
+/*
+x86RecordedStepOver()
+  Step over a subroutine call one recorded instruction at a time,
+until the stack pointer is back above the return address. Enabled
+breakpoints inside the subroutine stop us, as they would if it was
+run with x86DoContinue().
+
+Inputs: ws   - debug workspace
+        data - modified to contain info depending on the return
+               result
+
+Return: same as x86DoSingleStep()
+*/
+
+static int
+x86RecordedStepOver(struct debugWorkspace *ws, int *data)
+
+{
+  struct Breakpoint *bptr;
+  unsigned long frame;
+  int ret;
+
+  frame = (unsigned long) x86readIntRegisterDebug(ws, REG_ESP);
+
+  while (1)
+  {
+    ret = x86RecordedStep(ws, data);
+    if (ret != 1)
+      return (ret);
+
+    if ((unsigned long) x86readIntRegisterDebug(ws, REG_ESP) >= frame)
+      return (1);
+
+    bptr = findBreakpoint(ws, ws->instructionPointer);
+    if (!bptr || !(bptr->flags & BK_ENABLED) ||
+        (bptr->flags & (BK_STEPOVER | BK_TRACE)))
+      continue;
+
+    if (bptr->ignorecnt > 0)
+    {
+      --bptr->ignorecnt;
+      continue;
+    }
+
+    *data = bptr->number;
+    checkBreakpoint(ws, bptr);
+    dbSetHitBreakpoint(ws);
+
+    return (3);
+  }
+} /* x86RecordedStepOver() */
+
+/*
+x86DoBlockStep()
+  Run the process being debugged until it takes a branch, using the
+processor's branch trap flag (BTF) - it stops at the branch target,
+which is the start of the next basic block
+
+Inputs: ws   - debug workspace
+        data - modified to contain info depending on the return
+               result
+
+Return: same as x86DoSingleStep(). If block stepping is not supported
+        on this system, 0 is returned with errno set to ENOSYS.
+*/
+
+static int
+x86DoBlockStep(struct debugWorkspace *ws, int *data)
+
+{
+#ifdef PT_STEPBLOCK
+
+  struct Breakpoint *bptr;
+  unsigned long start; /* address we start stepping from */
+  int waitval;
+  int ptfunc;
+  int err;
+
+  assert(ws->pid != NOPID);
+
+  if (ws->catch.pending)
+    return (x86FinishSyscall(ws, data));
+
+  start = ws->instructionPointer;
+
+  clearRecord(ws);
+
+  /*
+   * Unlike a single step, a block may run many instructions, so
+   * breakpoints must be active. The one we are sitting on (if any)
+   * is left inactive so we can get past it - should the block loop
+   * back to it, the branch trap stops us there anyway.
+   */
+  x86resumeWatch(ws);
+
+  dbClearHitBreakpoint(ws);
+  enableBreakpoints(ws);
+
+  if ((bptr = findBreakpoint(ws, start)))
+    x86disableBreakpoint(ws, bptr);
+
+  if (!x86flushRegistersDebug(ws) ||
+      (ptrace(PT_STEPBLOCK, ws->pid, CONTADDR, ws->lastSignal) != 0))
+  {
+    err = errno;
+    disableBreakpoints(ws);
+    errno = err;
+    return (0); /* something went wrong */
+  }
+
+  /*
+   * Clear the last signal
+   */
+  ws->lastSignal = 0;
+
+  /*
+   * Wait for child to stop
+   */
+  waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+
+  disableBreakpoints(ws);
+
+  err = 0;
+  ws->instructionPointer = x86getCurrentInstruction(ws, &err);
+
+  /*
+   * A caught system call stops the block, unless it is only logged
+   * - a system call is not a branch, so the block then goes on
+   */
+  if (x86CatchTrap(ws, waitval, data))
+  {
+    if (!ws->catch.log)
+      return (9);
+
+    ptfunc = x86FinishSyscall(ws, data);
+    if (ptfunc != 1)
+      return (ptfunc);
+
+    return (x86DoBlockStep(ws, data));
+  }
+
+  /*
+   * Coverage breakpoints do not end a block - carry on from the
+   * block we just entered
+   */
+  if (x86CoverageTrap(ws, waitval, PT_STEPBLOCK, start))
+    return (x86DoBlockStep(ws, data));
+
+  /*
+   * So do writes to watched pages which do not change a watched
+   * range
+   */
+  ptfunc = x86WatchTrap(ws, &waitval, data);
+  if (ptfunc == 1)
+    return (x86DoBlockStep(ws, data));
+  else if (ptfunc == 2)
+    return (8);
+
+  /*
+   * If we stopped one byte past an active breakpoint, we ran into it
+   * before the block ended - treat it the way a continue would.
+   * Otherwise we are at the branch target.
+   */
+  ptfunc = PT_STEP;
+
+  bptr = findBreakpoint(ws, ws->instructionPointer - 1);
+  if (bptr && (bptr->address != start) && (bptr->flags & BK_ENABLED))
+    ptfunc = PT_CONTINUE;
+
+  return (x86GetDebugProcessStatus(ws, ptfunc, waitval, data));
+
+#else
+
+  errno = ENOSYS;
+  return (0);
+
+#endif /* PT_STEPBLOCK */
+} /* x86DoBlockStep() */
+
 /*
 x86DoContinue()
   Continue the process being debugged
@@ -407,6 +820,10 @@ Return: 0 if something goes wrong
           output using GetDebugOutput()
         6 (don't use)
         7 if program terminates due to a signal (signal num goes in data)
+        8 if program writes to a watched range (watchpoint number
+          goes in data)
+        9 if program makes a caught system call (system call number
+          goes in data)
 
 Special note about breakpoints:
   If this function is invoked from x86SingleStepOver(), it is
@@ -428,6 +845,18 @@ x86DoContinue(struct debugWorkspace *ws, int *data)
 
   assert(ws->pid != NOPID);
 
+  /*
+   * Nothing run from here on is recorded
+   */
+  clearRecord(ws);
+
+  if (ws->catch.pending)
+  {
+    ret = x86FinishSyscall(ws, data);
+    if (ret != 1)
+      return (ret);
+  }
+
   if (dbHitBreakpoint(ws))
   {
     dbClearHitBreakpoint(ws);
@@ -455,6 +884,11 @@ x86DoContinue(struct debugWorkspace *ws, int *data)
      */
     enableBreakpoints(ws);
 
+    if (!x86flushRegistersDebug(ws))
+      return (0); /* something went wrong */
+
+    x86resumeWatch(ws);
+
     /*fprintf(stderr, "lastsig = %d\n", ws->lastSignal);*/
     if (ptrace(PT_CONTINUE, ws->pid, CONTADDR, ws->lastSignal) != 0)
       return (0); /* something went wrong */
@@ -462,7 +896,7 @@ x86DoContinue(struct debugWorkspace *ws, int *data)
     /*
      * Wait for child to stop
      */
-    wret = wait(&waitval);
+    wret = waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
     /*fprintf(stderr, "wret = %d\n", wret);*/
 
     /*
@@ -478,7 +912,48 @@ x86DoContinue(struct debugWorkspace *ws, int *data)
     err = 0;
     ws->instructionPointer = x86getCurrentInstruction(ws, &err);
 
+    /*
+     * A caught system call either stops the program, or is logged
+     * and the program kept running
+     */
+    if (x86CatchTrap(ws, waitval, data))
+    {
+      if (!ws->catch.log)
+        return (9);
+
+      ret = x86FinishSyscall(ws, data);
+      if (ret != 1)
+        return (ret);
+
+      continue;
+    }
+
+    /*
+     * Coverage breakpoints are removed when hit - nothing to step
+     * past, just keep going
+     */
+    if (x86CoverageTrap(ws, waitval, PT_CONTINUE, 0))
+      continue;
+
+    /*
+     * Writes to watched pages are stepped by x86WatchTrap() - keep
+     * going unless a watched range changed
+     */
+    ret = x86WatchTrap(ws, &waitval, data);
+    if (ret == 1)
+      continue;
+    else if (ret == 2)
+      return (8);
+
     ret = x86GetDebugProcessStatus(ws, PT_CONTINUE, waitval, data);
+
+    /*
+     * Signals the program should not stop for have already been
+     * set up to be passed (or not) on the next PT_CONTINUE
+     */
+    if ((ret == 2) && checkSignalPolicy(ws, *data))
+      continue;
+
     if (ret != 1)
     {
       /*
@@ -546,7 +1021,7 @@ x86stepIntoDebug(struct debugWorkspace *ws, int num, int *data)
     /*
      * Perform single step
      */
-    ret = x86DoSingleStep(ws, data);
+    ret = x86RecordedStep(ws, data);
     if (ret != 1)
     {
       /*
@@ -563,26 +1038,74 @@ x86stepIntoDebug(struct debugWorkspace *ws, int num, int *data)
 } /* x86stepIntoDebug() */
 
 /*
-x86stepOverDebug()
-  Single step our program, stepping past any subroutines
+x86stepBlockDebug()
+  Step our program by basic blocks: each step runs until a branch
+is taken and stops at its target
 
 Inputs: ws   - debug workspace
-        num  - number of instructions to step over
+        num  - number of blocks to step through
         data - modified to contain info depending on the return
-               result, see below
-
-Return: 0 if unsuccessful
-        1 if successful
-        2 if program stops due to a signal
-        3 if breakpoint encountered
-        4 if program terminates
+               result, see x86stepIntoDebug()
 
-Side effects: If the process stops due to a signal, data is
-              modified to contain the signal number.
-              If the process stops due to a breakpoint, data is
-              modified to contain the breakpoint number.
-              If the process terminates normally, data is modified
-              to contain the exit status.
+Return: same as x86stepIntoDebug()
+*/
+
+int
+x86stepBlockDebug(struct debugWorkspace *ws, int num, int *data)
+
+{
+  int ii;
+  int ret;
+
+  assert(num > 0);
+
+  if (ws->pid == NOPID)
+  {
+    ret = x86execDebug(ws);
+    if (ret == 2)
+      return (6); /* not an executable file */
+    else if (ret == 0)
+      return (0); /* something went wrong */
+  }
+
+  dbSetRunning(ws);
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    ret = x86DoBlockStep(ws, data);
+    if (ret != 1)
+    {
+      /*
+       * Something stopped the process (signal, breakpoint, exit, etc)
+       */
+      return (ret);
+    }
+  } /* for (ii = 0; ii < num; ++ii) */
+
+  return (1);
+} /* x86stepBlockDebug() */
+
+/*
+x86stepOverDebug()
+  Single step our program, stepping past any subroutines
+
+Inputs: ws   - debug workspace
+        num  - number of instructions to step over
+        data - modified to contain info depending on the return
+               result, see below
+
+Return: 0 if unsuccessful
+        1 if successful
+        2 if program stops due to a signal
+        3 if breakpoint encountered
+        4 if program terminates
+
+Side effects: If the process stops due to a signal, data is
+              modified to contain the signal number.
+              If the process stops due to a breakpoint, data is
+              modified to contain the breakpoint number.
+              If the process terminates normally, data is modified
+              to contain the exit status.
 */
 
 int
@@ -629,6 +1152,19 @@ x86stepOverDebug(struct debugWorkspace *ws, int num, int *data)
       free(opbuf);
     }
 
+    if (slen && recordActive(ws))
+    {
+      /*
+       * Running the subroutine at full speed would lose the
+       * history - step through it instead
+       */
+      pret = x86RecordedStepOver(ws, data);
+      if (pret != 1)
+        return (pret);
+
+      continue;
+    }
+
     if (slen)
     {
       int bret;
@@ -681,7 +1217,7 @@ x86stepOverDebug(struct debugWorkspace *ws, int num, int *data)
      * We are not about to enter a subroutine - just step
      * one instruction
      */
-    pret = x86DoSingleStep(ws, data);
+    pret = x86RecordedStep(ws, data);
     if (pret != 1)
     {
       /*
@@ -697,6 +1233,117 @@ x86stepOverDebug(struct debugWorkspace *ws, int num, int *data)
   return (1);
 } /* x86stepOverDebug() */
 
+/*
+x86runToDebug()
+  Continue our program until it reaches one of the given addresses.
+A temporary breakpoint is placed at each address, so the program
+runs at full speed rather than being singlestepped.
+
+Inputs: ws    - debug workspace
+        addrs - addresses to run to
+        num   - number of addresses
+        frame - if non-zero, only stop at an address when the stack
+                pointer is at or above this value; arrivals in
+                deeper (recursive) invocations are ignored
+        data  - modified to contain info depending on the return
+                result, see x86stepOverDebug()
+
+Return: 1 if one of the addresses was reached, otherwise the same
+        as x86continueDebug()
+*/
+
+int
+x86runToDebug(struct debugWorkspace *ws, unsigned long *addrs, int num,
+              unsigned long frame, int *data)
+
+{
+  int ii;
+  int ret;
+
+  assert(num > 0);
+
+  if (ws->pid == NOPID)
+  {
+    ret = x86execDebug(ws);
+    if (ret == 2)
+      return (6); /* not an executable file */
+    else if (ret == 0)
+      return (0); /* something went wrong */
+  }
+
+  dbSetRunning(ws);
+
+  /*
+   * If we are sitting on one of the addresses, we want the next
+   * arrival there - get off of it before arming the breakpoints
+   */
+  for (ii = 0; ii < num; ++ii)
+  {
+    if (addrs[ii] == ws->instructionPointer)
+    {
+      dbClearHitBreakpoint(ws);
+
+      ret = x86DoSingleStep(ws, data);
+      if (ret != 1)
+        return (ret); /* something stopped the process */
+
+      break;
+    }
+  }
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    if (setAndSaveBreakpoint(ws, addrs[ii], BK_TEMPORARY | BK_STEPOVER) < 0)
+    {
+      clearStepOverBreakpoints(ws);
+      return (0);
+    }
+  }
+
+  while (1)
+  {
+    ret = x86DoContinue(ws, data);
+
+    if ((ret != 3) || (*data != 0))
+    {
+      /*
+       * Something else stopped the program (user breakpoint,
+       * signal, exit, etc)
+       */
+      break;
+    }
+
+    /*
+     * One of our temporary breakpoints was reached
+     */
+    if (!frame ||
+        ((unsigned long) x86readIntRegisterDebug(ws, REG_ESP) >= frame))
+    {
+      ret = 1;
+      break;
+    }
+
+    /*
+     * We are in a deeper invocation of the same code - the
+     * breakpoint was deleted when it was hit, so put it back
+     * and keep going
+     */
+    if (setAndSaveBreakpoint(ws, ws->instructionPointer,
+                             BK_TEMPORARY | BK_STEPOVER) < 0)
+    {
+      ret = 0;
+      break;
+    }
+  } /* while (1) */
+
+  /*
+   * Remove whichever breakpoints were not reached
+   */
+  clearStepOverBreakpoints(ws);
+
+  return (ret);
+} /* x86runToDebug() */
+
 /*
 x86continueDebug()
   Continue the debugged process where it left off
@@ -711,6 +1358,10 @@ Return: 0 if unsuccessful
         4 if program terminates (exit status put into data)
         6 if program is not executable
         7 if program terminates due to a signal (signal num put into data)
+        8 if program writes to a watched range (watchpoint number put
+          into data)
+        9 if program makes a caught system call (system call number
+          put into data)
 */
 
 int
@@ -733,6 +1384,169 @@ x86continueDebug(struct debugWorkspace *ws, int *data)
   return (x86DoContinue(ws, data));
 } /* x86continueDebug() */
 
+/*
+x86profileDebug()
+  Sample the debugged process: it is continued, and after each
+interval we stop it with SIGSTOP, record the instruction pointer
+and a short frame pointer (ebp) chain of return addresses, and
+resume it at once. Breakpoints are not inserted while profiling,
+so the program runs undisturbed between samples.
+
+Inputs: ws       - debug workspace
+        duration - how long to profile (microseconds)
+        interval - time between samples (microseconds)
+        callback - routine called with each sample
+        args     - passed to callback
+        data     - modified to contain info depending on the return
+                   result, see x86continueDebug()
+
+Return: 1 if the whole duration was sampled - the process is left
+          stopped after the last sample
+        otherwise same as x86continueDebug()
+
+Side effects: If the process stops for another reason just as we
+              send SIGSTOP, our SIGSTOP remains pending and will be
+              reported when the process is next continued.
+*/
+
+int
+x86profileDebug(struct debugWorkspace *ws, long duration, long interval,
+                void (*callback)(void *, unsigned long *, int),
+                void *args, int *data)
+
+{
+  struct timeval start,
+                 now,
+                 tv;
+  unsigned long pcs[DB_PROFILE_MAXDEPTH];
+  unsigned long fp,
+                next;
+  long elapsed;
+  int depth;
+  int waitval;
+  int ret;
+  int err;
+
+  assert(ws->pid != NOPID);
+
+  dbSetRunning(ws);
+
+  /*
+   * Breakpoints stay out of the program while profiling, so the
+   * original instruction is in place even if we are sitting on
+   * a breakpoint - there is no need to step past it
+   */
+  dbClearHitBreakpoint(ws);
+
+  /*
+   * Nothing run from here on is recorded
+   */
+  clearRecord(ws);
+
+  if (ws->catch.pending)
+  {
+    ret = x86FinishSyscall(ws, data);
+    if (ret != 1)
+      return (ret);
+  }
+
+  gettimeofday(&start, 0);
+
+  while (1)
+  {
+    if (!x86flushRegistersDebug(ws))
+      return (0); /* something went wrong */
+
+    x86resumeWatch(ws);
+
+    if (ptrace(PT_CONTINUE, ws->pid, CONTADDR, ws->lastSignal) != 0)
+      return (0); /* something went wrong */
+
+    ws->lastSignal = 0;
+
+    tv.tv_sec = interval / 1000000;
+    tv.tv_usec = interval % 1000000;
+    select(0, 0, 0, 0, &tv);
+
+    kill(ws->pid, SIGSTOP);
+
+    waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+
+    err = 0;
+    ws->instructionPointer = x86getCurrentInstruction(ws, &err);
+
+    if (!WIFSTOPPED(waitval) || (WSTOPSIG(waitval) != SIGSTOP))
+    {
+      /*
+       * The process stopped on its own (signal, exit, etc)
+       */
+      if (x86CatchTrap(ws, waitval, data))
+      {
+        if (!ws->catch.log)
+          return (9);
+
+        ret = x86FinishSyscall(ws, data);
+        if (ret != 1)
+          return (ret);
+
+        continue;
+      }
+
+      if (x86CoverageTrap(ws, waitval, PT_CONTINUE, 0))
+        continue;
+
+      ret = x86WatchTrap(ws, &waitval, data);
+      if (ret == 1)
+        continue;
+      else if (ret == 2)
+        return (8);
+
+      ret = x86GetDebugProcessStatus(ws, PT_CONTINUE, waitval, data);
+      if ((ret == 2) && checkSignalPolicy(ws, *data))
+        continue;
+
+      if (ret != 1)
+        return (ret);
+
+      continue;
+    }
+
+    /*
+     * Walk the saved frame pointers: [ebp + 4] is the return
+     * address of the current frame and [ebp] is the caller's
+     * ebp. Stop at the first frame which does not look sane.
+     */
+    depth = 0;
+    pcs[depth++] = ws->instructionPointer;
+
+    fp = (unsigned long) x86readIntRegisterDebug(ws, REG_EBP);
+    while (fp && (depth < DB_PROFILE_MAXDEPTH))
+    {
+      errno = 0;
+      pcs[depth] = (unsigned long) PtraceRead(ws->pid, fp + 4, 0);
+      if (errno)
+        break;
+
+      ++depth;
+
+      next = (unsigned long) PtraceRead(ws->pid, fp, 0);
+      if (errno || (next <= fp))
+        break;
+
+      fp = next;
+    }
+
+    (*callback)(args, pcs, depth);
+
+    gettimeofday(&now, 0);
+    elapsed = (now.tv_sec - start.tv_sec) * 1000000 +
+              (now.tv_usec - start.tv_usec);
+
+    if (elapsed >= duration)
+      return (1);
+  } /* while (1) */
+} /* x86profileDebug() */
+
 /*
 x86attachDebug()
   Attach to a currently running process
@@ -753,13 +1567,22 @@ x86attachDebug(struct debugWorkspace *ws, int pid)
   if (ptrace(PT_ATTACH, pid, 0, 0) != 0)
     return (0); /* something went wrong */
 
-  wait(&waitval);
+  waitpid((pid_t) pid, &waitval, WAIT_TRACED);
 
   ws->pid = (pid_t) pid;
 
+  clearFastTracepoints(ws, 0);
+
+  /*
+   * A catch filter can only be put in a program we start
+   */
+  ws->catch.active = 0;
+  ws->catch.pending = 0;
+
   /*
    * Set the instruction pointer to the program's current position
    */
+  x86invalidateRegistersDebug(ws);
   err = 0;
   ws->instructionPointer = x86getCurrentInstruction(ws, &err);
   if (err)
@@ -799,10 +1622,20 @@ x86detachDebug(struct debugWorkspace *ws)
   if (!dbIsAttached(ws))
     return (-1);
 
+  /*
+   * The process would get a segmentation fault on its next write
+   * to a watched page
+   */
+  if (watchActive(ws))
+    x86removeWatch(ws, &(ws->watch));
+
+  if (!x86flushRegistersDebug(ws))
+    return (0); /* something went wrong */
+
   if (ptrace(PT_DETACH, ws->pid, 0, 0) != 0)
     return (0); /* something went wrong */
 
-  wait(&waitval);
+  waitpid(ws->pid, &waitval, WAIT_TRACED);
 
   pid = ws->pid;
 
@@ -833,73 +1666,228 @@ x86killDebug(struct debugWorkspace *ws)
     ret = ptrace(PT_KILL, ws->pid, 0, 0);
 
     if (ret == 0)
-      wait(&waitval);
+      waitpid(ws->pid, &waitval, WAIT_TRACED);
+
+    x86invalidateRegistersDebug(ws);
   }
 
   return (1);
 } /* x86killDebug() */
 
 /*
-x86saveBreakpoint()
-  Save the contents of a breakpoint's memory location, so we can restore it later
+x86forkDebug()
+  Make a stopped copy of a stopped, traced process by making it
+execute a fork() system call: the word at the current instruction
+is temporarily replaced with an INT 0x80 and eax is loaded with
+the fork syscall number. The new process is traced by us from
+birth (PTRACE_O_TRACEFORK) and is given the original registers and
+instruction, so it is an exact copy of the process as it was
+before the injection.
 
-Inputs: ws   - debug workspace
-        bptr - breakpoint structure containing info
+Inputs: ws  - debug workspace
+        pid - process to fork - the debugged process, or a previous
+              copy
 
-Return: 1 if successful
-        0 if not
+Return: pid of new (stopped) process
+        -1 upon failure
 */
 
-int
-x86saveBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr)
+pid_t
+x86forkDebug(struct debugWorkspace *ws, pid_t pid)
 
 {
-  int saved; /* saved instruction */
+#if defined(OS_LINUX) && defined(PT_SETOPTIONS) && defined(PT_GETEVENTMSG)
 
-  assert(bptr != 0);
-  assert(ws->pid != NOPID);
-
-#if 0
-  if (ws->pid == NOPID)
-  {
-    if (x86execDebug(ws) == 0)
-      return (0); /* something went wrong */
-  }
-#endif
+  struct user_regs_struct saved, /* registers before injection */
+                          regs;
+  unsigned long address;         /* address of injected syscall */
+  unsigned long msg;
+  long insn;                     /* original word at address */
+  int waitval;
+  int requeue;                   /* signal to send back to pid */
+  pid_t child;
 
   /*
-   * Save lowest byte of the dword at the break address
+   * Our copy of the debugged process' registers may hold changes
+   * which have not been written yet
    */
-  saved = PtraceRead(ws->pid, bptr->address, 0);
-  if (saved == (-1))
-    return (0); /* error - most likely EIO */
+  if ((pid == ws->pid) && !x86flushRegistersDebug(ws))
+    return (-1);
 
-  bptr->svdinsn = saved;
+  if (ptrace(PT_GETREGS, pid, 0, &saved) != 0)
+    return (-1);
 
-  return (1);
-} /* x86saveBreakpoint() */
+  address = (unsigned long) saved.eip;
 
-/*
-x86enableBreakpoint()
-  Enable breakpoint by setting the first byte of it's
-memory address to the breakpoint instruction
+  errno = 0;
+  insn = PtraceRead(pid, address, 0);
+  if (errno)
+    return (-1);
 
-Return: 1 if successful
-        0 if not
-*/
+  if (PtraceWrite(pid, address, (insn & ~0xFFFFL) | SYSCALL_INSN) != 0)
+    return (-1);
 
-int
-x86enableBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr)
+  regs = saved;
+  regs.eax = SYS_fork;
 
-{
-  int insn;
-  int data;
+  /*
+   * Make sure the kernel does not try to restart a system call the
+   * process may have been stopped in
+   */
+  regs.orig_eax = (-1);
 
-  assert(ws->pid != NOPID);
-  assert(bptr != 0);
+  child = (-1);
+  requeue = 0;
 
-  /*
-   * We must read the contents of bptr->address again, even though we have
+  if ((ptrace(PT_SETREGS, pid, 0, &regs) == 0) &&
+      (ptrace(PT_SETOPTIONS,
+              pid,
+              0,
+              PTRACE_O_TRACEFORK | x86ptraceOptions(ws)) == 0) &&
+      x86stepInjected(pid, &waitval))
+  {
+    /*
+     * A pending signal stops the process before the fork is made -
+     * a checkpoint gets a SIGCHLD each time one of its copies is
+     * killed. Keep the signal and try again.
+     */
+    while (WIFSTOPPED(waitval) && ((waitval >> 16) == 0) &&
+           (WSTOPSIG(waitval) != SIGTRAP))
+    {
+      x86deferSignal(ws, pid, WSTOPSIG(waitval), &requeue);
+
+      if (!x86stepInjected(pid, &waitval))
+        break;
+    }
+
+    if (WIFSTOPPED(waitval) && ((waitval >> 16) == PTRACE_EVENT_FORK))
+    {
+      if (ptrace(PT_GETEVENTMSG, pid, 0, &msg) == 0)
+        child = (pid_t) msg;
+
+      /*
+       * Finish the INT 0x80 instruction
+       */
+      if ((ptrace(PT_STEP, pid, CONTADDR, 0) == 0) &&
+          (waitpid(pid, &waitval, WAIT_TRACED) == pid) &&
+          WIFSTOPPED(waitval) && (WSTOPSIG(waitval) != SIGTRAP))
+        x86deferSignal(ws, pid, WSTOPSIG(waitval), &requeue);
+    }
+  }
+
+  /*
+   * Put the original process back the way it was
+   */
+  PtraceWrite(pid, address, insn);
+  ptrace(PT_SETREGS, pid, 0, &saved);
+  ptrace(PT_SETOPTIONS, pid, 0, x86ptraceOptions(ws));
+
+  if (requeue)
+    kill(pid, requeue);
+
+  if (child == (-1))
+    return (-1);
+
+  /*
+   * The child starts out with a SIGSTOP - collect it, then give it
+   * the state the parent had before we touched it. Its memory is a
+   * copy of the parent's at the time of the fork, so it still
+   * contains the syscall instruction.
+   */
+  if ((waitpid(child, &waitval, WAIT_TRACED) != child) ||
+      (PtraceWrite(child, address, insn) != 0) ||
+      (ptrace(PT_SETREGS, child, 0, &saved) != 0))
+  {
+    kill(child, SIGKILL);
+    waitpid(child, &waitval, WAIT_TRACED);
+    return (-1);
+  }
+
+  ptrace(PT_SETOPTIONS, child, 0, x86ptraceOptions(ws));
+
+  return (child);
+
+#else
+
+  /*
+   * Not supported on this platform
+   */
+  errno = ENOSYS;
+  return (-1);
+
+#endif /* OS_LINUX && PT_SETOPTIONS && PT_GETEVENTMSG */
+} /* x86forkDebug() */
+
+/*
+x86saveBreakpoint()
+  Save the contents of a breakpoint's memory location, so we can restore it later
+
+Inputs: ws   - debug workspace
+        bptr - breakpoint structure containing info
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+x86saveBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr)
+
+{
+  int saved; /* saved instruction */
+  struct coverageSite *site;
+
+  assert(bptr != 0);
+  assert(ws->pid != NOPID);
+
+#if 0
+  if (ws->pid == NOPID)
+  {
+    if (x86execDebug(ws) == 0)
+      return (0); /* something went wrong */
+  }
+#endif
+
+  /*
+   * Save lowest byte of the dword at the break address
+   */
+  saved = PtraceRead(ws->pid, bptr->address, 0);
+  if (saved == (-1))
+    return (0); /* error - most likely EIO */
+
+  /*
+   * If a coverage breakpoint sits here, save the real instruction
+   */
+  if (coverageActive(ws) &&
+      (site = findCoverageSite(&(ws->coverage), bptr->address)) &&
+      !site->hit)
+    saved = (saved & ~0xFF) | site->svdbyte;
+
+  bptr->svdinsn = saved;
+
+  return (1);
+} /* x86saveBreakpoint() */
+
+/*
+x86enableBreakpoint()
+  Enable breakpoint by setting the first byte of it's
+memory address to the breakpoint instruction
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+x86enableBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr)
+
+{
+  int insn;
+  int data;
+
+  assert(ws->pid != NOPID);
+  assert(bptr != 0);
+
+  /*
+   * We must read the contents of bptr->address again, even though we have
    * previously saved the contents of that location. The reason for this is
    * the following scenario: If we set 2 breakpoints, within 4 bytes of each other,
    * when we enable the first, we stick a 0xCC in the first byte of it's location.
@@ -942,18 +1930,237 @@ int
 x86disableBreakpoint(struct debugWorkspace *ws, struct Breakpoint *bptr)
 
 {
+  int data;
+
   assert(ws->pid != NOPID);
   assert(bptr != 0);
 
+  /*
+   * Only the first byte is ours - the rest of the word may have
+   * changed since the breakpoint was saved (other breakpoints or
+   * coverage sites nearby), so leave it alone
+   */
+  data = PtraceRead(ws->pid, bptr->address, 0);
+  if (data == (-1))
+    return (0); /* error - most likely EIO */
+
   /*
    * Replace the instruction with our saved instruction
    */
-  if (PtraceWrite(ws->pid, bptr->address, bptr->svdinsn) != 0)
+  data = (data & ~0x000000FF) | (bptr->svdinsn & 0x000000FF);
+
+  if (PtraceWrite(ws->pid, bptr->address, data) != 0)
     return (0);
 
   return (1);
 } /* x86disableBreakpoint() */
 
+/*
+x86readMemoryDebug()
+  Read a block of the debugged process' memory into a buffer. On
+Linux the block is read with a few large reads of /proc/<pid>/mem;
+whatever that cannot provide is read a word at a time with ptrace().
+
+Inputs: ws    - debug workspace
+        start - address to start reading
+        buf   - where to store the memory
+        bytes - number of bytes to read
+
+Return: number of bytes read - if this is less than 'bytes', the
+        memory following them could not be accessed (errno is set)
+*/
+
+long
+x86readMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                   unsigned char *buf, unsigned long bytes)
+
+{
+  unsigned long addr,
+                aligned;
+  unsigned int ii;
+  long ret;
+  ssize_t cnt;
+  int wordval;
+  int fd;
+
+  ret = 0;
+
+  fd = x86openProcMem(ws);
+  if (fd >= 0)
+  {
+    while ((unsigned long) ret < bytes)
+    {
+      cnt = pread(fd, buf + ret, bytes - ret, (off_t) (start + ret));
+      if (cnt <= 0)
+        break;
+
+      ret += cnt;
+    }
+
+    close(fd);
+  }
+
+  /*
+   * /proc may be unavailable, or unable to express the offset in
+   * an off_t - fall back to ptrace()
+   */
+  while ((unsigned long) ret < bytes)
+  {
+    addr = start + ret;
+    aligned = addr & ~((unsigned long) sizeof(int) - 1);
+
+    errno = 0;
+    wordval = PtraceRead(ws->pid, aligned, 0);
+    if (errno)
+      break;
+
+    for (ii = addr - aligned;
+         (ii < sizeof(int)) && ((unsigned long) ret < bytes);
+         ++ii)
+      buf[ret++] = (unsigned char) ((wordval >> (ii * 8)) & 0xff);
+  }
+
+  /*
+   * Show the program text, not our coverage breakpoints
+   */
+  if (coverageActive(ws))
+    hideCoverage(&(ws->coverage), buf, start, (unsigned long) ret);
+
+  return (ret);
+} /* x86readMemoryDebug() */
+
+/*
+x86writeMemoryDebug()
+  Write a buffer to the debugged process' memory. On Linux the
+buffer is written with /proc/<pid>/mem, which ignores page
+protections; whatever that cannot write is patched a word at a
+time with ptrace().
+
+Inputs: ws    - debug workspace
+        start - address to start writing
+        buf   - bytes to write
+        bytes - number of bytes to write
+
+Return: number of bytes written - if this is less than 'bytes', the
+        memory following them could not be accessed (errno is set)
+*/
+
+long
+x86writeMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                    unsigned char *buf, unsigned long bytes)
+
+{
+  unsigned long addr,
+                aligned;
+  unsigned int ii;
+  long ret;
+  ssize_t cnt;
+  int wordval;
+  int fd;
+
+  ret = 0;
+
+  fd = x86openProcMem(ws);
+  if (fd >= 0)
+  {
+    while ((unsigned long) ret < bytes)
+    {
+      cnt = pwrite(fd, buf + ret, bytes - ret, (off_t) (start + ret));
+      if (cnt <= 0)
+        break;
+
+      ret += cnt;
+    }
+
+    close(fd);
+  }
+
+  while ((unsigned long) ret < bytes)
+  {
+    addr = start + ret;
+    aligned = addr & ~((unsigned long) sizeof(int) - 1);
+
+    errno = 0;
+    wordval = PtraceRead(ws->pid, aligned, 0);
+    if (errno)
+      break;
+
+    for (ii = addr - aligned;
+         (ii < sizeof(int)) && ((unsigned long) ret < bytes);
+         ++ii, ++ret)
+    {
+      wordval &= ~(0xff << (ii * 8));
+      wordval |= (int) buf[ret] << (ii * 8);
+    }
+
+    if (PtraceWrite(ws->pid, aligned, wordval) != 0)
+    {
+      ret = addr - start;
+      break;
+    }
+  }
+
+  return (ret);
+} /* x86writeMemoryDebug() */
+
+/*
+x86traverseMapsDebug()
+  Call a function for every region of the debugged process' address
+space
+
+Inputs: ws       - debug workspace
+        callback - function to call:
+                   void callback(void *args, unsigned long start,
+                                 unsigned long end, char *perms);
+                   perms is a string like "r-xp"
+        args     - arguments to callback
+
+Return: 1 if successful
+        0 if the memory map is not available (errno is set)
+*/
+
+int
+x86traverseMapsDebug(struct debugWorkspace *ws,
+                     void (*callback)(void *, unsigned long, unsigned long,
+                                      char *),
+                     void *args)
+
+{
+#ifdef OS_LINUX
+
+  FILE *fp;
+  char path[MAXLINE];
+  char line[MAXLINE];
+  char perms[5];
+  unsigned long start,
+                end;
+
+  sprintf(path, "/proc/%d/maps", (int) ws->pid);
+
+  fp = fopen(path, "r");
+  if (!fp)
+    return (0);
+
+  while (fgets(line, sizeof(line), fp))
+  {
+    if (sscanf(line, "%lx-%lx %4s", &start, &end, perms) != 3)
+      continue;
+
+    (*callback)(args, start, end, perms);
+  }
+
+  fclose(fp);
+
+  return (1);
+
+#else
+
+  errno = ENOSYS;
+  return (0);
+
+#endif /* OS_LINUX */
+} /* x86traverseMapsDebug() */
+
 /*
 x86dumpMemoryDebug()
   Dump memory contents of debugged process
@@ -975,10 +2182,6 @@ x86dumpMemoryDebug(struct debugWorkspace *ws, unsigned char **buf,
                    unsigned long start, unsigned long bytes)
 
 {
-  int wordval;
-  unsigned long addr, /* current address we are examining */
-                end;  /* last address to examine */
-  unsigned char *bufptr;
   long ret;           /* return value */
 
   if (ws->pid == NOPID)
@@ -987,10 +2190,7 @@ x86dumpMemoryDebug(struct debugWorkspace *ws, unsigned char **buf,
       return (0); /* something went wrong */
   }
 
-  addr = start;
-
-  end = start + bytes;
-  if (end < start)
+  if ((start + bytes) < start)
     return (0); /* integer overflow */
 
   if ((bytes + 1) == 0)
@@ -1000,34 +2200,9 @@ x86dumpMemoryDebug(struct debugWorkspace *ws, unsigned char **buf,
   if (*buf == NULL)
     return (0);
 
-  bufptr = (unsigned char *) *buf;
-
-  ret = 0;
-
-  while (addr < end)
-  {
-    wordval = PtraceRead(ws->pid, addr, 0);
-    if ((wordval == (-1)) && (errno == EIO))
-    {
-      /*
-       * Input/output error
-       */
-      return (ret);
-    }
-
-    /*
-     * The ptrace() call will return a 2 byte (word) value on
-     * intel systems, and little-endian will put the byte at
-     * the address 'addr' last, so anding with 0xff will separate
-     * that byte.
-     */
-    *bufptr++ = (unsigned char) (wordval & 0xff);
+  ret = x86readMemoryDebug(ws, start, *buf, bytes);
 
-    ++addr;
-    ++ret;
-  } /* while (addr <= end) */
-
-  *bufptr = '\0';
+  (*buf)[ret] = '\0';
 
   return (ret);
 } /* x86dumpMemoryDebug() */
@@ -1114,3 +2289,1108 @@ x86setMemoryDebug(struct debugWorkspace *ws, unsigned long address, unsigned lon
 
   return (ret);
 } /* x86setMemoryDebug() */
+
+/*
+x86CoverageTrap()
+  Check whether the process stopped on one of our coverage
+breakpoints. If so, the original byte is put back for good, the
+site is marked as hit and eip is moved back to it, so the caller
+can resume the process as if nothing happened.
+
+Inputs: ws      - debug workspace
+        waitval - status of the stop
+        ptfunc  - how the process was resumed (PT_STEP, PT_STEPBLOCK
+                  or PT_CONTINUE)
+        start   - address the process was resumed from
+
+Return: 1 if the stop was caused by a coverage breakpoint
+        0 if not
+*/
+
+static int
+x86CoverageTrap(struct debugWorkspace *ws, int waitval, int ptfunc,
+                unsigned long start)
+
+{
+  struct coverageSite *site;
+  unsigned long addr;
+  int word;
+
+  if (!coverageActive(ws) ||
+      !WIFSTOPPED(waitval) ||
+      (WSTOPSIG(waitval) != SIGTRAP))
+    return (0);
+
+  addr = ws->instructionPointer - 1;
+
+  site = findCoverageSite(&(ws->coverage), addr);
+  if (!site || site->hit)
+    return (0);
+
+  /*
+   * A step which merely landed one byte past a site (a branch to
+   * the following address) also stops there - a single step only
+   * runs into our breakpoint if it started on it, and a block step
+   * reports breakpoint traps as coming from the kernel.
+   */
+  if ((ptfunc == PT_STEP) && (addr != start))
+    return (0);
+
+#ifdef PT_STEPBLOCK
+  if ((ptfunc == PT_STEPBLOCK) && (addr != start))
+  {
+    siginfo_t si;
+
+    if ((ptrace(PTRACE_GETSIGINFO, ws->pid, 0, &si) != 0) ||
+        (si.si_code != SI_KERNEL))
+      return (0);
+  }
+#endif /* PT_STEPBLOCK */
+
+  /*
+   * If the breakpoint instruction is gone, a user breakpoint at
+   * the same address was hit (and has been disabled again) - the
+   * block did execute, but the stop is the breakpoint's
+   */
+  errno = 0;
+  word = PtraceRead(ws->pid, addr, 0);
+  if (errno)
+    return (0);
+
+  site->hit = 1;
+  ++(ws->coverage.hits);
+
+  if ((word & 0xFF) != BRKPT_INSN)
+    return (0);
+
+  word = (word & ~0xFF) | site->svdbyte;
+  if (PtraceWrite(ws->pid, addr, word) != 0)
+    return (0);
+
+  x86setCurrentInstruction(ws, addr);
+
+  return (1);
+} /* x86CoverageTrap() */
+
+/*
+x86openProcMem()
+  Open the memory file of the debugged process
+
+Return: file descriptor, -1 if not available
+*/
+
+int
+x86openProcMem(struct debugWorkspace *ws)
+
+{
+#ifdef OS_LINUX
+
+  char path[MAXLINE];
+
+  sprintf(path, "/proc/%d/mem", (int) ws->pid);
+
+  return (open(path, O_RDWR));
+
+#else
+
+  errno = ENOSYS;
+  return (-1);
+
+#endif /* OS_LINUX */
+} /* x86openProcMem() */
+
+/*
+x86readCoverage()
+  Save the original byte of each coverage site. Sites which cannot
+be read, or which hold a breakpoint instruction already, are dropped.
+
+Inputs: ws  - debug workspace
+        cov - coverage list (sorted)
+*/
+
+static void
+x86readCoverage(struct debugWorkspace *ws, struct Coverage *cov)
+
+{
+  unsigned char *buf;
+  unsigned long first,
+                len,
+                ii,
+                count;
+  int fd;
+  int word;
+  unsigned char byte;
+
+  first = cov->sites[0].address;
+  len = cov->sites[cov->count - 1].address - first + 1;
+
+  /*
+   * Read the whole range at once if we can
+   */
+  buf = 0;
+  fd = x86openProcMem(ws);
+  if (fd >= 0)
+  {
+    buf = (unsigned char *) malloc(len);
+    if (buf && (pread(fd, buf, len, (off_t) first) != (ssize_t) len))
+    {
+      free(buf);
+      buf = 0;
+    }
+
+    close(fd);
+  }
+
+  count = 0;
+  for (ii = 0; ii < cov->count; ++ii)
+  {
+    if (buf)
+      byte = buf[cov->sites[ii].address - first];
+    else
+    {
+      errno = 0;
+      word = PtraceRead(ws->pid, cov->sites[ii].address, 0);
+      if (errno)
+        continue;
+
+      byte = (unsigned char) (word & 0xFF);
+    }
+
+    if (byte == BRKPT_INSN)
+      continue;
+
+    cov->sites[count] = cov->sites[ii];
+    cov->sites[count].svdbyte = byte;
+    cov->sites[count].hit = 0;
+    ++count;
+  }
+
+  cov->count = count;
+
+  if (buf)
+    free(buf);
+} /* x86readCoverage() */
+
+/*
+x86writeCoverage()
+  Write the breakpoint instruction (or the original byte) to every
+coverage site which has not been hit. On Linux the whole range is
+read and written back through /proc/<pid>/mem, which ignores page
+protections, so any number of sites costs a couple of system calls.
+Elsewhere, or should that fail, each site is patched with ptrace().
+
+Inputs: ws     - debug workspace
+        cov    - coverage list (sorted)
+        insert - 1 to insert breakpoints, 0 to restore
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+x86writeCoverage(struct debugWorkspace *ws, struct Coverage *cov, int insert)
+
+{
+  unsigned char *buf;
+  unsigned long first,
+                len,
+                ii;
+  struct coverageSite *site;
+  int fd;
+  int word;
+
+  if (cov->count == 0)
+    return (1);
+
+  first = cov->sites[0].address;
+  len = cov->sites[cov->count - 1].address - first + 1;
+
+  fd = x86openProcMem(ws);
+  if (fd >= 0)
+  {
+    buf = (unsigned char *) malloc(len);
+    if (buf && (pread(fd, buf, len, (off_t) first) == (ssize_t) len))
+    {
+      for (ii = 0; ii < cov->count; ++ii)
+      {
+        site = cov->sites + ii;
+        if (!site->hit)
+          buf[site->address - first] = insert ? BRKPT_INSN : site->svdbyte;
+      }
+
+      if (pwrite(fd, buf, len, (off_t) first) == (ssize_t) len)
+      {
+        free(buf);
+        close(fd);
+        return (1);
+      }
+    }
+
+    if (buf)
+      free(buf);
+
+    close(fd);
+  }
+
+  for (ii = 0; ii < cov->count; ++ii)
+  {
+    site = cov->sites + ii;
+    if (site->hit)
+      continue;
+
+    errno = 0;
+    word = PtraceRead(ws->pid, site->address, 0);
+    if (errno)
+      return (0);
+
+    word = (word & ~0xFF) | (insert ? BRKPT_INSN : site->svdbyte);
+
+    if (PtraceWrite(ws->pid, site->address, word) != 0)
+      return (0);
+  }
+
+  return (1);
+} /* x86writeCoverage() */
+
+/*
+x86insertCoverage()
+  Save the original bytes of the coverage sites and insert the
+breakpoint instructions
+
+Inputs: ws  - debug workspace
+        cov - coverage list (sorted)
+
+Return: 1 if successful
+        0 if not - nothing is left inserted in that case
+*/
+
+int
+x86insertCoverage(struct debugWorkspace *ws, struct Coverage *cov)
+
+{
+  if (cov->count == 0)
+    return (1);
+
+  x86readCoverage(ws, cov);
+
+  if (!x86writeCoverage(ws, cov, 1))
+  {
+    x86writeCoverage(ws, cov, 0);
+    return (0);
+  }
+
+  return (1);
+} /* x86insertCoverage() */
+
+/*
+x86removeCoverage()
+  Restore the original bytes of all coverage sites not hit yet
+
+Inputs: ws  - debug workspace
+        cov - coverage list
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+x86removeCoverage(struct debugWorkspace *ws, struct Coverage *cov)
+
+{
+  return (x86writeCoverage(ws, cov, 0));
+} /* x86removeCoverage() */
+
+/*
+x86syscallDebug()
+  Make the (stopped) debugged process execute a system call on our
+behalf, the same way x86forkDebug() does: an INT 0x80 is put at the
+current instruction and single stepped, then the original word and
+registers are put back. Our copy of the registers must not hold
+unwritten changes.
+
+Inputs: ws     - debug workspace
+        number - system call number
+        args   - X86_SYSCALL_MAXARGS arguments (ebx, ecx, edx, esi,
+                 edi, ebp)
+        result - where to store the return value (eax) of the call
+
+Return: 1 if the system call was made
+        0 if not (errno is set)
+*/
+
+int
+x86syscallDebug(struct debugWorkspace *ws, long number, long *args,
+                long *result)
+
+{
+#ifdef OS_LINUX
+
+  struct user_regs_struct saved, /* registers before injection */
+                          regs;
+  unsigned long address;         /* address of injected syscall */
+  long insn;                     /* original word at address */
+  int waitval;
+  int ret;
+
+  if (ptrace(PT_GETREGS, ws->pid, 0, &saved) != 0)
+    return (0);
+
+  address = (unsigned long) saved.eip;
+
+  errno = 0;
+  insn = PtraceRead(ws->pid, address, 0);
+  if (errno)
+    return (0);
+
+  if (PtraceWrite(ws->pid, address, (insn & ~0xFFFFL) | SYSCALL_INSN) != 0)
+    return (0);
+
+  regs = saved;
+  regs.eax = number;
+  regs.ebx = args[0];
+  regs.ecx = args[1];
+  regs.edx = args[2];
+  regs.esi = args[3];
+  regs.edi = args[4];
+  regs.ebp = args[5];
+  regs.orig_eax = (-1);
+
+  ret = 0;
+
+  if ((ptrace(PT_SETREGS, ws->pid, 0, &regs) == 0) &&
+      x86stepInjected(ws->pid, &waitval) &&
+      WIFSTOPPED(waitval))
+  {
+    if ((WSTOPSIG(waitval) == SIGTRAP) &&
+        (ptrace(PT_GETREGS, ws->pid, 0, &regs) == 0))
+    {
+      *result = (long) regs.eax;
+      ret = 1;
+    }
+    else if ((WSTOPSIG(waitval) != SIGTRAP) && !ws->lastSignal)
+    {
+      /*
+       * A signal arrived before the system call could run - keep
+       * it for the program
+       */
+      ws->lastSignal = WSTOPSIG(waitval);
+    }
+  }
+
+  PtraceWrite(ws->pid, address, insn);
+  ptrace(PT_SETREGS, ws->pid, 0, &saved);
+
+  if (!ret)
+    errno = EAGAIN;
+
+  return (ret);
+
+#else
+
+  errno = ENOSYS;
+  return (0);
+
+#endif /* OS_LINUX */
+} /* x86syscallDebug() */
+
+/*
+x86protectWatchPages()
+  Change the protection of watched pages in the debugged process by
+injecting mprotect() calls, one for each run of adjacent pages with
+the same original protection
+
+Inputs: ws      - debug workspace
+        pages   - pages to change (sorted)
+        npages  - number of pages
+        restore - if set, give the pages their original protection,
+                  otherwise make them read-only
+
+Return: 1 if successful
+        0 if not (errno is set)
+*/
+
+static int
+x86protectWatchPages(struct debugWorkspace *ws, struct watchPage *pages,
+                     unsigned long npages, int restore)
+
+{
+  unsigned long pagesize,
+                first,
+                ii;
+  long args[X86_SYSCALL_MAXARGS];
+  long result;
+  int prot;
+
+  pagesize = (unsigned long) sysconf(_SC_PAGESIZE);
+
+  for (first = 0; first < npages; first = ii)
+  {
+    for (ii = first + 1; ii < npages; ++ii)
+    {
+      if ((pages[ii].address != pages[ii - 1].address + pagesize) ||
+          (pages[ii].prot != pages[first].prot))
+        break;
+    }
+
+    prot = pages[first].prot;
+    if (!restore)
+      prot &= ~PROT_WRITE;
+
+    memset(args, '\0', sizeof(args));
+    args[0] = (long) pages[first].address;
+    args[1] = (long) ((ii - first) * pagesize);
+    args[2] = (long) prot;
+
+    if (!x86syscallDebug(ws, SYS_mprotect, args, &result))
+      return (0);
+
+    if (result < 0)
+    {
+      errno = (int) -result;
+      return (0);
+    }
+  }
+
+  return (1);
+} /* x86protectWatchPages() */
+
+/*
+x86mapWatchPages()
+  Called by x86traverseMapsDebug() - record the protection of the
+watched pages which lie in a region
+*/
+
+static void
+x86mapWatchPages(void *args, unsigned long start, unsigned long end,
+                 char *perms)
+
+{
+  struct Watch *pages;
+  unsigned long lo,
+                hi,
+                mid;
+  int prot;
+
+  pages = (struct Watch *) args;
+
+  prot = PROT_NONE;
+  if (perms[0] == 'r')
+    prot |= PROT_READ;
+  if (perms[1] == 'w')
+    prot |= PROT_WRITE;
+  if (perms[2] == 'x')
+    prot |= PROT_EXEC;
+
+  /*
+   * Find the first page at or above start
+   */
+  lo = 0;
+  hi = pages->npages;
+
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+
+    if (pages->pages[mid].address < start)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  for (; (lo < pages->npages) && (pages->pages[lo].address < end); ++lo)
+    pages->pages[lo].prot = prot;
+} /* x86mapWatchPages() */
+
+/*
+x86comparePages()
+  qsort() comparison - order watched pages by address
+*/
+
+static int
+x86comparePages(const void *a, const void *b)
+
+{
+  const struct watchPage *pa,
+                         *pb;
+
+  pa = (const struct watchPage *) a;
+  pb = (const struct watchPage *) b;
+
+  if (pa->address < pb->address)
+    return (-1);
+  else if (pa->address > pb->address)
+    return (1);
+
+  return (0);
+} /* x86comparePages() */
+
+/*
+x86insertWatch()
+  Work out which pages of the debugged process hold watched ranges
+and make them read-only, then record the current contents of the
+ranges. Pages which are not mapped yet, or which are not writable
+anyway, are left alone.
+
+Inputs: ws    - debug workspace
+        watch - watch list
+
+Return: 1 if successful
+        0 if not (errno is set) - nothing is left protected
+*/
+
+int
+x86insertWatch(struct debugWorkspace *ws, struct Watch *watch)
+
+{
+  struct Watch found;
+  struct Watchpoint *ptr;
+  struct watchPage *old;
+  unsigned long pagesize,
+                page,
+                last,
+                ii,
+                cnt;
+
+  if (!x86flushRegistersDebug(ws))
+    return (0);
+
+  pagesize = (unsigned long) sysconf(_SC_PAGESIZE);
+
+  cnt = 0;
+  for (ptr = watch->list; ptr; ptr = ptr->next)
+  {
+    page = ptr->address & ~(pagesize - 1);
+    last = (ptr->address + ptr->size - 1) & ~(pagesize - 1);
+    cnt += (last - page) / pagesize + 1;
+  }
+
+  memset(&found, '\0', sizeof(struct Watch));
+
+  if (cnt)
+  {
+    found.pages = (struct watchPage *) malloc(sizeof(struct watchPage) * cnt);
+    if (!found.pages)
+      return (0);
+  }
+
+  for (ptr = watch->list; ptr; ptr = ptr->next)
+  {
+    page = ptr->address & ~(pagesize - 1);
+    last = (ptr->address + ptr->size - 1) & ~(pagesize - 1);
+
+    while (1)
+    {
+      found.pages[found.npages].address = page;
+      found.pages[found.npages].prot = (-1);
+      ++found.npages;
+
+      if (page == last)
+        break;
+
+      page += pagesize;
+    }
+  }
+
+  if (found.npages)
+  {
+    qsort(found.pages,
+          found.npages,
+          sizeof(struct watchPage),
+          x86comparePages);
+  }
+
+  cnt = 0;
+  for (ii = 0; ii < found.npages; ++ii)
+  {
+    if ((cnt > 0) && (found.pages[cnt - 1].address == found.pages[ii].address))
+      continue;
+
+    found.pages[cnt++] = found.pages[ii];
+  }
+
+  found.npages = cnt;
+
+  x86traverseMapsDebug(ws, x86mapWatchPages, &found);
+
+  /*
+   * A restarted checkpoint is a copy of a process we protected, so
+   * the map shows our protection - the original one is in the old
+   * page list
+   */
+  cnt = 0;
+  for (ii = 0; ii < found.npages; ++ii)
+  {
+    old = findWatchPage(watch, found.pages[ii].address);
+    if (old && (found.pages[ii].prot != (-1)))
+      found.pages[ii].prot = old->prot;
+
+    if ((found.pages[ii].prot == (-1)) ||
+        !(found.pages[ii].prot & PROT_WRITE))
+      continue;
+
+    found.pages[cnt++] = found.pages[ii];
+  }
+
+  found.npages = cnt;
+
+  if (!x86protectWatchPages(ws, found.pages, found.npages, 0))
+  {
+    cnt = errno;
+    x86protectWatchPages(ws, found.pages, found.npages, 1);
+
+    if (found.pages)
+      free(found.pages);
+
+    errno = (int) cnt;
+    return (0);
+  }
+
+  if (watch->pages)
+    free(watch->pages);
+
+  watch->pages = found.pages;
+  watch->npages = found.npages;
+  watch->pid = ws->pid;
+
+  initWatchpoints(ws);
+
+  return (1);
+} /* x86insertWatch() */
+
+/*
+x86removeWatch()
+  Give the watched pages of the debugged process their original
+protection back. The page list is kept, see x86insertWatch().
+
+Inputs: ws    - debug workspace
+        watch - watch list
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+x86removeWatch(struct debugWorkspace *ws, struct Watch *watch)
+
+{
+  watch->pid = NOPID;
+
+  if (!x86flushRegistersDebug(ws))
+    return (0);
+
+  return (x86protectWatchPages(ws, watch->pages, watch->npages, 1));
+} /* x86removeWatch() */
+
+/*
+x86resumeWatch()
+  Called before the debugged process is resumed - protect the
+watched pages if this process does not have them protected yet
+(it was just started, attached to or restarted from a checkpoint).
+
+Inputs: ws - debug workspace
+*/
+
+static void
+x86resumeWatch(struct debugWorkspace *ws)
+
+{
+  if (ws->watch.list && (ws->watch.pid != ws->pid))
+    x86insertWatch(ws, &(ws->watch));
+} /* x86resumeWatch() */
+
+/*
+x86WatchTrap()
+  Check whether the process stopped because it wrote to one of our
+protected pages. If so, the page is made writable, the instruction
+is single stepped and the page is protected again, after which the
+watched ranges are compared with their previous contents.
+
+Inputs: ws      - debug workspace
+        waitval - status of the stop - replaced by the status of the
+                  single step if one was made
+        data    - modified to contain the watchpoint number if a
+                  watched range changed
+
+Return: 0 if the stop has nothing to do with watchpoints - waitval
+          is to be analyzed as usual
+        1 if the write was stepped and no watched range changed
+        2 if a watched range changed
+*/
+
+static int
+x86WatchTrap(struct debugWorkspace *ws, int *waitval, int *data)
+
+{
+#if defined(OS_LINUX) && defined(PTRACE_GETSIGINFO)
+
+  struct watchPage *pages[WATCH_MAXSTEP];
+  struct watchPage *page;
+  struct Watchpoint *hit;
+  unsigned long pc;
+  siginfo_t si;
+  int count,
+      ii;
+  int err;
+
+  if (!watchActive(ws) ||
+      !WIFSTOPPED(*waitval) ||
+      (WSTOPSIG(*waitval) != SIGSEGV))
+    return (0);
+
+  pc = ws->instructionPointer;
+  count = 0;
+
+  /*
+   * An instruction may write to two protected pages (an unaligned
+   * store across a page boundary) - each one faults in turn, without
+   * the instruction being executed
+   */
+  while (1)
+  {
+    if (ptrace(PTRACE_GETSIGINFO, ws->pid, 0, &si) != 0)
+      break;
+
+    if (si.si_code != SEGV_ACCERR)
+      break;
+
+    page = findWatchPage(&(ws->watch), (unsigned long) si.si_addr);
+    if (!page || (count == WATCH_MAXSTEP))
+      break;
+
+    if (!x86protectWatchPages(ws, page, 1, 1))
+      break;
+
+    pages[count++] = page;
+
+    if ((ptrace(PT_STEP, ws->pid, CONTADDR, 0) != 0) ||
+        (waitCaptureDebug(&(ws->capture), ws->pid, waitval) != ws->pid))
+      break;
+
+    if (!WIFSTOPPED(*waitval) || (WSTOPSIG(*waitval) != SIGSEGV))
+      break;
+  }
+
+  if (count == 0)
+    return (0);
+
+  x86invalidateRegistersDebug(ws);
+
+  if (!WIFSTOPPED(*waitval))
+    return (0); /* the process is gone */
+
+  for (ii = 0; ii < count; ++ii)
+    x86protectWatchPages(ws, pages[ii], 1, 0);
+
+  err = 0;
+  ws->instructionPointer = x86getCurrentInstruction(ws, &err);
+
+  /*
+   * The step itself may have been stopped by something else, such
+   * as a real segmentation fault
+   */
+  if (WSTOPSIG(*waitval) != SIGTRAP)
+    return (0);
+
+  hit = checkWatchpoints(ws, pc);
+  if (!hit)
+    return (1);
+
+  *data = (int) hit->number;
+
+  return (2);
+
+#else
+
+  return (0);
+
+#endif /* OS_LINUX && PTRACE_GETSIGINFO */
+} /* x86WatchTrap() */
+
+/*
+x86installCatchFilter()
+  Called by the child process before it execs the program: put in a
+seccomp filter which makes the kernel stop the program for us when
+it makes one of the system calls being caught. All other calls are
+allowed without a stop. This needs PR_SET_NO_NEW_PRIVS, so set-uid
+programs do not gain privileges while calls are being caught.
+
+Inputs: ws - debug workspace
+*/
+
+static void
+x86installCatchFilter(struct debugWorkspace *ws)
+
+{
+#ifdef CATCH_SECCOMP
+
+  struct sock_filter *filter;
+  struct sock_fprog prog;
+  int len,
+      ii;
+
+  filter = (struct sock_filter *) malloc(sizeof(struct sock_filter) *
+                                         (ws->catch.count * 2 + 5));
+  if (!filter)
+    return;
+
+  len = 0;
+
+  /*
+   * Let calls made through another ABI (int 0x80 from 64 bit
+   * code) through untouched - their numbers are not ours
+   */
+  filter[len++] = (struct sock_filter)
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch));
+  filter[len++] = (struct sock_filter)
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AUDIT_ARCH_I386, 1, 0);
+  filter[len++] = (struct sock_filter)
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+
+  filter[len++] = (struct sock_filter)
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr));
+
+  /*
+   * Each caught call jumps to a RET_TRACE right after its test;
+   * anything else skips it
+   */
+  for (ii = 0; ii < CATCH_MAXSYSCALL; ++ii)
+  {
+    if (!ws->catch.syscalls[ii])
+      continue;
+
+    filter[len++] = (struct sock_filter)
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (unsigned int) ii, 0, 1);
+    filter[len++] = (struct sock_filter)
+      BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_TRACE);
+  }
+
+  filter[len++] = (struct sock_filter)
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+
+  prog.len = (unsigned short) len;
+  prog.filter = filter;
+
+  /*
+   * If this fails the program simply runs without stopping for
+   * system calls - there is nobody to tell at this point
+   */
+  if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0)
+    prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog, 0, 0);
+
+  free(filter);
+
+#endif /* CATCH_SECCOMP */
+} /* x86installCatchFilter() */
+
+/*
+x86ptraceOptions()
+  Return the ptrace options the debugged process needs: a process
+with a catch filter must have PTRACE_O_TRACESECCOMP set, or the
+caught system calls fail with ENOSYS
+
+Inputs: ws - debug workspace
+
+Return: PTRACE_O_xxx bits
+*/
+
+static long
+x86ptraceOptions(struct debugWorkspace *ws)
+
+{
+#ifdef CATCH_SECCOMP
+
+  if (ws->catch.active)
+    return (PTRACE_O_TRACESECCOMP | PTRACE_O_TRACESYSGOOD);
+
+#endif /* CATCH_SECCOMP */
+
+  return (0);
+} /* x86ptraceOptions() */
+
+#ifdef OS_LINUX
+
+/*
+x86stepInjected()
+  Single step a system call we injected (see x86forkDebug()) and
+wait for it. If the call is one being caught, it first stops for
+the seccomp filter - it was not made by the program, so carry on.
+
+Inputs: pid     - process
+        waitval - where to store the status
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+x86stepInjected(pid_t pid, int *waitval)
+
+{
+  if ((ptrace(PT_STEP, pid, CONTADDR, 0) != 0) ||
+      (waitpid(pid, waitval, WAIT_TRACED) != pid))
+    return (0);
+
+#ifdef CATCH_SECCOMP
+
+  while (WIFSTOPPED(*waitval) &&
+         ((*waitval >> 16) == PTRACE_EVENT_SECCOMP))
+  {
+    if ((ptrace(PT_STEP, pid, CONTADDR, 0) != 0) ||
+        (waitpid(pid, waitval, WAIT_TRACED) != pid))
+      return (0);
+  }
+
+#endif /* CATCH_SECCOMP */
+
+  return (1);
+} /* x86stepInjected() */
+
+/*
+x86deferSignal()
+  Keep a signal which stopped a process while we were injecting a
+system call into it. The debugged process gets it the next time it
+is resumed, like any other signal. A checkpoint never runs, so the
+signal is sent back to it to stay pending - except SIGCHLD, which
+only reports the death of a copy we killed.
+
+Inputs: ws      - debug workspace
+        pid     - process which received the signal
+        sig     - signal
+        requeue - modified to contain the signal to send back to pid
+*/
+
+static void
+x86deferSignal(struct debugWorkspace *ws, pid_t pid, int sig, int *requeue)
+
+{
+  if (pid == ws->pid)
+  {
+    if (!ws->lastSignal)
+      ws->lastSignal = sig;
+  }
+  else if (sig != SIGCHLD)
+    *requeue = sig;
+} /* x86deferSignal() */
+
+#endif /* OS_LINUX */
+
+/*
+x86CatchTrap()
+  Check whether the process stopped because it made a system call
+being caught. If so, the call and its arguments are taken from the
+register cache, and the process is left stopped at the entry of the
+call: x86FinishSyscall() must be used to resume it.
+
+Inputs: ws      - debug workspace
+        waitval - status of the process
+        data    - modified to contain the system call number
+
+Return: 1 if the process stopped for a caught system call
+        0 if not
+*/
+
+static int
+x86CatchTrap(struct debugWorkspace *ws, int waitval, int *data)
+
+{
+#ifdef CATCH_SECCOMP
+
+  struct syscallEvent *event;
+  struct user_regs_struct *regs;
+
+  if (!ws->catch.active || !WIFSTOPPED(waitval) ||
+      ((waitval >> 16) != PTRACE_EVENT_SECCOMP))
+    return (0);
+
+  if (!x86getRegistersDebug(ws))
+    return (0);
+
+  regs = &(ws->regContents.Regs.regs);
+  event = &(ws->catch.event);
+
+  event->number = (int) regs->orig_eax;
+  event->args[0] = (long) regs->ebx;
+  event->args[1] = (long) regs->ecx;
+  event->args[2] = (long) regs->edx;
+  event->args[3] = (long) regs->esi;
+  event->args[4] = (long) regs->edi;
+  event->args[5] = (long) regs->ebp;
+  event->address = (unsigned long) regs->eip;
+  event->result = 0;
+  event->done = 0;
+
+  ws->catch.pending = 1;
+  *data = event->number;
+
+  return (1);
+
+#else
+
+  return (0);
+
+#endif /* CATCH_SECCOMP */
+} /* x86CatchTrap() */
+
+/*
+x86FinishSyscall()
+  Let the system call the process is stopped at (see x86CatchTrap())
+run, and report its return value through the notify callback. The
+process stops again right after the call returns. Registers changed
+while the process was stopped at the call are written first, so the
+arguments may be altered.
+
+Inputs: ws   - debug workspace
+        data - modified to contain info depending on the return
+               result
+
+Return: same as x86DoSingleStep()
+*/
+
+static int
+x86FinishSyscall(struct debugWorkspace *ws, int *data)
+
+{
+#ifdef CATCH_SECCOMP
+
+  struct syscallEvent *event;
+  int waitval;
+  int err;
+
+  ws->catch.pending = 0;
+
+  if (!x86flushRegistersDebug(ws))
+    return (0);
+
+  if (ptrace(PT_SYSCALL, ws->pid, CONTADDR, 0) != 0)
+    return (0);
+
+  waitCaptureDebug(&(ws->capture), ws->pid, &waitval);
+
+  err = 0;
+  ws->instructionPointer = x86getCurrentInstruction(ws, &err);
+
+  /*
+   * PTRACE_O_TRACESYSGOOD marks system call stops with 0x80
+   */
+  if (WIFSTOPPED(waitval) && (WSTOPSIG(waitval) == (SIGTRAP | 0x80)))
+  {
+    event = &(ws->catch.event);
+
+    event->result = (long) x86readIntRegisterDebug(ws, REG_EAX);
+    event->done = 1;
+
+    if (ws->catch.notify)
+      (*ws->catch.notify)(ws->catch.notifyArgs, event);
+
+    return (1);
+  }
+
+  return (x86GetDebugProcessStatus(ws, PT_STEP, waitval, data));
+
+#else
+
+  ws->catch.pending = 0;
+  return (1);
+
+#endif /* CATCH_SECCOMP */
+} /* x86FinishSyscall() */
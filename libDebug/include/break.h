@@ -36,12 +36,15 @@ struct Breakpoint
   int ignorecnt;
 
   int hitcnt;            /* number of times we hit this breakpoint */
+
+  struct traceCollect *collect; /* what a tracepoint collects */
 };
 
 #define BK_ENABLED      (1 << 0) /* breakpoint is activated */
 #define BK_TEMPORARY    (1 << 1) /* temporary breakpoint */
 #define BK_STEPOVER     (1 << 2) /* stepping over subroutine */
 #define BK_NOTSAVED     (1 << 3) /* we have not stored instruction in svdinsn yet */
+#define BK_TRACE        (1 << 4) /* tracepoint - collect and keep going */
 
 /*
  * Prototypes
@@ -52,6 +55,7 @@ struct debugWorkspace;
 void deleteBreakpoint(struct debugWorkspace *ws, struct Breakpoint *ptr);
 void clearBreakpoints(struct debugWorkspace *ws);
 void clearTemporaryBreakpoints(struct debugWorkspace *ws);
+void clearStepOverBreakpoints(struct debugWorkspace *ws);
 int newBreakpoint(struct debugWorkspace *ws, unsigned long address, unsigned int flags);
 int setAndSaveBreakpoint(struct debugWorkspace *ws, unsigned long address,
                          unsigned int flags);
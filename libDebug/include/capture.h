@@ -0,0 +1,60 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_capture_h
+#define INCLUDED_libDebug_capture_h
+
+#ifndef INCLUDED_sys_types_h
+#include <sys/types.h>          /* size_t */
+#define INCLUDED_sys_types_h
+#endif
+
+/*
+ * Initial and maximum sizes of the capture ring buffer. The buffer
+ * starts small and doubles whenever the debugged process writes more
+ * than the UI has consumed, up to CAPTURE_MAXSIZE - past that point
+ * the oldest output is discarded.
+ */
+#define CAPTURE_INITSIZE   4096
+#define CAPTURE_MAXSIZE    (1024 * 1024)
+
+struct outputCapture
+{
+  int fd;             /* read end of redirection pipe (-1 if none) */
+
+  char *buf;          /* ring buffer */
+  size_t size;        /* allocated size of buf */
+  size_t start;       /* index of oldest unread byte */
+  size_t count;       /* number of unread bytes */
+  size_t dropped;     /* bytes discarded since last read */
+
+  int logfd;          /* log file descriptor (-1 if none) */
+  int logpipe[2];     /* intermediate pipe for tee()/splice() */
+  int nosplice;       /* set if splicing to logfd is not possible */
+};
+
+/*
+ * Prototypes
+ */
+
+void initCaptureDebug(struct outputCapture *cap);
+void termCaptureDebug(struct outputCapture *cap);
+void startCaptureDebug(struct outputCapture *cap, int fd);
+long drainCaptureDebug(struct outputCapture *cap);
+pid_t waitCaptureDebug(struct outputCapture *cap, pid_t pid, int *waitval);
+void closeCaptureDebug(struct outputCapture *cap);
+size_t readCaptureDebug(struct outputCapture *cap, char *buf, size_t len,
+                        size_t *dropped);
+void setCaptureLogDebug(struct outputCapture *cap, int fd);
+
+#endif /* INCLUDED_libDebug_capture_h */
@@ -0,0 +1,77 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_catch_h
+#define INCLUDED_libDebug_catch_h
+
+/*
+ * System calls numbered below this may be caught
+ */
+#define CATCH_MAXSYSCALL  512
+
+/*
+ * Number of system call arguments
+ */
+#define CATCH_MAXARGS     6
+
+/*
+ * A system call made by the program
+ */
+struct syscallEvent
+{
+  int number;                   /* system call number */
+  long args[CATCH_MAXARGS];     /* arguments */
+  long result;                  /* return value, if done is set */
+  unsigned long address;        /* address following the call */
+  int done;                     /* the call has returned */
+};
+
+/*
+ * System calls to catch. They are selected by a seccomp filter put
+ * into the program when it is started, so that the kernel only stops
+ * it for those calls - all others run at full speed. When 'log' is
+ * set, each call and its return value are reported through the
+ * notify callback and the program keeps running; otherwise the
+ * program stops when it makes the call, and the return value is
+ * reported when it is continued.
+ */
+struct Catch
+{
+  unsigned char syscalls[CATCH_MAXSYSCALL]; /* 1 if caught */
+  int count;                    /* number of system calls caught */
+  int log;                      /* log instead of stopping */
+
+  int active;                   /* filter is in the current program */
+  int pending;                  /* stopped at entry of event */
+  struct syscallEvent event;    /* last call caught */
+
+  void (*notify)(void *, struct syscallEvent *); /* reports calls */
+  void *notifyArgs;             /* passed to notify */
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int catchSyscall(struct debugWorkspace *ws, int number, int on);
+void clearCatch(struct debugWorkspace *ws);
+int isCaughtSyscall(struct debugWorkspace *ws, int number);
+void setCatchLog(struct debugWorkspace *ws, int log);
+void setCatchNotify(struct debugWorkspace *ws,
+                    void (*notify)(void *, struct syscallEvent *),
+                    void *args);
+struct syscallEvent *getCatchEvent(struct debugWorkspace *ws);
+
+#endif /* INCLUDED_libDebug_catch_h */
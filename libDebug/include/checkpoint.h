@@ -0,0 +1,53 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_checkpoint_h
+#define INCLUDED_libDebug_checkpoint_h
+
+#ifndef INCLUDED_sys_types_h
+#include <sys/types.h>          /* pid_t */
+#define INCLUDED_sys_types_h
+#endif
+
+/*
+ * A checkpoint is a copy of the debugged process, forked off at the
+ * time the checkpoint was taken and kept stopped under ptrace. It is
+ * never run itself - restarting from a checkpoint forks it again and
+ * debugs the new copy, so one checkpoint can be restarted any number
+ * of times.
+ */
+struct Checkpoint
+{
+  struct Checkpoint *next, *prev;
+
+  unsigned int number;   /* checkpoint number */
+  pid_t pid;             /* pid of frozen process */
+  unsigned long address; /* instruction pointer when taken */
+  unsigned int flags;    /* DB_xxx state of the workspace when taken */
+  int lastSignal;        /* pending signal when taken */
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int newCheckpoint(struct debugWorkspace *ws);
+int restartCheckpoint(struct debugWorkspace *ws, struct Checkpoint *ptr);
+void deleteCheckpoint(struct debugWorkspace *ws, struct Checkpoint *ptr);
+void clearCheckpoints(struct debugWorkspace *ws);
+struct Checkpoint *findCheckpointByNumber(struct debugWorkspace *ws,
+                                          unsigned int number);
+
+#endif /* INCLUDED_libDebug_checkpoint_h */
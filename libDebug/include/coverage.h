@@ -0,0 +1,66 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_coverage_h
+#define INCLUDED_libDebug_coverage_h
+
+#ifndef INCLUDED_sys_types_h
+#include <sys/types.h>          /* pid_t */
+#define INCLUDED_sys_types_h
+#endif
+
+/*
+ * A coverage site is a one-shot breakpoint at the start of a basic
+ * block. Unlike a struct Breakpoint, it is written into the program
+ * once and stays there while the program runs; the first time it is
+ * hit the original byte is put back for good, so each block costs at
+ * most one trap.
+ */
+struct coverageSite
+{
+  unsigned long address;  /* block address */
+  unsigned char svdbyte;  /* original first byte of the block */
+  unsigned char hit;      /* set once the block has executed */
+};
+
+struct Coverage
+{
+  struct coverageSite *sites; /* sorted by address */
+  unsigned long count;        /* number of sites */
+  unsigned long hits;         /* number of sites hit */
+  pid_t pid;                  /* process the sites were inserted into */
+};
+
+/*
+ * Coverage sites are only meaningful in the process they were
+ * inserted into - a new run or a restarted checkpoint has its own
+ * copy of the text
+ */
+#define coverageActive(ws)  (((ws)->coverage.count != 0) && \
+                             ((ws)->coverage.pid == (ws)->pid))
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+long startCoverage(struct debugWorkspace *ws, unsigned long *addrs,
+                   unsigned long num);
+void clearCoverage(struct debugWorkspace *ws);
+struct coverageSite *findCoverageSite(struct Coverage *cov,
+                                      unsigned long address);
+void hideCoverage(struct Coverage *cov, unsigned char *buf,
+                  unsigned long start, unsigned long bytes);
+
+#endif /* INCLUDED_libDebug_coverage_h */
@@ -34,6 +34,46 @@
 #define INCLUDED_libDebug_break_h
 #endif
 
+#ifndef INCLUDED_libDebug_catch_h
+#include "catch.h"
+#define INCLUDED_libDebug_catch_h
+#endif
+
+#ifndef INCLUDED_libDebug_checkpoint_h
+#include "checkpoint.h"
+#define INCLUDED_libDebug_checkpoint_h
+#endif
+
+#ifndef INCLUDED_libDebug_capture_h
+#include "capture.h"
+#define INCLUDED_libDebug_capture_h
+#endif
+
+#ifndef INCLUDED_libDebug_coverage_h
+#include "coverage.h"
+#define INCLUDED_libDebug_coverage_h
+#endif
+
+#ifndef INCLUDED_libDebug_record_h
+#include "record.h"
+#define INCLUDED_libDebug_record_h
+#endif
+
+#ifndef INCLUDED_libDebug_sigpolicy_h
+#include "sigpolicy.h"
+#define INCLUDED_libDebug_sigpolicy_h
+#endif
+
+#ifndef INCLUDED_libDebug_tracepoint_h
+#include "tracepoint.h"
+#define INCLUDED_libDebug_tracepoint_h
+#endif
+
+#ifndef INCLUDED_libDebug_watch_h
+#include "watch.h"
+#define INCLUDED_libDebug_watch_h
+#endif
+
 #ifndef INCLUDED_libDebug_version_h
 #include "version.h"
 #define INCLUDED_libDebug_version_h
@@ -71,6 +111,26 @@
 #define INCLUDED_sub_x86_h
 #endif
 
+#ifndef INCLUDED_decode_x86_h
+#include "../arch/ix86/include/decode-x86.h"
+#define INCLUDED_decode_x86_h
+#endif
+
+#ifndef INCLUDED_emulate_x86_h
+#include "../arch/ix86/include/emulate-x86.h"
+#define INCLUDED_emulate_x86_h
+#endif
+
+#ifndef INCLUDED_fasttrace_x86_h
+#include "../arch/ix86/include/fasttrace-x86.h"
+#define INCLUDED_fasttrace_x86_h
+#endif
+
+#ifndef INCLUDED_syscalls_x86_h
+#include "../arch/ix86/include/syscalls-x86.h"
+#define INCLUDED_syscalls_x86_h
+#endif
+
 #ifndef INCLUDED_trace_x86_h
 #include "../arch/ix86/include/trace-x86.h"
 #define INCLUDED_trace_x86_h
@@ -87,6 +147,11 @@ typedef struct x86RegisterContents debugRegisterContents;
 #define MAXLINE   1024
 #endif
 
+/*
+ * Maximum number of stack frames recorded per profiler sample
+ */
+#define DB_PROFILE_MAXDEPTH  8
+
 struct debugRegisterInfo
 {
   char name[MAXLINE];               /* register name */
@@ -125,11 +190,28 @@ struct debugWorkspace
   unsigned long instructionPointer; /* address of next instruction to be executed */
 
   int pipes[2];                     /* file descriptors for redirected io */
+  struct outputCapture capture;     /* captured output of redirected io */
 
   struct Breakpoint *breakpoints;   /* list of breakpoints */
   unsigned int breakNumber;         /* used to assign breakpoint numbers */
 
+  struct Checkpoint *checkpoints;   /* list of checkpoints */
+  unsigned int checkpointNumber;    /* used to assign checkpoint numbers */
+
+  struct Coverage coverage;         /* one-shot block breakpoints */
+
+  struct Watch watch;               /* watchpoints */
+
+  struct Record record;             /* execution history for reverse steps */
+
+  struct x86MemoryMap memoryMap;    /* memory map, for emulated steps */
+
+  struct Trace trace;               /* frames collected by tracepoints */
+
   int lastSignal;                   /* last signal received */
+  struct sigPolicy sigpolicy;       /* what to do on each signal */
+
+  struct Catch catch;               /* system calls to catch */
 
   unsigned int flags;               /* bitmask (DB_xxx) */
 
@@ -192,6 +274,10 @@ void endDebug(struct debugWorkspace *ws);
 unsigned long getAddressDebug(struct debugWorkspace *ws);
 int isRunningDebug(struct debugWorkspace *ws);
 char *getOutputDebug(struct debugWorkspace *ws);
+size_t readOutputDebug(struct debugWorkspace *ws, char *buf, size_t len,
+                       size_t *dropped);
+void setOutputLogDebug(struct debugWorkspace *ws, int fd);
+void setRedirectDebug(struct debugWorkspace *ws, int redirect);
 char *getArgsDebug(struct debugWorkspace *ws);
 void setArgsDebug(struct debugWorkspace *ws, char *args);
 char *getPathDebug(struct debugWorkspace *ws);
@@ -200,12 +286,31 @@ int killDebug(struct debugWorkspace *ws);
 int printRegistersDebug(struct debugWorkspace *ws, int regindex, unsigned int flags,
                         void (*callback)(), void *callbackArgs);
 int stepIntoDebug(struct debugWorkspace *ws, int num, int *data);
+int stepBlockDebug(struct debugWorkspace *ws, int num, int *data);
 int stepOverDebug(struct debugWorkspace *ws, int num, int *data);
+int runToDebug(struct debugWorkspace *ws, unsigned long *addrs, int num,
+               unsigned long frame, int *data);
 int continueDebug(struct debugWorkspace *ws, int *data);
+int profileDebug(struct debugWorkspace *ws, long duration, long interval,
+                 void (*callback)(void *, unsigned long *, int),
+                 void *args, int *data);
 int findRegisterDebug(struct debugWorkspace *ws, char *name);
+char *getRegisterNameDebug(struct debugWorkspace *ws, int regindex);
+int findSyscallDebug(struct debugWorkspace *ws, char *name);
+char *getSyscallNameDebug(struct debugWorkspace *ws, int number);
+int getSyscallArgsDebug(struct debugWorkspace *ws, int number);
 int setRegisterDebug(struct debugWorkspace *ws, int regindex, char *value);
 long readRegisterDebug(struct debugWorkspace *ws, int regindex);
 int getFlagsDebug(struct debugWorkspace *ws, char *flags);
+int loadCoreRegistersDebug(struct debugWorkspace *ws, void *prstatus,
+                           size_t size, void *fpregs, size_t fpsize,
+                           int *sig);
+long readMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                     unsigned char *buf, unsigned long bytes);
+int traverseMapsDebug(struct debugWorkspace *ws,
+                      void (*callback)(void *, unsigned long, unsigned long,
+                                       char *),
+                      void *args);
 long dumpMemoryDebug(struct debugWorkspace *ws, unsigned char **buf,
                      unsigned long start, unsigned long bytes);
 int setMemoryDebug(struct debugWorkspace *ws, unsigned long address, unsigned long value);
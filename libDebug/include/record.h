@@ -0,0 +1,94 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_record_h
+#define INCLUDED_libDebug_record_h
+
+#ifndef INCLUDED_sys_types_h
+#include <sys/types.h>          /* pid_t */
+#define INCLUDED_sys_types_h
+#endif
+
+/*
+ * Default limit on the memory used to record execution history
+ */
+#define RECORD_DEFSIZE    (1024 * 1024)
+
+/*
+ * Smallest limit which may be set
+ */
+#define RECORD_MINSIZE    4096
+
+/*
+ * Number of general registers saved before each step
+ */
+#define RECORD_MAXREGS    16
+
+/*
+ * While recording is on, every instruction executed by a single step
+ * adds an entry to a ring buffer holding what the instruction
+ * changed: the previous values of the registers which differ
+ * afterwards, and the previous contents of the memory it was about to
+ * write to. Stepping backwards pops entries and puts those values
+ * back. When the buffer is full, the oldest entries are discarded.
+ *
+ * An entry is laid out as:
+ *
+ *   unsigned long length      - total length of the entry
+ *   unsigned long regmask     - bit n set if register n changed
+ *   unsigned long regs[]      - old values of the changed registers
+ *   { unsigned long address,
+ *     unsigned long size,
+ *     unsigned char bytes[] } - old memory contents, any number
+ *   unsigned long length      - repeated, so the buffer can be
+ *                               walked backwards
+ */
+struct Record
+{
+  int enabled;                  /* 1 if recording */
+  pid_t pid;                    /* process the history belongs to */
+
+  unsigned char *buf;           /* ring buffer */
+  unsigned long size;           /* size of buf */
+  unsigned long head;           /* offset of oldest entry */
+  unsigned long used;           /* bytes used */
+  unsigned long count;          /* number of entries */
+
+  unsigned long regs[RECORD_MAXREGS]; /* registers before the step */
+  unsigned char *entry;         /* memory saved before the step */
+  unsigned long entryLen;       /* bytes used in entry */
+  unsigned long entrySize;      /* size of entry */
+  int barrier;                  /* step cannot be undone */
+};
+
+/*
+ * The history is only meaningful for the process it was recorded in
+ */
+#define recordActive(ws)  (((ws)->record.enabled != 0) && \
+                           ((ws)->pid != NOPID))
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int setRecord(struct debugWorkspace *ws, int enabled);
+int setRecordSize(struct debugWorkspace *ws, unsigned long size);
+void clearRecord(struct debugWorkspace *ws);
+void beginRecord(struct debugWorkspace *ws);
+void endRecord(struct debugWorkspace *ws, int ret);
+long reverseRecord(struct debugWorkspace *ws, long num, int tobreak,
+                   int *data);
+
+#endif /* INCLUDED_libDebug_record_h */
@@ -0,0 +1,61 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_sigpolicy_h
+#define INCLUDED_libDebug_sigpolicy_h
+
+/*
+ * Signals numbered below this have a policy
+ */
+#define SP_MAXSIG    65
+
+/*
+ * Policy bits: stop the program and return to the caller, report
+ * the signal through the notify callback when not stopping, and
+ * deliver the signal to the program when it is resumed
+ */
+#define SP_STOP      (1 << 0)
+#define SP_PRINT     (1 << 1)
+#define SP_PASS      (1 << 2)
+
+#define SP_DEFAULT   (SP_STOP | SP_PRINT | SP_PASS)
+
+/*
+ * What to do when the program receives each signal. Signals which
+ * do not stop the program are dealt with inside the continue loop,
+ * without returning to the caller.
+ */
+struct sigPolicy
+{
+  unsigned char policy[SP_MAXSIG];  /* SP_xxx bits for each signal */
+  unsigned long count[SP_MAXSIG];   /* times received without stopping */
+
+  void (*notify)(void *, int);      /* called for SP_PRINT signals */
+  void *notifyArgs;                 /* passed to notify */
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+void initSignalPolicy(struct debugWorkspace *ws);
+int setSignalPolicy(struct debugWorkspace *ws, int sig, unsigned int policy);
+unsigned int getSignalPolicy(struct debugWorkspace *ws, int sig);
+unsigned long getSignalCount(struct debugWorkspace *ws, int sig);
+void setSignalNotify(struct debugWorkspace *ws, void (*notify)(void *, int),
+                     void *args);
+int checkSignalPolicy(struct debugWorkspace *ws, int sig);
+
+#endif /* INCLUDED_libDebug_sigpolicy_h */
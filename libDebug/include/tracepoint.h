@@ -0,0 +1,170 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_tracepoint_h
+#define INCLUDED_libDebug_tracepoint_h
+
+/*
+ * Default size of the buffer holding collected frames
+ */
+#define TRACE_DEFSIZE     (1024 * 1024)
+
+/*
+ * Smallest size which may be set
+ */
+#define TRACE_MINSIZE     4096
+
+/*
+ * Number of general registers which may be collected
+ */
+#define TRACE_MAXREGS     16
+
+/*
+ * Most memory ranges collected by one tracepoint, and the longest
+ * range
+ */
+#define TRACE_MAXMEM      8
+#define TRACE_MAXRANGE    256
+
+/*
+ * Size of the ring a fast tracepoint's program side writes to, and
+ * the most instruction bytes its jump may displace
+ */
+#define TRACE_FASTRING    (64 * 1024)
+#define TRACE_MAXDISPLACE 20
+
+/*
+ * A range of memory to collect: 'offset' bytes from the value of
+ * register 'base' at the time of the hit, or the absolute address
+ * 'offset' if base is -1
+ */
+struct traceRange
+{
+  int base;               /* REG_xxx or -1 */
+  long offset;            /* displacement or address */
+  unsigned long size;     /* number of bytes */
+};
+
+/*
+ * What a tracepoint collects each time it is hit
+ */
+struct traceCollect
+{
+  unsigned long regmask;  /* bit n set to collect register n */
+  int nmem;               /* number of ranges */
+  struct traceRange mem[TRACE_MAXMEM];
+};
+
+/*
+ * A fast tracepoint does not stop the program at all: the first
+ * instructions at its address are replaced by a jump to code we put
+ * into the program, which saves the registers and memory into a ring
+ * shared with us, runs the displaced instructions and jumps back.
+ * Frames are copied from the ring into the trace buffer when the
+ * buffer is examined. Fast tracepoints share the breakpoint numbers.
+ */
+struct fastTracepoint
+{
+  struct fastTracepoint *next, *prev;
+
+  unsigned int number;          /* tracepoint number */
+  unsigned long address;        /* instruction address */
+  unsigned long length;         /* bytes replaced by the jump */
+  unsigned char saved[TRACE_MAXDISPLACE]; /* original bytes */
+  struct traceCollect collect;  /* what to collect */
+
+  unsigned long code;           /* address of our code in the program */
+  unsigned long ringAddress;    /* address of the ring in the program */
+  unsigned char *ring;          /* the ring, as mapped by us */
+  unsigned long ringSize;       /* size of ring */
+  unsigned long slotSize;       /* size of one frame in the ring */
+  unsigned long nslots;         /* number of frames the ring holds */
+  unsigned long harvested;      /* frames copied out of the ring */
+};
+
+/*
+ * A tracepoint is a breakpoint (BK_TRACE) which does not stop the
+ * program: each hit appends a frame to a ring buffer holding the
+ * registers and memory asked for, and the program is resumed right
+ * away. When the buffer is full, the oldest frames are discarded.
+ *
+ * A frame is laid out as:
+ *
+ *   unsigned long length      - total length of the frame
+ *   unsigned long number      - tracepoint number
+ *   unsigned long sequence    - index among all frames collected
+ *   unsigned long address     - tracepoint address
+ *   unsigned long regmask     - registers collected
+ *   unsigned long regs[]      - their values
+ *   unsigned long nmem        - number of ranges
+ *   { unsigned long address,
+ *     unsigned long size,
+ *     unsigned char bytes[] } - memory collected, size is 0 if
+ *                               the range could not be read
+ */
+struct Trace
+{
+  unsigned char *buf;           /* ring buffer */
+  unsigned long size;           /* size of buf */
+  unsigned long head;           /* offset of oldest frame */
+  unsigned long used;           /* bytes used */
+  unsigned long count;          /* number of frames held */
+  unsigned long collected;      /* number of frames ever collected */
+  unsigned long dropped;        /* number of frames discarded */
+
+  struct fastTracepoint *fast;  /* list of fast tracepoints */
+};
+
+/*
+ * A frame as returned by readTraceFrame()
+ */
+struct traceFrame
+{
+  unsigned int number;          /* tracepoint number */
+  unsigned long sequence;       /* index among all frames collected */
+  unsigned long address;        /* tracepoint address */
+  unsigned long regmask;        /* registers collected */
+  unsigned long regs[TRACE_MAXREGS];
+  int nmem;                     /* number of ranges */
+  unsigned long memaddr[TRACE_MAXMEM];
+  unsigned long memsize[TRACE_MAXMEM];
+  unsigned char *membytes[TRACE_MAXMEM];  /* point into data */
+  unsigned char data[TRACE_MAXMEM * TRACE_MAXRANGE];
+};
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+struct Breakpoint;
+
+int newTracepoint(struct debugWorkspace *ws, unsigned long address,
+                  struct traceCollect *collect);
+int newFastTracepoint(struct debugWorkspace *ws, unsigned long address,
+                      unsigned long length, struct traceCollect *collect);
+void deleteFastTracepoint(struct debugWorkspace *ws,
+                          struct fastTracepoint *ptr, int restore);
+void clearFastTracepoints(struct debugWorkspace *ws, int restore);
+struct fastTracepoint *findFastTracepointByNumber(struct debugWorkspace *ws,
+                                                  unsigned int number);
+void syncTrace(struct debugWorkspace *ws);
+int setTraceSize(struct debugWorkspace *ws, unsigned long size);
+void clearTrace(struct debugWorkspace *ws);
+void freeTrace(struct debugWorkspace *ws);
+void addTraceFrame(struct debugWorkspace *ws, struct traceFrame *frame);
+void collectTrace(struct debugWorkspace *ws, struct Breakpoint *bptr);
+int readTraceFrame(struct debugWorkspace *ws, unsigned long *cursor,
+                   struct traceFrame *frame);
+
+#endif /* INCLUDED_libDebug_tracepoint_h */
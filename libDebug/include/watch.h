@@ -0,0 +1,90 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#ifndef INCLUDED_libDebug_watch_h
+#define INCLUDED_libDebug_watch_h
+
+#ifndef INCLUDED_sys_types_h
+#include <sys/types.h>          /* pid_t */
+#define INCLUDED_sys_types_h
+#endif
+
+/*
+ * A watchpoint stops the program when it writes to a range of
+ * memory. There is no limit on the number or length of the ranges:
+ * instead of using the processor's debug registers, the pages
+ * holding the ranges are made read-only in the debugged process, and
+ * each write fault is single stepped with the page made writable
+ * again, after which the ranges on the page are compared with their
+ * previous contents.
+ */
+struct Watchpoint
+{
+  struct Watchpoint *next, *prev;
+
+  unsigned int number;    /* watchpoint number - shared with breakpoints */
+  unsigned long address;  /* start of watched range */
+  unsigned long size;     /* length of watched range */
+  unsigned char *value;   /* contents of range when last checked */
+  unsigned char *old;     /* contents before the last change */
+  unsigned long changed;  /* offset of first byte changed */
+  unsigned long length;   /* number of bytes from there to the last change */
+  unsigned long pc;       /* address of instruction which changed it */
+  unsigned long hits;     /* number of times range was changed */
+};
+
+/*
+ * A page of the debugged process which holds part of a watched
+ * range and which we made read-only
+ */
+struct watchPage
+{
+  unsigned long address;  /* page address */
+  int prot;               /* original protection (PROT_xxx) */
+};
+
+struct Watch
+{
+  struct Watchpoint *list;  /* list of watchpoints */
+  struct watchPage *pages;  /* protected pages, sorted by address */
+  unsigned long npages;     /* number of pages */
+  pid_t pid;                /* process the pages were protected in */
+};
+
+/*
+ * Page protections are only in effect in the process they were
+ * applied to - a new run or a restarted checkpoint has them applied
+ * again the next time it is resumed
+ */
+#define watchActive(ws)  (((ws)->watch.list != 0) && \
+                          ((ws)->pid != NOPID) && \
+                          ((ws)->watch.pid == (ws)->pid))
+
+/*
+ * Prototypes
+ */
+
+struct debugWorkspace;
+
+int newWatchpoint(struct debugWorkspace *ws, unsigned long address,
+                  unsigned long size);
+void deleteWatchpoint(struct debugWorkspace *ws, struct Watchpoint *ptr);
+void clearWatchpoints(struct debugWorkspace *ws);
+struct Watchpoint *findWatchpointByNumber(struct debugWorkspace *ws,
+                                          unsigned int number);
+struct watchPage *findWatchPage(struct Watch *watch, unsigned long address);
+struct Watchpoint *checkWatchpoints(struct debugWorkspace *ws,
+                                    unsigned long pc);
+void initWatchpoints(struct debugWorkspace *ws);
+
+#endif /* INCLUDED_libDebug_watch_h */
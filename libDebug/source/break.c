@@ -59,6 +59,10 @@ deleteBreakpoint(struct debugWorkspace *ws, struct Breakpoint *ptr)
 
 {
   unlinkBreakpoint(ptr, &(ws->breakpoints));
+
+  if (ptr->collect)
+    free(ptr->collect);
+
   free(ptr);
 } /* deleteBreakpoint() */
 
@@ -130,6 +134,32 @@ clearTemporaryBreakpoints(struct debugWorkspace *ws)
   }
 } /* clearTemporaryBreakpoints() */
 
+/*
+clearStepOverBreakpoints()
+  Delete all breakpoints set internally to step over or run to an
+address (BK_STEPOVER) - used when the process stopped before
+reaching them
+*/
+
+void
+clearStepOverBreakpoints(struct debugWorkspace *ws)
+
+{
+  struct Breakpoint *ptr,
+                    *next;
+
+  ptr = ws->breakpoints;
+  while (ptr)
+  {
+    next = ptr->next;
+
+    if (ptr->flags & BK_STEPOVER)
+      deleteBreakpoint(ws, ptr);
+
+    ptr = next;
+  }
+} /* clearStepOverBreakpoints() */
+
 /*
 newBreakpoint()
 */
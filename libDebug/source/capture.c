@@ -0,0 +1,623 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+/*
+ * api_cfgDebug.h only contains #defines - include it first so we
+ * know whether to ask for the linux specific splice()/tee() calls
+ */
+#include "api_cfgDebug.h"
+
+#ifdef OS_LINUX
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+
+/*
+ * Do not include libDebug.h here: with _GNU_SOURCE, sys/wait.h
+ * pulls in the REG_xxx constants of sys/ucontext.h, which collide
+ * with the ones in regs-x86.h
+ */
+#include "capture.h"
+
+#if defined(OS_LINUX) && defined(SPLICE_F_NONBLOCK)
+#define CAPTURE_SPLICE
+#endif
+
+/*
+ * waitpid() option to wait for a traced process which is not our
+ * child - WAIT_TRACED of trace-x86.h, which we cannot include
+ */
+#ifdef OS_LINUX
+#define CAPTURE_WAIT  __WALL
+#else
+#define CAPTURE_WAIT  0
+#endif
+
+static size_t spaceCapture(struct outputCapture *cap, char **ptr);
+static long readPipeCapture(struct outputCapture *cap, int fd, size_t want);
+static void writeLogCapture(struct outputCapture *cap, char *ptr, size_t len);
+static void sigchldCapture(int sig);
+
+#ifdef CAPTURE_SPLICE
+static long spliceLogCapture(struct outputCapture *cap, int fd);
+#endif
+
+/*
+initCaptureDebug()
+  Initialize an output capture structure
+
+Inputs: cap - capture structure
+*/
+
+void
+initCaptureDebug(struct outputCapture *cap)
+
+{
+  memset(cap, '\0', sizeof(struct outputCapture));
+
+  cap->fd = (-1);
+  cap->logfd = (-1);
+  cap->logpipe[0] = (-1);
+  cap->logpipe[1] = (-1);
+} /* initCaptureDebug() */
+
+/*
+termCaptureDebug()
+  Free resources used by an output capture structure
+
+Inputs: cap - capture structure
+*/
+
+void
+termCaptureDebug(struct outputCapture *cap)
+
+{
+  closeCaptureDebug(cap);
+
+  if (cap->buf)
+    free(cap->buf);
+
+  if (cap->logpipe[0] >= 0)
+    close(cap->logpipe[0]);
+
+  if (cap->logpipe[1] >= 0)
+    close(cap->logpipe[1]);
+
+  initCaptureDebug(cap);
+} /* termCaptureDebug() */
+
+/*
+startCaptureDebug()
+  Begin capturing from the read end of a redirection pipe. Any
+pipe left over from a previous run is closed, but output which
+has not been read yet is kept.
+
+Inputs: cap - capture structure
+        fd  - read end of pipe - the capture structure takes
+              ownership of it
+*/
+
+void
+startCaptureDebug(struct outputCapture *cap, int fd)
+
+{
+  closeCaptureDebug(cap);
+
+  /*
+   * The pipe must never block us, since we drain it while waiting
+   * on the process
+   */
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  cap->fd = fd;
+} /* startCaptureDebug() */
+
+/*
+setCaptureLogDebug()
+  Set a file descriptor which will receive a copy of everything
+the debugged process writes
+
+Inputs: cap - capture structure
+        fd  - log file descriptor, or -1 to stop logging
+*/
+
+void
+setCaptureLogDebug(struct outputCapture *cap, int fd)
+
+{
+  cap->logfd = fd;
+  cap->nosplice = 0;
+} /* setCaptureLogDebug() */
+
+/*
+drainCaptureDebug()
+  Read everything currently sitting in the redirection pipe into
+the ring buffer, so the debugged process never blocks on a full
+pipe.
+
+Inputs: cap - capture structure
+
+Return: number of bytes drained, -1 upon end of file
+*/
+
+long
+drainCaptureDebug(struct outputCapture *cap)
+
+{
+  long total,
+       ret;
+  int fd;
+
+  fd = cap->fd;
+  if (fd < 0)
+    return (0);
+
+  total = 0;
+
+  while (1)
+  {
+    ret = (-1);
+
+#ifdef CAPTURE_SPLICE
+    if ((cap->logfd >= 0) && !cap->nosplice)
+    {
+      /*
+       * Duplicate the pending data straight into the log file and
+       * then consume exactly that many bytes for the ring buffer
+       */
+      ret = spliceLogCapture(cap, fd);
+      if (ret > 0)
+        ret = readPipeCapture(cap, fd, (size_t) ret);
+    }
+#endif /* CAPTURE_SPLICE */
+
+    if (ret < 0)
+      ret = readPipeCapture(cap, fd, 0);
+
+    if (ret == 0)
+      return (total ? total : (-1)); /* writer closed the pipe */
+    else if (ret < 0)
+      break;
+
+    total += ret;
+  }
+
+  return (total);
+} /* drainCaptureDebug() */
+
+/*
+waitCaptureDebug()
+  Wait for the debugged process to change state. If we are capturing
+its output, keep draining the pipe while we wait, otherwise a
+process which writes a lot could block forever on write() while we
+block forever on wait().
+
+Inputs: cap     - capture structure
+        pid     - process to wait on
+        waitval - where to store process status
+
+Return: pid of process which changed state, -1 upon error
+*/
+
+pid_t
+waitCaptureDebug(struct outputCapture *cap, pid_t pid, int *waitval)
+
+{
+  struct sigaction sa,
+                   oldsa;
+  sigset_t block,
+           oldmask,
+           waitmask;
+  fd_set rfds;
+  pid_t ret;
+  int fd;
+
+  fd = cap->fd;
+  if (fd < 0)
+    return (waitpid(pid, waitval, CAPTURE_WAIT));
+
+  /*
+   * The process stopping must wake us up as well as output does.
+   * SIGCHLD is blocked while we check on the process and only let
+   * through by pselect(), so a stop right after the check is not
+   * missed. It needs a handler, since it is ignored by default.
+   */
+  memset(&sa, '\0', sizeof(sa));
+  sa.sa_handler = sigchldCapture;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGCHLD, &sa, &oldsa);
+
+  sigemptyset(&block);
+  sigaddset(&block, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &block, &oldmask);
+
+  waitmask = oldmask;
+  sigdelset(&waitmask, SIGCHLD);
+
+  while (1)
+  {
+    if (drainCaptureDebug(cap) < 0)
+    {
+      /*
+       * The write end was closed (process exited or closed its
+       * stdout/stderr) - nothing more to drain, so just block
+       */
+      closeCaptureDebug(cap);
+      ret = waitpid(pid, waitval, CAPTURE_WAIT);
+      break;
+    }
+
+    ret = waitpid(pid, waitval, WNOHANG | CAPTURE_WAIT);
+    if (ret != 0)
+    {
+      /*
+       * Pick up anything written right before the process stopped
+       */
+      drainCaptureDebug(cap);
+      break;
+    }
+
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+
+    pselect(fd + 1, &rfds, 0, 0, 0, &waitmask);
+  }
+
+  sigprocmask(SIG_SETMASK, &oldmask, 0);
+  sigaction(SIGCHLD, &oldsa, 0);
+
+  return (ret);
+} /* waitCaptureDebug() */
+
+/*
+closeCaptureDebug()
+  Drain and close the redirection pipe. Output already captured
+stays in the ring buffer until it is read.
+
+Inputs: cap - capture structure
+*/
+
+void
+closeCaptureDebug(struct outputCapture *cap)
+
+{
+  if (cap->fd < 0)
+    return;
+
+  drainCaptureDebug(cap);
+  close(cap->fd);
+  cap->fd = (-1);
+} /* closeCaptureDebug() */
+
+/*
+readCaptureDebug()
+  Consume captured output which has not been read yet
+
+Inputs: cap     - capture structure
+        buf     - where to store output
+        len     - size of buf
+        dropped - modified to contain number of bytes which were
+                  discarded because the ring buffer overflowed
+                  since the last call
+
+Return: number of bytes stored in buf
+*/
+
+size_t
+readCaptureDebug(struct outputCapture *cap, char *buf, size_t len,
+                 size_t *dropped)
+
+{
+  size_t n,
+         first;
+
+  if (dropped)
+  {
+    *dropped = cap->dropped;
+    cap->dropped = 0;
+  }
+
+  n = (len < cap->count) ? len : cap->count;
+  if (n == 0)
+    return (0);
+
+  first = cap->size - cap->start;
+  if (first > n)
+    first = n;
+
+  memcpy(buf, cap->buf + cap->start, first);
+  memcpy(buf + first, cap->buf, n - first);
+
+  cap->start = (cap->start + n) % cap->size;
+  cap->count -= n;
+
+  return (n);
+} /* readCaptureDebug() */
+
+/*******************************************************
+ *                 INTERNAL ROUTINES                   *
+ *******************************************************/
+
+/*
+spaceCapture()
+  Find the largest contiguous free region at the tail of the ring
+buffer, growing the buffer or discarding old output if needed
+
+Inputs: cap - capture structure
+        ptr - modified to point to free region
+
+Return: size of free region (0 upon malloc failure)
+*/
+
+static size_t
+spaceCapture(struct outputCapture *cap, char **ptr)
+
+{
+  size_t tail,
+         newsize,
+         n;
+  char *newbuf;
+
+  if (cap->count == 0)
+    cap->start = 0;
+
+  if (cap->count == cap->size)
+  {
+    newbuf = 0;
+    newsize = cap->size ? cap->size * 2 : CAPTURE_INITSIZE;
+
+    if (newsize <= CAPTURE_MAXSIZE)
+      newbuf = (char *) malloc(newsize);
+
+    if (newbuf)
+    {
+      /*
+       * Linearize the unread data into the new buffer
+       */
+      n = cap->size - cap->start;
+      if (n > cap->count)
+        n = cap->count;
+
+      if (cap->count)
+      {
+        memcpy(newbuf, cap->buf + cap->start, n);
+        memcpy(newbuf + n, cap->buf, cap->count - n);
+      }
+
+      if (cap->buf)
+        free(cap->buf);
+
+      cap->buf = newbuf;
+      cap->size = newsize;
+      cap->start = 0;
+    }
+    else if (cap->size == 0)
+      return (0);
+    else
+    {
+      /*
+       * At the size limit - throw away the oldest chunk
+       */
+      n = (cap->count < CAPTURE_INITSIZE) ? cap->count : CAPTURE_INITSIZE;
+      cap->start = (cap->start + n) % cap->size;
+      cap->count -= n;
+      cap->dropped += n;
+    }
+  }
+
+  tail = (cap->start + cap->count) % cap->size;
+  *ptr = cap->buf + tail;
+
+  if (tail >= cap->start && cap->count < cap->size)
+    return (cap->size - tail);
+
+  return (cap->start - tail);
+} /* spaceCapture() */
+
+/*
+readPipeCapture()
+  Read from the redirection pipe directly into the ring buffer
+
+Inputs: cap  - capture structure
+        fd   - pipe descriptor (non-blocking)
+        want - number of bytes to read (0 means as much as possible)
+
+Return: number of bytes read
+        0 upon end of file
+        -1 if no data is available
+*/
+
+static long
+readPipeCapture(struct outputCapture *cap, int fd, size_t want)
+
+{
+  long total;
+  ssize_t ret;
+  size_t space;
+  char *ptr;
+
+  total = 0;
+
+  do
+  {
+    space = spaceCapture(cap, &ptr);
+    if (space == 0)
+      return (total ? total : (-1));
+
+    if (want && (space > want - total))
+      space = want - total;
+
+    ret = read(fd, ptr, space);
+    if (ret == 0)
+      return (total);
+    else if (ret < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return (total ? total : (-1));
+    }
+
+    cap->count += ret;
+
+    /*
+     * If the data was not already spliced into the log, copy it
+     * there ourselves
+     */
+    if (!want)
+      writeLogCapture(cap, ptr, (size_t) ret);
+
+    total += ret;
+  } while (want ? ((size_t) total < want) : ((size_t) ret == space));
+
+  return (total);
+} /* readPipeCapture() */
+
+/*
+writeLogCapture()
+  Append captured output to the log file, if any
+
+Inputs: cap - capture structure
+        ptr - data
+        len - length of data
+*/
+
+static void
+writeLogCapture(struct outputCapture *cap, char *ptr, size_t len)
+
+{
+  ssize_t ret;
+
+  if (cap->logfd < 0)
+    return;
+
+  while (len > 0)
+  {
+    ret = write(cap->logfd, ptr, len);
+    if (ret <= 0)
+    {
+      if ((ret < 0) && (errno == EINTR))
+        continue;
+
+      return;
+    }
+
+    ptr += ret;
+    len -= ret;
+  }
+} /* writeLogCapture() */
+
+/*
+sigchldCapture()
+  SIGCHLD handler used while waiting on the process - the signal
+only has to interrupt pselect()
+*/
+
+static void
+sigchldCapture(int sig)
+
+{
+} /* sigchldCapture() */
+
+#ifdef CAPTURE_SPLICE
+
+/*
+spliceLogCapture()
+  Duplicate pending pipe data into the log file without copying it
+through our address space: tee() the redirection pipe into an
+intermediate pipe (which does not consume it), then splice() the
+intermediate pipe into the log file.
+
+Inputs: cap - capture structure
+        fd  - redirection pipe (read end)
+
+Return: number of bytes written to the log (and still sitting in fd)
+        -1 if nothing was logged - the caller should fall back
+        to read() and write()
+*/
+
+static long
+spliceLogCapture(struct outputCapture *cap, int fd)
+
+{
+  ssize_t nteed,
+          ret;
+  size_t left;
+
+  if (cap->logpipe[0] < 0)
+  {
+    if (pipe(cap->logpipe) == (-1))
+    {
+      cap->nosplice = 1;
+      return (-1);
+    }
+  }
+
+  nteed = tee(fd, cap->logpipe[1], CAPTURE_MAXSIZE, SPLICE_F_NONBLOCK);
+  if (nteed <= 0)
+  {
+    if ((nteed < 0) && (errno != EAGAIN))
+      cap->nosplice = 1;
+
+    return (-1);
+  }
+
+  left = (size_t) nteed;
+  while (left > 0)
+  {
+    ret = splice(cap->logpipe[0], 0, cap->logfd, 0, left, SPLICE_F_MOVE);
+    if (ret <= 0)
+    {
+      char tmp[4096];
+
+      /*
+       * The log file does not support splicing (or the write
+       * failed) - empty the intermediate pipe by hand and stop
+       * using splice() for this log
+       */
+      cap->nosplice = 1;
+      while (left > 0)
+      {
+        ret = read(cap->logpipe[0], tmp,
+                   (left < sizeof(tmp)) ? left : sizeof(tmp));
+        if (ret <= 0)
+          break;
+
+        writeLogCapture(cap, tmp, (size_t) ret);
+        left -= ret;
+      }
+
+      break;
+    }
+
+    left -= ret;
+  }
+
+  return ((long) nteed);
+} /* spliceLogCapture() */
+
+#endif /* CAPTURE_SPLICE */
@@ -0,0 +1,140 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+
+#include "catch.h"
+#include "libDebug.h"
+
+/*
+catchSyscall()
+  Start or stop catching a system call. The change takes effect the
+next time the program is started.
+
+Inputs: ws     - debug workspace
+        number - system call number
+        on     - 1 to catch, 0 to stop catching
+
+Return: 1 if successful
+        0 if the number is invalid (errno is EINVAL)
+*/
+
+int
+catchSyscall(struct debugWorkspace *ws, int number, int on)
+
+{
+  if ((number < 0) || (number >= CATCH_MAXSYSCALL))
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  if (on && !ws->catch.syscalls[number])
+    ++(ws->catch.count);
+  else if (!on && ws->catch.syscalls[number])
+    --(ws->catch.count);
+
+  ws->catch.syscalls[number] = on ? 1 : 0;
+
+  return (1);
+} /* catchSyscall() */
+
+/*
+clearCatch()
+  Stop catching all system calls
+
+Inputs: ws - debug workspace
+*/
+
+void
+clearCatch(struct debugWorkspace *ws)
+
+{
+  int ii;
+
+  for (ii = 0; ii < CATCH_MAXSYSCALL; ++ii)
+    ws->catch.syscalls[ii] = 0;
+
+  ws->catch.count = 0;
+} /* clearCatch() */
+
+/*
+isCaughtSyscall()
+  Determine whether a system call is caught
+
+Inputs: ws     - debug workspace
+        number - system call number
+
+Return: 1 if so, 0 if not
+*/
+
+int
+isCaughtSyscall(struct debugWorkspace *ws, int number)
+
+{
+  if ((number < 0) || (number >= CATCH_MAXSYSCALL))
+    return (0);
+
+  return (ws->catch.syscalls[number]);
+} /* isCaughtSyscall() */
+
+/*
+setCatchLog()
+  Set whether caught system calls are logged (the program keeps
+running) or stop the program
+
+Inputs: ws  - debug workspace
+        log - 1 to log, 0 to stop
+*/
+
+void
+setCatchLog(struct debugWorkspace *ws, int log)
+
+{
+  ws->catch.log = log;
+} /* setCatchLog() */
+
+/*
+setCatchNotify()
+  Set the function caught system calls are reported through
+
+Inputs: ws     - debug workspace
+        notify - callback function:
+                   void notify(void *args, struct syscallEvent *event);
+                 event->done is 0 for a call which is being made, 1
+                 for one which returned event->result
+        args   - passed to notify
+*/
+
+void
+setCatchNotify(struct debugWorkspace *ws,
+               void (*notify)(void *, struct syscallEvent *), void *args)
+
+{
+  ws->catch.notify = notify;
+  ws->catch.notifyArgs = args;
+} /* setCatchNotify() */
+
+/*
+getCatchEvent()
+  Return the system call the program last stopped at
+
+Inputs: ws - debug workspace
+*/
+
+struct syscallEvent *
+getCatchEvent(struct debugWorkspace *ws)
+
+{
+  return (&(ws->catch.event));
+} /* getCatchEvent() */
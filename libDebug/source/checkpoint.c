@@ -0,0 +1,235 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "break.h"
+#include "checkpoint.h"
+#include "libDebug.h"
+
+static struct Checkpoint *createCheckpoint(struct debugWorkspace *ws);
+static void unlinkCheckpoint(struct Checkpoint *ptr,
+                             struct Checkpoint **list);
+
+/*
+createCheckpoint()
+  Create a Checkpoint structure
+*/
+
+static struct Checkpoint *
+createCheckpoint(struct debugWorkspace *ws)
+
+{
+  struct Checkpoint *ptr;
+
+  ptr = (struct Checkpoint *) malloc(sizeof(struct Checkpoint));
+  if (!ptr)
+    return (0);
+
+  memset(ptr, '\0', sizeof(struct Checkpoint));
+
+  ptr->prev = 0;
+  ptr->next = ws->checkpoints;
+  if (ptr->next)
+    ptr->next->prev = ptr;
+
+  ws->checkpoints = ptr;
+
+  return (ptr);
+} /* createCheckpoint() */
+
+/*
+unlinkCheckpoint()
+  Unlink checkpoint from linked list
+
+Inputs: ptr  - structure to unlink
+        list - list to unlink from
+*/
+
+static void
+unlinkCheckpoint(struct Checkpoint *ptr, struct Checkpoint **list)
+
+{
+  assert(ptr != 0);
+
+  if (ptr->next)
+    ptr->next->prev = ptr->prev;
+
+  if (ptr->prev)
+    ptr->prev->next = ptr->next;
+  else
+    *list = ptr->next;
+} /* unlinkCheckpoint() */
+
+/*
+newCheckpoint()
+  Take a checkpoint of the (stopped) debugged process
+
+Inputs: ws - debug workspace
+
+Return: number of new checkpoint
+        -1 if the process could not be forked (errno is set)
+*/
+
+int
+newCheckpoint(struct debugWorkspace *ws)
+
+{
+  struct Checkpoint *ptr;
+  pid_t pid;
+
+  assert(ws->pid != NOPID);
+
+  pid = x86forkDebug(ws, ws->pid);
+  if (pid == (-1))
+    return (-1);
+
+  ptr = createCheckpoint(ws);
+  if (!ptr)
+  {
+    kill(pid, SIGKILL);
+    waitpid(pid, 0, WAIT_TRACED);
+    return (-1);
+  }
+
+  ptr->number = ws->checkpointNumber++;
+  ptr->pid = pid;
+  ptr->address = ws->instructionPointer;
+  ptr->flags = ws->flags & DB_HITBREAKPOINT;
+  ptr->lastSignal = ws->lastSignal;
+
+  return ((int) ptr->number);
+} /* newCheckpoint() */
+
+/*
+restartCheckpoint()
+  Replace the debugged process with a fresh copy of a checkpoint.
+The checkpoint itself stays frozen so it may be restarted again.
+Breakpoints are kept - the copy has the same text, so their saved
+instructions remain valid.
+
+Inputs: ws  - debug workspace
+        ptr - checkpoint to restart from
+
+Return: 1 if successful
+        0 if not (the current process is left alone)
+*/
+
+int
+restartCheckpoint(struct debugWorkspace *ws, struct Checkpoint *ptr)
+
+{
+  pid_t pid;
+  int err;
+
+  assert(ptr != 0);
+
+  pid = x86forkDebug(ws, ptr->pid);
+  if (pid == (-1))
+    return (0);
+
+  if (ws->pid != NOPID)
+  {
+    x86killDebug(ws);
+    clearTemporaryBreakpoints(ws);
+  }
+
+  ws->pid = pid;
+  ws->lastSignal = ptr->lastSignal;
+  ws->catch.pending = 0;
+  x86invalidateRegistersDebug(ws);
+
+  dbClearHitBreakpoint(ws);
+  ws->flags |= ptr->flags;
+
+  err = 0;
+  ws->instructionPointer = x86getCurrentInstruction(ws, &err);
+  if (err)
+  {
+    x86killDebug(ws);
+    ws->pid = NOPID;
+    dbClearRunning(ws);
+    return (0);
+  }
+
+  dbSetRunning(ws);
+
+  return (1);
+} /* restartCheckpoint() */
+
+/*
+deleteCheckpoint()
+  Kill the frozen process and remove checkpoint from list
+*/
+
+void
+deleteCheckpoint(struct debugWorkspace *ws, struct Checkpoint *ptr)
+
+{
+  kill(ptr->pid, SIGKILL);
+  waitpid(ptr->pid, 0, WAIT_TRACED);
+
+  unlinkCheckpoint(ptr, &(ws->checkpoints));
+  free(ptr);
+} /* deleteCheckpoint() */
+
+/*
+clearCheckpoints()
+  Delete all checkpoints
+*/
+
+void
+clearCheckpoints(struct debugWorkspace *ws)
+
+{
+  struct Checkpoint *ptr,
+                    *next;
+
+  ptr = ws->checkpoints;
+  while (ptr)
+  {
+    next = ptr->next;
+    deleteCheckpoint(ws, ptr);
+    ptr = next;
+  }
+} /* clearCheckpoints() */
+
+/*
+findCheckpointByNumber()
+  Find a certain checkpoint structure
+
+Inputs: ws     - debug workspace
+        number - checkpoint number
+
+Return: pointer to Checkpoint structure
+*/
+
+struct Checkpoint *
+findCheckpointByNumber(struct debugWorkspace *ws, unsigned int number)
+
+{
+  struct Checkpoint *ptr;
+
+  for (ptr = ws->checkpoints; ptr; ptr = ptr->next)
+  {
+    if (ptr->number == number)
+      return (ptr);
+  }
+
+  return (0);
+} /* findCheckpointByNumber() */
@@ -0,0 +1,225 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "break.h"
+#include "coverage.h"
+#include "libDebug.h"
+
+static int compareSites(const void *a, const void *b);
+
+/*
+compareSites()
+  qsort() comparison - order coverage sites by address
+*/
+
+static int
+compareSites(const void *a, const void *b)
+
+{
+  const struct coverageSite *sa,
+                            *sb;
+
+  sa = (const struct coverageSite *) a;
+  sb = (const struct coverageSite *) b;
+
+  if (sa->address < sb->address)
+    return (-1);
+  else if (sa->address > sb->address)
+    return (1);
+
+  return (0);
+} /* compareSites() */
+
+/*
+startCoverage()
+  Insert one-shot breakpoints at the given block addresses of the
+(stopped) debugged process. Any previous coverage sites are removed
+first.
+
+Inputs: ws    - debug workspace
+        addrs - block addresses
+        num   - number of addresses
+
+Return: number of sites inserted - duplicates, addresses which
+        already carry a breakpoint and addresses which cannot be
+        accessed are skipped
+        -1 if an error occurs (errno is set)
+*/
+
+long
+startCoverage(struct debugWorkspace *ws, unsigned long *addrs,
+              unsigned long num)
+
+{
+  struct coverageSite *sites;
+  unsigned long ii,
+                count;
+
+  assert(ws->pid != NOPID);
+
+  clearCoverage(ws);
+
+  if (num == 0)
+    return (0);
+
+  sites = (struct coverageSite *) malloc(sizeof(struct coverageSite) * num);
+  if (!sites)
+    return (-1);
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    sites[ii].address = addrs[ii];
+    sites[ii].svdbyte = 0;
+    sites[ii].hit = 0;
+  }
+
+  qsort(sites, num, sizeof(struct coverageSite), compareSites);
+
+  /*
+   * Drop duplicates, and addresses which already have a breakpoint
+   * - the breakpoint must keep restoring the original instruction
+   * itself
+   */
+  count = 0;
+  for (ii = 0; ii < num; ++ii)
+  {
+    if ((count > 0) && (sites[count - 1].address == sites[ii].address))
+      continue;
+
+    if (findBreakpoint(ws, sites[ii].address))
+      continue;
+
+    sites[count++] = sites[ii];
+  }
+
+  ws->coverage.sites = sites;
+  ws->coverage.count = count;
+  ws->coverage.hits = 0;
+  ws->coverage.pid = ws->pid;
+
+  if (!x86insertCoverage(ws, &(ws->coverage)))
+  {
+    free(sites);
+    memset(&(ws->coverage), '\0', sizeof(struct Coverage));
+    return (-1);
+  }
+
+  return ((long) ws->coverage.count);
+} /* startCoverage() */
+
+/*
+clearCoverage()
+  Remove all coverage sites which have not been hit yet from the
+debugged process (if it is still around), and delete the list
+*/
+
+void
+clearCoverage(struct debugWorkspace *ws)
+
+{
+  if (coverageActive(ws))
+    x86removeCoverage(ws, &(ws->coverage));
+
+  if (ws->coverage.sites)
+    free(ws->coverage.sites);
+
+  memset(&(ws->coverage), '\0', sizeof(struct Coverage));
+} /* clearCoverage() */
+
+/*
+findCoverageSite()
+  Find the coverage site at an address
+
+Inputs: cov     - coverage list
+        address - address to look up
+
+Return: pointer to site, 0 if there is none
+*/
+
+struct coverageSite *
+findCoverageSite(struct Coverage *cov, unsigned long address)
+
+{
+  unsigned long lo,
+                hi,
+                mid;
+
+  lo = 0;
+  hi = cov->count;
+
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+
+    if (cov->sites[mid].address == address)
+      return (cov->sites + mid);
+    else if (cov->sites[mid].address < address)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return (0);
+} /* findCoverageSite() */
+
+/*
+hideCoverage()
+  Replace the breakpoint instructions of pending coverage sites in
+a memory dump with the original bytes, so the caller sees the real
+program text
+
+Inputs: cov   - coverage list
+        buf   - memory dump
+        start - address of first byte in buf
+        bytes - number of bytes in buf
+*/
+
+void
+hideCoverage(struct Coverage *cov, unsigned char *buf,
+             unsigned long start, unsigned long bytes)
+
+{
+  unsigned long lo,
+                hi,
+                mid;
+  struct coverageSite *site;
+
+  /*
+   * Find the first site at or above start
+   */
+  lo = 0;
+  hi = cov->count;
+
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+
+    if (cov->sites[mid].address < start)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  for (site = cov->sites + lo; site < cov->sites + cov->count; ++site)
+  {
+    if (site->address - start >= bytes)
+      break;
+
+    if (!site->hit)
+      buf[site->address - start] = site->svdbyte;
+  }
+} /* hideCoverage() */
@@ -42,6 +42,15 @@ initDebug()
 
   ws->pid = NOPID;
   ws->breakNumber = 1;
+  ws->checkpointNumber = 1;
+  ws->watch.pid = NOPID;
+  ws->record.pid = NOPID;
+  ws->record.size = RECORD_DEFSIZE;
+  ws->trace.size = TRACE_DEFSIZE;
+
+  initSignalPolicy(ws);
+
+  initCaptureDebug(&(ws->capture));
 
   ws->fpuState = (struct x86fpuInfo *) malloc(sizeof(struct x86fpuInfo));
   if (!ws->fpuState)
@@ -88,6 +97,20 @@ termDebug(struct debugWorkspace *ws)
     free(ws->fpuState);
 
   clearBreakpoints(ws);
+  clearCoverage(ws);
+  clearWatchpoints(ws);
+  x86clearMemoryMap(ws);
+  setRecord(ws, 0);
+  clearFastTracepoints(ws, 0);
+  freeTrace(ws);
+
+  /*
+   * The frozen checkpoint processes would start running on their
+   * own once we exit, so get rid of them
+   */
+  clearCheckpoints(ws);
+
+  termCaptureDebug(&(ws->capture));
 
   free(ws);
 } /* termDebug() */
@@ -134,8 +157,7 @@ startDebug(struct debugWorkspace *ws, char *path, int redirect)
   else
     setArgsDebug(ws, 0);
 
-  if (redirect)
-    dbSetRedirect(ws);
+  setRedirectDebug(ws, redirect);
 
   memset(ws->output, 0, sizeof(ws->output));
 } /* startDebug() */
@@ -155,15 +177,20 @@ endDebug(struct debugWorkspace *ws)
   clearTemporaryBreakpoints(ws);
 
   ws->pid = NOPID;
+  clearRecord(ws);
 
   dbClearRunning(ws);
   dbClearHitBreakpoint(ws);
 
-  if (dbIsRedirect(ws))
-  {
-    close(ws->pipes[0]);
-    close(ws->pipes[1]);
-  }
+  /*
+   * Collect whatever the process wrote before it went away - it
+   * stays available through readOutputDebug(). Checkpoints share
+   * the pipe, so keep it open while any of them might be restarted.
+   */
+  if (ws->checkpoints)
+    drainCaptureDebug(&(ws->capture));
+  else
+    closeCaptureDebug(&(ws->capture));
 } /* endDebug() */
 
 /*
@@ -207,6 +234,66 @@ getOutputDebug(struct debugWorkspace *ws)
   return (ws->output);
 } /* getOutputDebug() */
 
+/*
+readOutputDebug()
+  Retrieve output the debugged process has written to its stdout
+or stderr since the last call. Only meaningful if redirection was
+requested in startDebug().
+
+Inputs: ws      - debug workspace
+        buf     - where to store output
+        len     - size of buf
+        dropped - modified to contain the number of bytes lost
+                  because they were not read in time (optional)
+
+Return: number of bytes stored in buf
+*/
+
+size_t
+readOutputDebug(struct debugWorkspace *ws, char *buf, size_t len,
+                size_t *dropped)
+
+{
+  drainCaptureDebug(&(ws->capture));
+
+  return (readCaptureDebug(&(ws->capture), buf, len, dropped));
+} /* readOutputDebug() */
+
+/*
+setOutputLogDebug()
+  Set a file descriptor which receives a copy of all redirected
+output of the debugged process
+
+Inputs: ws - debug workspace
+        fd - file descriptor, -1 to disable
+*/
+
+void
+setOutputLogDebug(struct debugWorkspace *ws, int fd)
+
+{
+  setCaptureLogDebug(&(ws->capture), fd);
+} /* setOutputLogDebug() */
+
+/*
+setRedirectDebug()
+  Enable or disable capturing of the debugged process' output. This
+takes effect the next time the process is started.
+
+Inputs: ws       - debug workspace
+        redirect - 1 to capture output, 0 to leave it alone
+*/
+
+void
+setRedirectDebug(struct debugWorkspace *ws, int redirect)
+
+{
+  if (redirect)
+    dbSetRedirect(ws);
+  else
+    dbClearRedirect(ws);
+} /* setRedirectDebug() */
+
 /*
 getArgsDebug()
   Return runtime program arguments
@@ -382,6 +469,10 @@ Return: 0 if unsuccessful
         5 if program outputs data and RedirectIO is set
         6 if program is not executable
         7 if program terminates due to a signal (signal num goes in data)
+        8 if program writes to a watched range (data will contain
+          watchpoint number)
+        9 if program makes a caught system call (data will contain
+          system call number)
 */
 
 int
@@ -391,6 +482,26 @@ stepIntoDebug(struct debugWorkspace *ws, int num, int *data)
   return (x86stepIntoDebug(ws, num, data));
 } /* stepIntoDebug() */
 
+/*
+stepBlockDebug()
+  Step our program by 'num' basic blocks: the program runs until
+it takes a branch, and stops at the branch target
+
+Inputs: ws   - debug workspace
+        num  - number of blocks to step
+        data - modified to contain various data, depending
+               on the return result
+
+Return: same as stepIntoDebug()
+*/
+
+int
+stepBlockDebug(struct debugWorkspace *ws, int num, int *data)
+
+{
+  return (x86stepBlockDebug(ws, num, data));
+} /* stepBlockDebug() */
+
 /*
 stepOverDebug()
   Single step our program by 'num' instructions, stepping
@@ -411,6 +522,10 @@ Return: 0 if unsuccessful
         5 if program outputs data and RedirectIO is set
         6 if program is not executable
         7 if program terminates due to a signal (signal num goes in data)
+        8 if program writes to a watched range (data will contain
+          watchpoint number)
+        9 if program makes a caught system call (data will contain
+          system call number)
 */
 
 int
@@ -420,6 +535,29 @@ stepOverDebug(struct debugWorkspace *ws, int num, int *data)
   return (x86stepOverDebug(ws, num, data));
 } /* stepOverDebug() */
 
+/*
+runToDebug()
+  Continue our program until it reaches one of the given addresses
+
+Inputs: ws    - debug workspace
+        addrs - addresses to stop at
+        num   - number of addresses
+        frame - if non-zero, ignore arrivals while the stack pointer
+                is below this value (deeper invocations)
+        data  - modified to contain various data, depending
+                on the return result
+
+Return: 1 if an address was reached, otherwise same as continueDebug()
+*/
+
+int
+runToDebug(struct debugWorkspace *ws, unsigned long *addrs, int num,
+           unsigned long frame, int *data)
+
+{
+  return (x86runToDebug(ws, addrs, num, frame, data));
+} /* runToDebug() */
+
 /*
 continueDebug()
   Continue the current process from where it left off
@@ -435,6 +573,10 @@ Return: 0 if unsuccessful (ptrace error)
         5 if program outputs data and RedirectIO is set
         6 if program is not executable
         7 if program terminates due to a signal (signal number stored in data)
+        8 if program writes to a watched range (watchpoint number stored
+          in data)
+        9 if program makes a caught system call (system call number
+          stored in data)
 */
 
 int
@@ -444,6 +586,33 @@ continueDebug(struct debugWorkspace *ws, int *data)
   return (x86continueDebug(ws, data));
 } /* continueDebug() */
 
+/*
+profileDebug()
+  Run the current process, interrupting it at regular intervals to
+sample where it is executing
+
+Inputs: ws       - debug workspace
+        duration - how long to profile (microseconds)
+        interval - time between samples (microseconds)
+        callback - called for each sample with the instruction
+                   pointer followed by the return addresses found
+                   on the stack, and the number of addresses
+        args     - passed to callback
+        data     - modified depending on return value
+
+Return: 1 if the process was profiled for the whole duration (it is
+        left stopped), otherwise same as continueDebug()
+*/
+
+int
+profileDebug(struct debugWorkspace *ws, long duration, long interval,
+             void (*callback)(void *, unsigned long *, int),
+             void *args, int *data)
+
+{
+  return (x86profileDebug(ws, duration, interval, callback, args, data));
+} /* profileDebug() */
+
 /*
 findRegisterDebug()
   Find register matching the given string
@@ -465,6 +634,75 @@ findRegisterDebug(struct debugWorkspace *ws, char *name)
   return (x86findRegisterDebug(ws, name));
 } /* findRegisterDebug() */
 
+/*
+getRegisterNameDebug()
+  Return the name of a register
+
+Inputs: ws       - debug workspace
+        regindex - index returned by findRegisterDebug()
+
+Return: register name
+*/
+
+char *
+getRegisterNameDebug(struct debugWorkspace *ws, int regindex)
+
+{
+  return (x86Registers[regindex].name);
+} /* getRegisterNameDebug() */
+
+/*
+findSyscallDebug()
+  Find a system call by name
+
+Inputs: ws   - debug workspace
+        name - system call name
+
+Return: system call number
+        -1 if not found
+*/
+
+int
+findSyscallDebug(struct debugWorkspace *ws, char *name)
+
+{
+  return (x86findSyscall(name));
+} /* findSyscallDebug() */
+
+/*
+getSyscallNameDebug()
+  Return the name of a system call
+
+Inputs: ws     - debug workspace
+        number - system call number
+
+Return: name, or 0 if it is not known
+*/
+
+char *
+getSyscallNameDebug(struct debugWorkspace *ws, int number)
+
+{
+  return (x86getSyscallName(number));
+} /* getSyscallNameDebug() */
+
+/*
+getSyscallArgsDebug()
+  Return the number of arguments a system call takes
+
+Inputs: ws     - debug workspace
+        number - system call number
+
+Return: number of arguments
+*/
+
+int
+getSyscallArgsDebug(struct debugWorkspace *ws, int number)
+
+{
+  return (x86getSyscallArgs(number));
+} /* getSyscallArgsDebug() */
+
 /*
 setRegisterDebug()
   Set a register to a given value
@@ -520,6 +758,94 @@ getFlagsDebug(struct debugWorkspace *ws, char *flags)
   return (x86getFlagsDebug(ws, flags));
 } /* getFlagsDebug() */
 
+/*
+loadCoreRegistersDebug()
+  Load the registers saved in a core file, so they can be
+displayed with printRegistersDebug() and friends while there is no
+process
+
+Inputs: ws       - debug workspace
+        prstatus - process status note of the core file
+        size     - size of prstatus
+        fpregs   - floating point register note (may be 0)
+        fpsize   - size of fpregs
+        sig      - where to store the signal which caused the dump
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+loadCoreRegistersDebug(struct debugWorkspace *ws, void *prstatus,
+                       size_t size, void *fpregs, size_t fpsize,
+                       int *sig)
+
+{
+  return (x86loadCoreRegistersDebug(ws,
+                                    prstatus,
+                                    size,
+                                    fpregs,
+                                    fpsize,
+                                    sig));
+} /* loadCoreRegistersDebug() */
+
+/*
+readMemoryDebug()
+  Read memory of the debugged process into a caller supplied buffer.
+Large blocks are read in bulk where the platform allows it.
+
+Inputs: ws    - debug workspace
+        start - address to start reading
+        buf   - buffer to store memory bytes in
+        bytes - number of bytes to read
+
+Return: number of bytes read - if this value is less than 'bytes',
+        an error occurred and errno should be set appropriately
+*/
+
+long
+readMemoryDebug(struct debugWorkspace *ws, unsigned long start,
+                unsigned char *buf, unsigned long bytes)
+
+{
+  if (ws->pid == NOPID)
+  {
+    errno = ESRCH;
+    return (0);
+  }
+
+  return (x86readMemoryDebug(ws, start, buf, bytes));
+} /* readMemoryDebug() */
+
+/*
+traverseMapsDebug()
+  Call a function for every mapped region of the debugged process
+
+Inputs: ws       - debug workspace
+        callback - function to call with the start and end address and
+                   the permissions ("rwxp") of each region
+        args     - arguments to callback
+
+Return: 1 if successful
+        0 if the memory map could not be obtained
+*/
+
+int
+traverseMapsDebug(struct debugWorkspace *ws,
+                  void (*callback)(void *, unsigned long, unsigned long,
+                                   char *),
+                  void *args)
+
+{
+  if (ws->pid == NOPID)
+  {
+    errno = ESRCH;
+    return (0);
+  }
+
+  return (x86traverseMapsDebug(ws, callback, args));
+} /* traverseMapsDebug() */
+
 /*
 dumpMemoryDebug()
   Dump memory contents of debugged process
@@ -0,0 +1,557 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "break.h"
+#include "libDebug.h"
+#include "record.h"
+#include "watch.h"
+
+#if REG_ENDGENERAL > RECORD_MAXREGS
+# error RECORD_MAXREGS is too small
+#endif
+
+/*
+ * Size of the length, mask, address and size fields of an entry
+ */
+#define RECORD_FIELD   (sizeof(unsigned long))
+
+static unsigned long ringWrite(struct Record *rec, unsigned long off,
+                               void *src, unsigned long bytes);
+static unsigned long ringRead(struct Record *rec, unsigned long off,
+                              void *dst, unsigned long bytes);
+static void dropOldest(struct Record *rec);
+static void saveMemory(struct debugWorkspace *ws, unsigned long address,
+                       unsigned long size);
+
+/*
+ringWrite()
+  Copy bytes into the ring buffer, wrapping around at its end
+
+Inputs: rec   - record
+        off   - offset to write at
+        src   - bytes to copy
+        bytes - number of bytes
+
+Return: offset following the bytes written
+*/
+
+static unsigned long
+ringWrite(struct Record *rec, unsigned long off, void *src,
+          unsigned long bytes)
+
+{
+  unsigned char *ptr;
+  unsigned long chunk;
+
+  ptr = (unsigned char *) src;
+
+  while (bytes)
+  {
+    chunk = rec->size - off;
+    if (chunk > bytes)
+      chunk = bytes;
+
+    memcpy(rec->buf + off, ptr, chunk);
+
+    ptr += chunk;
+    bytes -= chunk;
+    off = (off + chunk) % rec->size;
+  }
+
+  return (off);
+} /* ringWrite() */
+
+/*
+ringRead()
+  Copy bytes out of the ring buffer, wrapping around at its end
+
+Inputs: rec   - record
+        off   - offset to read from
+        dst   - where to store bytes
+        bytes - number of bytes
+
+Return: offset following the bytes read
+*/
+
+static unsigned long
+ringRead(struct Record *rec, unsigned long off, void *dst,
+         unsigned long bytes)
+
+{
+  unsigned char *ptr;
+  unsigned long chunk;
+
+  ptr = (unsigned char *) dst;
+
+  while (bytes)
+  {
+    chunk = rec->size - off;
+    if (chunk > bytes)
+      chunk = bytes;
+
+    memcpy(ptr, rec->buf + off, chunk);
+
+    ptr += chunk;
+    bytes -= chunk;
+    off = (off + chunk) % rec->size;
+  }
+
+  return (off);
+} /* ringRead() */
+
+/*
+dropOldest()
+  Discard the oldest entry to make room for a new one
+*/
+
+static void
+dropOldest(struct Record *rec)
+
+{
+  unsigned long len;
+
+  ringRead(rec, rec->head, &len, RECORD_FIELD);
+
+  rec->head = (rec->head + len) % rec->size;
+  rec->used -= len;
+  --(rec->count);
+} /* dropOldest() */
+
+/*
+setRecord()
+  Turn recording of execution history on or off. Turning it off
+discards the history.
+
+Inputs: ws      - debug workspace
+        enabled - 1 to record, 0 not to
+
+Return: 1 if successful
+        0 if the buffer cannot be allocated
+*/
+
+int
+setRecord(struct debugWorkspace *ws, int enabled)
+
+{
+  struct Record *rec;
+
+  rec = &(ws->record);
+
+  if (enabled && !rec->buf)
+  {
+    rec->buf = (unsigned char *) malloc(rec->size);
+    if (!rec->buf)
+      return (0);
+  }
+  else if (!enabled && rec->buf)
+  {
+    free(rec->buf);
+    rec->buf = 0;
+
+    if (rec->entry)
+      free(rec->entry);
+
+    rec->entry = 0;
+    rec->entrySize = 0;
+  }
+
+  rec->enabled = enabled;
+  clearRecord(ws);
+
+  return (1);
+} /* setRecord() */
+
+/*
+setRecordSize()
+  Set the most memory used to record execution history. If
+recording is on, the history recorded so far is discarded.
+
+Inputs: ws   - debug workspace
+        size - size of buffer in bytes
+
+Return: 1 if successful
+        0 if not (errno is set)
+*/
+
+int
+setRecordSize(struct debugWorkspace *ws, unsigned long size)
+
+{
+  struct Record *rec;
+  unsigned char *buf;
+
+  rec = &(ws->record);
+
+  if (size < RECORD_MINSIZE)
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  if (rec->buf)
+  {
+    buf = (unsigned char *) malloc(size);
+    if (!buf)
+      return (0);
+
+    free(rec->buf);
+    rec->buf = buf;
+  }
+
+  rec->size = size;
+  clearRecord(ws);
+
+  return (1);
+} /* setRecordSize() */
+
+/*
+clearRecord()
+  Discard the recorded history - called whenever the process runs in
+a way we cannot undo
+
+Inputs: ws - debug workspace
+*/
+
+void
+clearRecord(struct debugWorkspace *ws)
+
+{
+  ws->record.head = 0;
+  ws->record.used = 0;
+  ws->record.count = 0;
+  ws->record.pid = ws->pid;
+} /* clearRecord() */
+
+/*
+saveMemory()
+  Append the current contents of a range of memory to the entry
+being built. Bytes which cannot be read are left out - the
+instruction will fault on them anyway.
+
+Inputs: ws      - debug workspace
+        address - start of range
+        size    - length of range
+*/
+
+static void
+saveMemory(struct debugWorkspace *ws, unsigned long address,
+           unsigned long size)
+
+{
+  struct Record *rec;
+  unsigned char *ptr;
+  unsigned long need;
+  long ret;
+
+  rec = &(ws->record);
+
+  need = rec->entryLen + 2 * RECORD_FIELD + size;
+  if (need > rec->size)
+  {
+    rec->barrier = 1;
+    return;
+  }
+
+  if (need > rec->entrySize)
+  {
+    ptr = (unsigned char *) realloc(rec->entry, need);
+    if (!ptr)
+    {
+      rec->barrier = 1;
+      return;
+    }
+
+    rec->entry = ptr;
+    rec->entrySize = need;
+  }
+
+  ptr = rec->entry + rec->entryLen;
+
+  ret = x86readMemoryDebug(ws, address, ptr + 2 * RECORD_FIELD, size);
+  if (ret <= 0)
+    return;
+
+  size = (unsigned long) ret;
+
+  memcpy(ptr, &address, RECORD_FIELD);
+  memcpy(ptr + RECORD_FIELD, &size, RECORD_FIELD);
+
+  rec->entryLen += 2 * RECORD_FIELD + size;
+} /* saveMemory() */
+
+/*
+beginRecord()
+  Save what the next instruction is about to change - called right
+before it is single stepped
+
+Inputs: ws - debug workspace
+*/
+
+void
+beginRecord(struct debugWorkspace *ws)
+
+{
+  struct Record *rec;
+  struct x86MemWrite writes[X86_MAXWRITES];
+  unsigned char insn[X86_MAXINSN];
+  long len;
+  int num,
+      ii;
+
+  rec = &(ws->record);
+
+  /*
+   * A new run or a restarted checkpoint starts with no history
+   */
+  if (rec->pid != ws->pid)
+    clearRecord(ws);
+
+  rec->barrier = 0;
+  rec->entryLen = 0;
+
+  if (!x86getRegistersDebug(ws))
+  {
+    rec->barrier = 1;
+    return;
+  }
+
+  for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+    rec->regs[ii] = *(unsigned long *) x86Registers[ii].valptr;
+
+  len = x86readMemoryDebug(ws, ws->instructionPointer, insn, X86_MAXINSN);
+  if (len <= 0)
+  {
+    rec->barrier = 1;
+    return;
+  }
+
+  num = x86memoryWrites(ws, insn, (int) len, writes);
+  if (num < 0)
+  {
+    rec->barrier = 1;
+    return;
+  }
+
+  for (ii = 0; (ii < num) && !rec->barrier; ++ii)
+    saveMemory(ws, writes[ii].address, writes[ii].size);
+} /* beginRecord() */
+
+/*
+endRecord()
+  Add an entry for the instruction just stepped to the history. If
+it cannot be undone, the history is discarded instead, since
+nothing before it can be reached any more.
+
+Inputs: ws  - debug workspace
+        ret - result of the single step
+*/
+
+void
+endRecord(struct debugWorkspace *ws, int ret)
+
+{
+  struct Record *rec;
+  unsigned long mask,
+                len,
+                off,
+                value;
+  int nregs,
+      ii;
+
+  rec = &(ws->record);
+
+  /*
+   * Only steps which ran the instruction normally can be undone -
+   * a signal may have run a handler, and an exit ends it all
+   */
+  if (rec->barrier || ((ret != 1) && (ret != 8)) ||
+      (ws->pid == NOPID) || !x86getRegistersDebug(ws))
+  {
+    clearRecord(ws);
+    return;
+  }
+
+  mask = 0;
+  nregs = 0;
+
+  for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+  {
+    if (*(unsigned long *) x86Registers[ii].valptr != rec->regs[ii])
+    {
+      mask |= 1UL << ii;
+      ++nregs;
+    }
+  }
+
+  len = (3 + nregs) * RECORD_FIELD + rec->entryLen;
+  if (len > rec->size)
+  {
+    clearRecord(ws);
+    return;
+  }
+
+  while (rec->used + len > rec->size)
+    dropOldest(rec);
+
+  off = (rec->head + rec->used) % rec->size;
+
+  off = ringWrite(rec, off, &len, RECORD_FIELD);
+  off = ringWrite(rec, off, &mask, RECORD_FIELD);
+
+  for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+  {
+    if (mask & (1UL << ii))
+    {
+      value = rec->regs[ii];
+      off = ringWrite(rec, off, &value, RECORD_FIELD);
+    }
+  }
+
+  off = ringWrite(rec, off, rec->entry, rec->entryLen);
+  ringWrite(rec, off, &len, RECORD_FIELD);
+
+  rec->used += len;
+  ++(rec->count);
+} /* endRecord() */
+
+/*
+reverseRecord()
+  Step the process backwards through its recorded history
+
+Inputs: ws      - debug workspace
+        num     - number of instructions to undo
+        tobreak - if 1, stop early upon arriving at an enabled
+                  breakpoint
+        data    - modified to contain the number of the breakpoint
+                  we stopped at, 0 if none
+
+Return: number of instructions undone - fewer than num if the start
+        of the history was reached
+        -1 upon failure (errno is set)
+*/
+
+long
+reverseRecord(struct debugWorkspace *ws, long num, int tobreak, int *data)
+
+{
+  struct Record *rec;
+  struct Breakpoint *bptr;
+  unsigned char buf[512];
+  unsigned long len,
+                mask,
+                off,
+                end,
+                remain,
+                address,
+                size,
+                chunk;
+  long done;
+  int ii;
+
+  rec = &(ws->record);
+  *data = 0;
+
+  if ((ws->pid == NOPID) || (rec->pid != ws->pid))
+    return (0);
+
+  if (!x86getRegistersDebug(ws))
+    return (-1);
+
+  for (done = 0; (done < num) && rec->count; ++done)
+  {
+    /*
+     * The newest entry ends where the used part of the buffer does
+     */
+    end = (rec->head + rec->used) % rec->size;
+    ringRead(rec,
+             (end + rec->size - RECORD_FIELD) % rec->size,
+             &len,
+             RECORD_FIELD);
+
+    off = (end + rec->size - len) % rec->size;
+    off = ringRead(rec, off, &len, RECORD_FIELD);
+    off = ringRead(rec, off, &mask, RECORD_FIELD);
+
+    remain = len - 3 * RECORD_FIELD;
+
+    for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+    {
+      if (mask & (1UL << ii))
+      {
+        off = ringRead(rec, off, x86Registers[ii].valptr, RECORD_FIELD);
+        remain -= RECORD_FIELD;
+      }
+    }
+
+    while (remain)
+    {
+      off = ringRead(rec, off, &address, RECORD_FIELD);
+      off = ringRead(rec, off, &size, RECORD_FIELD);
+      remain -= 2 * RECORD_FIELD + size;
+
+      while (size)
+      {
+        chunk = (size > sizeof(buf)) ? sizeof(buf) : size;
+        off = ringRead(rec, off, buf, chunk);
+
+        if (x86writeMemoryDebug(ws, address, buf, chunk) != (long) chunk)
+        {
+          clearRecord(ws);
+          return (-1);
+        }
+
+        address += chunk;
+        size -= chunk;
+      }
+    }
+
+    rec->used -= len;
+    --(rec->count);
+
+    ws->regContents.cache |= RC_GENERAL_DIRTY;
+    ws->instructionPointer = *(unsigned long *) x86Registers[REG_EIP].valptr;
+
+    if (tobreak)
+    {
+      bptr = findBreakpoint(ws, ws->instructionPointer);
+      if (bptr && (bptr->flags & BK_ENABLED) &&
+          !(bptr->flags & (BK_STEPOVER | BK_TRACE)))
+      {
+        *data = bptr->number;
+        ++done;
+        break;
+      }
+    }
+  }
+
+  /*
+   * If we are sitting on a breakpoint, continuing must step past it
+   * first, as it would after the breakpoint was hit
+   */
+  if (findBreakpoint(ws, ws->instructionPointer))
+    dbSetHitBreakpoint(ws);
+  else
+    dbClearHitBreakpoint(ws);
+
+  /*
+   * Watched ranges may have been changed back
+   */
+  if (watchActive(ws))
+    initWatchpoints(ws);
+
+  return (done);
+} /* reverseRecord() */
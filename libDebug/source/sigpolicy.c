@@ -0,0 +1,174 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <signal.h>
+
+#include "libDebug.h"
+#include "sigpolicy.h"
+
+/*
+initSignalPolicy()
+  Set the default policy: stop for every signal, except those a
+program normally receives while running fine, which are passed to it
+quietly. SIGINT is usually the user interrupting the program, so it
+stops but is not passed.
+
+Inputs: ws - debug workspace
+*/
+
+void
+initSignalPolicy(struct debugWorkspace *ws)
+
+{
+  int sig;
+
+  for (sig = 0; sig < SP_MAXSIG; ++sig)
+  {
+    ws->sigpolicy.policy[sig] = SP_DEFAULT;
+    ws->sigpolicy.count[sig] = 0;
+  }
+
+  ws->sigpolicy.policy[SIGINT] = SP_STOP | SP_PRINT;
+  ws->sigpolicy.policy[SIGTRAP] = SP_STOP | SP_PRINT;
+
+  ws->sigpolicy.policy[SIGALRM] = SP_PASS;
+  ws->sigpolicy.policy[SIGCHLD] = SP_PASS;
+  ws->sigpolicy.policy[SIGURG] = SP_PASS;
+  ws->sigpolicy.policy[SIGWINCH] = SP_PASS;
+  ws->sigpolicy.policy[SIGVTALRM] = SP_PASS;
+  ws->sigpolicy.policy[SIGPROF] = SP_PASS;
+
+#ifdef SIGIO
+  ws->sigpolicy.policy[SIGIO] = SP_PASS;
+#endif
+} /* initSignalPolicy() */
+
+/*
+setSignalPolicy()
+  Set what is done when the program receives a signal
+
+Inputs: ws     - debug workspace
+        sig    - signal number
+        policy - SP_xxx bits
+
+Return: 1 if successful
+        0 if the signal is invalid, or is used by the debugger or
+          cannot be caught (errno is EINVAL)
+*/
+
+int
+setSignalPolicy(struct debugWorkspace *ws, int sig, unsigned int policy)
+
+{
+  if ((sig <= 0) || (sig >= SP_MAXSIG) ||
+      (sig == SIGTRAP) || (sig == SIGKILL))
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  ws->sigpolicy.policy[sig] = (unsigned char) policy;
+
+  return (1);
+} /* setSignalPolicy() */
+
+/*
+getSignalPolicy()
+  Return the policy for a signal
+
+Inputs: ws  - debug workspace
+        sig - signal number
+
+Return: SP_xxx bits
+*/
+
+unsigned int
+getSignalPolicy(struct debugWorkspace *ws, int sig)
+
+{
+  if ((sig < 0) || (sig >= SP_MAXSIG))
+    return (SP_DEFAULT);
+
+  return (ws->sigpolicy.policy[sig]);
+} /* getSignalPolicy() */
+
+/*
+getSignalCount()
+  Return the number of times a signal was received without stopping
+the program
+
+Inputs: ws  - debug workspace
+        sig - signal number
+*/
+
+unsigned long
+getSignalCount(struct debugWorkspace *ws, int sig)
+
+{
+  if ((sig < 0) || (sig >= SP_MAXSIG))
+    return (0);
+
+  return (ws->sigpolicy.count[sig]);
+} /* getSignalCount() */
+
+/*
+setSignalNotify()
+  Set the function called when a signal with SP_PRINT set is
+received and the program keeps running
+
+Inputs: ws     - debug workspace
+        notify - callback function:
+                   void notify(void *args, int sig);
+        args   - passed to notify
+*/
+
+void
+setSignalNotify(struct debugWorkspace *ws, void (*notify)(void *, int),
+                void *args)
+
+{
+  ws->sigpolicy.notify = notify;
+  ws->sigpolicy.notifyArgs = args;
+} /* setSignalNotify() */
+
+/*
+checkSignalPolicy()
+  Called when the program stops due to a signal, to find out whether
+it should be resumed right away
+
+Inputs: ws  - debug workspace
+        sig - signal number
+
+Return: 1 if the program should keep running
+        0 if it should stop
+*/
+
+int
+checkSignalPolicy(struct debugWorkspace *ws, int sig)
+
+{
+  struct sigPolicy *sp;
+
+  sp = &(ws->sigpolicy);
+
+  if ((sig <= 0) || (sig >= SP_MAXSIG) || (sp->policy[sig] & SP_STOP))
+    return (0);
+
+  ++(sp->count[sig]);
+
+  if ((sp->policy[sig] & SP_PRINT) && sp->notify)
+    (*sp->notify)(sp->notifyArgs, sig);
+
+  return (1);
+} /* checkSignalPolicy() */
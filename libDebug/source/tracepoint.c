@@ -0,0 +1,629 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "break.h"
+#include "libDebug.h"
+#include "tracepoint.h"
+
+#if REG_ENDGENERAL > TRACE_MAXREGS
+# error TRACE_MAXREGS is too small
+#endif
+
+/*
+ * Size of the fixed fields of a frame
+ */
+#define TRACE_FIELD     (sizeof(unsigned long))
+
+/*
+ * Longest possible frame
+ */
+#define TRACE_MAXFRAME  ((7 + TRACE_MAXREGS + 2 * TRACE_MAXMEM) * \
+                         TRACE_FIELD + TRACE_MAXMEM * TRACE_MAXRANGE)
+
+static unsigned long ringWrite(struct Trace *trace, unsigned long off,
+                               void *src, unsigned long bytes);
+static unsigned long ringRead(struct Trace *trace, unsigned long off,
+                              void *dst, unsigned long bytes);
+static void unlinkFastTracepoint(struct fastTracepoint *ptr,
+                                 struct fastTracepoint **list);
+
+/*
+ringWrite()
+  Copy bytes into the ring buffer, wrapping around at its end
+
+Inputs: trace - trace buffer
+        off   - offset to write at
+        src   - bytes to copy
+        bytes - number of bytes
+
+Return: offset following the bytes written
+*/
+
+static unsigned long
+ringWrite(struct Trace *trace, unsigned long off, void *src,
+          unsigned long bytes)
+
+{
+  unsigned char *ptr;
+  unsigned long chunk;
+
+  ptr = (unsigned char *) src;
+
+  while (bytes)
+  {
+    chunk = trace->size - off;
+    if (chunk > bytes)
+      chunk = bytes;
+
+    memcpy(trace->buf + off, ptr, chunk);
+
+    ptr += chunk;
+    bytes -= chunk;
+    off = (off + chunk) % trace->size;
+  }
+
+  return (off);
+} /* ringWrite() */
+
+/*
+ringRead()
+  Copy bytes out of the ring buffer, wrapping around at its end
+
+Inputs: trace - trace buffer
+        off   - offset to read from
+        dst   - where to store bytes
+        bytes - number of bytes
+
+Return: offset following the bytes read
+*/
+
+static unsigned long
+ringRead(struct Trace *trace, unsigned long off, void *dst,
+         unsigned long bytes)
+
+{
+  unsigned char *ptr;
+  unsigned long chunk;
+
+  ptr = (unsigned char *) dst;
+
+  while (bytes)
+  {
+    chunk = trace->size - off;
+    if (chunk > bytes)
+      chunk = bytes;
+
+    memcpy(ptr, trace->buf + off, chunk);
+
+    ptr += chunk;
+    bytes -= chunk;
+    off = (off + chunk) % trace->size;
+  }
+
+  return (off);
+} /* ringRead() */
+
+/*
+newTracepoint()
+  Set a tracepoint. The buffer for collected frames is allocated
+along with the first one.
+
+Inputs: ws      - debug workspace
+        address - instruction address
+        collect - what to collect on each hit
+
+Return: tracepoint number (shared with breakpoints), or -1 if
+        error occurs (errno is set)
+*/
+
+int
+newTracepoint(struct debugWorkspace *ws, unsigned long address,
+              struct traceCollect *collect)
+
+{
+  struct Breakpoint *bptr;
+  struct traceCollect *ptr;
+  int num;
+
+  if (!ws->trace.buf)
+  {
+    ws->trace.buf = (unsigned char *) malloc(ws->trace.size);
+    if (!ws->trace.buf)
+      return (-1);
+  }
+
+  ptr = (struct traceCollect *) malloc(sizeof(struct traceCollect));
+  if (!ptr)
+    return (-1);
+
+  memcpy(ptr, collect, sizeof(struct traceCollect));
+
+  num = newBreakpoint(ws, address, BK_TRACE);
+  if (num == (-1))
+  {
+    free(ptr);
+    return (-1);
+  }
+
+  bptr = findBreakpointByNumber(ws, (unsigned int) num);
+  bptr->collect = ptr;
+
+  return (num);
+} /* newTracepoint() */
+
+/*
+newFastTracepoint()
+  Set a fast tracepoint in the running process: the instructions
+at the address are replaced by a jump to code which collects into a
+ring shared with us
+
+Inputs: ws      - debug workspace
+        address - instruction address
+        length  - length of the whole instructions at the address
+                  which the jump replaces - at least 5 bytes, and
+                  none of them may depend on where they are
+        collect - what to collect on each hit
+
+Return: tracepoint number (shared with breakpoints), or -1 if
+        error occurs (errno is set)
+*/
+
+int
+newFastTracepoint(struct debugWorkspace *ws, unsigned long address,
+                  unsigned long length, struct traceCollect *collect)
+
+{
+  struct fastTracepoint *ptr;
+
+  if (ws->pid == NOPID)
+  {
+    errno = ESRCH;
+    return (-1);
+  }
+
+  if ((length < 5) || (length > TRACE_MAXDISPLACE))
+  {
+    errno = EINVAL;
+    return (-1);
+  }
+
+  if (!ws->trace.buf)
+  {
+    ws->trace.buf = (unsigned char *) malloc(ws->trace.size);
+    if (!ws->trace.buf)
+      return (-1);
+  }
+
+  ptr = (struct fastTracepoint *) malloc(sizeof(struct fastTracepoint));
+  if (!ptr)
+    return (-1);
+
+  memset(ptr, '\0', sizeof(struct fastTracepoint));
+
+  ptr->number = ws->breakNumber;
+  ptr->address = address;
+  ptr->length = length;
+  memcpy(&(ptr->collect), collect, sizeof(struct traceCollect));
+
+  if (!x86insertFastTracepoint(ws, ptr))
+  {
+    free(ptr);
+    return (-1);
+  }
+
+  ++(ws->breakNumber);
+
+  ptr->prev = 0;
+  ptr->next = ws->trace.fast;
+  if (ptr->next)
+    ptr->next->prev = ptr;
+
+  ws->trace.fast = ptr;
+
+  return ((int) ptr->number);
+} /* newFastTracepoint() */
+
+/*
+unlinkFastTracepoint()
+  Unlink fast tracepoint from linked list
+
+Inputs: ptr  - structure to unlink
+        list - list to unlink from
+*/
+
+static void
+unlinkFastTracepoint(struct fastTracepoint *ptr,
+                     struct fastTracepoint **list)
+
+{
+  if (ptr->next)
+    ptr->next->prev = ptr->prev;
+
+  if (ptr->prev)
+    ptr->prev->next = ptr->next;
+  else
+    *list = ptr->next;
+} /* unlinkFastTracepoint() */
+
+/*
+deleteFastTracepoint()
+  Copy out the frames left in a fast tracepoint's ring, then remove
+it
+
+Inputs: ws      - debug workspace
+        ptr     - fast tracepoint
+        restore - if set, put the original instructions back in the
+                  process; otherwise the process is gone or was
+                  replaced by a new program
+*/
+
+void
+deleteFastTracepoint(struct debugWorkspace *ws, struct fastTracepoint *ptr,
+                     int restore)
+
+{
+  x86harvestFastTracepoint(ws, ptr);
+  x86removeFastTracepoint(ws, ptr, restore && (ws->pid != NOPID));
+
+  unlinkFastTracepoint(ptr, &(ws->trace.fast));
+  free(ptr);
+} /* deleteFastTracepoint() */
+
+/*
+clearFastTracepoints()
+  Delete all fast tracepoints
+
+Inputs: ws      - debug workspace
+        restore - same as deleteFastTracepoint()
+*/
+
+void
+clearFastTracepoints(struct debugWorkspace *ws, int restore)
+
+{
+  while (ws->trace.fast)
+    deleteFastTracepoint(ws, ws->trace.fast, restore);
+} /* clearFastTracepoints() */
+
+/*
+findFastTracepointByNumber()
+  Find a certain fast tracepoint
+
+Inputs: ws     - debug workspace
+        number - tracepoint number
+
+Return: pointer to fastTracepoint structure
+*/
+
+struct fastTracepoint *
+findFastTracepointByNumber(struct debugWorkspace *ws, unsigned int number)
+
+{
+  struct fastTracepoint *ptr;
+
+  for (ptr = ws->trace.fast; ptr; ptr = ptr->next)
+  {
+    if (ptr->number == number)
+      return (ptr);
+  }
+
+  return (0);
+} /* findFastTracepointByNumber() */
+
+/*
+syncTrace()
+  Copy the frames written by fast tracepoints since the last call
+into the trace buffer - called before the buffer is examined
+
+Inputs: ws - debug workspace
+*/
+
+void
+syncTrace(struct debugWorkspace *ws)
+
+{
+  struct fastTracepoint *ptr;
+
+  for (ptr = ws->trace.fast; ptr; ptr = ptr->next)
+    x86harvestFastTracepoint(ws, ptr);
+} /* syncTrace() */
+
+/*
+setTraceSize()
+  Set the size of the buffer holding collected frames. Frames
+collected so far are discarded.
+
+Inputs: ws   - debug workspace
+        size - size of buffer in bytes
+
+Return: 1 if successful
+        0 if not (errno is set)
+*/
+
+int
+setTraceSize(struct debugWorkspace *ws, unsigned long size)
+
+{
+  struct Trace *trace;
+  unsigned char *buf;
+
+  trace = &(ws->trace);
+
+  if (size < TRACE_MINSIZE)
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  if (trace->buf)
+  {
+    buf = (unsigned char *) malloc(size);
+    if (!buf)
+      return (0);
+
+    free(trace->buf);
+    trace->buf = buf;
+  }
+
+  trace->size = size;
+  clearTrace(ws);
+
+  return (1);
+} /* setTraceSize() */
+
+/*
+clearTrace()
+  Discard all collected frames
+
+Inputs: ws - debug workspace
+*/
+
+void
+clearTrace(struct debugWorkspace *ws)
+
+{
+  ws->trace.head = 0;
+  ws->trace.used = 0;
+  ws->trace.count = 0;
+  ws->trace.collected = 0;
+  ws->trace.dropped = 0;
+} /* clearTrace() */
+
+/*
+freeTrace()
+  Free the buffer holding collected frames
+
+Inputs: ws - debug workspace
+*/
+
+void
+freeTrace(struct debugWorkspace *ws)
+
+{
+  if (ws->trace.buf)
+    free(ws->trace.buf);
+
+  ws->trace.buf = 0;
+  clearTrace(ws);
+} /* freeTrace() */
+
+/*
+addTraceFrame()
+  Append a frame to the buffer, discarding the oldest frames to make
+room. Its sequence number is assigned here.
+
+Inputs: ws    - debug workspace
+        frame - frame to add (the register values in regs[] and the
+                memory at membytes[] are stored)
+*/
+
+void
+addTraceFrame(struct debugWorkspace *ws, struct traceFrame *frame)
+
+{
+  struct Trace *trace;
+  unsigned char buf[TRACE_MAXFRAME];
+  unsigned long field[TRACE_MAXREGS + 7];
+  unsigned long len,
+                old;
+  unsigned char *ptr;
+  int nfield,
+      ii;
+
+  trace = &(ws->trace);
+
+  if (!trace->buf)
+    return;
+
+  frame->sequence = trace->collected++;
+
+  nfield = 0;
+  field[nfield++] = 0;
+  field[nfield++] = frame->number;
+  field[nfield++] = frame->sequence;
+  field[nfield++] = frame->address;
+  field[nfield++] = frame->regmask;
+
+  for (ii = 0; ii < TRACE_MAXREGS; ++ii)
+  {
+    if (frame->regmask & (1UL << ii))
+      field[nfield++] = frame->regs[ii];
+  }
+
+  field[nfield++] = (unsigned long) frame->nmem;
+
+  ptr = buf + nfield * TRACE_FIELD;
+
+  for (ii = 0; ii < frame->nmem; ++ii)
+  {
+    memcpy(ptr, &(frame->memaddr[ii]), TRACE_FIELD);
+    memcpy(ptr + TRACE_FIELD, &(frame->memsize[ii]), TRACE_FIELD);
+    memcpy(ptr + 2 * TRACE_FIELD, frame->membytes[ii], frame->memsize[ii]);
+
+    ptr += 2 * TRACE_FIELD + frame->memsize[ii];
+  }
+
+  len = (unsigned long) (ptr - buf);
+  field[0] = len;
+  memcpy(buf, field, nfield * TRACE_FIELD);
+
+  if (len > trace->size)
+  {
+    ++(trace->dropped);
+    return;
+  }
+
+  while (trace->used + len > trace->size)
+  {
+    ringRead(trace, trace->head, &old, TRACE_FIELD);
+
+    trace->head = (trace->head + old) % trace->size;
+    trace->used -= old;
+    --(trace->count);
+    ++(trace->dropped);
+  }
+
+  ringWrite(trace, (trace->head + trace->used) % trace->size, buf, len);
+
+  trace->used += len;
+  ++(trace->count);
+} /* addTraceFrame() */
+
+/*
+collectTrace()
+  Collect a frame for a tracepoint which was just hit
+
+Inputs: ws   - debug workspace
+        bptr - tracepoint
+*/
+
+void
+collectTrace(struct debugWorkspace *ws, struct Breakpoint *bptr)
+
+{
+  struct traceCollect *collect;
+  struct traceRange *range;
+  struct traceFrame frame;
+  unsigned char *ptr;
+  int ii;
+  long ret;
+
+  collect = bptr->collect;
+  if (!collect)
+    return;
+
+  frame.number = bptr->number;
+  frame.address = bptr->address;
+  frame.regmask = collect->regmask;
+
+  for (ii = 0; ii < REG_ENDGENERAL; ++ii)
+  {
+    if (collect->regmask & (1UL << ii))
+      frame.regs[ii] = (unsigned long) x86readIntRegisterDebug(ws, ii);
+  }
+
+  frame.nmem = collect->nmem;
+
+  ptr = frame.data;
+  for (ii = 0; ii < collect->nmem; ++ii)
+  {
+    range = &(collect->mem[ii]);
+
+    frame.memaddr[ii] = (unsigned long) range->offset;
+    if (range->base >= 0)
+    {
+      frame.memaddr[ii] +=
+        (unsigned long) x86readIntRegisterDebug(ws, range->base);
+    }
+
+    ret = x86readMemoryDebug(ws, frame.memaddr[ii], ptr, range->size);
+
+    frame.membytes[ii] = ptr;
+    frame.memsize[ii] = (ret == (long) range->size) ? range->size : 0;
+
+    ptr += frame.memsize[ii];
+  }
+
+  addTraceFrame(ws, &frame);
+} /* collectTrace() */
+
+/*
+readTraceFrame()
+  Read the next frame from the buffer, oldest first
+
+Inputs: ws     - debug workspace
+        cursor - set to 0 to read the first frame; advanced past
+                 the frame read
+        frame  - where to store the frame
+
+Return: 1 if a frame was read
+        0 if there are no more
+*/
+
+int
+readTraceFrame(struct debugWorkspace *ws, unsigned long *cursor,
+               struct traceFrame *frame)
+
+{
+  struct Trace *trace;
+  unsigned long off,
+                len,
+                value,
+                used;
+  int ii;
+
+  trace = &(ws->trace);
+
+  if (*cursor >= trace->used)
+    return (0);
+
+  off = (trace->head + *cursor) % trace->size;
+
+  off = ringRead(trace, off, &len, TRACE_FIELD);
+  off = ringRead(trace, off, &value, TRACE_FIELD);
+  frame->number = (unsigned int) value;
+  off = ringRead(trace, off, &(frame->sequence), TRACE_FIELD);
+  off = ringRead(trace, off, &(frame->address), TRACE_FIELD);
+  off = ringRead(trace, off, &(frame->regmask), TRACE_FIELD);
+
+  for (ii = 0; ii < TRACE_MAXREGS; ++ii)
+  {
+    if (frame->regmask & (1UL << ii))
+      off = ringRead(trace, off, &(frame->regs[ii]), TRACE_FIELD);
+    else
+      frame->regs[ii] = 0;
+  }
+
+  off = ringRead(trace, off, &value, TRACE_FIELD);
+  frame->nmem = (int) value;
+
+  used = 0;
+  for (ii = 0; ii < frame->nmem; ++ii)
+  {
+    off = ringRead(trace, off, &(frame->memaddr[ii]), TRACE_FIELD);
+    off = ringRead(trace, off, &(frame->memsize[ii]), TRACE_FIELD);
+
+    frame->membytes[ii] = frame->data + used;
+    off = ringRead(trace, off, frame->membytes[ii], frame->memsize[ii]);
+
+    used += frame->memsize[ii];
+  }
+
+  *cursor += len;
+
+  return (1);
+} /* readTraceFrame() */
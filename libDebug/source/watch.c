@@ -0,0 +1,400 @@
+/*
+ * libDebug
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This library comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this library is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libDebug.h"
+#include "watch.h"
+
+static struct Watchpoint *createWatchpoint(struct debugWorkspace *ws,
+                                           unsigned long size);
+static void unlinkWatchpoint(struct Watchpoint *ptr,
+                             struct Watchpoint **list);
+static void freeWatchpoint(struct Watchpoint *ptr);
+static void readWatchpoint(struct debugWorkspace *ws,
+                           struct Watchpoint *ptr, unsigned char *buf);
+
+/*
+createWatchpoint()
+  Create a Watchpoint structure with buffers for a range of the
+given size
+*/
+
+static struct Watchpoint *
+createWatchpoint(struct debugWorkspace *ws, unsigned long size)
+
+{
+  struct Watchpoint *ptr;
+
+  ptr = (struct Watchpoint *) malloc(sizeof(struct Watchpoint));
+  if (!ptr)
+    return (0);
+
+  memset(ptr, '\0', sizeof(struct Watchpoint));
+
+  ptr->value = (unsigned char *) malloc(size);
+  ptr->old = (unsigned char *) malloc(size);
+  if (!ptr->value || !ptr->old)
+  {
+    freeWatchpoint(ptr);
+    return (0);
+  }
+
+  memset(ptr->value, '\0', size);
+  memset(ptr->old, '\0', size);
+
+  ptr->prev = 0;
+  ptr->next = ws->watch.list;
+  if (ptr->next)
+    ptr->next->prev = ptr;
+
+  ws->watch.list = ptr;
+
+  return (ptr);
+} /* createWatchpoint() */
+
+/*
+unlinkWatchpoint()
+  Unlink watchpoint from linked list
+
+Inputs: ptr  - structure to unlink
+        list - list to unlink from
+*/
+
+static void
+unlinkWatchpoint(struct Watchpoint *ptr, struct Watchpoint **list)
+
+{
+  assert(ptr != 0);
+
+  if (ptr->next)
+    ptr->next->prev = ptr->prev;
+
+  if (ptr->prev)
+    ptr->prev->next = ptr->next;
+  else
+    *list = ptr->next;
+} /* unlinkWatchpoint() */
+
+/*
+freeWatchpoint()
+  Free a Watchpoint structure and its buffers
+*/
+
+static void
+freeWatchpoint(struct Watchpoint *ptr)
+
+{
+  if (ptr->value)
+    free(ptr->value);
+
+  if (ptr->old)
+    free(ptr->old);
+
+  free(ptr);
+} /* freeWatchpoint() */
+
+/*
+readWatchpoint()
+  Read the current contents of a watched range. Bytes which cannot
+be read (the range is not mapped yet) read as zero.
+
+Inputs: ws  - debug workspace
+        ptr - watchpoint
+        buf - where to store ptr->size bytes
+*/
+
+static void
+readWatchpoint(struct debugWorkspace *ws, struct Watchpoint *ptr,
+               unsigned char *buf)
+
+{
+  long ret;
+
+  ret = x86readMemoryDebug(ws, ptr->address, buf, ptr->size);
+  if (ret < 0)
+    ret = 0;
+
+  if ((unsigned long) ret < ptr->size)
+    memset(buf + ret, '\0', ptr->size - ret);
+} /* readWatchpoint() */
+
+/*
+newWatchpoint()
+  Watch a range of the debugged process' memory for writes. If
+there is a process, its pages are protected right away, otherwise
+this happens when the next process is resumed.
+
+Inputs: ws      - debug workspace
+        address - start of range
+        size    - length of range
+
+Return: number of new watchpoint
+        -1 upon failure (errno is set)
+*/
+
+int
+newWatchpoint(struct debugWorkspace *ws, unsigned long address,
+              unsigned long size)
+
+{
+  struct Watchpoint *ptr;
+  int err;
+
+  if ((size == 0) || (address + size < address))
+  {
+    errno = EINVAL;
+    return (-1);
+  }
+
+  /*
+   * The set of protected pages is worked out again from scratch
+   */
+  if (watchActive(ws))
+    x86removeWatch(ws, &(ws->watch));
+
+  ptr = createWatchpoint(ws, size);
+  if (!ptr)
+  {
+    err = errno;
+
+    if (ws->watch.list && (ws->pid != NOPID))
+      x86insertWatch(ws, &(ws->watch));
+
+    errno = err;
+    return (-1);
+  }
+
+  ptr->address = address;
+  ptr->size = size;
+
+  if ((ws->pid != NOPID) && !x86insertWatch(ws, &(ws->watch)))
+  {
+    err = errno;
+
+    unlinkWatchpoint(ptr, &(ws->watch.list));
+    freeWatchpoint(ptr);
+
+    if (ws->watch.list)
+      x86insertWatch(ws, &(ws->watch));
+
+    errno = err;
+    return (-1);
+  }
+
+  /*
+   * Watchpoints are listed and deleted along with breakpoints, so
+   * they share their numbers
+   */
+  ptr->number = ws->breakNumber++;
+
+  return ((int) ptr->number);
+} /* newWatchpoint() */
+
+/*
+deleteWatchpoint()
+  Remove watchpoint from list, and give its pages back their
+original protection if no other watchpoint needs them
+*/
+
+void
+deleteWatchpoint(struct debugWorkspace *ws, struct Watchpoint *ptr)
+
+{
+  if (watchActive(ws))
+    x86removeWatch(ws, &(ws->watch));
+
+  unlinkWatchpoint(ptr, &(ws->watch.list));
+  freeWatchpoint(ptr);
+
+  if (ws->watch.list && (ws->pid != NOPID))
+    x86insertWatch(ws, &(ws->watch));
+} /* deleteWatchpoint() */
+
+/*
+clearWatchpoints()
+  Delete all watchpoints
+*/
+
+void
+clearWatchpoints(struct debugWorkspace *ws)
+
+{
+  struct Watchpoint *ptr,
+                    *next;
+
+  if (watchActive(ws))
+    x86removeWatch(ws, &(ws->watch));
+
+  ptr = ws->watch.list;
+  while (ptr)
+  {
+    next = ptr->next;
+    freeWatchpoint(ptr);
+    ptr = next;
+  }
+
+  ws->watch.list = 0;
+
+  if (ws->watch.pages)
+    free(ws->watch.pages);
+
+  ws->watch.pages = 0;
+  ws->watch.npages = 0;
+  ws->watch.pid = NOPID;
+} /* clearWatchpoints() */
+
+/*
+findWatchpointByNumber()
+  Find a certain watchpoint structure
+
+Inputs: ws     - debug workspace
+        number - watchpoint number
+
+Return: pointer to Watchpoint structure
+*/
+
+struct Watchpoint *
+findWatchpointByNumber(struct debugWorkspace *ws, unsigned int number)
+
+{
+  struct Watchpoint *ptr;
+
+  for (ptr = ws->watch.list; ptr; ptr = ptr->next)
+  {
+    if (ptr->number == number)
+      return (ptr);
+  }
+
+  return (0);
+} /* findWatchpointByNumber() */
+
+/*
+findWatchPage()
+  Find the protected page containing an address
+
+Inputs: watch   - watch list
+        address - address to look up
+
+Return: pointer to page, 0 if the address is not on a protected page
+*/
+
+struct watchPage *
+findWatchPage(struct Watch *watch, unsigned long address)
+
+{
+  unsigned long lo,
+                hi,
+                mid,
+                page;
+
+  page = address & ~((unsigned long) sysconf(_SC_PAGESIZE) - 1);
+
+  lo = 0;
+  hi = watch->npages;
+
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+
+    if (watch->pages[mid].address == page)
+      return (watch->pages + mid);
+    else if (watch->pages[mid].address < page)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return (0);
+} /* findWatchPage() */
+
+/*
+checkWatchpoints()
+  Compare every watched range with its previous contents. Called
+after an instruction has written to a protected page.
+
+Inputs: ws - debug workspace
+        pc - address of the instruction
+
+Return: the lowest numbered watchpoint which changed - all changed
+        watchpoints are updated, so a later check only reports
+        new changes
+        0 if none changed
+*/
+
+struct Watchpoint *
+checkWatchpoints(struct debugWorkspace *ws, unsigned long pc)
+
+{
+  struct Watchpoint *ptr,
+                    *hit;
+  unsigned char *tmp;
+  unsigned long first,
+                last;
+
+  hit = 0;
+
+  for (ptr = ws->watch.list; ptr; ptr = ptr->next)
+  {
+    readWatchpoint(ws, ptr, ptr->old);
+
+    if (!memcmp(ptr->old, ptr->value, ptr->size))
+      continue;
+
+    for (first = 0; ptr->old[first] == ptr->value[first]; ++first)
+      ;
+
+    for (last = ptr->size - 1; ptr->old[last] == ptr->value[last]; --last)
+      ;
+
+    /*
+     * ptr->old holds the new contents now - swap them around
+     */
+    tmp = ptr->value;
+    ptr->value = ptr->old;
+    ptr->old = tmp;
+
+    ptr->changed = first;
+    ptr->length = last - first + 1;
+    ptr->pc = pc;
+    ++(ptr->hits);
+
+    if (!hit || (ptr->number < hit->number))
+      hit = ptr;
+  }
+
+  return (hit);
+} /* checkWatchpoints() */
+
+/*
+initWatchpoints()
+  Record the current contents of every watched range - called when
+the pages are protected, so only changes made from then on are
+reported
+
+Inputs: ws - debug workspace
+*/
+
+void
+initWatchpoints(struct debugWorkspace *ws)
+
+{
+  struct Watchpoint *ptr;
+
+  for (ptr = ws->watch.list; ptr; ptr = ptr->next)
+    readWatchpoint(ws, ptr, ptr->value);
+} /* initWatchpoints() */
@@ -333,6 +333,28 @@ typedef struct
   Elf32_Word p_align;      /* alignment in memory and file */
 } Elf32_Phdr;
 
+/* p_type values */
+#define PT_NULL         0  /* program header table entry unused */
+#define PT_LOAD         1  /* loadable segment */
+#define PT_DYNAMIC      2  /* dynamic linking information */
+#define PT_INTERP       3  /* program interpreter */
+#define PT_NOTE         4  /* auxiliary information */
+#define PT_SHLIB        5  /* reserved */
+#define PT_PHDR         6  /* program header table itself */
+
+/* Note header */
+typedef struct
+{
+  Elf32_Word n_namesz;     /* length of note name */
+  Elf32_Word n_descsz;     /* length of note descriptor */
+  Elf32_Word n_type;       /* note type */
+} Elf32_Nhdr;
+
+/* n_type values found in core files */
+#define NT_PRSTATUS     1  /* process status (registers) */
+#define NT_PRFPREG      2  /* floating point registers */
+#define NT_PRPSINFO     3  /* process information */
+
 /* Symbol table entry */
 typedef struct
 {
@@ -383,6 +405,7 @@ struct elfWorkspace
   char *StringTable;               /* pointer to string header table */
   char *symbolStringTable;         /* pointer to symbol string table */
 
+  size_t fileSize;                 /* size of mapped file */
   int elfEndian;                   /* endian type of elf file */
 
   unsigned int virtualFileAddress; /* virtual file address */
@@ -418,6 +441,8 @@ struct elfCallbackParams
   void *printCallbackArgs;
   char *str;
   unsigned int address;
+  int (*symbolCallback)(void *, struct elfSymbolInfo *);
+  void *symbolCallbackArgs;
 };
 
 struct elfFlagsInfo
@@ -449,6 +474,15 @@ int findSectionELF(struct elfWorkspace *ws, char *name,
                    unsigned int address, struct elfSectionInfo *secinfo);
 int findSymbolELF(struct elfWorkspace *ws, char *name,
                   unsigned int address, struct elfSymbolInfo *syminfo);
+int findSectionByIndexELF(struct elfWorkspace *ws, unsigned int index,
+                          struct elfSectionInfo *secinfo, int *exec);
+void traverseSymbolsELF(struct elfWorkspace *ws,
+                        int (*callback)(void *, struct elfSymbolInfo *),
+                        void *args);
+int isCoreELF(struct elfWorkspace *ws);
+long findSegmentELF(struct elfWorkspace *ws, unsigned int address,
+                    unsigned char **ptr);
+void *findNoteELF(struct elfWorkspace *ws, unsigned int type, size_t *size);
 void printHeaderELF(struct elfWorkspace *ws,
                     void (*callback)(void *, const char *, ...), void *args);
 void printSectionInfoELF(struct elfWorkspace *ws, char *sname,
@@ -16,6 +16,11 @@
 
 #define OFF_MAXLINE     1024
 
+/*
+ * Length of a synthetic symbol name, such as "sub_08048000"
+ */
+#define OFF_SYNTHNAMELEN  16
+
 #ifndef INCLUDED_libOFF_fmt_aout_h
 #include "fmt_aout.h"       /* struct aoutWorkspace */
 #define INCLUDED_libOFF_fmt_aout_h
@@ -38,11 +43,29 @@ struct offParameters
   unsigned int entryPoint;              /* entry point of object file */
 };
 
+/*
+ * A symbol which is not in the object file, but was supplied by the
+ * caller (for example a function recovered from a stripped file)
+ */
+struct offSyntheticSymbol
+{
+  char name[OFF_SYNTHNAMELEN];         /* symbol name */
+  unsigned int address;                /* symbol address */
+  unsigned int size;                   /* symbol size */
+};
+
 struct offWorkspace
 {
   struct aoutWorkspace *aoutWorkspace_p;  /* a.out workspace */
   struct elfWorkspace *elfWorkspace_p;    /* elf workspace */
 
+  /*
+   * Synthetic symbols, sorted by address - used when the object
+   * file has no symbol of its own for an address
+   */
+  struct offSyntheticSymbol *syntheticSymbols;
+  unsigned long numSyntheticSymbols;
+
   int platformEndian;                     /* endianness of platform */
   int fileType;                           /* object file type (OFF_TYPE_xxx) */
 };
@@ -99,6 +122,19 @@ int findSectionOFF(struct offWorkspace *ws, char *name,
                    unsigned int address, struct offSectionInfo *secinfo);
 int findSymbolOFF(struct offWorkspace *ws, char *name,
                   unsigned int address, struct offSymbolInfo *syminfo);
+void setSyntheticSymbolsOFF(struct offWorkspace *ws,
+                           struct offSyntheticSymbol *symbols,
+                           unsigned long count);
+int traverseSectionsOFF(struct offWorkspace *ws,
+                        void (*callback)(void *, struct offSectionInfo *, int),
+                        void *args);
+void traverseSymbolsOFF(struct offWorkspace *ws,
+                        int (*callback)(void *, struct offSymbolInfo *),
+                        void *args);
+int isCoreOFF(struct offWorkspace *ws);
+long findMemoryOFF(struct offWorkspace *ws, unsigned int address,
+                   unsigned char **ptr);
+void *findNoteOFF(struct offWorkspace *ws, unsigned int type, size_t *size);
 void printHeaderOFF(struct offWorkspace *ws,
                     void (*callback)(void *, const char *, ...),
                     void *args);
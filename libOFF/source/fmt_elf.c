@@ -34,6 +34,7 @@ static Elf32_Sym *locateSymbolByAddressELF(struct elfWorkspace *ws,
 static int callbackPrintSymbolELF(void *data, void *params);
 static int callbackCompareSymbolNameELF(void *data, void *params);
 static int callbackCompareSymbolAddressELF(void *data, void *params);
+static int callbackTraverseSymbolELF(void *data, void *params);
 
 static char *ElfClass[] = {
   "Invalid class",             /* ELFCLASSNONE */
@@ -493,6 +494,7 @@ checkELF(struct elfWorkspace *ws, void *ptr, size_t size,
           ElfVersion[(unsigned char) ElfHeader->e_version]);
 
   ws->ElfHeader = ElfHeader;
+  ws->fileSize = size;
   ws->ProgramHeader = ProgramHeader;
   ws->SectionTable = SectionTable;
   ws->StringTable = StringTable;
@@ -726,6 +728,242 @@ findSymbolELF(struct elfWorkspace *ws, char *name,
   return (1);
 } /* findSymbolELF() */
 
+/*
+findSectionByIndexELF()
+  Look up a section by its index in the section header table, so
+the caller can visit every section in turn
+
+Inputs: ws      - elf workspace
+        index   - section index (starting at 0)
+        secinfo - where to store result
+        exec    - set to 1 if the section holds executable code which
+                  is present in the file, 0 if not
+
+Return: 1 if the section exists
+        0 if index is past the last section
+*/
+
+int
+findSectionByIndexELF(struct elfWorkspace *ws, unsigned int index,
+                      struct elfSectionInfo *secinfo, int *exec)
+
+{
+  Elf32_Shdr *secptr;
+
+  if (!ws->SectionTable || (index >= ws->ElfHeader->e_shnum))
+    return (0);
+
+  secptr = ws->SectionTable + index;
+
+  secinfo->name = ws->StringTable ? ws->StringTable + secptr->sh_name : "";
+  secinfo->address = ws->virtualFileAddress + secptr->sh_offset;
+  secinfo->offset = 0;
+
+  if (secptr->sh_type == SHT_NOBITS)
+    secinfo->size = 0;
+  else
+    secinfo->size = secptr->sh_size;
+
+  *exec = (secptr->sh_type == SHT_PROGBITS) &&
+          ((secptr->sh_flags & (SHF_ALLOC | SHF_EXECINSTR)) ==
+           (SHF_ALLOC | SHF_EXECINSTR)) &&
+          (secptr->sh_offset + secptr->sh_size <= ws->fileSize);
+
+  return (1);
+} /* findSectionByIndexELF() */
+
+/*
+traverseSymbolsELF()
+  Call a function for every symbol which names a location (section
+and file symbols are skipped)
+
+Inputs: ws       - elf workspace
+        callback - function to call with args and the symbol; it
+                   returns ST_CONTINUE, or ST_STOP to stop early
+        args     - args to callback
+
+Return: none
+*/
+
+void
+traverseSymbolsELF(struct elfWorkspace *ws,
+                   int (*callback)(void *, struct elfSymbolInfo *),
+                   void *args)
+
+{
+  struct elfCallbackParams callbackArgs;
+
+  if (!ws->symbolStringTable)
+    return;
+
+  callbackArgs.ws = ws;
+  callbackArgs.symbolCallback = callback;
+  callbackArgs.symbolCallbackArgs = args;
+
+  traverseSYM(ws->symbolWorkspace_p,
+              callbackTraverseSymbolELF,
+              &callbackArgs);
+} /* traverseSymbolsELF() */
+
+/*
+isCoreELF()
+  Determine whether the file is a core file
+
+Inputs: ws - elf workspace
+
+Return: 1 if the file is a core file
+        0 if not
+*/
+
+int
+isCoreELF(struct elfWorkspace *ws)
+
+{
+  if (!ws->ElfHeader)
+    return (0);
+
+  return (ws->ElfHeader->e_type == ET_CORE);
+} /* isCoreELF() */
+
+/*
+findSegmentELF()
+  Locate the file contents of the loadable segment containing a
+given virtual address. Nothing is copied - ptr is pointed straight
+into the mapped file.
+
+Inputs: ws      - elf workspace
+        address - virtual address to look up
+        ptr     - where to store pointer into the mapped file
+
+Return: number of bytes available at ptr (they run up to the end
+        of the segment's file image)
+        0 if the address is not backed by the file
+*/
+
+long
+findSegmentELF(struct elfWorkspace *ws, unsigned int address,
+               unsigned char **ptr)
+
+{
+  Elf32_Phdr *pptr;
+  unsigned int ii;
+  unsigned long filesz;
+
+  if (!ws->ElfHeader || !ws->ProgramHeader)
+    return (0);
+
+  if ((ws->ElfHeader->e_phoff +
+       ws->ElfHeader->e_phnum * sizeof(Elf32_Phdr)) > ws->fileSize)
+    return (0);
+
+  for (ii = 0; ii < ws->ElfHeader->e_phnum; ++ii)
+  {
+    pptr = ws->ProgramHeader + ii;
+
+    if (pptr->p_type != PT_LOAD)
+      continue;
+
+    if ((address < pptr->p_vaddr) ||
+        ((address - pptr->p_vaddr) >= pptr->p_filesz))
+      continue;
+
+    /*
+     * Segments of a truncated file only count as far as the file
+     * goes
+     */
+    if (pptr->p_offset >= ws->fileSize)
+      continue;
+
+    filesz = pptr->p_filesz;
+    if (filesz > (ws->fileSize - pptr->p_offset))
+      filesz = ws->fileSize - pptr->p_offset;
+
+    if ((address - pptr->p_vaddr) >= filesz)
+      continue;
+
+    *ptr = (unsigned char *) ws->ElfHeader +
+           pptr->p_offset +
+           (address - pptr->p_vaddr);
+
+    return ((long) (filesz - (address - pptr->p_vaddr)));
+  }
+
+  return (0);
+} /* findSegmentELF() */
+
+/*
+findNoteELF()
+  Locate the descriptor of the first note of a given type in the
+file's PT_NOTE segments
+
+Inputs: ws   - elf workspace
+        type - note type (NT_xxx)
+        size - where to store descriptor size
+
+Return: pointer to descriptor inside the mapped file
+        0 if there is no such note
+*/
+
+void *
+findNoteELF(struct elfWorkspace *ws, unsigned int type, size_t *size)
+
+{
+  Elf32_Phdr *pptr;
+  Elf32_Nhdr *note;
+  unsigned char *start,
+                *end,
+                *desc;
+  unsigned int ii;
+
+  if (!ws->ElfHeader || !ws->ProgramHeader)
+    return (0);
+
+  if ((ws->ElfHeader->e_phoff +
+       ws->ElfHeader->e_phnum * sizeof(Elf32_Phdr)) > ws->fileSize)
+    return (0);
+
+  for (ii = 0; ii < ws->ElfHeader->e_phnum; ++ii)
+  {
+    pptr = ws->ProgramHeader + ii;
+
+    if (pptr->p_type != PT_NOTE)
+      continue;
+
+    if ((pptr->p_offset > ws->fileSize) ||
+        (pptr->p_filesz > (ws->fileSize - pptr->p_offset)))
+      continue;
+
+    start = (unsigned char *) ws->ElfHeader + pptr->p_offset;
+    end = start + pptr->p_filesz;
+
+    /*
+     * Each note is a header followed by its name and descriptor,
+     * both padded to a multiple of 4 bytes
+     */
+    while ((start + sizeof(Elf32_Nhdr)) <= end)
+    {
+      note = (Elf32_Nhdr *) start;
+
+      if (note->n_namesz > (unsigned long) (end - start))
+        break;
+
+      desc = start + sizeof(Elf32_Nhdr) + ((note->n_namesz + 3) & ~3);
+      if ((desc > end) || (note->n_descsz > (unsigned long) (end - desc)))
+        break;
+
+      if (note->n_type == type)
+      {
+        *size = note->n_descsz;
+        return ((void *) desc);
+      }
+
+      start = desc + ((note->n_descsz + 3) & ~3);
+    }
+  }
+
+  return (0);
+} /* findNoteELF() */
+
 /*
 printHeaderELF()
   Print ELF header informaton
@@ -1461,3 +1699,39 @@ callbackCompareSymbolAddressELF(void *data, void *params)
 
   return (ST_CONTINUE);
 } /* callbackCompareSymbolAddressELF() */
+
+/*
+callbackTraverseSymbolELF()
+  Backend to traverseSymbolsELF(). Called from traverseSYM() to pass
+one symbol on to the caller's function
+
+Inputs: data   - symbol node data
+        params - struct elfCallbackParams containing the function
+
+Return: result of the caller's function
+*/
+
+static int
+callbackTraverseSymbolELF(void *data, void *params)
+
+{
+  struct elfCallbackParams *callbackArgs;
+  struct elfSymbolInfo syminfo;
+  Elf32_Sym *symptr;
+  int type;
+
+  symptr = (Elf32_Sym *) data;
+  callbackArgs = (struct elfCallbackParams *) params;
+
+  type = ELF32_ST_TYPE(symptr->st_info);
+  if ((type == STT_SECTION) || (type == STT_FILE) || !symptr->st_value)
+    return (ST_CONTINUE);
+
+  syminfo.name = callbackArgs->ws->symbolStringTable + symptr->st_name;
+  syminfo.address = symptr->st_value;
+  syminfo.offset = 0;
+  syminfo.size = symptr->st_size;
+
+  return ((*callbackArgs->symbolCallback)(callbackArgs->symbolCallbackArgs,
+                                          &syminfo));
+} /* callbackTraverseSymbolELF() */
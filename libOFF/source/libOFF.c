@@ -21,6 +21,21 @@
 #include "fmt_elf.h"
 #include "libOFF.h"
 
+/*
+ * Passes the caller's function through traverseSymbolsELF()
+ */
+struct offSymbolCallback
+{
+  int (*callback)(void *, struct offSymbolInfo *);
+  void *args;
+};
+
+static int callbackSymbolOFF(void *params, struct elfSymbolInfo *elfinfo);
+static int findSyntheticSymbolOFF(struct offWorkspace *ws, char *name,
+                                  unsigned int address,
+                                  struct offSymbolInfo *syminfo);
+static void freeSyntheticSymbolsOFF(struct offWorkspace *ws);
+
 char *EndianTypeOFF[] = {
   "little endian",     /* OFF_ENDIAN_LITTLE */
   "big endian"         /* OFF_ENDIAN_BIG */
@@ -107,6 +122,8 @@ termOFF(struct offWorkspace *ws)
   if (ws->elfWorkspace_p)
     termELF(ws->elfWorkspace_p);
 
+  freeSyntheticSymbolsOFF(ws);
+
   free(ws);
 } /* termOFF() */
 
@@ -236,6 +253,8 @@ void
 unloadSymbolsOFF(struct offWorkspace *ws)
 
 {
+  freeSyntheticSymbolsOFF(ws);
+
   switch (ws->fileType)
   {
     case OFF_TYPE_ELF:
@@ -376,9 +395,204 @@ findSymbolOFF(struct offWorkspace *ws, char *name,
     }
   } /* switch (ws->fileType) */
 
+  if (!ret && ws->numSyntheticSymbols)
+    ret = findSyntheticSymbolOFF(ws, name, address, syminfo);
+
   return (ret);
 } /* findSymbolOFF() */
 
+/*
+setSyntheticSymbolsOFF()
+  Supply symbols which are not in the object file. They are found
+by findSymbolOFF() and traverseSymbolsOFF() wherever the file has no
+symbol of its own, and are discarded by unloadSymbolsOFF().
+
+Inputs: ws      - off workspace
+        symbols - malloc()'d array of symbols sorted by address; the
+                  workspace takes it over and frees it
+        count   - number of symbols
+
+Return: none
+*/
+
+void
+setSyntheticSymbolsOFF(struct offWorkspace *ws,
+                       struct offSyntheticSymbol *symbols,
+                       unsigned long count)
+
+{
+  freeSyntheticSymbolsOFF(ws);
+
+  ws->syntheticSymbols = symbols;
+  ws->numSyntheticSymbols = count;
+} /* setSyntheticSymbolsOFF() */
+
+/*
+traverseSectionsOFF()
+  Call a function for every section of the file
+
+Inputs: ws       - off workspace
+        callback - function to call with args, the section and a flag
+                   which is 1 if the section holds executable code
+                   present in the file
+        args     - args to callback
+
+Return: number of sections visited
+*/
+
+int
+traverseSectionsOFF(struct offWorkspace *ws,
+                    void (*callback)(void *, struct offSectionInfo *, int),
+                    void *args)
+
+{
+  struct elfSectionInfo elfSecInfo;
+  struct offSectionInfo secinfo;
+  unsigned int ii;
+  int exec;
+
+  ii = 0;
+
+  if (ws->fileType == OFF_TYPE_ELF)
+  {
+    while (findSectionByIndexELF(ws->elfWorkspace_p, ii, &elfSecInfo, &exec))
+    {
+      secinfo.name = elfSecInfo.name;
+      secinfo.address = elfSecInfo.address;
+      secinfo.size = elfSecInfo.size;
+      secinfo.offset = elfSecInfo.offset;
+
+      (*callback)(args, &secinfo, exec);
+      ++ii;
+    }
+  }
+  else if (ws->fileType == OFF_TYPE_AOUT)
+  {
+    if (findSectionOFF(ws, ".text", 0, &secinfo))
+    {
+      (*callback)(args, &secinfo, 1);
+      ++ii;
+    }
+
+    if (findSectionOFF(ws, ".data", 0, &secinfo))
+    {
+      (*callback)(args, &secinfo, 0);
+      ++ii;
+    }
+  }
+
+  return ((int) ii);
+} /* traverseSectionsOFF() */
+
+/*
+traverseSymbolsOFF()
+  Call a function for every symbol which names a location
+
+Inputs: ws       - off workspace
+        callback - function to call with args and the symbol; it
+                   returns ST_CONTINUE, or ST_STOP to stop early
+        args     - args to callback
+
+Return: none
+*/
+
+void
+traverseSymbolsOFF(struct offWorkspace *ws,
+                   int (*callback)(void *, struct offSymbolInfo *),
+                   void *args)
+
+{
+  struct offSymbolCallback params;
+  struct offSymbolInfo syminfo;
+  unsigned long ii;
+
+  if (ws->fileType == OFF_TYPE_ELF)
+  {
+    params.callback = callback;
+    params.args = args;
+
+    traverseSymbolsELF(ws->elfWorkspace_p, callbackSymbolOFF, &params);
+  }
+
+  for (ii = 0; ii < ws->numSyntheticSymbols; ++ii)
+  {
+    syminfo.name = ws->syntheticSymbols[ii].name;
+    syminfo.address = ws->syntheticSymbols[ii].address;
+    syminfo.offset = 0;
+    syminfo.size = ws->syntheticSymbols[ii].size;
+
+    if ((*callback)(args, &syminfo) == ST_STOP)
+      break;
+  }
+} /* traverseSymbolsOFF() */
+
+/*
+isCoreOFF()
+  Determine whether the identified file is a core file
+
+Inputs: ws - off workspace
+
+Return: 1 if the file is a core file
+        0 if not
+*/
+
+int
+isCoreOFF(struct offWorkspace *ws)
+
+{
+  if (ws->fileType == OFF_TYPE_ELF)
+    return (isCoreELF(ws->elfWorkspace_p));
+
+  return (0);
+} /* isCoreOFF() */
+
+/*
+findMemoryOFF()
+  Find the file contents backing a virtual address of the memory
+image described by the file. The returned pointer points into the
+mapped file, so no data is copied.
+
+Inputs: ws      - off workspace
+        address - virtual address
+        ptr     - where to store pointer to the contents
+
+Return: number of contiguous bytes available at ptr
+        0 if the address is not backed by the file
+*/
+
+long
+findMemoryOFF(struct offWorkspace *ws, unsigned int address,
+              unsigned char **ptr)
+
+{
+  if (ws->fileType == OFF_TYPE_ELF)
+    return (findSegmentELF(ws->elfWorkspace_p, address, ptr));
+
+  return (0);
+} /* findMemoryOFF() */
+
+/*
+findNoteOFF()
+  Find a note (such as the registers of a core file) by type
+
+Inputs: ws   - off workspace
+        type - note type
+        size - where to store the size of the note
+
+Return: pointer to note contents inside the mapped file
+        0 if not found
+*/
+
+void *
+findNoteOFF(struct offWorkspace *ws, unsigned int type, size_t *size)
+
+{
+  if (ws->fileType == OFF_TYPE_ELF)
+    return (findNoteELF(ws->elfWorkspace_p, type, size));
+
+  return (0);
+} /* findNoteOFF() */
+
 /*
 printHeaderOFF()
   Print header information about the object file we are working with
@@ -496,6 +710,52 @@ printSymbolsOFF(struct offWorkspace *ws,
                 void *args)
 
 {
+  struct offSymbolInfo syminfo;
+  unsigned long ii;
+
+  if (ws->numSyntheticSymbols)
+  {
+    /*
+     * The file has no symbols of its own
+     */
+    if (name)
+    {
+      if (!findSyntheticSymbolOFF(ws, name, 0, &syminfo))
+      {
+        (*callback)(args, "No symbol found matching: %s", name);
+        return;
+      }
+
+      (*callback)(args, "%-25s %s", "Symbol name:", syminfo.name);
+      (*callback)(args, "%-25s 0x%08X", "Symbol address:", syminfo.address);
+      (*callback)(args,
+                  "%-25s 0x%08X (%d)",
+                  "Symbol size:",
+                  syminfo.size,
+                  syminfo.size);
+      (*callback)(args, "%-25s %s", "Symbol type:", "recovered function");
+    }
+    else
+    {
+      (*callback)(args,
+                  "%-10s %-30s %s",
+                  "Address",
+                  "Name (recovered)",
+                  "Size");
+
+      for (ii = 0; ii < ws->numSyntheticSymbols; ++ii)
+      {
+        (*callback)(args,
+                    "0x%08X %-30s %d",
+                    ws->syntheticSymbols[ii].address,
+                    ws->syntheticSymbols[ii].name,
+                    ws->syntheticSymbols[ii].size);
+      }
+    }
+
+    return;
+  }
+
   switch (ws->fileType)
   {
     case OFF_TYPE_ELF:
@@ -511,3 +771,114 @@ printSymbolsOFF(struct offWorkspace *ws,
     }
   } /* switch (ws->fileType) */
 } /* printSymbolsOFF() */
+
+/*
+findSyntheticSymbolOFF()
+  Find a synthetic symbol by name, or by an address inside it using
+a binary search
+
+Inputs: ws      - off workspace
+        name    - symbol name (0 to search by address)
+        address - symbol address
+        syminfo - where to store result
+
+Return: 1 if symbol found
+        0 if not
+*/
+
+static int
+findSyntheticSymbolOFF(struct offWorkspace *ws, char *name,
+                       unsigned int address, struct offSymbolInfo *syminfo)
+
+{
+  struct offSyntheticSymbol *symptr;
+  unsigned long low,
+                high,
+                mid;
+
+  symptr = 0;
+
+  if (name)
+  {
+    for (mid = 0; mid < ws->numSyntheticSymbols; ++mid)
+    {
+      if (!strcmp(ws->syntheticSymbols[mid].name, name))
+      {
+        symptr = ws->syntheticSymbols + mid;
+        break;
+      }
+    }
+  }
+  else
+  {
+    /*
+     * Find the last symbol starting at or below address
+     */
+    low = 0;
+    high = ws->numSyntheticSymbols;
+    while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (ws->syntheticSymbols[mid].address <= address)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+
+    if (low)
+    {
+      symptr = ws->syntheticSymbols + low - 1;
+      if (address - symptr->address >= symptr->size)
+        symptr = 0;
+    }
+  }
+
+  if (!symptr)
+    return (0);
+
+  syminfo->name = symptr->name;
+  syminfo->address = symptr->address;
+  syminfo->offset = name ? 0 : address - symptr->address;
+  syminfo->size = symptr->size;
+
+  return (1);
+} /* findSyntheticSymbolOFF() */
+
+/*
+freeSyntheticSymbolsOFF()
+  Free synthetic symbols
+*/
+
+static void
+freeSyntheticSymbolsOFF(struct offWorkspace *ws)
+
+{
+  if (ws->syntheticSymbols)
+    free(ws->syntheticSymbols);
+
+  ws->syntheticSymbols = 0;
+  ws->numSyntheticSymbols = 0;
+} /* freeSyntheticSymbolsOFF() */
+
+/*
+callbackSymbolOFF()
+  Backend to traverseSymbolsOFF(): convert an elf symbol and pass it
+on to the caller's function
+*/
+
+static int
+callbackSymbolOFF(void *params, struct elfSymbolInfo *elfinfo)
+
+{
+  struct offSymbolCallback *cb;
+  struct offSymbolInfo syminfo;
+
+  cb = (struct offSymbolCallback *) params;
+
+  syminfo.name = elfinfo->name;
+  syminfo.address = elfinfo->address;
+  syminfo.offset = elfinfo->offset;
+  syminfo.size = elfinfo->size;
+
+  return ((*cb->callback)(cb->args, &syminfo));
+} /* callbackSymbolOFF() */
@@ -0,0 +1,672 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module runs command scripts given with "ald -batch". A script
+ * contains ordinary ald commands, one per line, plus a few keywords
+ * which allow it to react to how the program stopped:
+ *
+ *   if <condition> ... [else ...] end
+ *   while <condition> ... end
+ *   print <text>
+ *   exit [code]
+ *
+ * Conditions (optionally preceded by "not"):
+ *
+ *   running          - a process is being debugged
+ *   exited           - the program has terminated
+ *   breakpoint [n]   - last stop was at a breakpoint (number n)
+ *   watchpoint [n]   - last stop was a write to a watched range (number n)
+ *   signal [sig]     - last stop was due to a signal (name or number)
+ *   syscall [call]   - last stop was a caught system call (name or number)
+ *   failed           - the last command failed
+ *
+ * A command which runs the program to its end (run, continue, step
+ * ...) is not counted as failed - test "exited" for that.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "alddefs.h"
+#include "batch.h"
+#include "command.h"
+#include "list.h"
+#include "main.h"
+#include "print.h"
+#include "signals.h"
+#include "systrace.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+ * Kinds of script lines
+ */
+#define BL_COMMAND   0
+#define BL_IF        1
+#define BL_ELSE      2
+#define BL_WHILE     3
+#define BL_END       4
+#define BL_PRINT     5
+#define BL_EXIT      6
+
+struct batchLine
+{
+  char *text;       /* command, or what follows the keyword */
+  int type;         /* BL_xxx */
+  int match;        /* index of matching else/end, or opening line of end */
+  int lineno;       /* line number in script */
+};
+
+struct batchScript
+{
+  char *filename;           /* script name */
+  struct batchLine *lines;  /* executable lines */
+  int nlines;               /* number of lines */
+  int failed;               /* did the last command fail? */
+};
+
+static struct batchScript *readScript(struct aldWorkspace *ws,
+                                      char *filename);
+static int addLine(struct aldWorkspace *ws, struct batchScript *script,
+                   char *text, int lineno, int *size);
+static int matchBlocks(struct aldWorkspace *ws,
+                       struct batchScript *script);
+static int evalCondition(struct aldWorkspace *ws,
+                         struct batchScript *script,
+                         struct batchLine *lptr, int *result);
+static void freeScript(struct batchScript *script);
+
+/*
+runBatch()
+  Execute a command script without user interaction
+
+Inputs: ws       - main workspace
+        filename - script file
+
+Return: exit status for ald (BATCH_xxx, or the script's own)
+*/
+
+int
+runBatch(struct aldWorkspace *ws, char *filename)
+
+{
+  struct batchScript *script;
+  struct batchLine *lptr;
+  char buffer[MAXLINE + 1];
+  char *endptr;
+  int status;
+  int result;
+  int last;
+  int ret;
+  int pc;
+
+  script = readScript(ws, filename);
+  if (!script)
+    return (BATCH_BADSCRIPT);
+
+  if (setjmp(ws->commandWorkspace_p->CmdParserEnv))
+  {
+    /*
+     * ^C - give up on the script (see procCommand())
+     */
+    endPrintBurst(ws->printWorkspace_p);
+    freeList(&(ws->toBeFreed));
+    freeScript(script);
+
+    return (BATCH_INTERRUPTED);
+  }
+
+  status = BATCH_OK;
+  pc = 0;
+
+  while (pc < script->nlines)
+  {
+    lptr = script->lines + pc;
+
+    switch (lptr->type)
+    {
+      case BL_COMMAND:
+      {
+        /*
+         * ProcessCommand() splits its argument in place
+         */
+        strncpy(buffer, lptr->text, MAXLINE);
+        buffer[MAXLINE] = '\0';
+
+        last = ws->lastTraceResult;
+        ws->lastTraceResult = (-1);
+
+        ret = ProcessCommand(ws, buffer);
+        if (ret < 0)
+        {
+          /*
+           * quit
+           */
+          pc = script->nlines;
+          break;
+        }
+
+        /*
+         * run, continue, step etc. report failure when the program
+         * terminates, but for a script that is just how the program
+         * stopped - analyzeTraceResult(): 4 = normal exit, 7 = killed
+         * by signal. Tell it apart from a real failure.
+         */
+        if (ws->lastTraceResult < 0)
+          ws->lastTraceResult = last;
+        else if ((ws->lastTraceResult == 4) || (ws->lastTraceResult == 7))
+          ret = 1;
+
+        script->failed = !ret;
+        if (!ret)
+          status = BATCH_FAILED;
+
+        ++pc;
+
+        break;
+      }
+
+      case BL_IF:
+      case BL_WHILE:
+      {
+        if (!evalCondition(ws, script, lptr, &result))
+        {
+          status = BATCH_BADSCRIPT;
+          pc = script->nlines;
+          break;
+        }
+
+        if (result)
+          ++pc;
+        else
+          pc = lptr->match + 1;
+
+        break;
+      }
+
+      case BL_ELSE:
+      {
+        /*
+         * End of the "if" part - skip the "else" part
+         */
+        pc = lptr->match + 1;
+
+        break;
+      }
+
+      case BL_END:
+      {
+        if (script->lines[lptr->match].type == BL_WHILE)
+          pc = lptr->match;
+        else
+          ++pc;
+
+        break;
+      }
+
+      case BL_PRINT:
+      {
+        Print(ws, P_COMMAND, "%s", lptr->text);
+        ++pc;
+
+        break;
+      }
+
+      case BL_EXIT:
+      {
+        if (*lptr->text)
+        {
+          status = (int) strtol(lptr->text, &endptr, 0);
+          if ((endptr == lptr->text) || (*endptr != '\0'))
+          {
+            Print(ws,
+                  P_ERROR,
+                  "%s:%d: invalid exit code: %s",
+                  script->filename,
+                  lptr->lineno,
+                  lptr->text);
+            status = BATCH_BADSCRIPT;
+          }
+        }
+
+        pc = script->nlines;
+
+        break;
+      }
+    } /* switch (lptr->type) */
+  } /* while (pc < script->nlines) */
+
+  freeScript(script);
+
+  return (status);
+} /* runBatch() */
+
+/*
+readScript()
+  Read a script file and match up its blocks
+
+Inputs: ws       - main workspace
+        filename - script file
+
+Return: pointer to script
+        0 if it could not be read or is malformed (an error has been
+        printed)
+*/
+
+static struct batchScript *
+readScript(struct aldWorkspace *ws, char *filename)
+
+{
+  struct batchScript *script;
+  FILE *fp;
+  char buf[MAXLINE];
+  char *bufptr,
+       *tmp;
+  int lineno;
+  int size;
+
+  fp = fopen(filename, "r");
+  if (!fp)
+  {
+    Print(ws, P_ERROR, "Unable to open %s: %s", filename, strerror(errno));
+    return (0);
+  }
+
+  script = (struct batchScript *) malloc(sizeof(struct batchScript));
+  if (!script)
+  {
+    Print(ws, P_ERROR, "readScript: malloc failed: %s", strerror(errno));
+    fclose(fp);
+    return (0);
+  }
+
+  memset(script, '\0', sizeof(struct batchScript));
+  script->filename = filename;
+
+  size = 0;
+  lineno = 0;
+
+  while (fgets(buf, MAXLINE, fp))
+  {
+    ++lineno;
+
+    if ((tmp = strchr(buf, '\n')))
+      *tmp = '\0';
+
+    bufptr = buf;
+    while ((*bufptr == ' ') || (*bufptr == '\t'))
+      ++bufptr;
+
+    if ((*bufptr == '\0') || (*bufptr == '#'))
+      continue;
+
+    if (!addLine(ws, script, bufptr, lineno, &size))
+    {
+      fclose(fp);
+      freeScript(script);
+      return (0);
+    }
+  }
+
+  fclose(fp);
+
+  if (!matchBlocks(ws, script))
+  {
+    freeScript(script);
+    return (0);
+  }
+
+  return (script);
+} /* readScript() */
+
+/*
+addLine()
+  Add a line to a script, recognizing keywords
+
+Inputs: ws     - main workspace
+        script - script
+        text   - line without leading whitespace
+        lineno - line number in file
+        size   - number of lines allocated - updated
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+addLine(struct aldWorkspace *ws, struct batchScript *script, char *text,
+        int lineno, int *size)
+
+{
+  struct batchLine *lptr;
+  char *args;
+  int len;
+
+  if (script->nlines == *size)
+  {
+    *size += 64;
+    lptr = (struct batchLine *) realloc(script->lines,
+                                        sizeof(struct batchLine) * *size);
+    if (!lptr)
+    {
+      Print(ws, P_ERROR, "addLine: realloc failed: %s", strerror(errno));
+      return (0);
+    }
+
+    script->lines = lptr;
+  }
+
+  lptr = script->lines + script->nlines;
+  lptr->type = BL_COMMAND;
+  lptr->match = -1;
+  lptr->lineno = lineno;
+
+  /*
+   * Split off the first word to check for a keyword
+   */
+  len = strcspn(text, " \t");
+  args = text + len;
+  while ((*args == ' ') || (*args == '\t'))
+    ++args;
+
+  if ((len == 2) && !Strncasecmp(text, "if", len))
+    lptr->type = BL_IF;
+  else if ((len == 4) && !Strncasecmp(text, "else", len))
+    lptr->type = BL_ELSE;
+  else if ((len == 5) && !Strncasecmp(text, "while", len))
+    lptr->type = BL_WHILE;
+  else if ((len == 3) && !Strncasecmp(text, "end", len))
+    lptr->type = BL_END;
+  else if ((len == 5) && !Strncasecmp(text, "print", len))
+    lptr->type = BL_PRINT;
+  else if ((len == 4) && !Strncasecmp(text, "exit", len))
+    lptr->type = BL_EXIT;
+
+  lptr->text = Strdup((lptr->type == BL_COMMAND) ? text : args);
+  if (!lptr->text)
+  {
+    Print(ws, P_ERROR, "addLine: malloc failed: %s", strerror(errno));
+    return (0);
+  }
+
+  ++(script->nlines);
+
+  return (1);
+} /* addLine() */
+
+/*
+matchBlocks()
+  Link each if/else/while with the line which ends it, and each end
+with the line which opened it
+
+Inputs: ws     - main workspace
+        script - script
+
+Return: 1 if the blocks are properly nested
+        0 if not (an error has been printed)
+*/
+
+static int
+matchBlocks(struct aldWorkspace *ws, struct batchScript *script)
+
+{
+  struct batchLine *lptr;
+  int stack[BATCH_MAXDEPTH];
+  int depth;
+  int ii;
+
+  depth = 0;
+
+  for (ii = 0; ii < script->nlines; ++ii)
+  {
+    lptr = script->lines + ii;
+
+    switch (lptr->type)
+    {
+      case BL_IF:
+      case BL_WHILE:
+      {
+        if (depth == BATCH_MAXDEPTH)
+        {
+          Print(ws,
+                P_ERROR,
+                "%s:%d: blocks nested too deeply",
+                script->filename,
+                lptr->lineno);
+          return (0);
+        }
+
+        stack[depth++] = ii;
+
+        break;
+      }
+
+      case BL_ELSE:
+      {
+        if (!depth || (script->lines[stack[depth - 1]].type != BL_IF))
+        {
+          Print(ws,
+                P_ERROR,
+                "%s:%d: else without if",
+                script->filename,
+                lptr->lineno);
+          return (0);
+        }
+
+        script->lines[stack[depth - 1]].match = ii;
+        stack[depth - 1] = ii;
+
+        break;
+      }
+
+      case BL_END:
+      {
+        if (!depth)
+        {
+          Print(ws,
+                P_ERROR,
+                "%s:%d: end without if or while",
+                script->filename,
+                lptr->lineno);
+          return (0);
+        }
+
+        --depth;
+        script->lines[stack[depth]].match = ii;
+        lptr->match = stack[depth];
+
+        break;
+      }
+
+      default: break;
+    } /* switch (lptr->type) */
+  }
+
+  if (depth)
+  {
+    Print(ws,
+          P_ERROR,
+          "%s:%d: block is never ended",
+          script->filename,
+          script->lines[stack[depth - 1]].lineno);
+    return (0);
+  }
+
+  return (1);
+} /* matchBlocks() */
+
+/*
+evalCondition()
+  Evaluate the condition of an if/while line
+
+Inputs: ws     - main workspace
+        script - script
+        lptr   - if/while line
+        result - set to 1 if the condition holds, 0 if not
+
+Return: 1 if successful
+        0 if the condition is malformed (an error has been printed)
+*/
+
+static int
+evalCondition(struct aldWorkspace *ws, struct batchScript *script,
+              struct batchLine *lptr, int *result)
+
+{
+  struct aSignal *sptr;
+  char buffer[MAXLINE + 1];
+  char **av;
+  char *cond,
+       *arg,
+       *endptr;
+  int ac;
+  int negate;
+  int value;
+  int num;
+
+  strncpy(buffer, lptr->text, MAXLINE);
+  buffer[MAXLINE] = '\0';
+
+  ac = SplitBuffer(buffer, &av);
+  if (ac <= 0)
+  {
+    if (ac == 0)
+      free(av);
+
+    Print(ws,
+          P_ERROR,
+          "%s:%d: missing condition",
+          script->filename,
+          lptr->lineno);
+    return (0);
+  }
+
+  negate = 0;
+  if (!Strcasecmp(av[0], "not") || !strcmp(av[0], "!"))
+    negate = 1;
+
+  cond = (negate < ac) ? av[negate] : "";
+  arg = ((negate + 1) < ac) ? av[negate + 1] : 0;
+  value = -1;
+
+  if (!Strcasecmp(cond, "running"))
+    value = isRunningDebug(ws->debugWorkspace_p) ? 1 : 0;
+  else if (!Strcasecmp(cond, "exited"))
+  {
+    /*
+     * analyzeTraceResult(): 4 = normal exit, 7 = killed by signal
+     */
+    value = ((ws->lastTraceResult == 4) || (ws->lastTraceResult == 7));
+  }
+  else if (!Strcasecmp(cond, "failed"))
+    value = script->failed;
+  else if (!Strcasecmp(cond, "breakpoint") ||
+           !Strcasecmp(cond, "watchpoint"))
+  {
+    /*
+     * analyzeTraceResult(): 3 = breakpoint, 8 = watchpoint
+     */
+    if (!Strcasecmp(cond, "breakpoint"))
+      value = (ws->lastTraceResult == 3);
+    else
+      value = (ws->lastTraceResult == 8);
+
+    if (value && arg)
+    {
+      num = (int) strtol(arg, &endptr, 0);
+      if ((endptr == arg) || (*endptr != '\0'))
+        value = -1;
+      else
+        value = (num == ws->lastTraceData);
+    }
+  }
+  else if (!Strcasecmp(cond, "signal"))
+  {
+    value = (ws->lastTraceResult == 2);
+    if (value && arg)
+    {
+      num = (int) strtol(arg, &endptr, 0);
+      if ((endptr != arg) && (*endptr == '\0'))
+        value = (num == ws->lastTraceData);
+      else
+      {
+        sptr = GetSignal(ws->lastTraceData);
+        value = sptr &&
+                (!Strcasecmp(sptr->name, arg) ||
+                 (!Strncasecmp(sptr->name, "SIG", 3) &&
+                  !Strcasecmp(sptr->name + 3, arg)));
+      }
+    }
+  }
+
+  else if (!Strcasecmp(cond, "syscall"))
+  {
+    /*
+     * analyzeTraceResult(): 9 = caught system call
+     */
+    value = (ws->lastTraceResult == 9);
+    if (value && arg)
+    {
+      num = FindSyscall(ws, arg);
+      if (num < 0)
+        value = -1;
+      else
+        value = (num == ws->lastTraceData);
+    }
+  }
+
+  if (value < 0)
+  {
+    Print(ws,
+          P_ERROR,
+          "%s:%d: invalid condition: %s",
+          script->filename,
+          lptr->lineno,
+          lptr->text);
+    free(av);
+    return (0);
+  }
+
+  *result = negate ? !value : value;
+
+  free(av);
+
+  return (1);
+} /* evalCondition() */
+
+/*
+freeScript()
+  Free a script and its lines
+*/
+
+static void
+freeScript(struct batchScript *script)
+
+{
+  int ii;
+
+  for (ii = 0; ii < script->nlines; ++ii)
+    free(script->lines[ii].text);
+
+  if (script->lines)
+    free(script->lines);
+
+  free(script);
+} /* freeScript() */
@@ -0,0 +1,467 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "blocks.h"
+#include "defs.h"
+#include "main.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * Opcodes which end a basic block without a relative target
+ */
+#define OP_CALLREL      0xE8   /* call rel32 */
+#define OP_RETIMM       0xC2   /* ret imm16 */
+#define OP_RET          0xC3   /* ret */
+#define OP_RETFIMM      0xCA   /* retf imm16 */
+#define OP_RETF         0xCB   /* retf */
+#define OP_IRET         0xCF   /* iret */
+#define OP_GRP5         0xFF   /* inc/dec/call/jmp r/m */
+
+/*
+ * Symbol addresses inside the range being swept, collected from
+ * libOFF - decoding starts over at each of them
+ */
+struct blockSymbols
+{
+  unsigned long start;        /* range start */
+  unsigned long end;          /* range end */
+
+  unsigned long *addrs;       /* symbol addresses */
+  long num;
+  long max;
+
+  int failed;                 /* malloc failed */
+};
+
+static int endsBlock(unsigned char *code, long len, unsigned int target);
+static int callbackBlockSymbol(void *args, struct offSymbolInfo *syminfo);
+static int compareBlockSymbol(const void *a, const void *b);
+
+/*
+endsBlock()
+  Determine whether an instruction transfers control elsewhere, so
+that the following instruction starts a new basic block. Calls are
+not counted - execution normally comes back to the next instruction.
+
+Inputs: code   - instruction bytes
+        len    - instruction length
+        target - relative branch target reported by the disassembler
+                 (0 if none)
+
+Return: 1 if the instruction ends a block
+        0 if not
+*/
+
+static int
+endsBlock(unsigned char *code, long len, unsigned int target)
+
+{
+  unsigned char *ptr;
+
+  /*
+   * Skip prefixes (branch hints, "rep ret" etc)
+   */
+  ptr = code;
+  while ((ptr < code + len - 1) &&
+         ((*ptr == 0x2E) || (*ptr == 0x3E) || (*ptr == 0x66) ||
+          (*ptr == 0x67) || (*ptr == 0xF2) || (*ptr == 0xF3)))
+    ++ptr;
+
+  if (target)
+    return (*ptr != OP_CALLREL);
+
+  switch (*ptr)
+  {
+    case OP_RETIMM:
+    case OP_RET:
+    case OP_RETFIMM:
+    case OP_RETF:
+    case OP_IRET:
+    {
+      return (1);
+    }
+
+    case OP_GRP5:
+    {
+      /*
+       * jmp r/m (/4) and jmp far (/5)
+       */
+      if (ptr < code + len - 1)
+        return ((((ptr[1] >> 3) & 7) == 4) || (((ptr[1] >> 3) & 7) == 5));
+
+      break;
+    }
+
+    default:
+    {
+      break;
+    }
+  }
+
+  return (0);
+} /* endsBlock() */
+
+/*
+callbackBlockSymbol()
+  Called by traverseSymbolsOFF() - remember the addresses of symbols
+inside the range
+
+Return: ST_CONTINUE
+        ST_STOP if memory is exhausted
+*/
+
+static int
+callbackBlockSymbol(void *args, struct offSymbolInfo *syminfo)
+
+{
+  struct blockSymbols *syms;
+  unsigned long *ptr;
+
+  syms = (struct blockSymbols *) args;
+
+  if ((syminfo->address < syms->start) || (syminfo->address >= syms->end))
+    return (ST_CONTINUE);
+
+  if (syms->num == syms->max)
+  {
+    syms->max += 256;
+    ptr = (unsigned long *) realloc(syms->addrs,
+                                    sizeof(unsigned long) * syms->max);
+    if (!ptr)
+    {
+      syms->failed = 1;
+      return (ST_STOP);
+    }
+
+    syms->addrs = ptr;
+  }
+
+  syms->addrs[syms->num++] = syminfo->address;
+
+  return (ST_CONTINUE);
+} /* callbackBlockSymbol() */
+
+/*
+compareBlockSymbol()
+  qsort() comparison - order addresses
+*/
+
+static int
+compareBlockSymbol(const void *a, const void *b)
+
+{
+  unsigned long aa,
+                bb;
+
+  aa = *(const unsigned long *) a;
+  bb = *(const unsigned long *) b;
+
+  if (aa < bb)
+    return (-1);
+  else if (aa > bb)
+    return (1);
+
+  return (0);
+} /* compareBlockSymbol() */
+
+/*
+findBlocks()
+  Find the basic blocks in a range of the debugged process' code.
+The range is disassembled from its start; a block begins at the
+start, at every branch or call target inside the range, and after
+every jump or return. Only addresses which are instruction
+boundaries of this sweep are returned.
+
+Decoding starts over at every symbol address, as the instruction
+index does (see indexSection()). A byte which cannot be decoded means
+we ran into data or padding, and cannot tell where the instructions
+after it begin - nothing is decoded from there up to the next symbol,
+so no breakpoints are put in the middle of an instruction or in data.
+
+Inputs: ws     - ald workspace
+        start  - start of range
+        bytes  - size of range
+        blocks - modified to point to an array of block addresses,
+                 in ascending order, which the caller must free
+
+Return: number of blocks found
+        -1 if an error occurs
+*/
+
+long
+findBlocks(struct aldWorkspace *ws, unsigned long start,
+           unsigned long bytes, unsigned long **blocks)
+
+{
+  struct blockSymbols syms;
+  unsigned char *code,
+                *marks;
+  char buffer[MAXLINE];
+  long ndumped,
+       offset,
+       nextsym,
+       symidx,
+       len,
+       num;
+  unsigned int target;
+
+  *blocks = 0;
+
+  code = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                            &code,
+                            start,
+                            bytes + MAX_OPCODE_LEN);
+  if (ndumped > (long) bytes)
+    ndumped = (long) bytes;
+
+  if (ndumped <= 0)
+  {
+    if (code)
+      free(code);
+
+    return (0);
+  }
+
+  /*
+   * Bit 0 of each mark is set at instruction boundaries, bit 1
+   * at block starts
+   */
+  marks = (unsigned char *) calloc((size_t) ndumped, 1);
+  if (!marks)
+  {
+    free(code);
+    return (-1);
+  }
+
+  memset(&syms, '\0', sizeof(syms));
+  syms.start = start;
+  syms.end = start + (unsigned long) ndumped;
+
+  traverseSymbolsOFF(ws->offWorkspace_p, callbackBlockSymbol, &syms);
+
+  if (syms.failed)
+  {
+    if (syms.addrs)
+      free(syms.addrs);
+
+    free(marks);
+    free(code);
+    errno = ENOMEM;
+    return (-1);
+  }
+
+  if (syms.num)
+  {
+    qsort(syms.addrs,
+          syms.num,
+          sizeof(unsigned long),
+          compareBlockSymbol);
+  }
+
+  marks[0] |= 2;
+
+  symidx = 0;
+  offset = 0;
+  while (offset < ndumped)
+  {
+    if (symidx < syms.num)
+      nextsym = (long) (syms.addrs[symidx] - start);
+    else
+      nextsym = ndumped;
+
+    if (offset >= nextsym)
+    {
+      /*
+       * We reached (or decoded past) a symbol - start over from it
+       */
+      offset = nextsym;
+      ++symidx;
+      continue;
+    }
+
+    len = procDisasm(ws->disasmWorkspace_p,
+                     code + offset,
+                     buffer,
+                     (unsigned int) (start + offset));
+    if (len <= 0)
+    {
+      /*
+       * Unknown instruction or data - we are out of step until the
+       * next symbol
+       */
+      offset = nextsym;
+      continue;
+    }
+
+    marks[offset] |= 1;
+
+    target = ws->disasmWorkspace_p->effectiveAddress;
+    if (target && (target >= start) && (target - start < (unsigned long) ndumped))
+      marks[target - start] |= 2;
+
+    if (endsBlock(code + offset, len, target) && (offset + len < ndumped))
+      marks[offset + len] |= 2;
+
+    offset += len;
+  }
+
+  if (syms.addrs)
+    free(syms.addrs);
+
+  num = 0;
+  for (offset = 0; offset < ndumped; ++offset)
+  {
+    if (marks[offset] == 3)
+      ++num;
+  }
+
+  if (num > 0)
+  {
+    *blocks = (unsigned long *) malloc(sizeof(unsigned long) * num);
+    if (!*blocks)
+    {
+      free(marks);
+      free(code);
+      return (-1);
+    }
+
+    num = 0;
+    for (offset = 0; offset < ndumped; ++offset)
+    {
+      if (marks[offset] == 3)
+        (*blocks)[num++] = start + offset;
+    }
+  }
+
+  free(marks);
+  free(code);
+
+  return (num);
+} /* findBlocks() */
+
+/*
+reportCoverage()
+  Output block coverage of the debugged process: a summary line,
+then for each function the number of blocks executed and a bitmap
+of its blocks ('#' executed, '.' not)
+
+Inputs: ws - ald workspace
+*/
+
+void
+reportCoverage(struct aldWorkspace *ws)
+
+{
+  struct Coverage *cov;
+  struct offSymbolInfo symInfo;
+  unsigned long ii,
+                jj,
+                first,   /* first site of current function */
+                hits,
+                symaddr,
+                nextaddr;
+  char *name;
+  char bitmap[BLOCKS_PER_LINE + 1];
+  int len;
+
+  cov = &(ws->debugWorkspace_p->coverage);
+
+  if (cov->count == 0)
+  {
+    Print(ws, P_COMMAND, "No coverage information");
+    return;
+  }
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  Print(ws,
+        P_COMMAND,
+        "Coverage: %lu of %lu blocks executed (%.1f%%)",
+        cov->hits,
+        cov->count,
+        (100.0 * cov->hits) / cov->count);
+
+  ii = 0;
+  while (ii < cov->count)
+  {
+    /*
+     * Gather the sites which belong to the same symbol
+     */
+    if (findSymbolOFF(ws->offWorkspace_p, 0, cov->sites[ii].address, &symInfo))
+    {
+      symaddr = symInfo.address;
+      name = symInfo.name;
+    }
+    else
+    {
+      symaddr = cov->sites[ii].address;
+      name = 0;
+    }
+
+    first = ii;
+    hits = 0;
+
+    do
+    {
+      if (cov->sites[ii].hit)
+        ++hits;
+
+      ++ii;
+
+      if (ii >= cov->count)
+        break;
+
+      if (findSymbolOFF(ws->offWorkspace_p, 0, cov->sites[ii].address, &symInfo))
+        nextaddr = symInfo.address;
+      else
+        nextaddr = cov->sites[ii].address;
+    } while (name && (nextaddr == symaddr));
+
+    if (name)
+    {
+      Print(ws, P_COMMAND, "\n%6.1f%% %5lu/%-5lu %s",
+            (100.0 * hits) / (ii - first),
+            hits,
+            ii - first,
+            name);
+    }
+    else
+    {
+      Print(ws, P_COMMAND, "\n%6.1f%% %5lu/%-5lu 0x%08lX",
+            (100.0 * hits) / (ii - first),
+            hits,
+            ii - first,
+            symaddr);
+    }
+
+    for (jj = first; jj < ii; jj += BLOCKS_PER_LINE)
+    {
+      for (len = 0; (len < BLOCKS_PER_LINE) && (jj + len < ii); ++len)
+        bitmap[len] = cov->sites[jj + len].hit ? '#' : '.';
+
+      bitmap[len] = '\0';
+
+      Print(ws, P_COMMAND, "  0x%08lX  %s", cov->sites[jj].address, bitmap);
+    }
+  }
+
+  endPrintBurst(ws->printWorkspace_p);
+} /* reportCoverage() */
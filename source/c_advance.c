@@ -0,0 +1,91 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "display.h"
+#include "frame.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "terminal.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+
+/*
+c_advance()
+  Continue the program until it reaches a given address, or the
+current function returns, whichever comes first
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_advance(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int data,
+      num,
+      ret;
+  unsigned long addrs[2], /* target and return address */
+                frame;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: advance <address | symbol>");
+    return (0);
+  }
+
+  if (!resolveAddress(ws, av[1], &addrs[0]))
+  {
+    Print(ws, P_ERROR, MSG_INVSYM, av[1]);
+    return (0);
+  }
+
+  num = 1;
+
+  /*
+   * Also stop if the current function returns before the target
+   * is reached. The target itself may lie in a deeper call, so
+   * arrivals are not filtered by frame.
+   */
+  if (isRunningDebug(ws->debugWorkspace_p) &&
+      getReturnAddress(ws, &addrs[1], &frame) &&
+      (addrs[1] != addrs[0]))
+    ++num;
+
+  /*
+   * Restore the child's terminal state
+   */
+  restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+
+  ret = runToDebug(ws->debugWorkspace_p, addrs, num, 0, &data);
+
+  /*
+   * Save the child's terminal state and restore the original
+   * terminal settings in case the child messed with them.
+   */
+  saveTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+  restoreTerminal(&(ws->terminalWorkspace_p->ParentAttributes));
+
+  if (analyzeTraceResult(ws, ret, data) == 0)
+    return (0);
+
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_advance() */
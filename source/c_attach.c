@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include "disassemble.h"
+#include "display.h"
 #include "main.h"
 #include "msg.h"
 #include "print.h"
@@ -67,21 +68,10 @@ c_attach(struct aldWorkspace *ws, int ac, char **av)
         "Attached to process id %d",
         pid);
 
-  if (IsSetStepDisplayRegs(ws))
-  {
-    /*
-     * Update and display new register values
-     */
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_GENERAL);
-  }
-
-  if (IsSetStepDisplayFpRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_FPREGS);
-
-  if (IsSetStepDisplayMmxRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_MMXREGS);
-
-  DisplayNextInstruction(ws);
+  /*
+   * Display registers, memory and the next instruction
+   */
+  doStepDisplay(ws);
 
   awSetAttached(ws);
 
@@ -0,0 +1,162 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "print.h"
+#include "systrace.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static void showCatch(struct aldWorkspace *ws);
+
+/*
+c_catch()
+  Select system calls to catch. The kernel stops the program only
+for caught calls, so the rest run at full speed. Depending on "set
+catch-log", the program either stops at each caught call or keeps
+running while the calls and their return values are printed. The
+list takes effect the next time the program is started.
+
+Format for this command:
+  catch [syscall <name | number> ...]
+  catch clear
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_catch(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int number,
+      ii;
+
+  if (ac < 2)
+  {
+    showCatch(ws);
+    return (1);
+  }
+
+  if (!Strcasecmp(av[1], "clear"))
+  {
+    clearCatch(ws->debugWorkspace_p);
+    Print(ws, P_COMMAND, "No system calls are caught");
+    return (1);
+  }
+
+  if (Strcasecmp(av[1], "syscall"))
+  {
+    Print(ws, P_ERROR, "Syntax: catch [syscall <name | number> ...]");
+    Print(ws, P_ERROR, "        catch clear");
+    return (0);
+  }
+
+  if (ac < 3)
+  {
+    Print(ws, P_ERROR, "Syntax: catch syscall <name | number> ...");
+    return (0);
+  }
+
+  /*
+   * Check every name first so a typo does not leave half the list
+   * added
+   */
+  for (ii = 2; ii < ac; ++ii)
+  {
+    if (FindSyscall(ws, av[ii]) < 0)
+    {
+      Print(ws, P_ERROR, "Unknown system call: %s", av[ii]);
+      return (0);
+    }
+  }
+
+  for (ii = 2; ii < ac; ++ii)
+  {
+    number = FindSyscall(ws, av[ii]);
+    catchSyscall(ws->debugWorkspace_p, number, 1);
+  }
+
+  showCatch(ws);
+
+  if (isRunningDebug(ws->debugWorkspace_p))
+  {
+    Print(ws,
+          P_COMMAND,
+          "Changes take effect when the program is restarted");
+  }
+
+  return (1);
+} /* c_catch() */
+
+/*
+showCatch()
+  List the system calls being caught
+
+Inputs: ws - ald workspace
+*/
+
+static void
+showCatch(struct aldWorkspace *ws)
+
+{
+  char buf[MAXLINE];
+  char *name;
+  int number,
+      len;
+
+  if (!ws->debugWorkspace_p->catch.count)
+  {
+    Print(ws, P_COMMAND, "No system calls are caught");
+    return;
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "Caught system calls (%s):",
+        ws->debugWorkspace_p->catch.log ? "logged" : "stop");
+
+  *buf = '\0';
+  len = 0;
+
+  for (number = 0; number < CATCH_MAXSYSCALL; ++number)
+  {
+    if (!isCaughtSyscall(ws->debugWorkspace_p, number))
+      continue;
+
+    if (len > 60)
+    {
+      Print(ws, P_COMMAND, "  %s", buf);
+      *buf = '\0';
+      len = 0;
+    }
+
+    name = getSyscallNameDebug(ws->debugWorkspace_p, number);
+    if (name)
+      len += Sprintf(buf + len, "%s%s", len ? " " : "", name);
+    else
+      len += Sprintf(buf + len, "%s%d", len ? " " : "", number);
+  }
+
+  if (len)
+    Print(ws, P_COMMAND, "  %s", buf);
+} /* showCatch() */
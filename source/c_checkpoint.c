@@ -0,0 +1,71 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+c_checkpoint()
+  Take a snapshot of the debugged process which can later be
+resumed with "restart"
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_checkpoint(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int num;
+  unsigned long address;
+  struct offSymbolInfo symInfo;
+  char sstr[MAXLINE];
+
+  num = newCheckpoint(ws->debugWorkspace_p);
+  if (num == (-1))
+  {
+    Print(ws,
+          P_ERROR,
+          "Unable to checkpoint process: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  address = getAddressDebug(ws->debugWorkspace_p);
+
+  if (findSymbolOFF(ws->offWorkspace_p, 0, address, &symInfo))
+    Sprintf(sstr, " (%s+0x%x)", symInfo.name, symInfo.offset);
+  else
+    *sstr = '\0';
+
+  Print(ws,
+        P_COMMAND,
+        "Checkpoint %d taken at 0x%08lX%s",
+        num,
+        address,
+        sstr);
+
+  return (1);
+} /* c_checkpoint() */
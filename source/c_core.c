@@ -0,0 +1,76 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <string.h>
+
+#include "core.h"
+#include "main.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+c_core()
+  Load or unload a core file of the current program
+
+Format for this command:
+  core [<filename> | -unload]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_core(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  if (ac < 2)
+  {
+    if (!awIsCoreLoaded(ws))
+    {
+      Print(ws, P_COMMAND, "Syntax: core <filename | -unload>");
+      return (0);
+    }
+
+    Print(ws,
+          P_COMMAND,
+          "Core file: %s (%lu bytes)",
+          ws->coreFileName,
+          (unsigned long) ws->CoreSize);
+
+    if (isRunningDebug(ws->debugWorkspace_p))
+      Print(ws, P_COMMAND, "Not in use while the process is running");
+
+    return (1);
+  }
+
+  if (!Strncasecmp(av[1], "-unload", strlen(av[1])))
+  {
+    if (!awIsCoreLoaded(ws))
+    {
+      Print(ws, P_COMMAND, "No core file is loaded");
+      return (0);
+    }
+
+    unloadCore(ws);
+
+    return (1);
+  }
+
+  return (loadCore(ws, av[1]));
+} /* c_core() */
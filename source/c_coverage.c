@@ -0,0 +1,176 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "blocks.h"
+#include "command.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+static int c_coverage_start(struct aldWorkspace *ws, int ac, char **av);
+static int c_coverage_report(struct aldWorkspace *ws, int ac, char **av);
+static int c_coverage_stop(struct aldWorkspace *ws, int ac, char **av);
+
+static struct Command coverageCmds[] = {
+  { "report", c_coverage_report, 0 },
+  { "start", c_coverage_start, 0 },
+  { "stop", c_coverage_stop, 0 },
+  { 0, 0, 0 }
+};
+
+/*
+c_coverage()
+  Record which basic blocks of the program are executed
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_coverage(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct Command *cptr;
+  unsigned int flags;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: coverage <start | report | stop>");
+    return (0);
+  }
+
+  flags = 0;
+  cptr = FindCommand(coverageCmds, av[1], &flags);
+  if (cptr)
+  {
+    /*
+     * Call cptr->func to execute command
+     */
+    return ((*cptr->funcptr)(ws, ac, av));
+  }
+
+  /*
+   * They gave us an invalid command
+   */
+  Print(ws,
+        P_COMMAND,
+        "%s command: coverage %s",
+        (flags & C_AMBIGUOUS) ? "Ambiguous" : "Unknown",
+        av[1]);
+
+  return (0);
+} /* c_coverage() */
+
+/*
+c_coverage_start()
+  Find the basic blocks of a section or function and insert a
+one-shot breakpoint at each of them
+*/
+
+static int
+c_coverage_start(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long start,
+                bytes,
+                *blocks;
+  long num,
+       ret;
+  char *name;
+  struct offSectionInfo secInfo;
+  struct offSymbolInfo symInfo;
+
+  if (!isRunningDebug(ws->debugWorkspace_p))
+  {
+    Print(ws, P_ERROR, MSG_NOPROCESS);
+    return (0);
+  }
+
+  name = (ac > 2) ? av[2] : ".text";
+
+  if (findSectionOFF(ws->offWorkspace_p, name, 0, &secInfo))
+  {
+    start = secInfo.address;
+    bytes = secInfo.size;
+  }
+  else if (findSymbolOFF(ws->offWorkspace_p, name, 0, &symInfo) &&
+           (symInfo.size > 0))
+  {
+    start = symInfo.address;
+    bytes = symInfo.size;
+  }
+  else
+  {
+    Print(ws, P_ERROR, "No such section or function: %s", name);
+    return (0);
+  }
+
+  num = findBlocks(ws, start, bytes, &blocks);
+  if (num < 0)
+  {
+    Print(ws, P_ERROR, "Unable to find blocks: %s", strerror(errno));
+    return (0);
+  }
+
+  ret = startCoverage(ws->debugWorkspace_p, blocks, (unsigned long) num);
+
+  if (blocks)
+    free(blocks);
+
+  if (ret < 0)
+  {
+    Print(ws, P_ERROR, "Unable to insert coverage breakpoints: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws, P_COMMAND, "Recording coverage of %ld blocks in %s", ret, name);
+
+  return (1);
+} /* c_coverage_start() */
+
+/*
+c_coverage_report()
+  Show which blocks have been executed so far
+*/
+
+static int
+c_coverage_report(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  reportCoverage(ws);
+
+  return (1);
+} /* c_coverage_report() */
+
+/*
+c_coverage_stop()
+  Show the coverage report and remove the remaining breakpoints
+*/
+
+static int
+c_coverage_stop(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  reportCoverage(ws);
+  clearCoverage(ws->debugWorkspace_p);
+
+  return (1);
+} /* c_coverage_stop() */
@@ -21,6 +21,7 @@
  * libDebug includes
  */
 #include "break.h"
+#include "libDebug.h"
 
 /*
  * libString includes
@@ -29,7 +30,7 @@
 
 /*
 c_dbreak()
-  Delete a breakpoint
+  Delete a breakpoint, watchpoint or fast tracepoint
 
 Return: 0 upon failure
         1 upon success
@@ -42,6 +43,8 @@ c_dbreak(struct aldWorkspace *ws, int ac, char **av)
   unsigned long num;
   char *endptr;
   struct Breakpoint *ptr;
+  struct Watchpoint *wptr;
+  struct fastTracepoint *fptr;
 
   if (ac < 2)
   {
@@ -64,13 +67,24 @@ c_dbreak(struct aldWorkspace *ws, int ac, char **av)
   if (num)
   {
     ptr = findBreakpointByNumber(ws->debugWorkspace_p, (unsigned int) num);
-    if (!ptr)
-      Print(ws, P_ERROR, "No such breakpoint number: %ld", num);
-    else
+    wptr = findWatchpointByNumber(ws->debugWorkspace_p, (unsigned int) num);
+    fptr = findFastTracepointByNumber(ws->debugWorkspace_p,
+                                      (unsigned int) num);
+    if (ptr)
       deleteBreakpoint(ws->debugWorkspace_p, ptr);
+    else if (wptr)
+      deleteWatchpoint(ws->debugWorkspace_p, wptr);
+    else if (fptr)
+      deleteFastTracepoint(ws->debugWorkspace_p, fptr, 1);
+    else
+      Print(ws, P_ERROR, "No such breakpoint number: %ld", num);
   }
   else
+  {
     clearBreakpoints(ws->debugWorkspace_p);
+    clearWatchpoints(ws->debugWorkspace_p);
+    clearFastTracepoints(ws->debugWorkspace_p, 1);
+  }
 
   return (1);
 } /* c_dbreak() */
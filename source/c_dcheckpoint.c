@@ -0,0 +1,73 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+c_dcheckpoint()
+  Delete a checkpoint
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_dcheckpoint(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long num;
+  char *endptr;
+  struct Checkpoint *ptr;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: dcheckpoint <number | all>");
+    return (0);
+  }
+
+  if (!Strcasecmp(av[1], "all"))
+    num = 0;
+  else
+  {
+    num = strtoul(av[1], &endptr, 0);
+    if ((endptr == av[1]) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+  }
+
+  if (num)
+  {
+    ptr = findCheckpointByNumber(ws->debugWorkspace_p, (unsigned int) num);
+    if (!ptr)
+      Print(ws, P_ERROR, "No such checkpoint number: %ld", num);
+    else
+      deleteCheckpoint(ws->debugWorkspace_p, ptr);
+  }
+  else
+    clearCheckpoints(ws->debugWorkspace_p);
+
+  return (1);
+} /* c_dcheckpoint() */
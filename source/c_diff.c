@@ -0,0 +1,83 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <string.h>
+
+#include "list.h"
+#include "main.h"
+#include "print.h"
+#include "snapshot.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+c_diff()
+  Show which bytes have changed since a snapshot was taken
+
+Format for this command:
+  diff <name> [-update]
+
+If -update is given, the snapshot is retaken afterwards so the next
+diff shows only newer changes.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_diff(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct genericList *node;
+  struct snapshot *snap;
+  struct snapshotRegion regions[SNAPSHOT_MAXREGIONS];
+  char name[SNAPSHOT_NAMELEN + 1];
+  int ii;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: diff <name> [-update]");
+    return (0);
+  }
+
+  node = findSnapshot(ws, av[1]);
+  if (!node)
+  {
+    Print(ws, P_ERROR, "No such snapshot: %s", av[1]);
+    return (0);
+  }
+
+  snap = (struct snapshot *) node->ptr;
+
+  startPrintBurst(ws->printWorkspace_p);
+  diffSnapshot(ws, snap);
+  endPrintBurst(ws->printWorkspace_p);
+
+  if ((ac > 2) && !Strcasecmp(av[2], "-update"))
+  {
+    /*
+     * takeSnapshot() frees the old snapshot, so copy what we need
+     */
+    strcpy(name, snap->name);
+    for (ii = 0; ii < snap->nregions; ++ii)
+      regions[ii] = snap->regions[ii];
+
+    if (!takeSnapshot(ws, name, regions, snap->nregions))
+      return (0);
+  }
+
+  return (1);
+} /* c_diff() */
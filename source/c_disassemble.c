@@ -18,8 +18,10 @@
 #include <assert.h>
 
 #include "alddefs.h"
+#include "core.h"
 #include "defs.h"
 #include "disassemble.h"
+#include "insnindex.h"
 #include "load.h"
 #include "main.h"
 #include "msg.h"
@@ -40,7 +42,8 @@ c_disassemble()
  Disassemble the current file
 
 Format for this command:
-  disassemble [start [stop]] [-num <number>] [-section <name>]
+  disassemble [start [stop]] [-num <number>] [-back <number>]
+              [-section <name>]
 
 Return: 0 upon failure
         1 upon success
@@ -53,7 +56,9 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
   unsigned char *data;  /* data to disassemble */
   unsigned char *membuf;
   long insnum,          /* number of instructions to disassemble */
-       inscnt;          /* number of instructions disassembled so far */
+       inscnt,          /* number of instructions disassembled so far */
+       backnum,         /* number of instructions to move back */
+       moved;
   char *endptr;
   long length;
   int cnt,
@@ -61,6 +66,8 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
   unsigned int start,
                end;
   unsigned int address; /* address of instruction to be disassembled */
+  unsigned long lookup, /* address to snap or move back from */
+                newaddr;
   char *section;        /* are we disassembling a specific section? */
   long ndumped,         /* number of bytes dumped */
        numbytes;        /* total bytes */
@@ -68,11 +75,14 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
   int gotstart;         /* did we get a starting address? */
   int sret;             /* return result from findSectionOFF() */
   struct offSectionInfo secInfo;
+  unsigned char *coredata; /* start of core file memory */
+  int fromcore;            /* disassembling a core file? */
 
   start = end = 0;
   gotstart = 0;
   section = 0;
   insnum = 0;
+  backnum = 0;
   ndumped = numbytes = 0;
 
   for (cnt = 1; cnt < ac; ++cnt)
@@ -124,6 +134,21 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
         return (0);
       }
     }
+    else if (!Strncasecmp(av[cnt], "-back", alen))
+    {
+      if (++cnt >= ac)
+      {
+        Print(ws, P_COMMAND, "No instruction count specified");
+        return (0);
+      }
+
+      backnum = strtol(av[cnt], &endptr, 0);
+      if ((endptr == av[cnt]) || (*endptr != '\0') || (backnum <= 0))
+      {
+        Print(ws, P_COMMAND, MSG_INVNUM, av[cnt]);
+        return (0);
+      }
+    }
     else
     {
       /*
@@ -164,8 +189,65 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
       start,
       end);
   } /* if (section) */
+  else
+  {
+    /*
+     * Make sure we start on an instruction boundary, using the
+     * instruction index of the file when the address lies in one
+     * of its executable sections
+     */
+    if (gotstart)
+      lookup = start;
+    else
+      lookup = ws->virtualObjectFileOffset;
+
+    newaddr = lookup;
+
+    if (backnum)
+    {
+      moved = backInsnIndex(ws, lookup, backnum, &newaddr);
+      if (moved < 0)
+      {
+        Print(ws,
+              P_COMMAND,
+              "0x%08lX is not in an executable section of the file",
+              lookup);
+        return (0);
+      }
+
+      if (moved < backnum)
+      {
+        Print(ws,
+              P_COMMAND,
+              "Reached start of section after %ld instruction%s",
+              moved,
+              (moved == 1) ? "" : "s");
+      }
+
+      if (!insnum)
+        insnum = backnum;
+    }
+    else if (snapInsnIndex(ws, lookup, &newaddr) && (newaddr != lookup))
+    {
+      Print(ws,
+            P_COMMAND,
+            "0x%08lX is inside an instruction, starting at 0x%08lX",
+            lookup,
+            newaddr);
+    }
+
+    if (gotstart)
+      start = newaddr;
+    else
+    {
+      ws->virtualObjectFileOffset = newaddr;
+      ws->objectFileOffset = newaddr - ws->virtualFileAddress;
+    }
+  }
 
   membuf = 0;
+  coredata = 0;
+  fromcore = useCore(ws);
   if (gotstart)
   {
     if (!end)
@@ -182,7 +264,10 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
       /*
        * 150 bytes should be sufficient for 15 instructions
        */
-      end = start + 150;
+      if (insnum > 15)
+        end = start + insnum * 10;
+      else
+        end = start + 150;
     }
 
     numbytes = end - start;
@@ -198,10 +283,21 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
      */
     numbytes += 15;
 
-    ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
-                              &membuf,
-                              start,
-                              numbytes);
+    if (fromcore)
+    {
+      /*
+       * Disassemble straight out of the core file mapping
+       */
+      ndumped = readCoreMemory(ws, start, numbytes, &data);
+    }
+    else
+    {
+      ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                                &membuf,
+                                start,
+                                numbytes);
+      data = membuf;
+    }
 
     if (!ndumped)
     {
@@ -224,7 +320,7 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
     if (ndumped < numbytes)
       end = start + ndumped;
 
-    data = membuf;
+    coredata = data;
     address = start;
   } /* if (gotstart) */
   else
@@ -266,6 +362,27 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
     {
       if (end && (address > end))
         break;
+
+      if (fromcore)
+      {
+        /*
+         * The core file mapping may end right after the last
+         * segment - copy the final bytes into a separate buffer
+         * like we do at the end of the program file below
+         */
+        if ((address - start) >= (unsigned long) ndumped)
+          break;
+
+        if (((address - start) + MAX_OPCODE_LEN) >= (unsigned long) ndumped)
+        {
+          memset((void *) spill, 0, sizeof(spill));
+          memcpy(spill,
+                 coredata + (address - start),
+                 ndumped - (address - start));
+
+          data = spill;
+        }
+      }
     }
     else
     {
@@ -320,7 +437,7 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
       data += length;
       address += length;
 
-      if (!membuf)
+      if (!gotstart)
       {
         ws->virtualObjectFileOffset += length;
         ws->objectFileOffset += length;
@@ -332,9 +449,11 @@ c_disassemble(struct aldWorkspace *ws, int ac, char **av)
 
   endPrintBurst(ws->printWorkspace_p);
 
-  if (membuf)
+  if (membuf || coredata)
   {
-    free(membuf);
+    if (membuf)
+      free(membuf);
+
     if (ndumped < numbytes)
     {
       Print(ws,
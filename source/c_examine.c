@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include "alddefs.h"
+#include "core.h"
 #include "defs.h"
 #include "list.h"
 #include "load.h"
@@ -71,6 +72,7 @@ c_examine(struct aldWorkspace *ws, int ac, char **av)
   long ndumped;            /* number of bytes actually dumped */
   unsigned long deladdr;   /* delta address (stopaddr - startaddr) */
   struct genericList *ptr;
+  int fromcore;            /* dump comes from a core file? */
 
   /*
    * Defaults: dump 64 elements, each 1 byte, in hex format
@@ -223,6 +225,7 @@ c_examine(struct aldWorkspace *ws, int ac, char **av)
   }
 
   membuf = 0;
+  fromcore = useCore(ws);
 
   /*
    * Determine exactly how many bytes of memory we want to
@@ -249,12 +252,25 @@ c_examine(struct aldWorkspace *ws, int ac, char **av)
   else
     numbytes = elbytes;
 
-  ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
-                            &membuf,
-                            startaddr,
-                            numbytes);
+  if (fromcore)
+  {
+    /*
+     * Dump straight out of the core file mapping - membuf points
+     * into the mapping and must not be freed
+     */
+    ndumped = readCoreMemory(ws, startaddr, numbytes, &membuf);
+    if (ndumped > 0)
+      OutputMemory(ws, membuf, startaddr, ndumped, elsize, output);
+  }
+  else
+  {
+    ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                              &membuf,
+                              startaddr,
+                              numbytes);
+  }
 
-  if (membuf)
+  if (membuf && !fromcore)
   {
     /*
      * OutputMemory uses print bursts, so if the user kills
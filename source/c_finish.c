@@ -0,0 +1,77 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "display.h"
+#include "frame.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "terminal.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+
+/*
+c_finish()
+  Continue the program until the current function returns. A
+temporary breakpoint is placed at the return address, so the
+function runs at full speed.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_finish(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int data,
+      ret;
+  unsigned long address, /* return address */
+                frame;   /* stack pointer after return */
+
+  if (!getReturnAddress(ws, &address, &frame))
+  {
+    Print(ws,
+          P_ERROR,
+          "Unable to locate the return address of the current function");
+    return (0);
+  }
+
+  Print(ws, P_COMMAND, "Running until return to 0x%08lX", address);
+
+  /*
+   * Restore the child's terminal state
+   */
+  restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+
+  ret = runToDebug(ws->debugWorkspace_p, &address, 1, frame, &data);
+
+  /*
+   * Save the child's terminal state and restore the original
+   * terminal settings in case the child messed with them.
+   */
+  saveTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+  restoreTerminal(&(ws->terminalWorkspace_p->ParentAttributes));
+
+  if (analyzeTraceResult(ws, ret, data) == 0)
+    return (0);
+
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_finish() */
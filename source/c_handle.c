@@ -0,0 +1,183 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <signal.h>
+
+#include "main.h"
+#include "print.h"
+#include "signals.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static void showPolicy(struct aldWorkspace *ws, int signum);
+
+/*
+c_handle()
+  Set or show what is done when the program receives a signal.
+Signals which do not stop the program are passed to it (or not)
+and the program resumed without returning to the prompt.
+
+Format for this command:
+  handle [<signal | all> [keyword ...]]
+
+Keywords are stop, nostop, print, noprint, pass and nopass. stop
+implies print, and noprint implies nostop.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_handle(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned int policy;
+  int signum,
+      first,
+      last,
+      ii;
+
+  if (ac < 2)
+  {
+    Print(ws,
+          P_COMMAND,
+          "%-10s %-5s %-5s %-5s %-8s %s",
+          "Signal",
+          "Stop",
+          "Print",
+          "Pass",
+          "Count",
+          "Description");
+
+    for (signum = 1; signum < SP_MAXSIG; ++signum)
+    {
+      if (GetSignal(signum))
+        showPolicy(ws, signum);
+    }
+
+    return (1);
+  }
+
+  if (!Strcasecmp(av[1], "all"))
+  {
+    first = 1;
+    last = SP_MAXSIG - 1;
+  }
+  else
+  {
+    first = last = FindSignal(av[1]);
+    if (!first)
+    {
+      Print(ws, P_ERROR, "Invalid signal: %s", av[1]);
+      return (0);
+    }
+
+    if ((first == SIGTRAP) || (first == SIGKILL))
+    {
+      Print(ws, P_ERROR, "Signal %s cannot be handled", av[1]);
+      return (0);
+    }
+  }
+
+  for (signum = first; signum <= last; ++signum)
+  {
+    /*
+     * "all" leaves alone the signals the debugger itself uses
+     */
+    if ((signum == SIGTRAP) || (signum == SIGKILL) ||
+        ((first != last) && (signum == SIGINT)))
+      continue;
+
+    policy = getSignalPolicy(ws->debugWorkspace_p, signum);
+
+    for (ii = 2; ii < ac; ++ii)
+    {
+      if (!Strcasecmp(av[ii], "stop"))
+        policy |= SP_STOP | SP_PRINT;
+      else if (!Strcasecmp(av[ii], "nostop"))
+        policy &= ~SP_STOP;
+      else if (!Strcasecmp(av[ii], "print"))
+        policy |= SP_PRINT;
+      else if (!Strcasecmp(av[ii], "noprint"))
+        policy &= ~(SP_PRINT | SP_STOP);
+      else if (!Strcasecmp(av[ii], "pass"))
+        policy |= SP_PASS;
+      else if (!Strcasecmp(av[ii], "nopass"))
+        policy &= ~SP_PASS;
+      else
+      {
+        Print(ws, P_ERROR, "Invalid keyword: %s", av[ii]);
+        return (0);
+      }
+    }
+
+    setSignalPolicy(ws->debugWorkspace_p, signum, policy);
+  }
+
+  if (first == last)
+  {
+    Print(ws,
+          P_COMMAND,
+          "%-10s %-5s %-5s %-5s %-8s %s",
+          "Signal",
+          "Stop",
+          "Print",
+          "Pass",
+          "Count",
+          "Description");
+    showPolicy(ws, first);
+  }
+
+  return (1);
+} /* c_handle() */
+
+/*
+showPolicy()
+  Print the policy for a signal
+
+Inputs: ws     - ald workspace
+        signum - signal number
+*/
+
+static void
+showPolicy(struct aldWorkspace *ws, int signum)
+
+{
+  struct aSignal *sptr;
+  unsigned int policy;
+  char name[MAXLINE];
+
+  policy = getSignalPolicy(ws->debugWorkspace_p, signum);
+
+  sptr = GetSignal(signum);
+  if (sptr)
+    Sprintf(name, "%s", sptr->name);
+  else
+    Sprintf(name, "%d", signum);
+
+  Print(ws,
+        P_COMMAND,
+        "%-10s %-5s %-5s %-5s %-8lu %s",
+        name,
+        (policy & SP_STOP) ? "Yes" : "No",
+        (policy & SP_PRINT) ? "Yes" : "No",
+        (policy & SP_PASS) ? "Yes" : "No",
+        getSignalCount(ws->debugWorkspace_p, signum),
+        sptr ? sptr->desc : "Unknown signal");
+} /* showPolicy() */
@@ -26,7 +26,7 @@
 
 /*
 c_lbreak()
-  List breakpoints
+  List breakpoints and watchpoints
 
 Return: 0 upon failure
         1 upon success
@@ -37,6 +37,7 @@ c_lbreak(struct aldWorkspace *ws, int ac, char **av)
 
 {
   struct Breakpoint *bptr;
+  struct Watchpoint *wptr;
   char istr[MAXLINE];
   char sstr[MAXLINE];
   struct offSymbolInfo symInfo;
@@ -54,7 +55,11 @@ c_lbreak(struct aldWorkspace *ws, int ac, char **av)
     bptr = bptr->next;
   }
 
-  if (bptr)
+  wptr = ws->debugWorkspace_p->watch.list;
+  while (wptr && wptr->next)
+    wptr = wptr->next;
+
+  if (bptr || wptr)
   {
     Print(ws,
           P_COMMAND,
@@ -66,8 +71,40 @@ c_lbreak(struct aldWorkspace *ws, int ac, char **av)
           "IgnoreCount",
           "HitCount");
 
-    while (bptr)
+    while (bptr || wptr)
     {
+      /*
+       * Watchpoints share the breakpoint numbers - show both lists
+       * in numerical order
+       */
+      if (wptr && (!bptr || (wptr->number < bptr->number)))
+      {
+        Sprintf(istr, "%lu bytes", wptr->size);
+
+        sret = findSymbolOFF(ws->offWorkspace_p,
+                             0,
+                             wptr->address,
+                             &symInfo);
+        if (sret)
+          Sprintf(sstr, "(%s+0x%x)", symInfo.name, symInfo.offset);
+        else
+          *sstr = '\0';
+
+        Print(ws,
+              P_COMMAND,
+              "%-03d   %-10s   %-07s   0x%08lX   %-12s %-08lu %s",
+              wptr->number,
+              "Watchpoint",
+              "y",
+              wptr->address,
+              istr,
+              wptr->hits,
+              sstr);
+
+        wptr = wptr->prev;
+        continue;
+      }
+
       if (bptr->ignorecnt)
         Sprintf(istr, "%-12d", bptr->ignorecnt);
       else
@@ -86,7 +123,7 @@ c_lbreak(struct aldWorkspace *ws, int ac, char **av)
             P_COMMAND,
             "%-03d   %-10s   %-07s   0x%08lX   %-12s %-08d %s",
             bptr->number,
-            "Breakpoint",
+            (bptr->flags & BK_TRACE) ? "Tracepoint" : "Breakpoint",
             (bptr->flags & BK_ENABLED) ? "y" : "n",
             bptr->address,
             istr,
@@ -0,0 +1,83 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <string.h>
+
+#include "main.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+c_lcheckpoint()
+  List checkpoints
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_lcheckpoint(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct Checkpoint *cptr;
+  char sstr[MAXLINE];
+  struct offSymbolInfo symInfo;
+
+  /*
+   * Checkpoints are stored in reverse numerical order, so
+   * advance to the end and work backwards
+   */
+  cptr = ws->debugWorkspace_p->checkpoints;
+  while (cptr && cptr->next)
+    cptr = cptr->next;
+
+  if (!cptr)
+  {
+    Print(ws, P_COMMAND, "No checkpoints taken");
+    return (1);
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "%-5s %-8s %-10s",
+        "Num",
+        "Pid",
+        "Address");
+
+  while (cptr)
+  {
+    if (findSymbolOFF(ws->offWorkspace_p, 0, cptr->address, &symInfo))
+      Sprintf(sstr, "(%s+0x%x)", symInfo.name, symInfo.offset);
+    else
+      *sstr = '\0';
+
+    Print(ws,
+          P_COMMAND,
+          "%-5u %-8d 0x%08lX %s",
+          cptr->number,
+          (int) cptr->pid,
+          cptr->address,
+          sstr);
+
+    cptr = cptr->prev;
+  }
+
+  return (1);
+} /* c_lcheckpoint() */
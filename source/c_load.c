@@ -14,6 +14,7 @@
 #include "load.h"
 #include "main.h"
 #include "print.h"
+#include "set.h"
 
 #include "libDebug.h"
 
@@ -37,7 +38,7 @@ c_load(struct aldWorkspace *ws, int ac, char **av)
 
   loadFile(ws, av[1]);
 
-  startDebug(ws->debugWorkspace_p, av[1], 0);
+  startDebug(ws->debugWorkspace_p, av[1], IsSetCaptureOutput(ws) ? 1 : 0);
 
   awSetFileLoaded(ws);
 
@@ -0,0 +1,516 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "terminal.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * Defaults for the duration and sampling frequency
+ */
+#define PROFILE_SECONDS     5
+#define PROFILE_HZ          100
+#define PROFILE_MAXHZ       10000
+
+/*
+ * Number of hash buckets used to count sampled addresses
+ */
+#define PROFILE_HASHSIZE    1024
+
+/*
+ * Number of lines in each section of the report
+ */
+#define PROFILE_TOPFUNCS    20
+#define PROFILE_TOPADDRS    10
+
+#define PROFILE_HASH(x)     (((x) >> 2) % PROFILE_HASHSIZE)
+
+/*
+ * Sample counts for one address
+ */
+struct profileEntry
+{
+  struct profileEntry *next;
+
+  unsigned long address;
+  unsigned long self;    /* samples with this address as eip */
+  unsigned long total;   /* samples with this address anywhere on the stack */
+};
+
+/*
+ * Sample counts for one function - built from the address
+ * counts once sampling is done
+ */
+struct profileSymbol
+{
+  unsigned long address; /* symbol address */
+  char *name;            /* symbol name (0 if unknown) */
+  unsigned long self;
+  unsigned long total;
+};
+
+struct profileData
+{
+  struct profileEntry *table[PROFILE_HASHSIZE];
+  unsigned long samples;   /* number of samples taken */
+  unsigned long entries;   /* number of distinct addresses */
+  int nomem;               /* set if an allocation failed */
+};
+
+static void profileCallback(void *args, unsigned long *pcs, int depth);
+static struct profileEntry *findEntry(struct profileData *prof,
+                                      unsigned long address);
+static int compareSymbolAddress(const void *a, const void *b);
+static int compareSymbolSelf(const void *a, const void *b);
+static int compareEntrySelf(const void *a, const void *b);
+static void profileReport(struct aldWorkspace *ws, struct profileData *prof);
+static void freeProfile(struct profileData *prof);
+
+/*
+findEntry()
+  Find (or create) the counts for an address
+
+Return: pointer to entry, 0 if out of memory
+*/
+
+static struct profileEntry *
+findEntry(struct profileData *prof, unsigned long address)
+
+{
+  struct profileEntry *ptr;
+  unsigned long hv;
+
+  hv = PROFILE_HASH(address);
+
+  for (ptr = prof->table[hv]; ptr; ptr = ptr->next)
+  {
+    if (ptr->address == address)
+      return (ptr);
+  }
+
+  ptr = (struct profileEntry *) malloc(sizeof(struct profileEntry));
+  if (!ptr)
+  {
+    prof->nomem = 1;
+    return (0);
+  }
+
+  ptr->address = address;
+  ptr->self = 0;
+  ptr->total = 0;
+  ptr->next = prof->table[hv];
+  prof->table[hv] = ptr;
+
+  ++(prof->entries);
+
+  return (ptr);
+} /* findEntry() */
+
+/*
+profileCallback()
+  Called by libDebug for each sample - this runs while the process
+is stopped, so only the address counts are updated here; symbols
+are looked up when the report is generated.
+
+Inputs: args  - profile data
+        pcs   - instruction pointer, followed by return addresses
+        depth - number of addresses in pcs
+*/
+
+static void
+profileCallback(void *args, unsigned long *pcs, int depth)
+
+{
+  struct profileData *prof;
+  struct profileEntry *ptr;
+  int ii,
+      jj;
+
+  prof = (struct profileData *) args;
+
+  ++(prof->samples);
+
+  for (ii = 0; ii < depth; ++ii)
+  {
+    /*
+     * Count an address only once per sample, so recursion does
+     * not inflate its total
+     */
+    for (jj = 0; jj < ii; ++jj)
+    {
+      if (pcs[jj] == pcs[ii])
+        break;
+    }
+
+    if (jj < ii)
+      continue;
+
+    ptr = findEntry(prof, pcs[ii]);
+    if (!ptr)
+      return;
+
+    if (ii == 0)
+      ++(ptr->self);
+
+    ++(ptr->total);
+  }
+} /* profileCallback() */
+
+/*
+compareSymbolAddress()
+  qsort() comparison - order symbols by address
+*/
+
+static int
+compareSymbolAddress(const void *a, const void *b)
+
+{
+  const struct profileSymbol *sa,
+                             *sb;
+
+  sa = (const struct profileSymbol *) a;
+  sb = (const struct profileSymbol *) b;
+
+  if (sa->address < sb->address)
+    return (-1);
+  else if (sa->address > sb->address)
+    return (1);
+
+  return (0);
+} /* compareSymbolAddress() */
+
+/*
+compareSymbolSelf()
+  qsort() comparison - order symbols by descending self samples
+*/
+
+static int
+compareSymbolSelf(const void *a, const void *b)
+
+{
+  const struct profileSymbol *sa,
+                             *sb;
+
+  sa = (const struct profileSymbol *) a;
+  sb = (const struct profileSymbol *) b;
+
+  if (sa->self != sb->self)
+    return ((sa->self < sb->self) ? 1 : -1);
+
+  if (sa->total != sb->total)
+    return ((sa->total < sb->total) ? 1 : -1);
+
+  return (0);
+} /* compareSymbolSelf() */
+
+/*
+compareEntrySelf()
+  qsort() comparison - order addresses by descending self samples
+*/
+
+static int
+compareEntrySelf(const void *a, const void *b)
+
+{
+  const struct profileEntry *ea,
+                            *eb;
+
+  ea = *(const struct profileEntry **) a;
+  eb = *(const struct profileEntry **) b;
+
+  if (ea->self != eb->self)
+    return ((ea->self < eb->self) ? 1 : -1);
+
+  return (0);
+} /* compareEntrySelf() */
+
+/*
+profileReport()
+  Output the hottest functions and addresses
+
+Inputs: ws   - ald workspace
+        prof - profile data
+*/
+
+static void
+profileReport(struct aldWorkspace *ws, struct profileData *prof)
+
+{
+  struct profileSymbol *syms;
+  struct profileEntry **entries,
+                      *ptr;
+  struct offSymbolInfo symInfo;
+  unsigned long ii,
+                num,
+                nsyms;
+  double pct;
+
+  if (prof->samples == 0)
+  {
+    Print(ws, P_COMMAND, "No samples were taken");
+    return;
+  }
+
+  syms = (struct profileSymbol *)
+         malloc(sizeof(struct profileSymbol) * prof->entries);
+  entries = (struct profileEntry **)
+            malloc(sizeof(struct profileEntry *) * prof->entries);
+  if (!syms || !entries)
+  {
+    Print(ws, P_ERROR, "profileReport: malloc failed: %s", strerror(errno));
+
+    if (syms)
+      free(syms);
+
+    if (entries)
+      free(entries);
+
+    return;
+  }
+
+  /*
+   * Map every sampled address to the symbol containing it
+   */
+  num = 0;
+  for (ii = 0; ii < PROFILE_HASHSIZE; ++ii)
+  {
+    for (ptr = prof->table[ii]; ptr; ptr = ptr->next)
+    {
+      entries[num] = ptr;
+
+      if (findSymbolOFF(ws->offWorkspace_p, 0, ptr->address, &symInfo))
+      {
+        syms[num].address = symInfo.address;
+        syms[num].name = symInfo.name;
+      }
+      else
+      {
+        syms[num].address = ptr->address;
+        syms[num].name = 0;
+      }
+
+      syms[num].self = ptr->self;
+      syms[num].total = ptr->total;
+
+      ++num;
+    }
+  }
+
+  /*
+   * Merge addresses belonging to the same symbol
+   */
+  qsort(syms, num, sizeof(struct profileSymbol), compareSymbolAddress);
+
+  nsyms = 0;
+  for (ii = 0; ii < num; ++ii)
+  {
+    if ((nsyms > 0) && syms[ii].name &&
+        (syms[nsyms - 1].address == syms[ii].address))
+    {
+      syms[nsyms - 1].self += syms[ii].self;
+      syms[nsyms - 1].total += syms[ii].total;
+    }
+    else
+      syms[nsyms++] = syms[ii];
+  }
+
+  qsort(syms, nsyms, sizeof(struct profileSymbol), compareSymbolSelf);
+  qsort(entries, num, sizeof(struct profileEntry *), compareEntrySelf);
+
+  Print(ws, P_COMMAND, "%lu samples", prof->samples);
+
+  Print(ws, P_COMMAND, "\nHot functions:");
+  Print(ws, P_COMMAND, "%8s %8s %8s  %s", "Self%", "Self", "Total", "Function");
+
+  for (ii = 0; (ii < nsyms) && (ii < PROFILE_TOPFUNCS); ++ii)
+  {
+    if (syms[ii].self == 0)
+      break;
+
+    pct = (100.0 * syms[ii].self) / prof->samples;
+
+    if (syms[ii].name)
+    {
+      Print(ws, P_COMMAND, "%7.2f%% %8lu %8lu  %s",
+            pct,
+            syms[ii].self,
+            syms[ii].total,
+            syms[ii].name);
+    }
+    else
+    {
+      Print(ws, P_COMMAND, "%7.2f%% %8lu %8lu  0x%08lX",
+            pct,
+            syms[ii].self,
+            syms[ii].total,
+            syms[ii].address);
+    }
+  }
+
+  Print(ws, P_COMMAND, "\nHot addresses:");
+  Print(ws, P_COMMAND, "%8s %8s  %s", "Self%", "Self", "Address");
+
+  for (ii = 0; (ii < num) && (ii < PROFILE_TOPADDRS); ++ii)
+  {
+    if (entries[ii]->self == 0)
+      break;
+
+    pct = (100.0 * entries[ii]->self) / prof->samples;
+
+    if (findSymbolOFF(ws->offWorkspace_p, 0, entries[ii]->address, &symInfo))
+    {
+      Print(ws, P_COMMAND, "%7.2f%% %8lu  0x%08lX <%s+%u>",
+            pct,
+            entries[ii]->self,
+            entries[ii]->address,
+            symInfo.name,
+            symInfo.offset);
+    }
+    else
+    {
+      Print(ws, P_COMMAND, "%7.2f%% %8lu  0x%08lX",
+            pct,
+            entries[ii]->self,
+            entries[ii]->address);
+    }
+  }
+
+  if (prof->nomem)
+    Print(ws, P_ERROR, "Some samples were lost (out of memory)");
+
+  free(syms);
+  free(entries);
+} /* profileReport() */
+
+/*
+freeProfile()
+  Free the address counts
+*/
+
+static void
+freeProfile(struct profileData *prof)
+
+{
+  struct profileEntry *ptr,
+                      *next;
+  int ii;
+
+  for (ii = 0; ii < PROFILE_HASHSIZE; ++ii)
+  {
+    ptr = prof->table[ii];
+    while (ptr)
+    {
+      next = ptr->next;
+      free(ptr);
+      ptr = next;
+    }
+
+    prof->table[ii] = 0;
+  }
+} /* freeProfile() */
+
+/*
+c_profile()
+  Sample the running process at a fixed frequency and report where
+it spends its time
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_profile(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int data,
+      ret;
+  long seconds,
+       hz;
+  char *endptr;
+  struct profileData *prof;
+
+  seconds = PROFILE_SECONDS;
+  hz = PROFILE_HZ;
+
+  if (ac > 1)
+  {
+    seconds = strtol(av[1], &endptr, 0);
+    if ((endptr == av[1]) || (*endptr != '\0') || (seconds <= 0))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+  }
+
+  if (ac > 2)
+  {
+    hz = strtol(av[2], &endptr, 0);
+    if ((endptr == av[2]) || (*endptr != '\0') ||
+        (hz <= 0) || (hz > PROFILE_MAXHZ))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[2]);
+      return (0);
+    }
+  }
+
+  prof = (struct profileData *) malloc(sizeof(struct profileData));
+  if (!prof)
+  {
+    Print(ws, P_ERROR, "c_profile: malloc failed: %s", strerror(errno));
+    return (0);
+  }
+
+  memset(prof, '\0', sizeof(struct profileData));
+
+  Print(ws, P_COMMAND, "Profiling for %ld seconds at %ld Hz...",
+        seconds,
+        hz);
+
+  /*
+   * Restore the child's terminal state
+   */
+  restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+
+  ret = profileDebug(ws->debugWorkspace_p,
+                     seconds * 1000000,
+                     1000000 / hz,
+                     profileCallback,
+                     (void *) prof,
+                     &data);
+
+  /*
+   * Save the child's terminal state and restore the original
+   * terminal settings in case the child messed with them.
+   */
+  saveTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+  restoreTerminal(&(ws->terminalWorkspace_p->ParentAttributes));
+
+  profileReport(ws, prof);
+
+  freeProfile(prof);
+  free(prof);
+
+  if (analyzeTraceResult(ws, ret, data) == 0)
+    return (0);
+
+  return (1);
+} /* c_profile() */
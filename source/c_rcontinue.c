@@ -0,0 +1,77 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <limits.h>
+#include <errno.h>
+#include <string.h>
+
+#include "display.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+c_rcontinue()
+  Run backwards through the recorded execution history until a
+breakpoint or the start of the history is reached
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_rcontinue(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  long ret;
+  int data;
+
+  if (!ws->debugWorkspace_p->record.enabled)
+  {
+    Print(ws, P_COMMAND, MSG_NORECORD);
+    return (0);
+  }
+
+  ret = reverseRecord(ws->debugWorkspace_p, LONG_MAX, 1, &data);
+  if (ret < 0)
+  {
+    Print(ws,
+          P_ERROR,
+          "Error occurred while stepping backwards: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  if (data)
+  {
+    Print(ws,
+          P_COMMAND,
+          MSG_BKPTENCOUNTERED,
+          data,
+          getAddressDebug(ws->debugWorkspace_p));
+  }
+  else
+    Print(ws, P_COMMAND, MSG_HISTORYSTART);
+
+  if (ret == 0)
+    return (1);
+
+  /*
+   * Display registers, memory and the next instruction
+   */
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_rcontinue() */
@@ -16,6 +16,7 @@
 #include <string.h>
 
 #include "alddefs.h"
+#include "core.h"
 #include "main.h"
 #include "msg.h"
 #include "output.h"
@@ -84,6 +85,12 @@ c_register(struct aldWorkspace *ws, int ac, char **av)
      * Check if they gave a value to set the register to
      */
 
+    if (useCore(ws))
+    {
+      Print(ws, P_ERROR, "Registers of a core file cannot be modified");
+      return (0);
+    }
+
     strncpy(regval, av[2], MAXLINE);
 
     sret = setRegisterDebug(ws->debugWorkspace_p, rindex, regval);
@@ -0,0 +1,82 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "display.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+c_restart()
+  Resume debugging from a checkpoint previously taken with
+"checkpoint". The current process is killed and replaced with a
+copy of the checkpoint; breakpoints and displays are kept.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_restart(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long num;
+  char *endptr;
+  struct Checkpoint *ptr;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: restart <number>");
+    return (0);
+  }
+
+  num = strtoul(av[1], &endptr, 0);
+  if ((endptr == av[1]) || (*endptr != '\0'))
+  {
+    Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+    return (0);
+  }
+
+  ptr = findCheckpointByNumber(ws->debugWorkspace_p, (unsigned int) num);
+  if (!ptr)
+  {
+    Print(ws, P_ERROR, "No such checkpoint number: %lu", num);
+    return (0);
+  }
+
+  if (!restartCheckpoint(ws->debugWorkspace_p, ptr))
+  {
+    Print(ws,
+          P_ERROR,
+          "Unable to restart checkpoint %u: %s",
+          ptr->number,
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "Restarted from checkpoint %u (0x%08lX)",
+        ptr->number,
+        ptr->address);
+
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_restart() */
@@ -0,0 +1,85 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "display.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+c_rstep()
+  Step backwards through the recorded execution history
+
+Format for this command:
+  rstep [num]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_rstep(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  long num,
+       ret;
+  int data;
+  char *endptr;
+
+  if (!ws->debugWorkspace_p->record.enabled)
+  {
+    Print(ws, P_COMMAND, MSG_NORECORD);
+    return (0);
+  }
+
+  if (ac > 1)
+  {
+    num = strtol(av[1], &endptr, 0);
+    if ((endptr == av[1]) || (*endptr != '\0') || (num <= 0))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+  }
+  else
+    num = 1;
+
+  ret = reverseRecord(ws->debugWorkspace_p, num, 0, &data);
+  if (ret < 0)
+  {
+    Print(ws,
+          P_ERROR,
+          "Error occurred while stepping backwards: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  if (ret < num)
+    Print(ws, P_COMMAND, MSG_HISTORYSTART);
+
+  if (ret == 0)
+    return (1);
+
+  /*
+   * Display registers, memory and the next instruction
+   */
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_rstep() */
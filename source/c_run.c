@@ -16,6 +16,7 @@
 #include <assert.h>
 
 #include "disassemble.h"
+#include "display.h"
 #include "load.h"
 #include "main.h"
 #include "misc.h"
@@ -139,21 +140,10 @@ c_run(struct aldWorkspace *ws, int ac, char **av)
   if (analyzeTraceResult(ws, ret, data) == 0)
     return (0);
 
-  if (IsSetStepDisplayRegs(ws))
-  {
-    /*
-     * Update and display new register values
-     */
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_GENERAL);
-  }
-
-  if (IsSetStepDisplayFpRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_FPREGS);
-
-  if (IsSetStepDisplayMmxRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_MMXREGS);
-
-  DisplayNextInstruction(ws);
+  /*
+   * Display registers, memory and the next instruction
+   */
+  doStepDisplay(ws);
 
   return (1);
 } /* c_run() */
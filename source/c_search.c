@@ -0,0 +1,620 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "frame.h"
+#include "list.h"
+#include "main.h"
+#include "memory.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+ * Target memory is read in chunks of this size
+ */
+#define SEARCH_CHUNKSIZE    65536
+
+/*
+ * Longest pattern we search for
+ */
+#define SEARCH_MAXPATTERN   256
+
+/*
+ * A pattern is a sequence of bytes, some of which may be wildcards.
+ * The anchor is the first byte which is not a wildcard - it is what
+ * we scan the memory for before comparing the rest of the pattern.
+ */
+struct searchPattern
+{
+  unsigned char bytes[SEARCH_MAXPATTERN];
+  unsigned char wild[SEARCH_MAXPATTERN]; /* set for wildcard bytes */
+  unsigned long len;                     /* pattern length */
+  unsigned long align;                   /* required match alignment */
+  unsigned long anchor;                  /* index of first fixed byte */
+};
+
+/*
+ * Address range to search
+ */
+struct searchRegion
+{
+  unsigned long start;
+  unsigned long end;
+};
+
+struct searchState
+{
+  struct aldWorkspace *ws;
+  struct searchPattern *pat;
+  unsigned long matches;          /* number of matches found */
+
+  struct searchRegion *regions;   /* regions collected from the memory map */
+  int nregions;
+  int maxregions;
+  int nomem;                      /* set if an allocation failed */
+};
+
+static int parsePattern(struct aldWorkspace *ws, int ac, char **av,
+                        struct searchPattern *pat);
+static int parseHexBytes(char *str, struct searchPattern *pat);
+static void collectRegion(void *args, unsigned long start,
+                          unsigned long end, char *perms);
+static long searchRange(struct searchState *state, unsigned char *buf,
+                        unsigned long start, unsigned long end);
+static void scanChunk(struct searchState *state, unsigned char *buf,
+                      unsigned long avail, unsigned long base);
+
+/*
+c_search()
+  Search the debugged process' memory for a pattern
+
+Format for this command:
+  search <start> <end> <pattern>
+  search -maps <pattern>
+
+Pattern:
+  -string <text>              = character string
+  -bytes <hex bytes>          = bytes such as "55 89 e5", ?? matches any byte
+  -value <number> [-size <n>] = integer stored at an address aligned to
+                                its size (default 4)
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_search(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct searchPattern pat;
+  struct searchState state;
+  struct genericList *bufptr,
+                     *regptr;
+  unsigned char *buf;
+  unsigned long start,
+                end;
+  long ret;
+  int first;
+  int ii;
+
+  if (ac < 3)
+  {
+    Print(ws, P_COMMAND, "Syntax: search <start> <end> <pattern>");
+    Print(ws, P_COMMAND, "        search -maps <pattern>");
+    return (0);
+  }
+
+  memset(&state, '\0', sizeof(state));
+  state.ws = ws;
+  state.pat = &pat;
+
+  start = end = 0;
+
+  if (!Strcasecmp(av[1], "-maps"))
+    first = 2;
+  else
+  {
+    if (!resolveAddress(ws, av[1], &start))
+    {
+      Print(ws, P_ERROR, MSG_INVADDR, av[1]);
+      return (0);
+    }
+
+    if (!resolveAddress(ws, av[2], &end))
+    {
+      Print(ws, P_ERROR, MSG_INVADDR, av[2]);
+      return (0);
+    }
+
+    if (end <= start)
+    {
+      Print(ws, P_ERROR, "Ending address is lower than starting address");
+      return (0);
+    }
+
+    first = 3;
+  }
+
+  if (!parsePattern(ws, ac - first, av + first, &pat))
+    return (0);
+
+  if (first == 2)
+  {
+    /*
+     * Search every readable region of the address space
+     */
+    if (!traverseMapsDebug(ws->debugWorkspace_p, collectRegion, &state))
+    {
+      Print(ws,
+            P_ERROR,
+            "Unable to read memory map: %s",
+            strerror(errno));
+      return (0);
+    }
+
+    if (state.nomem)
+    {
+      Print(ws, P_ERROR, "c_search: malloc failed: %s", strerror(errno));
+      if (state.regions)
+        free(state.regions);
+      return (0);
+    }
+  }
+
+  /*
+   * Leave room to carry the last (len - 1) bytes of a chunk over to
+   * the next one, so matches straddling chunks are found
+   */
+  buf = (unsigned char *) malloc(SEARCH_CHUNKSIZE + pat.len);
+  if (!buf)
+  {
+    Print(ws, P_ERROR, "c_search: malloc failed: %s", strerror(errno));
+    if (state.regions)
+      free(state.regions);
+    return (0);
+  }
+
+  /*
+   * The user may stop the search output, in which case we will not
+   * get to free our buffers (see c_examine)
+   */
+  bufptr = insertList(&(ws->toBeFreed), (void *) buf);
+  regptr = 0;
+  if (state.regions)
+    regptr = insertList(&(ws->toBeFreed), (void *) state.regions);
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  if (first == 2)
+  {
+    for (ii = 0; ii < state.nregions; ++ii)
+    {
+      searchRange(&state,
+                  buf,
+                  state.regions[ii].start,
+                  state.regions[ii].end);
+    }
+  }
+  else
+  {
+    ret = searchRange(&state, buf, start, end);
+    if ((unsigned long) ret < (end - start))
+    {
+      Print(ws,
+            P_ERROR,
+            MSG_NOACCESS,
+            start + ret,
+            strerror(errno));
+    }
+  }
+
+  endPrintBurst(ws->printWorkspace_p);
+
+  Print(ws,
+        P_COMMAND,
+        "%lu match%s found",
+        state.matches,
+        (state.matches == 1) ? "" : "es");
+
+  free(buf);
+  deleteList(&(ws->toBeFreed), bufptr);
+
+  if (state.regions)
+  {
+    free(state.regions);
+    deleteList(&(ws->toBeFreed), regptr);
+  }
+
+  return (1);
+} /* c_search() */
+
+/*
+parsePattern()
+  Build a search pattern from the command arguments
+
+Inputs: ws  - ald workspace
+        ac  - number of arguments
+        av  - arguments, starting with the pattern type
+        pat - pattern to fill in
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+parsePattern(struct aldWorkspace *ws, int ac, char **av,
+             struct searchPattern *pat)
+
+{
+  unsigned long value,
+                size;
+  long lvalue;
+  unsigned char fill;
+  char *endptr;
+  int alen;
+  int ii;
+
+  memset(pat, '\0', sizeof(struct searchPattern));
+  pat->align = 1;
+
+  if (ac < 2)
+  {
+    Print(ws, P_ERROR, "No search pattern specified");
+    return (0);
+  }
+
+  alen = strlen(av[0]);
+
+  if (!Strncasecmp(av[0], "-string", alen))
+  {
+    pat->len = strlen(av[1]);
+    if ((pat->len == 0) || (pat->len > SEARCH_MAXPATTERN))
+    {
+      Print(ws, P_ERROR, "Invalid search string: %s", av[1]);
+      return (0);
+    }
+
+    memcpy(pat->bytes, av[1], pat->len);
+  }
+  else if (!Strncasecmp(av[0], "-bytes", alen))
+  {
+    for (ii = 1; ii < ac; ++ii)
+    {
+      if (!parseHexBytes(av[ii], pat))
+      {
+        Print(ws, P_ERROR, "Invalid byte pattern: %s", av[ii]);
+        return (0);
+      }
+    }
+  }
+  else if (!Strncasecmp(av[0], "-value", alen))
+  {
+    size = 4;
+
+    if (ac > 2)
+    {
+      if ((ac != 4) || Strncasecmp(av[2], "-size", strlen(av[2])))
+      {
+        Print(ws, P_ERROR, "Invalid argument: %s", av[2]);
+        return (0);
+      }
+
+      size = GetElementSize(av[3]);
+      if ((size != 1) && (size != 2) && (size != 4) && (size != 8))
+      {
+        Print(ws, P_ERROR, "Invalid element size: %s", av[3]);
+        return (0);
+      }
+    }
+
+    fill = 0;
+    if (*av[1] == '-')
+    {
+      lvalue = strtol(av[1], &endptr, 0);
+      value = (unsigned long) lvalue;
+      if (lvalue < 0)
+        fill = 0xff;
+    }
+    else
+      value = strtoul(av[1], &endptr, 0);
+
+    if ((endptr == av[1]) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+
+    if (!fill && (size < sizeof(unsigned long)) &&
+        ((value >> (size * 8)) != 0))
+    {
+      Print(ws, P_ERROR, "Value does not fit in %lu bytes: %s", size, av[1]);
+      return (0);
+    }
+
+    /*
+     * Store the value in target (little endian) byte order
+     */
+    for (ii = 0; (unsigned long) ii < size; ++ii)
+    {
+      if ((unsigned long) ii < sizeof(unsigned long))
+        pat->bytes[ii] = (unsigned char) ((value >> (ii * 8)) & 0xff);
+      else
+        pat->bytes[ii] = fill;
+    }
+
+    pat->len = size;
+    pat->align = size;
+  }
+  else
+  {
+    Print(ws, P_ERROR, "Invalid search pattern type: %s", av[0]);
+    return (0);
+  }
+
+  for (pat->anchor = 0; pat->anchor < pat->len; ++pat->anchor)
+  {
+    if (!pat->wild[pat->anchor])
+      break;
+  }
+
+  if ((pat->len == 0) || (pat->anchor == pat->len))
+  {
+    Print(ws, P_ERROR, "Search pattern must contain at least one fixed byte");
+    return (0);
+  }
+
+  return (1);
+} /* parsePattern() */
+
+/*
+parseHexBytes()
+  Append hex bytes such as "5589e5" or "??" to a pattern
+
+Inputs: str - string of hex digit pairs
+        pat - pattern
+
+Return: 1 if successful
+        0 if str is not valid
+*/
+
+static int
+parseHexBytes(char *str, struct searchPattern *pat)
+
+{
+  char digits[3];
+
+  while (*str)
+  {
+    if (isspace((unsigned char) *str))
+    {
+      ++str;
+      continue;
+    }
+
+    if (!str[1] || (pat->len >= SEARCH_MAXPATTERN))
+      return (0);
+
+    if ((str[0] == '?') && (str[1] == '?'))
+    {
+      pat->bytes[pat->len] = 0;
+      pat->wild[pat->len] = 1;
+    }
+    else
+    {
+      if (!isxdigit((unsigned char) str[0]) ||
+          !isxdigit((unsigned char) str[1]))
+        return (0);
+
+      digits[0] = str[0];
+      digits[1] = str[1];
+      digits[2] = '\0';
+
+      pat->bytes[pat->len] = (unsigned char) strtoul(digits, 0, 16);
+    }
+
+    ++pat->len;
+    str += 2;
+  }
+
+  return (1);
+} /* parseHexBytes() */
+
+/*
+collectRegion()
+  Callback for traverseMapsDebug() - remember readable regions
+
+Inputs: args  - search state
+        start - start of region
+        end   - end of region
+        perms - region permissions
+*/
+
+static void
+collectRegion(void *args, unsigned long start, unsigned long end,
+              char *perms)
+
+{
+  struct searchState *state;
+  struct searchRegion *ptr;
+
+  state = (struct searchState *) args;
+
+  if ((perms[0] != 'r') || state->nomem)
+    return;
+
+  if (state->nregions == state->maxregions)
+  {
+    state->maxregions = state->maxregions ? state->maxregions * 2 : 64;
+
+    ptr = (struct searchRegion *) realloc(state->regions,
+                                          state->maxregions *
+                                          sizeof(struct searchRegion));
+    if (!ptr)
+    {
+      state->nomem = 1;
+      return;
+    }
+
+    state->regions = ptr;
+  }
+
+  state->regions[state->nregions].start = start;
+  state->regions[state->nregions].end = end;
+  ++state->nregions;
+} /* collectRegion() */
+
+/*
+searchRange()
+  Search an address range, reading it in large chunks
+
+Inputs: state - search state
+        buf   - chunk buffer (SEARCH_CHUNKSIZE + pattern length bytes)
+        start - start of range
+        end   - end of range
+
+Return: number of bytes which could be read - if this is less than
+        the size of the range, errno is set
+*/
+
+static long
+searchRange(struct searchState *state, unsigned char *buf,
+            unsigned long start, unsigned long end)
+
+{
+  unsigned long base,   /* address of buf[0] */
+                keep,   /* bytes carried over from the last chunk */
+                want,
+                avail,
+                carry;
+  long got;
+
+  base = start;
+  keep = 0;
+
+  while ((base + keep) < end)
+  {
+    want = end - (base + keep);
+    if (want > SEARCH_CHUNKSIZE)
+      want = SEARCH_CHUNKSIZE;
+
+    got = readMemoryDebug(state->ws->debugWorkspace_p,
+                          base + keep,
+                          buf + keep,
+                          want);
+
+    avail = keep + got;
+
+    scanChunk(state, buf, avail, base);
+
+    if ((unsigned long) got < want)
+      return ((long) (base + avail - start));
+
+    /*
+     * Keep the tail of the chunk which could still be the start
+     * of a match - every position before it has been tested
+     */
+    carry = state->pat->len - 1;
+    if (carry > avail)
+      carry = avail;
+
+    memmove(buf, buf + avail - carry, carry);
+    base += avail - carry;
+    keep = carry;
+  }
+
+  return ((long) (end - start));
+} /* searchRange() */
+
+/*
+scanChunk()
+  Report all matches starting in a buffer. memchr() does the actual
+scanning for the anchor byte - it is vectorised by the C library on
+any platform worth mentioning - and the rest of the pattern is only
+compared where the anchor matched.
+
+Inputs: state - search state
+        buf   - memory contents
+        avail - number of bytes in buf
+        base  - address of buf[0]
+*/
+
+static void
+scanChunk(struct searchState *state, unsigned char *buf,
+          unsigned long avail, unsigned long base)
+
+{
+  struct searchPattern *pat;
+  struct offSymbolInfo symInfo;
+  unsigned char *hit;
+  unsigned long pos,
+                last,
+                addr,
+                ii;
+
+  pat = state->pat;
+
+  if (avail < pat->len)
+    return;
+
+  last = avail - pat->len;
+  pos = 0;
+
+  while (pos <= last)
+  {
+    hit = (unsigned char *) memchr(buf + pos + pat->anchor,
+                                   pat->bytes[pat->anchor],
+                                   last - pos + 1);
+    if (!hit)
+      break;
+
+    pos = (unsigned long) (hit - buf) - pat->anchor;
+    addr = base + pos;
+
+    for (ii = 0; ii < pat->len; ++ii)
+    {
+      if (!pat->wild[ii] && (buf[pos + ii] != pat->bytes[ii]))
+        break;
+    }
+
+    if ((ii == pat->len) && ((addr % pat->align) == 0))
+    {
+      ++state->matches;
+
+      if (findSymbolOFF(state->ws->offWorkspace_p, 0, addr, &symInfo))
+      {
+        Print(state->ws,
+              P_COMMAND,
+              "0x%08lX <%s+%u>",
+              addr,
+              symInfo.name,
+              symInfo.offset);
+      }
+      else
+        Print(state->ws, P_COMMAND, "0x%08lX", addr);
+    }
+
+    ++pos;
+  }
+} /* scanChunk() */
@@ -0,0 +1,235 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "frame.h"
+#include "list.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "snapshot.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static void listSnapshots(struct aldWorkspace *ws);
+
+/*
+c_snapshot()
+  Save the contents of memory regions for a later "diff"
+
+Format for this command:
+  snapshot                   - list snapshots
+  snapshot <name> <range...> - take snapshot
+  snapshot -delete <name>    - delete snapshot ("all" deletes every one)
+
+where each <range> is one of:
+  <section>     - an entire section, such as .data
+  <symbol>      - a symbol whose size is known
+  <start> <end> - an address range (end is exclusive)
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_snapshot(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct snapshotRegion regions[SNAPSHOT_MAXREGIONS];
+  struct offSectionInfo secInfo;
+  struct offSymbolInfo symInfo;
+  struct genericList *node;
+  struct snapshot *snap;
+  unsigned long start,
+                end,
+                total;
+  int nregions;
+  int ii;
+
+  if (ac < 2)
+  {
+    listSnapshots(ws);
+    return (1);
+  }
+
+  if (!Strcasecmp(av[1], "-delete"))
+  {
+    if (ac < 3)
+    {
+      Print(ws, P_COMMAND, "Syntax: snapshot -delete <name | all>");
+      return (0);
+    }
+
+    if (!Strcasecmp(av[2], "all"))
+    {
+      freeList(&(ws->snapshotList));
+      return (1);
+    }
+
+    node = findSnapshot(ws, av[2]);
+    if (!node)
+    {
+      Print(ws, P_ERROR, "No such snapshot: %s", av[2]);
+      return (0);
+    }
+
+    free(node->ptr);
+    deleteList(&(ws->snapshotList), node);
+
+    return (1);
+  }
+
+  if (ac < 3)
+  {
+    Print(ws, P_COMMAND, "Syntax: snapshot <name> <range...>");
+    return (0);
+  }
+
+  if (!isRunningDebug(ws->debugWorkspace_p))
+  {
+    Print(ws, P_ERROR, MSG_NOPROCESS);
+    return (0);
+  }
+
+  if (strlen(av[1]) > SNAPSHOT_NAMELEN)
+  {
+    Print(ws,
+          P_ERROR,
+          "Snapshot name too long (maximum %d characters)",
+          SNAPSHOT_NAMELEN);
+    return (0);
+  }
+
+  nregions = 0;
+  for (ii = 2; ii < ac; ++ii)
+  {
+    if (nregions == SNAPSHOT_MAXREGIONS)
+    {
+      Print(ws,
+            P_ERROR,
+            "Too many ranges (maximum %d)",
+            SNAPSHOT_MAXREGIONS);
+      return (0);
+    }
+
+    if (findSectionOFF(ws->offWorkspace_p, av[ii], 0, &secInfo))
+    {
+      start = secInfo.address;
+      end = start + secInfo.size;
+    }
+    else if (findSymbolOFF(ws->offWorkspace_p, av[ii], 0, &symInfo) &&
+             symInfo.size)
+    {
+      start = symInfo.address;
+      end = start + symInfo.size;
+    }
+    else
+    {
+      if (!resolveAddress(ws, av[ii], &start))
+      {
+        Print(ws, P_ERROR, MSG_INVADDR, av[ii]);
+        return (0);
+      }
+
+      if (++ii >= ac)
+      {
+        Print(ws, P_ERROR, "No ending address given for 0x%08lX", start);
+        return (0);
+      }
+
+      if (!resolveAddress(ws, av[ii], &end))
+      {
+        Print(ws, P_ERROR, MSG_INVADDR, av[ii]);
+        return (0);
+      }
+    }
+
+    if (end <= start)
+    {
+      Print(ws, P_ERROR, "Ending address is lower than starting address");
+      return (0);
+    }
+
+    regions[nregions].start = start;
+    regions[nregions].size = end - start;
+    regions[nregions].data = 0;
+    ++nregions;
+  }
+
+  snap = takeSnapshot(ws, av[1], regions, nregions);
+  if (!snap)
+    return (0);
+
+  total = 0;
+  for (ii = 0; ii < snap->nregions; ++ii)
+    total += snap->regions[ii].size;
+
+  Print(ws,
+        P_COMMAND,
+        "Snapshot %s: %lu bytes in %d range%s",
+        snap->name,
+        total,
+        snap->nregions,
+        (snap->nregions == 1) ? "" : "s");
+
+  return (1);
+} /* c_snapshot() */
+
+/*
+listSnapshots()
+  Display all snapshots and their ranges
+*/
+
+static void
+listSnapshots(struct aldWorkspace *ws)
+
+{
+  struct genericList *node;
+  struct snapshot *snap;
+  int ii;
+
+  if (!ws->snapshotList)
+  {
+    Print(ws, P_COMMAND, "No snapshots taken");
+    return;
+  }
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  for (node = ws->snapshotList; node; node = node->next)
+  {
+    snap = (struct snapshot *) node->ptr;
+
+    Print(ws, P_COMMAND, "%s:", snap->name);
+    for (ii = 0; ii < snap->nregions; ++ii)
+    {
+      Print(ws,
+            P_COMMAND,
+            "  0x%08lX - 0x%08lX (%lu bytes)",
+            snap->regions[ii].start,
+            snap->regions[ii].start + snap->regions[ii].size,
+            snap->regions[ii].size);
+    }
+  }
+
+  endPrintBurst(ws->printWorkspace_p);
+} /* listSnapshots() */
@@ -18,6 +18,7 @@
 
 #include "alddefs.h"
 #include "disassemble.h"
+#include "display.h"
 #include "load.h"
 #include "main.h"
 #include "misc.h"
@@ -53,6 +54,12 @@ c_step(struct aldWorkspace *ws, int ac, char **av)
       ret;
   char *endptr;
 
+  /*
+   * "set step-granularity block" makes step behave like stepb
+   */
+  if (IsSetStepBlock(ws))
+    return (c_stepb(ws, ac, av));
+
   if (ac > 1)
   {
     num = strtol(av[1], &endptr, 0);
@@ -82,24 +89,10 @@ c_step(struct aldWorkspace *ws, int ac, char **av)
   if (analyzeTraceResult(ws, ret, data) == 0)
     return (0);
 
-  if (IsSetStepDisplayRegs(ws))
-  {
-    /*
-     * Update and display new register values
-     */
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_GENERAL);
-  }
-
-  if (IsSetStepDisplayFpRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_FPREGS);
-
-  if (IsSetStepDisplayMmxRegs(ws))
-    displayRegisters(ws, NOREG, 1, DB_REGFL_DISPLAY_MMXREGS);
-
   /*
-   * Disassemble and output the next instruction
+   * Display registers, memory and the next instruction
    */
-  DisplayNextInstruction(ws);
+  doStepDisplay(ws);
 
   return (1);
 } /* c_step() */
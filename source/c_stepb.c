@@ -0,0 +1,90 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2004 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+
+#include "alddefs.h"
+#include "display.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "terminal.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+
+/*
+c_stepb()
+  Step through program one basic block at a time: the program runs
+until it takes a branch and stops at the branch target. The usual
+step display is shown at the start of each block.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_stepb(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int data, /* data returned from block step procedure */
+      num,  /* number of blocks to step */
+      ii,   /* looping */
+      ret;
+  char *endptr;
+
+  if (ac > 1)
+  {
+    num = strtol(av[1], &endptr, 0);
+    if ((endptr == av[1]) || (*endptr != '\0') || (num <= 0))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+  }
+  else
+    num = 1;
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    /*
+     * Restore the child's terminal state
+     */
+    restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+
+    ret = stepBlockDebug(ws->debugWorkspace_p, 1, &data);
+
+    /*
+     * Save the child's terminal state and restore the original
+     * terminal settings in case the child messed with them.
+     */
+    saveTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+    restoreTerminal(&(ws->terminalWorkspace_p->ParentAttributes));
+
+    if (analyzeTraceResult(ws, ret, data) == 0)
+      return (0);
+
+    /*
+     * Display registers, memory and the entry of the new block
+     */
+    doStepDisplay(ws);
+
+    if (ret != 1)
+      break; /* stopped by a breakpoint or signal */
+  }
+
+  return (1);
+} /* c_stepb() */
@@ -0,0 +1,232 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "strindex.h"
+
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static int containsString(unsigned char *str, unsigned long len,
+                          char *match, unsigned long mlen);
+
+/*
+c_strings()
+  Show the printable strings of the loaded file
+
+Format for this command:
+  strings [-section <name>] [-min <length>] [-match <text>]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_strings(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct strIndex *index;
+  struct strEntry *eptr;
+  struct offSectionInfo secInfo;
+  char *section,
+       *match,
+       *endptr;
+  char buffer[STR_SHOWLEN + 1];
+  unsigned char *data;
+  unsigned long minlen,
+                mlen,
+                start,
+                end,
+                shown,
+                len;
+  long ii;
+  int cnt,
+      alen;
+
+  section = 0;
+  match = 0;
+  minlen = STR_MINLEN;
+  mlen = 0;
+
+  for (cnt = 1; cnt < ac; ++cnt)
+  {
+    alen = strlen(av[cnt]);
+    if (!Strncasecmp(av[cnt], "-section", alen))
+    {
+      if (++cnt >= ac)
+      {
+        Print(ws, P_COMMAND, "No section name specified");
+        return (0);
+      }
+
+      section = av[cnt];
+    }
+    else if (!Strncasecmp(av[cnt], "-min", alen))
+    {
+      if (++cnt >= ac)
+      {
+        Print(ws, P_COMMAND, "No length specified");
+        return (0);
+      }
+
+      minlen = strtoul(av[cnt], &endptr, 0);
+      if ((endptr == av[cnt]) || (*endptr != '\0'))
+      {
+        Print(ws, P_COMMAND, MSG_INVNUM, av[cnt]);
+        return (0);
+      }
+
+      if (minlen < STR_MINLEN)
+      {
+        Print(ws,
+              P_COMMAND,
+              "Minimum string length is %d",
+              STR_MINLEN);
+        return (0);
+      }
+    }
+    else if (!Strncasecmp(av[cnt], "-match", alen))
+    {
+      if (++cnt >= ac)
+      {
+        Print(ws, P_COMMAND, "No text specified");
+        return (0);
+      }
+
+      match = av[cnt];
+      mlen = strlen(match);
+    }
+    else
+    {
+      Print(ws,
+            P_COMMAND,
+            "Syntax: strings [-section <name>] [-min <length>] [-match <text>]");
+      return (0);
+    }
+  }
+
+  start = 0;
+  end = ws->MappedSize;
+
+  if (section)
+  {
+    if (!findSectionOFF(ws->offWorkspace_p, section, 0, &secInfo))
+    {
+      Print(ws, P_COMMAND, "No such section: %s", section);
+      return (0);
+    }
+
+    if (secInfo.address < ws->virtualFileAddress)
+      return (1);
+
+    start = secInfo.address - ws->virtualFileAddress;
+    end = start + secInfo.size;
+  }
+
+  index = getStrIndex(ws);
+  if (!index)
+    return (0);
+
+  data = (unsigned char *) ws->MapPtr;
+  shown = 0;
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  for (ii = findStringIndex(index, start); ii < index->count; ++ii)
+  {
+    eptr = index->entries + ii;
+    if (eptr->offset >= end)
+      break;
+
+    if (eptr->length < minlen)
+      continue;
+
+    if (match &&
+        !containsString(data + eptr->offset, eptr->length, match, mlen))
+      continue;
+
+    len = eptr->length;
+    if (len > STR_SHOWLEN)
+      len = STR_SHOWLEN;
+
+    memcpy(buffer, data + eptr->offset, len);
+    buffer[len] = '\0';
+
+    Print(ws,
+          P_COMMAND,
+          "0x%08lX %-12s %s%s",
+          ws->virtualFileAddress + eptr->offset,
+          (eptr->section >= 0) ? index->sections[eptr->section].name : "",
+          buffer,
+          (eptr->length > STR_SHOWLEN) ? "..." : "");
+
+    ++shown;
+  }
+
+  endPrintBurst(ws->printWorkspace_p);
+
+  if (!shown)
+    Print(ws, P_COMMAND, "No strings found");
+
+  return (1);
+} /* c_strings() */
+
+/*
+containsString()
+  Determine whether a string of known length contains some text
+
+Inputs: str   - string
+        len   - length of string
+        match - text to look for
+        mlen  - length of text
+
+Return: 1 if found
+        0 if not
+*/
+
+static int
+containsString(unsigned char *str, unsigned long len,
+               char *match, unsigned long mlen)
+
+{
+  unsigned char *ptr,
+                *last;
+
+  if (!mlen)
+    return (1);
+
+  if (mlen > len)
+    return (0);
+
+  last = str + len - mlen;
+  for (ptr = str; ptr <= last; ++ptr)
+  {
+    ptr = (unsigned char *) memchr(ptr, *match, last - ptr + 1);
+    if (!ptr)
+      return (0);
+
+    if (!memcmp(ptr, match, mlen))
+      return (1);
+  }
+
+  return (0);
+} /* containsString() */
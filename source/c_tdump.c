@@ -0,0 +1,181 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+ * Registers and memory bytes shown per line
+ */
+#define TDUMP_REGSPERLINE   4
+#define TDUMP_BYTESPERLINE  16
+
+static void dumpFrame(struct aldWorkspace *ws, struct traceFrame *frame);
+
+/*
+c_tdump()
+  Show the frames collected by tracepoints
+
+Format for this command:
+  tdump [tracepoint]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_tdump(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct traceFrame frame;
+  unsigned long cursor,
+                shown;
+  unsigned int number;
+  char *endptr;
+
+  number = 0;
+  if (ac > 1)
+  {
+    number = (unsigned int) strtoul(av[1], &endptr, 0);
+    if ((endptr == av[1]) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[1]);
+      return (0);
+    }
+  }
+
+  syncTrace(ws->debugWorkspace_p);
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  shown = 0;
+  cursor = 0;
+  while (readTraceFrame(ws->debugWorkspace_p, &cursor, &frame))
+  {
+    if (number && (frame.number != number))
+      continue;
+
+    dumpFrame(ws, &frame);
+    ++shown;
+  }
+
+  if (!shown)
+    Print(ws, P_COMMAND, "No frames collected");
+
+  endPrintBurst(ws->printWorkspace_p);
+
+  return (1);
+} /* c_tdump() */
+
+/*
+dumpFrame()
+  Show one frame
+
+Inputs: ws    - main workspace
+        frame - frame to show
+*/
+
+static void
+dumpFrame(struct aldWorkspace *ws, struct traceFrame *frame)
+
+{
+  struct offSymbolInfo symInfo;
+  char buf[MAXLINE];
+  unsigned long ii;
+  int len,
+      cnt,
+      regindex;
+
+  if (findSymbolOFF(ws->offWorkspace_p, 0, frame->address, &symInfo))
+    Snprintf(buf, MAXLINE, " (%s+0x%x)", symInfo.name, symInfo.offset);
+  else
+    *buf = '\0';
+
+  Print(ws,
+        P_COMMAND,
+        "Frame %lu: tracepoint %u at 0x%08lX%s",
+        frame->sequence,
+        frame->number,
+        frame->address,
+        buf);
+
+  len = 0;
+  cnt = 0;
+  for (regindex = 0; regindex < TRACE_MAXREGS; ++regindex)
+  {
+    if (!(frame->regmask & (1UL << regindex)))
+      continue;
+
+    len += Snprintf(buf + len,
+                    MAXLINE - len,
+                    "  %-6s = 0x%08lX",
+                    getRegisterNameDebug(ws->debugWorkspace_p, regindex),
+                    frame->regs[regindex]);
+
+    if (++cnt == TDUMP_REGSPERLINE)
+    {
+      Print(ws, P_COMMAND, "%s", buf);
+      len = 0;
+      cnt = 0;
+    }
+  }
+
+  if (cnt)
+    Print(ws, P_COMMAND, "%s", buf);
+
+  for (cnt = 0; cnt < frame->nmem; ++cnt)
+  {
+    if (frame->memsize[cnt] == 0)
+    {
+      Print(ws,
+            P_COMMAND,
+            "  0x%08lX: (unable to read memory)",
+            frame->memaddr[cnt]);
+      continue;
+    }
+
+    for (ii = 0; ii < frame->memsize[cnt]; ++ii)
+    {
+      if ((ii % TDUMP_BYTESPERLINE) == 0)
+      {
+        len = Snprintf(buf,
+                       MAXLINE,
+                       "  0x%08lX:",
+                       frame->memaddr[cnt] + ii);
+      }
+
+      len += Snprintf(buf + len,
+                      MAXLINE - len,
+                      " %02X",
+                      frame->membytes[cnt][ii]);
+
+      if (((ii + 1) % TDUMP_BYTESPERLINE) == 0)
+        Print(ws, P_COMMAND, "%s", buf);
+    }
+
+    if ((ii % TDUMP_BYTESPERLINE) != 0)
+      Print(ws, P_COMMAND, "%s", buf);
+  }
+} /* dumpFrame() */
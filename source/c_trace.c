@@ -0,0 +1,456 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "xref.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * Number of bytes collected from a memory range if no size is given
+ */
+#define TRACE_DEFRANGE  4
+
+static int parseTracepoint(struct aldWorkspace *ws, int ac, char **av,
+                           unsigned long *address,
+                           struct traceCollect *collect);
+static long findDisplaced(struct aldWorkspace *ws, unsigned long address);
+static int parseCollect(struct aldWorkspace *ws, char *item,
+                        struct traceCollect *collect);
+static int parseRange(struct aldWorkspace *ws, char *item,
+                      struct traceRange *range);
+
+/*
+c_trace()
+  Set a tracepoint: each time the program reaches it, the given
+registers and memory are collected and the program runs on
+
+Format for this command:
+  trace <address | symbol> [collect <item> ...]
+
+An item is one of:
+  <register>                   - a general register
+  regs                         - all general registers
+  [<register | address>]:size  - 'size' bytes of memory at the
+                                 register value or address, which
+                                 may be followed by +offset or
+                                 -offset
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_trace(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long address;
+  struct traceCollect collect;
+  int num;
+
+  if (!parseTracepoint(ws, ac, av, &address, &collect))
+    return (0);
+
+  num = newTracepoint(ws->debugWorkspace_p, address, &collect);
+  if (num == (-1))
+  {
+    Print(ws,
+          P_ERROR,
+          "Error occurred while setting tracepoint: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws, P_COMMAND, "Tracepoint %d set for 0x%08lX", num, address);
+
+  return (1);
+} /* c_trace() */
+
+/*
+c_ftrace()
+  Set a fast tracepoint: like a tracepoint, but the program is not
+stopped when it is hit. The instructions at the address are replaced
+by a jump to code which collects into a ring inside the program, so
+the address must start at least 5 bytes of instructions which do not
+depend on where they are, and which nothing jumps into.
+
+Format for this command:
+  ftrace <address | symbol> [collect <item> ...]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_ftrace(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long address;
+  struct traceCollect collect;
+  long length;
+  int num;
+
+  if (!parseTracepoint(ws, ac, av, &address, &collect))
+    return (0);
+
+  length = findDisplaced(ws, address);
+  if (length <= 0)
+    return (0);
+
+  num = newFastTracepoint(ws->debugWorkspace_p,
+                          address,
+                          (unsigned long) length,
+                          &collect);
+  if (num == (-1))
+  {
+    Print(ws,
+          P_ERROR,
+          "Error occurred while setting fast tracepoint: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws, P_COMMAND, "Fast tracepoint %d set for 0x%08lX", num, address);
+
+  return (1);
+} /* c_ftrace() */
+
+/*
+parseTracepoint()
+  Parse the arguments of the trace and ftrace commands
+
+Inputs: ws      - main workspace
+        ac      - argument count
+        av      - arguments
+        address - where to store the tracepoint address
+        collect - where to store the collect list
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+parseTracepoint(struct aldWorkspace *ws, int ac, char **av,
+                unsigned long *address, struct traceCollect *collect)
+
+{
+  struct offSymbolInfo symInfo;
+  char *endptr;
+  int ii;
+
+  if ((ac < 2) || ((ac > 2) && (strcmp(av[2], "collect") != 0)))
+  {
+    Print(ws,
+          P_COMMAND,
+          "Syntax: %s <address | symbol> [collect <item> ...]",
+          av[0]);
+    return (0);
+  }
+
+  *address = strtoul(av[1], &endptr, 0);
+  if ((endptr == av[1]) || (*endptr != '\0'))
+  {
+    /*
+     * They gave an invalid number, but it may be the name
+     * of a debugging symbol
+     */
+    if (!findSymbolOFF(ws->offWorkspace_p, av[1], 0, &symInfo))
+    {
+      Print(ws, P_ERROR, MSG_INVSYM, av[1]);
+      return (0);
+    }
+
+    *address = symInfo.address;
+  }
+
+  memset(collect, '\0', sizeof(struct traceCollect));
+
+  for (ii = 3; ii < ac; ++ii)
+  {
+    if (!parseCollect(ws, av[ii], collect))
+      return (0);
+  }
+
+  return (1);
+} /* parseTracepoint() */
+
+/*
+findDisplaced()
+  Work out how many bytes of instructions at an address a fast
+tracepoint's jump replaces: whole instructions covering at least 5
+bytes. The instructions are run from elsewhere, so none may be a
+relative branch, nothing may jump into the middle of them, and the
+program may not be stopped inside them.
+
+Inputs: ws      - main workspace
+        address - tracepoint address
+
+Return: number of bytes
+        0 if the address is unsuitable (an error is printed)
+*/
+
+static long
+findDisplaced(struct aldWorkspace *ws, unsigned long address)
+
+{
+  unsigned char *code;
+  char buffer[MAXLINE];
+  struct xref *refs;
+  unsigned long pc;
+  long ndumped,
+       length,
+       len;
+
+  code = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                            &code,
+                            address,
+                            TRACE_MAXDISPLACE + MAX_OPCODE_LEN);
+
+  length = 0;
+  while (length < 5)
+  {
+    if (length + MAX_OPCODE_LEN > ndumped)
+    {
+      Print(ws, P_ERROR, "Unable to read memory at 0x%08lX", address);
+      length = 0;
+      break;
+    }
+
+    len = procDisasm(ws->disasmWorkspace_p,
+                     code + length,
+                     buffer,
+                     (unsigned int) (address + length));
+    if (len <= 0)
+    {
+      Print(ws,
+            P_ERROR,
+            "Invalid instruction at 0x%08lX",
+            address + length);
+      length = 0;
+      break;
+    }
+
+    if (ws->disasmWorkspace_p->effectiveAddress)
+    {
+      Print(ws,
+            P_ERROR,
+            "Instruction at 0x%08lX is a relative branch and cannot be moved",
+            address + length);
+      length = 0;
+      break;
+    }
+
+    length += len;
+  }
+
+  if (code)
+    free(code);
+
+  if (length == 0)
+    return (0);
+
+  if (length > TRACE_MAXDISPLACE)
+  {
+    Print(ws, P_ERROR, "Instructions at 0x%08lX are too long", address);
+    return (0);
+  }
+
+  if (findXrefsTo(ws, address + 1, address + length, &refs) > 0)
+  {
+    Print(ws,
+          P_ERROR,
+          "Code at 0x%08lX jumps into the instructions at 0x%08lX",
+          refs->source,
+          address);
+    return (0);
+  }
+
+  for (len = 0; len < length; ++len)
+  {
+    if (findBreakpoint(ws->debugWorkspace_p, address + len))
+    {
+      Print(ws,
+            P_ERROR,
+            "Breakpoint set at 0x%08lX",
+            address + len);
+      return (0);
+    }
+  }
+
+  pc = getAddressDebug(ws->debugWorkspace_p);
+  if ((pc > address) && (pc < address + length))
+  {
+    Print(ws,
+          P_ERROR,
+          "Program is stopped inside the instructions at 0x%08lX",
+          address);
+    return (0);
+  }
+
+  return (length);
+} /* findDisplaced() */
+
+/*
+parseCollect()
+  Add an item to the list of things a tracepoint collects
+
+Inputs: ws      - main workspace
+        item    - register or memory range
+        collect - collect list
+
+Return: 1 if successful
+        0 if the item is invalid
+*/
+
+static int
+parseCollect(struct aldWorkspace *ws, char *item,
+             struct traceCollect *collect)
+
+{
+  int regindex;
+
+  if (*item == '[')
+  {
+    if (collect->nmem >= TRACE_MAXMEM)
+    {
+      Print(ws,
+            P_ERROR,
+            "A tracepoint may collect at most %d memory ranges",
+            TRACE_MAXMEM);
+      return (0);
+    }
+
+    if (!parseRange(ws, item, &(collect->mem[collect->nmem])))
+      return (0);
+
+    ++(collect->nmem);
+
+    return (1);
+  }
+
+  if (!strcmp(item, "regs"))
+  {
+    collect->regmask |= (1UL << REG_ENDGENERAL) - 1;
+    return (1);
+  }
+
+  regindex = findRegisterDebug(ws->debugWorkspace_p, item);
+  if ((regindex < 0) || (regindex >= REG_ENDGENERAL))
+  {
+    Print(ws, P_ERROR, "Invalid general register: %s", item);
+    return (0);
+  }
+
+  collect->regmask |= 1UL << regindex;
+
+  return (1);
+} /* parseCollect() */
+
+/*
+parseRange()
+  Parse a memory range of the form [<register | address>+offset]:size
+
+Inputs: ws    - main workspace
+        item  - range string
+        range - where to store the range
+
+Return: 1 if successful
+        0 if the range is invalid
+*/
+
+static int
+parseRange(struct aldWorkspace *ws, char *item, struct traceRange *range)
+
+{
+  char buf[MAXLINE];
+  char *start,
+       *end,
+       *sign,
+       *endptr;
+
+  strncpy(buf, item + 1, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = '\0';
+
+  start = buf;
+  end = strchr(start, ']');
+  if (!end)
+  {
+    Print(ws, P_ERROR, "Invalid memory range: %s", item);
+    return (0);
+  }
+
+  *end++ = '\0';
+
+  range->size = TRACE_DEFRANGE;
+  if (*end == ':')
+  {
+    range->size = strtoul(end + 1, &endptr, 0);
+    if ((endptr == end + 1) || (*endptr != '\0') || (range->size == 0) ||
+        (range->size > TRACE_MAXRANGE))
+    {
+      Print(ws,
+            P_ERROR,
+            "Invalid size: %s (at most %d bytes)",
+            end + 1,
+            TRACE_MAXRANGE);
+      return (0);
+    }
+  }
+  else if (*end != '\0')
+  {
+    Print(ws, P_ERROR, "Invalid memory range: %s", item);
+    return (0);
+  }
+
+  range->offset = 0;
+
+  sign = strpbrk(start, "+-");
+  if (sign && (sign != start))
+  {
+    range->offset = strtol(sign, &endptr, 0);
+    if ((endptr == sign + 1) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, sign);
+      return (0);
+    }
+
+    *sign = '\0';
+  }
+
+  range->base = findRegisterDebug(ws->debugWorkspace_p, start);
+  if (range->base >= REG_ENDGENERAL)
+  {
+    Print(ws, P_ERROR, "Invalid general register: %s", start);
+    return (0);
+  }
+
+  if (range->base < 0)
+  {
+    range->offset += (long) strtoul(start, &endptr, 0);
+    if ((endptr == start) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVADDR, start);
+      return (0);
+    }
+  }
+
+  return (1);
+} /* parseRange() */
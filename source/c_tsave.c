@@ -0,0 +1,143 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+c_tsave()
+  Write the frames collected by tracepoints to a file, one line per
+frame, for processing by other programs. A line looks like:
+
+  <frame> <tracepoint> <address> [<register>=<value> ...]
+    [<address>=<hex bytes> ...]
+
+with the bytes given as '?' for memory which could not be read.
+
+Format for this command:
+  tsave <file> [tracepoint]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_tsave(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct traceFrame frame;
+  unsigned long cursor,
+                saved,
+                ii;
+  unsigned int number;
+  char *endptr;
+  FILE *fp;
+  int regindex,
+      cnt;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: tsave <file> [tracepoint]");
+    return (0);
+  }
+
+  number = 0;
+  if (ac > 2)
+  {
+    number = (unsigned int) strtoul(av[2], &endptr, 0);
+    if ((endptr == av[2]) || (*endptr != '\0'))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[2]);
+      return (0);
+    }
+  }
+
+  fp = fopen(av[1], "w");
+  if (!fp)
+  {
+    Print(ws,
+          P_ERROR,
+          "Unable to open file %s: %s",
+          av[1],
+          strerror(errno));
+    return (0);
+  }
+
+  syncTrace(ws->debugWorkspace_p);
+
+  saved = 0;
+  cursor = 0;
+  while (readTraceFrame(ws->debugWorkspace_p, &cursor, &frame))
+  {
+    if (number && (frame.number != number))
+      continue;
+
+    fprintf(fp,
+            "%lu %u 0x%08lX",
+            frame.sequence,
+            frame.number,
+            frame.address);
+
+    for (regindex = 0; regindex < TRACE_MAXREGS; ++regindex)
+    {
+      if (frame.regmask & (1UL << regindex))
+      {
+        fprintf(fp,
+                " %s=0x%08lX",
+                getRegisterNameDebug(ws->debugWorkspace_p, regindex),
+                frame.regs[regindex]);
+      }
+    }
+
+    for (cnt = 0; cnt < frame.nmem; ++cnt)
+    {
+      fprintf(fp, " 0x%08lX=", frame.memaddr[cnt]);
+
+      if (frame.memsize[cnt] == 0)
+        fputc('?', fp);
+
+      for (ii = 0; ii < frame.memsize[cnt]; ++ii)
+        fprintf(fp, "%02X", frame.membytes[cnt][ii]);
+    }
+
+    fputc('\n', fp);
+    ++saved;
+  }
+
+  if (fclose(fp) != 0)
+  {
+    Print(ws,
+          P_ERROR,
+          "Error writing file %s: %s",
+          av[1],
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "Saved %lu frame%s to %s",
+        saved,
+        (saved == 1) ? "" : "s",
+        av[1]);
+
+  return (1);
+} /* c_tsave() */
@@ -0,0 +1,99 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+
+#include "main.h"
+#include "print.h"
+
+#include "libDebug.h"
+
+/*
+c_tstatus()
+  Show the tracepoints and how full the trace buffer is
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_tstatus(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct Trace *trace;
+  struct Breakpoint *bptr;
+  struct fastTracepoint *fptr;
+  int cnt;
+
+  trace = &(ws->debugWorkspace_p->trace);
+
+  syncTrace(ws->debugWorkspace_p);
+
+  /*
+   * Breakpoints are stored in reverse numerical order
+   */
+  bptr = ws->debugWorkspace_p->breakpoints;
+  while (bptr && bptr->next)
+    bptr = bptr->next;
+
+  cnt = 0;
+  for (; bptr; bptr = bptr->prev)
+  {
+    if (!(bptr->flags & BK_TRACE))
+      continue;
+
+    Print(ws,
+          P_COMMAND,
+          "Tracepoint %u at 0x%08lX: %d hit%s%s",
+          bptr->number,
+          bptr->address,
+          bptr->hitcnt,
+          (bptr->hitcnt == 1) ? "" : "s",
+          (bptr->flags & BK_ENABLED) ? "" : " (disabled)");
+    ++cnt;
+  }
+
+  /*
+   * Fast tracepoints are stored newest first too
+   */
+  fptr = trace->fast;
+  while (fptr && fptr->next)
+    fptr = fptr->next;
+
+  for (; fptr; fptr = fptr->prev)
+  {
+    Print(ws,
+          P_COMMAND,
+          "Fast tracepoint %u at 0x%08lX: %lu hit%s",
+          fptr->number,
+          fptr->address,
+          fptr->harvested,
+          (fptr->harvested == 1) ? "" : "s");
+    ++cnt;
+  }
+
+  if (!cnt)
+    Print(ws, P_COMMAND, "No tracepoints set");
+
+  Print(ws,
+        P_COMMAND,
+        "%lu frame%s in buffer (%lu of %lu bytes used), %lu collected, %lu discarded",
+        trace->count,
+        (trace->count == 1) ? "" : "s",
+        trace->used,
+        trace->size,
+        trace->collected,
+        trace->dropped);
+
+  return (1);
+} /* c_tstatus() */
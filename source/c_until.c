@@ -0,0 +1,299 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "defs.h"
+#include "display.h"
+#include "frame.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "terminal.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+
+/*
+ * Number of bytes past the current instruction searched for the
+ * branch which closes the current loop
+ */
+#define UNTIL_SCANBYTES    1024
+
+/*
+ * Maximum number of loop exits we will place breakpoints on
+ */
+#define UNTIL_MAXEXITS     32
+
+/*
+ * Opcode of CALL rel32 - calls are not loop branches
+ */
+#define OP_CALLREL         0xE8
+
+static int findLoop(struct aldWorkspace *ws, unsigned long address,
+                    unsigned long *start, unsigned long *end);
+static int findLoopExits(struct aldWorkspace *ws, unsigned long start,
+                         unsigned long end, unsigned long *exits);
+static int addExit(unsigned long *exits, int num, unsigned long address);
+
+/*
+findLoop()
+  Find the innermost loop containing an address: scan forward for
+the first relative jump which branches back to (or before) the
+address.
+
+Inputs: ws      - ald workspace
+        address - address inside the loop
+        start   - modified to contain the loop head (branch target)
+        end     - modified to contain the address following the
+                  branch which closes the loop
+
+Return: 1 if a loop was found
+        0 if not
+*/
+
+static int
+findLoop(struct aldWorkspace *ws, unsigned long address,
+         unsigned long *start, unsigned long *end)
+
+{
+  unsigned char *code;
+  char buffer[MAXLINE];
+  long ndumped,
+       offset,
+       len;
+  int found;
+
+  code = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                            &code,
+                            address,
+                            UNTIL_SCANBYTES);
+
+  found = 0;
+  offset = 0;
+
+  /*
+   * Leave room for one maximum length instruction at the end of
+   * the buffer so we never decode past it
+   */
+  while (offset < (ndumped - MAX_OPCODE_LEN))
+  {
+    len = procDisasm(ws->disasmWorkspace_p,
+                     code + offset,
+                     buffer,
+                     (unsigned int) (address + offset));
+    if (len <= 0)
+      break;
+
+    if (ws->disasmWorkspace_p->effectiveAddress &&
+        (code[offset] != OP_CALLREL) &&
+        (ws->disasmWorkspace_p->effectiveAddress <= address))
+    {
+      *start = ws->disasmWorkspace_p->effectiveAddress;
+      *end = address + offset + len;
+      found = 1;
+      break;
+    }
+
+    offset += len;
+  }
+
+  if (code)
+    free(code);
+
+  return (found);
+} /* findLoop() */
+
+/*
+addExit()
+  Add an address to the list of loop exits, unless it is
+already present
+
+Return: new number of exits
+*/
+
+static int
+addExit(unsigned long *exits, int num, unsigned long address)
+
+{
+  int ii;
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    if (exits[ii] == address)
+      return (num);
+  }
+
+  if (num < UNTIL_MAXEXITS)
+    exits[num++] = address;
+
+  return (num);
+} /* addExit() */
+
+/*
+findLoopExits()
+  Compute the addresses at which control leaves a loop: the
+instruction following the closing branch, and the target of every
+jump in the loop body which lands outside of it
+
+Inputs: ws    - ald workspace
+        start - loop head
+        end   - address following the closing branch
+        exits - where to store exit addresses (UNTIL_MAXEXITS)
+
+Return: number of exits found
+*/
+
+static int
+findLoopExits(struct aldWorkspace *ws, unsigned long start,
+              unsigned long end, unsigned long *exits)
+
+{
+  unsigned char *code;
+  char buffer[MAXLINE];
+  long ndumped,
+       offset,
+       len;
+  unsigned long target;
+  int num;
+
+  num = addExit(exits, 0, end);
+
+  /*
+   * Dump a little past the end so the closing branch can always
+   * be decoded in full
+   */
+  code = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p,
+                            &code,
+                            start,
+                            end - start + MAX_OPCODE_LEN);
+  if (ndumped > (long) (end - start))
+    ndumped = end - start;
+
+  offset = 0;
+  while (offset < ndumped)
+  {
+    len = procDisasm(ws->disasmWorkspace_p,
+                     code + offset,
+                     buffer,
+                     (unsigned int) (start + offset));
+    if (len <= 0)
+      break;
+
+    target = ws->disasmWorkspace_p->effectiveAddress;
+    if (target &&
+        (code[offset] != OP_CALLREL) &&
+        ((target < start) || (target >= end)))
+      num = addExit(exits, num, target);
+
+    offset += len;
+  }
+
+  if (code)
+    free(code);
+
+  return (num);
+} /* findLoopExits() */
+
+/*
+c_until()
+  With no argument, continue the program until it leaves the
+current loop. With an argument, continue until the given address
+is reached in the current frame, or the current function returns.
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_until(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  int data,
+      num,
+      ret;
+  unsigned long exits[UNTIL_MAXEXITS + 1],
+                start,
+                end,
+                retaddr,
+                frame;
+
+  num = 0;
+
+  if (ac > 1)
+  {
+    if (!resolveAddress(ws, av[1], &exits[0]))
+    {
+      Print(ws, P_ERROR, MSG_INVSYM, av[1]);
+      return (0);
+    }
+
+    num = 1;
+  }
+  else if (findLoop(ws,
+                    getAddressDebug(ws->debugWorkspace_p),
+                    &start,
+                    &end))
+  {
+    num = findLoopExits(ws, start, end, exits);
+
+    Print(ws,
+          P_COMMAND,
+          "Running until loop 0x%08lX - 0x%08lX is left",
+          start,
+          end);
+  }
+
+  if (num == 0)
+  {
+    /*
+     * We are not inside a loop - behave like "next"
+     */
+    restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+    ret = stepOverDebug(ws->debugWorkspace_p, 1, &data);
+  }
+  else
+  {
+    /*
+     * Leaving the function also leaves the loop
+     */
+    if (getReturnAddress(ws, &retaddr, &frame))
+      exits[num++] = retaddr;
+
+    /*
+     * Ignore arrivals in deeper (recursive) invocations
+     */
+    frame = readStackPointer(ws);
+
+    restoreTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+    ret = runToDebug(ws->debugWorkspace_p, exits, num, frame, &data);
+  }
+
+  /*
+   * Save the child's terminal state and restore the original
+   * terminal settings in case the child messed with them.
+   */
+  saveTerminal(&(ws->terminalWorkspace_p->ChildAttributes));
+  restoreTerminal(&(ws->terminalWorkspace_p->ParentAttributes));
+
+  if (analyzeTraceResult(ws, ret, data) == 0)
+    return (0);
+
+  doStepDisplay(ws);
+
+  return (1);
+} /* c_until() */
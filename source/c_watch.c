@@ -0,0 +1,107 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * Size of a watched range if neither the command nor the symbol
+ * gives one
+ */
+#define WATCH_DEFSIZE  4
+
+/*
+c_watch()
+  Stop the program when it writes to a range of memory
+
+Format for this command:
+  watch <address | symbol> [size]
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_watch(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  unsigned long address,
+                size;
+  int num;
+  char *endptr;
+  struct offSymbolInfo symInfo;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: watch <address | symbol> [size]");
+    return (0);
+  }
+
+  size = WATCH_DEFSIZE;
+
+  address = strtoul(av[1], &endptr, 0);
+  if ((endptr == av[1]) || (*endptr != '\0'))
+  {
+    /*
+     * They gave an invalid number, but it may be the name
+     * of a debugging symbol - watch all of it
+     */
+    if (!findSymbolOFF(ws->offWorkspace_p, av[1], 0, &symInfo))
+    {
+      Print(ws, P_ERROR, MSG_INVSYM, av[1]);
+      return (0);
+    }
+
+    address = symInfo.address;
+    if (symInfo.size)
+      size = symInfo.size;
+  }
+
+  if (ac > 2)
+  {
+    size = strtoul(av[2], &endptr, 0);
+    if ((endptr == av[2]) || (*endptr != '\0') || (size == 0))
+    {
+      Print(ws, P_ERROR, MSG_INVNUM, av[2]);
+      return (0);
+    }
+  }
+
+  num = newWatchpoint(ws->debugWorkspace_p, address, size);
+  if (num == (-1))
+  {
+    Print(ws,
+          P_ERROR,
+          "Error occurred while setting watchpoint: %s",
+          strerror(errno));
+    return (0);
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "Watchpoint %d set for 0x%08lX (%lu byte%s)",
+        num,
+        address,
+        size,
+        (size == 1) ? "" : "s");
+
+  return (1);
+} /* c_watch() */
@@ -0,0 +1,221 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "frame.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "strindex.h"
+#include "xref.h"
+
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+ * Longest part of a referenced string which is shown
+ */
+#define XREF_STRLEN     40
+
+static char *xrefLocation(struct aldWorkspace *ws, unsigned long address,
+                          char *buf);
+static void xrefString(struct aldWorkspace *ws, unsigned long address,
+                       char *buf);
+
+/*
+c_xref()
+  Show cross references of an address
+
+Format for this command:
+  xref <address | symbol>        - show references to a location
+  xref <address | symbol> -from  - show references made by the code
+                                   of a function (or one instruction)
+
+Return: 0 upon failure
+        1 upon success
+*/
+
+int
+c_xref(struct aldWorkspace *ws, int ac, char **av)
+
+{
+  struct offSymbolInfo symInfo;
+  struct xref *refs;
+  unsigned long address,
+                end;
+  char srcbuf[MAXLINE],
+       dstbuf[MAXLINE],
+       strbuf[XREF_STRLEN + 8];
+  long num,
+       ii;
+  int from;
+
+  if (ac < 2)
+  {
+    Print(ws, P_COMMAND, "Syntax: xref <address | symbol> [-from]");
+    return (0);
+  }
+
+  if (!resolveAddress(ws, av[1], &address))
+  {
+    Print(ws, P_ERROR, MSG_INVADDR, av[1]);
+    return (0);
+  }
+
+  from = (ac > 2) && !Strcasecmp(av[2], "-from");
+
+  if (from)
+  {
+    /*
+     * Use the whole function if we know its size
+     */
+    end = address + 1;
+    if (findSymbolOFF(ws->offWorkspace_p, 0, address, &symInfo) &&
+        (symInfo.offset == 0) && symInfo.size)
+      end = address + symInfo.size;
+
+    num = findXrefsFrom(ws, address, end, &refs);
+  }
+  else
+    num = findXrefsTo(ws, address, address + 1, &refs);
+
+  if (num < 0)
+    return (0);
+
+  if (num == 0)
+  {
+    Print(ws,
+          P_COMMAND,
+          "No references %s %s",
+          from ? "from" : "to",
+          xrefLocation(ws, address, dstbuf));
+    return (1);
+  }
+
+  startPrintBurst(ws->printWorkspace_p);
+
+  Print(ws,
+        P_COMMAND,
+        "%ld reference%s %s %s:",
+        num,
+        (num == 1) ? "" : "s",
+        from ? "from" : "to",
+        xrefLocation(ws, address, dstbuf));
+
+  for (ii = 0; ii < num; ++ii)
+  {
+    if (from)
+    {
+      if (refs[ii].kind == XREF_DATA)
+        xrefString(ws, refs[ii].target, strbuf);
+      else
+        *strbuf = '\0';
+
+      Print(ws,
+            P_COMMAND,
+            "  %-30s %s %s%s",
+            xrefLocation(ws, refs[ii].source, srcbuf),
+            XrefKindNames[refs[ii].kind],
+            xrefLocation(ws, refs[ii].target, dstbuf),
+            strbuf);
+    }
+    else
+    {
+      Print(ws,
+            P_COMMAND,
+            "  %-30s %s",
+            xrefLocation(ws, refs[ii].source, srcbuf),
+            XrefKindNames[refs[ii].kind]);
+    }
+  }
+
+  endPrintBurst(ws->printWorkspace_p);
+
+  return (1);
+} /* c_xref() */
+
+/*
+xrefLocation()
+  Format an address along with the symbol it belongs to
+
+Inputs: ws      - ald workspace
+        address - address
+        buf     - buffer of MAXLINE characters
+
+Return: buf
+*/
+
+static char *
+xrefLocation(struct aldWorkspace *ws, unsigned long address, char *buf)
+
+{
+  struct offSymbolInfo symInfo;
+
+  if (findSymbolOFF(ws->offWorkspace_p, 0, address, &symInfo))
+  {
+    if (symInfo.offset)
+    {
+      Snprintf(buf,
+               MAXLINE,
+               "0x%08lX <%s+%u>",
+               address,
+               symInfo.name,
+               symInfo.offset);
+    }
+    else
+      Snprintf(buf, MAXLINE, "0x%08lX <%s>", address, symInfo.name);
+  }
+  else
+    Snprintf(buf, MAXLINE, "0x%08lX", address);
+
+  return (buf);
+} /* xrefLocation() */
+
+/*
+xrefString()
+  If an address is the start of a string in the file, format the
+string for display after a data reference
+
+Inputs: ws      - ald workspace
+        address - address referenced
+        buf     - buffer of XREF_STRLEN + 8 characters, set to the
+                  empty string if address is not a string
+*/
+
+static void
+xrefString(struct aldWorkspace *ws, unsigned long address, char *buf)
+
+{
+  struct strEntry *eptr;
+  unsigned long len;
+
+  *buf = '\0';
+
+  eptr = findString(ws, address);
+  if (!eptr || (eptr->offset != address - ws->virtualFileAddress))
+    return;
+
+  len = eptr->length;
+  if (len > XREF_STRLEN)
+    len = XREF_STRLEN;
+
+  strcpy(buf, " \"");
+  memcpy(buf + 2, (char *) ws->MapPtr + eptr->offset, len);
+  strcpy(buf + 2 + len, (eptr->length > XREF_STRLEN) ? "...\"" : "\"");
+} /* xrefString() */
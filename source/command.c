@@ -21,6 +21,7 @@
 
 #include "alddefs.h"
 #include "command.h"
+#include "core.h"
 #include "defs.h"
 #include "input.h"
 #include "list.h"
@@ -39,8 +40,6 @@
 #include "alloc.h"
 #include "Strn.h"
 
-static int ProcessCommand(struct aldWorkspace *main_p, char *command);
-
 /*
  * Global: pointer to command parser environment. This needs to
  * be global because SigHandler() needs it.
@@ -59,36 +58,62 @@ static struct Command mainCmds[] = {
   { "r", c_run, C_ALIAS|C_PROCESS|C_PTRACE },
   { "s", c_step, C_ALIAS|C_PROCESS|C_PTRACE },
 
+  { "advance", c_advance, C_PROCESS|C_PTRACE },
   { "attach", c_attach, C_PTRACE },
   { "break", c_break, C_PROCESS },
+  { "catch", c_catch, 0 },
+  { "checkpoint", c_checkpoint, C_PROCESS_RUNNING|C_PTRACE },
   { "continue", c_continue, C_PROCESS|C_PTRACE },
+  { "core", c_core, C_FILELOADED },
+  { "coverage", c_coverage, C_FILELOADED|C_PTRACE },
   { "dbreak", c_dbreak, 0 },
+  { "dcheckpoint", c_dcheckpoint, 0 },
   { "delete", c_dbreak, C_ALIAS },
   { "detach", c_detach, C_PTRACE },
+  { "diff", c_diff, C_PROCESS_RUNNING },
   { "disable", c_disable, 0 },
-  { "disassemble", c_disassemble, C_FILELOADED },
+  { "disassemble", c_disassemble, C_FILELOADED|C_CORE },
   { "display", c_display, C_PROCESS },
-  { "dump", c_examine, C_ALIAS|C_PROCESS },
+  { "dump", c_examine, C_ALIAS|C_PROCESS|C_CORE },
   { "enable", c_enable, 0 },
   { "enter", c_enter, C_PROCESS },
-  { "examine", c_examine, C_PROCESS },
+  { "examine", c_examine, C_PROCESS|C_CORE },
   { "exit", c_quit, C_ALIAS },
   { "file", c_file, C_FILELOADED },
+  { "finish", c_finish, C_PROCESS_RUNNING|C_PTRACE },
+  { "ftrace", c_ftrace, C_PROCESS_RUNNING|C_PTRACE },
+  { "handle", c_handle, 0 },
   { "help", c_help, 0 },
   { "ignore", c_ignore, 0 },
   { "lbreak", c_lbreak, 0 },
+  { "lcheckpoint", c_lcheckpoint, 0 },
   { "ldisplay", c_ldisplay, C_PROCESS },
   { "load", c_load, 0 },
   { "next", c_next, C_PROCESS|C_PTRACE },
+  { "profile", c_profile, C_PROCESS_RUNNING|C_PTRACE },
   { "quit", c_quit, 0 },
-  { "register", c_register, C_PROCESS_RUNNING },
+  { "rcontinue", c_rcontinue, C_PROCESS_RUNNING|C_PTRACE },
+  { "register", c_register, C_PROCESS_RUNNING|C_CORE },
+  { "restart", c_restart, C_PROCESS|C_PTRACE },
+  { "rstep", c_rstep, C_PROCESS_RUNNING|C_PTRACE },
   { "run", c_run, C_PROCESS|C_PTRACE },
+  { "search", c_search, C_PROCESS_RUNNING },
   { "set", c_set, 0 },
+  { "snapshot", c_snapshot, 0 },
   { "step", c_step, C_PROCESS|C_PTRACE },
+  { "stepb", c_stepb, C_PROCESS|C_PTRACE },
   { "store", c_enter, C_ALIAS|C_PROCESS },
+  { "strings", c_strings, C_FILELOADED },
   { "tbreak", c_tbreak, C_PROCESS },
+  { "tdump", c_tdump, 0 },
+  { "trace", c_trace, C_PROCESS },
+  { "tsave", c_tsave, 0 },
+  { "tstatus", c_tstatus, 0 },
   { "undisplay", c_undisplay, C_PROCESS },
   { "unload", c_unload, C_FILELOADED },
+  { "until", c_until, C_PROCESS_RUNNING|C_PTRACE },
+  { "watch", c_watch, C_PROCESS|C_PTRACE },
+  { "xref", c_xref, C_FILELOADED },
 
   { 0, 0, 0 }
 };
@@ -239,11 +264,11 @@ Inputs: ws      - main workspace
         command - command
 
 Return: 1 upon success
-        0 upon error
+        0 upon error (or if the command failed)
         -1 upon fatal error
 */
 
-static int
+int
 ProcessCommand(struct aldWorkspace *ws, char *command)
 
 {
@@ -308,7 +333,8 @@ ProcessCommand(struct aldWorkspace *ws, char *command)
   }
 
   if ((cptr->flags & C_PROCESS_RUNNING) &&
-      !isRunningDebug(ws->debugWorkspace_p))
+      !isRunningDebug(ws->debugWorkspace_p) &&
+      !((cptr->flags & C_CORE) && awIsCoreLoaded(ws)))
   {
     /*
      * This command requires the process to be running, but it
@@ -319,6 +345,16 @@ ProcessCommand(struct aldWorkspace *ws, char *command)
     return (0);
   }
 
+  if ((cptr->flags & C_CORE) && useCore(ws))
+  {
+    /*
+     * The command will be answered from the core file - a process
+     * may have run since it was loaded, so make sure the register
+     * queries see the dumped registers again
+     */
+    selectCoreRegisters(ws);
+  }
+
   if (cptr->flags & C_PTRACE)
   {
     /*
@@ -369,7 +405,7 @@ ProcessCommand(struct aldWorkspace *ws, char *command)
   if (ret < 0)
     return (ret);
 
-  return (1);
+  return (ret ? 1 : 0);
 } /* ProcessCommand() */
 
 /*
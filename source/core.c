@@ -0,0 +1,275 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module lets a core file stand in for the debugged process.
+ * The core file is mapped read-only and memory queries are served
+ * straight out of the mapping: readCoreMemory() hands back a pointer
+ * into the PT_LOAD segment holding the address, so nothing is copied
+ * no matter how large the dump.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "core.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "signals.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+/*
+loadCore()
+  Map a core file of the loaded program, so its memory and registers
+can be examined while there is no process
+
+Inputs: ws       - ald workspace
+        filename - core file
+
+Return: 1 if successful
+        0 if not
+*/
+
+int
+loadCore(struct aldWorkspace *ws, char *filename)
+
+{
+  struct stat statbuf;
+  struct offParameters offParams;
+  struct aSignal *sptr;
+  char buffer[MAXLINE];
+  int fd;
+  int ret;
+
+  assert(filename != 0);
+
+  if (awIsCoreLoaded(ws))
+    unloadCore(ws);
+
+  if (!ws->coreWorkspace_p)
+  {
+    ws->coreWorkspace_p = initOFF();
+    if (!ws->coreWorkspace_p)
+      return (0);
+  }
+
+  if ((fd = open(filename, O_RDONLY)) == (-1))
+  {
+    Print(ws,
+          P_COMMAND,
+          "Unable to open %s: %s",
+          filename,
+          strerror(errno));
+    return (0);
+  }
+
+  if (fstat(fd, &statbuf) == (-1))
+  {
+    Print(ws,
+          P_COMMAND,
+          "stat() failed on %s: %s",
+          filename,
+          strerror(errno));
+    close(fd);
+    return (0);
+  }
+
+  ws->CoreSize = statbuf.st_size;
+
+  ws->CorePtr = mmap(0, ws->CoreSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (ws->CorePtr == MAP_FAILED)
+  {
+    Print(ws,
+          P_COMMAND,
+          "Unable to map memory for %s: %s",
+          filename,
+          strerror(errno));
+    ws->CorePtr = 0;
+    close(fd);
+    return (0);
+  }
+
+  ret = identifyOFF(ws->coreWorkspace_p,
+                    ws->CorePtr,
+                    ws->CoreSize,
+                    &offParams,
+                    buffer);
+
+  if ((ret != OFF_TYPE_ELF) || !isCoreOFF(ws->coreWorkspace_p))
+  {
+    if (ret < 0)
+      Print(ws, P_ERROR, "%s", buffer);
+
+    Print(ws, P_COMMAND, "%s: not a core file", filename);
+
+    munmap(ws->CorePtr, ws->CoreSize);
+    ws->CorePtr = 0;
+    close(fd);
+    return (0);
+  }
+
+  Print(ws,
+        P_COMMAND,
+        "%s: %s",
+        filename,
+        buffer);
+
+  ws->coreFileName = Strdup(filename);
+  ws->coreFileDescriptor = fd;
+  ws->coreSignal = 0;
+
+  awSetCoreLoaded(ws);
+
+  if (!selectCoreRegisters(ws))
+  {
+    Print(ws,
+          P_COMMAND,
+          "%s: no usable register information",
+          filename);
+    return (1);
+  }
+
+  sptr = GetSignal(ws->coreSignal);
+  if (sptr && ws->coreSignal)
+    Print(ws, P_COMMAND, MSG_PROGTERMSIG, sptr->name, sptr->desc);
+  else
+    Print(ws, P_COMMAND, MSG_PROGTERMUNKNOWNSIG, ws->coreSignal);
+
+  Print(ws,
+        P_COMMAND,
+        "Location: 0x%08lX",
+        getAddressDebug(ws->debugWorkspace_p));
+
+  return (1);
+} /* loadCore() */
+
+/*
+unloadCore()
+  Unmap the current core file
+
+Inputs: ws - ald workspace
+*/
+
+void
+unloadCore(struct aldWorkspace *ws)
+
+{
+  assert(ws->CorePtr != 0);
+
+  if (munmap(ws->CorePtr, ws->CoreSize) == (-1))
+  {
+    Print(ws,
+          P_COMMAND,
+          "Error unloading core file %s: %s",
+          ws->coreFileName,
+          strerror(errno));
+  }
+
+  close(ws->coreFileDescriptor);
+  ws->coreFileDescriptor = (-1);
+
+  if (ws->coreFileName)
+    free(ws->coreFileName);
+
+  ws->coreFileName = 0;
+  ws->CorePtr = 0;
+  ws->CoreSize = 0;
+
+  awClearCoreLoaded(ws);
+} /* unloadCore() */
+
+/*
+selectCoreRegisters()
+  Make the registers saved in the core file the ones returned by
+register queries. This needs to be redone whenever a process has
+run since the core file was loaded.
+
+Inputs: ws - ald workspace
+
+Return: 1 if successful
+        0 if the core file has no usable registers
+*/
+
+int
+selectCoreRegisters(struct aldWorkspace *ws)
+
+{
+  void *prstatus,
+       *fpregs;
+  size_t size,
+         fpsize;
+
+  prstatus = findNoteOFF(ws->coreWorkspace_p, NT_PRSTATUS, &size);
+  if (!prstatus)
+    return (0);
+
+  fpsize = 0;
+  fpregs = findNoteOFF(ws->coreWorkspace_p, NT_PRFPREG, &fpsize);
+
+  return (loadCoreRegistersDebug(ws->debugWorkspace_p,
+                                 prstatus,
+                                 size,
+                                 fpregs,
+                                 fpsize,
+                                 &(ws->coreSignal)));
+} /* selectCoreRegisters() */
+
+/*
+readCoreMemory()
+  Locate memory of the dumped process. The core file is searched
+first; memory it does not contain (such as program text, which is
+usually not dumped) is taken from the loaded file.
+
+Inputs: ws      - ald workspace
+        address - address to read
+        len     - number of bytes wanted
+        ptr     - where to store pointer to the memory
+
+Return: number of bytes available at ptr (at most len) - this is
+        less than len if the range crosses the end of a segment
+        0 if the address is not in the core or program file (errno
+        is set)
+*/
+
+long
+readCoreMemory(struct aldWorkspace *ws, unsigned long address,
+               unsigned long len, unsigned char **ptr)
+
+{
+  long cnt;
+
+  cnt = findMemoryOFF(ws->coreWorkspace_p, (unsigned int) address, ptr);
+  if (!cnt && awIsFileLoaded(ws))
+    cnt = findMemoryOFF(ws->offWorkspace_p, (unsigned int) address, ptr);
+
+  if ((unsigned long) cnt > len)
+    cnt = (long) len;
+
+  if ((unsigned long) cnt < len)
+    errno = EFAULT;
+
+  return (cnt);
+} /* readCoreMemory() */
@@ -25,6 +25,7 @@
 #include "display.h"
 #include "main.h"
 #include "list.h"
+#include "memory.h"
 #include "msg.h"
 #include "registers.h"
 
@@ -50,7 +51,11 @@ addStepDisplay(struct aldWorkspace *ws, unsigned long startaddr,
 {
   struct stepDisplay *ptr;
 
-  ptr = (struct stepDisplay *) malloc(sizeof(struct stepDisplay));
+  /*
+   * Allocate room for the previous contents of the range right
+   * behind the structure, so freeing the node frees both
+   */
+  ptr = (struct stepDisplay *) malloc(sizeof(struct stepDisplay) + numbytes);
   if (!ptr)
   {
     fprintf(stderr, "addStepDisplay: malloc failed: %s\n",
@@ -65,6 +70,8 @@ addStepDisplay(struct aldWorkspace *ws, unsigned long startaddr,
   ptr->elsize = elsize;
   ptr->output = output;
   ptr->number = ++(ws->stepDisplayNum);
+  ptr->prev = (unsigned char *) (ptr + 1);
+  ptr->prevbytes = 0;
 
   /*
    * Insert into linked list of things to display after
@@ -80,7 +87,9 @@ addStepDisplay(struct aldWorkspace *ws, unsigned long startaddr,
 doStepDisplay()
   Called after each single step or when the program stops execution
 in order to display relevant registers, memory, next disassembled
-instruction, etc.
+instruction, etc. Depending on "set step-display-mode", either
+everything, only what changed since the last display, or only the
+next instruction is output.
 
 Inputs: ws - main workspace
 
@@ -95,11 +104,23 @@ doStepDisplay(struct aldWorkspace *ws)
   struct genericList *ptr;
   unsigned char *membuf;
   long ndumped;
+  int changed;
+
+  if (ws->stepDisplayMode == STEPDISP_NONE)
+  {
+    DisplayNextInstruction(ws);
+    return;
+  }
+
+  changed = (ws->stepDisplayMode == STEPDISP_CHANGED);
 
   /*
    * Display register list
    */
-  displayRegisters(ws, NOREG, 1, ws->stepDisplayFlags);
+  if (changed)
+    displayChangedRegisters(ws, ws->stepDisplayFlags);
+  else
+    displayRegisters(ws, NOREG, 1, ws->stepDisplayFlags);
 
   /*
    * Display memory locations
@@ -117,14 +138,34 @@ doStepDisplay(struct aldWorkspace *ws)
 
     if (ndumped > 0)
     {
-      OutputMemory(ws,
-                   membuf,
-                   sptr->startaddr,
-                   ndumped,
-                   sptr->elsize,
-                   sptr->output);
+      if (changed && (sptr->prevbytes > 0))
+      {
+        OutputChangedMemory(ws,
+                            membuf,
+                            sptr->prev,
+                            sptr->prevbytes,
+                            sptr->startaddr,
+                            ndumped,
+                            sptr->elsize,
+                            sptr->output);
+      }
+      else
+      {
+        OutputMemory(ws,
+                     membuf,
+                     sptr->startaddr,
+                     ndumped,
+                     sptr->elsize,
+                     sptr->output);
+      }
+
+      memcpy(sptr->prev, membuf, (size_t) ndumped);
+      sptr->prevbytes = ndumped;
+
       free(membuf);
     }
+    else
+      sptr->prevbytes = 0;
 
     if (ndumped < sptr->numbytes)
     {
@@ -141,6 +182,33 @@ doStepDisplay(struct aldWorkspace *ws)
   DisplayNextInstruction(ws);
 } /* doStepDisplay() */
 
+/*
+resetStepDisplay()
+  Forget the registers and memory recorded by previous step displays,
+so the next "changed" display shows everything
+
+Inputs: ws - main workspace
+
+Return: none
+*/
+
+void
+resetStepDisplay(struct aldWorkspace *ws)
+
+{
+  struct genericList *ptr;
+  int ii;
+
+  if (ws->stepRegisters)
+  {
+    for (ii = 0; ii < SNAP_CLASSES; ++ii)
+      ws->stepRegisters->valid[ii] = 0;
+  }
+
+  for (ptr = ws->stepDisplayList; ptr; ptr = ptr->next)
+    ((struct stepDisplay *) ptr->ptr)->prevbytes = 0;
+} /* resetStepDisplay() */
+
 struct genericList *
 findStepDisplayByNumber(struct aldWorkspace *ws, unsigned int num)
 
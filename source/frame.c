@@ -0,0 +1,219 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+
+#include "frame.h"
+#include "main.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * Opcodes recognized when locating the return address
+ */
+#define OP_PUSHEBP     0x55   /* push ebp */
+#define OP_RET         0xC3   /* ret */
+#define OP_RETIMM      0xC2   /* ret imm16 */
+#define OP_MOVRM       0x89   /* mov r/m32, r32 */
+#define OP_MOVR        0x8B   /* mov r32, r/m32 */
+#define MODRM_EBPESP   0xE5   /* modrm for mov ebp, esp (0x89) */
+#define MODRM_EBPESP2  0xEC   /* modrm for mov ebp, esp (0x8B) */
+
+static int readRegister(struct aldWorkspace *ws, char *name,
+                        unsigned long *value);
+static int readLong(struct aldWorkspace *ws, unsigned long address,
+                    unsigned long *value);
+
+/*
+readRegister()
+  Read an integer register of the debugged process by name
+
+Inputs: ws    - ald workspace
+        name  - register name
+        value - modified to contain register contents
+
+Return: 1 if successful
+        0 if not
+*/
+
+static int
+readRegister(struct aldWorkspace *ws, char *name, unsigned long *value)
+
+{
+  int regindex;
+
+  regindex = findRegisterDebug(ws->debugWorkspace_p, name);
+  if (regindex < 0)
+    return (0);
+
+  *value = (unsigned long) readRegisterDebug(ws->debugWorkspace_p, regindex);
+
+  return (1);
+} /* readRegister() */
+
+/*
+readLong()
+  Read a 32 bit little endian word from the debugged process
+
+Inputs: ws      - ald workspace
+        address - address to read
+        value   - modified to contain the word
+
+Return: 1 if successful
+        0 if the memory could not be read
+*/
+
+static int
+readLong(struct aldWorkspace *ws, unsigned long address, unsigned long *value)
+
+{
+  unsigned char *buf;
+  long ndumped;
+
+  buf = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p, &buf, address, 4);
+
+  if (ndumped == 4)
+  {
+    *value = (unsigned long) buf[0] |
+             ((unsigned long) buf[1] << 8) |
+             ((unsigned long) buf[2] << 16) |
+             ((unsigned long) buf[3] << 24);
+  }
+
+  if (buf)
+    free(buf);
+
+  return (ndumped == 4);
+} /* readLong() */
+
+/*
+readStackPointer()
+  Return the current stack pointer of the debugged process
+*/
+
+unsigned long
+readStackPointer(struct aldWorkspace *ws)
+
+{
+  unsigned long esp;
+
+  if (!readRegister(ws, "esp", &esp))
+    return (0);
+
+  return (esp);
+} /* readStackPointer() */
+
+/*
+getReturnAddress()
+  Determine where the current function will return to. We do not
+have any unwind information, so the conventional ebp frame layout
+is assumed:
+
+  o At the first instruction of a function, on a "push ebp" or
+    on a "ret", the return address is at [esp]
+  o On the "mov ebp, esp" following "push ebp", it is at [esp + 4]
+  o Anywhere else in the function body, it is at [ebp + 4]
+
+Inputs: ws      - ald workspace
+        retaddr - modified to contain the return address
+        frame   - modified to contain the value of the stack pointer
+                  once the function has returned, so callers can tell
+                  this invocation apart from deeper (recursive) ones
+
+Return: 1 if successful
+        0 if the stack could not be read
+*/
+
+int
+getReturnAddress(struct aldWorkspace *ws, unsigned long *retaddr,
+                 unsigned long *frame)
+
+{
+  unsigned long eip,
+                esp,
+                ebp,
+                slot;  /* address of the return address */
+  unsigned char *code;
+  long ndumped;
+  struct offSymbolInfo symInfo;
+
+  if (!readRegister(ws, "esp", &esp) || !readRegister(ws, "ebp", &ebp))
+    return (0);
+
+  eip = getAddressDebug(ws->debugWorkspace_p);
+
+  code = 0;
+  ndumped = dumpMemoryDebug(ws->debugWorkspace_p, &code, eip, 2);
+  if (ndumped < 2)
+  {
+    if (code)
+      free(code);
+
+    return (0);
+  }
+
+  if ((code[0] == OP_PUSHEBP) ||
+      (code[0] == OP_RET) ||
+      (code[0] == OP_RETIMM) ||
+      (findSymbolOFF(ws->offWorkspace_p, 0, eip, &symInfo) &&
+       (symInfo.offset == 0)))
+    slot = esp;
+  else if (((code[0] == OP_MOVRM) && (code[1] == MODRM_EBPESP)) ||
+           ((code[0] == OP_MOVR) && (code[1] == MODRM_EBPESP2)))
+    slot = esp + 4;
+  else
+    slot = ebp + 4;
+
+  free(code);
+
+  if (!readLong(ws, slot, retaddr))
+    return (0);
+
+  *frame = slot + 4;
+
+  return (1);
+} /* getReturnAddress() */
+
+/*
+resolveAddress()
+  Convert a command argument to an address - it may be a number
+or the name of a debugging symbol
+
+Inputs: ws      - ald workspace
+        str     - argument
+        address - modified to contain the address
+
+Return: 1 if successful
+        0 if str is neither a number nor a known symbol
+*/
+
+int
+resolveAddress(struct aldWorkspace *ws, char *str, unsigned long *address)
+
+{
+  char *endptr;
+  struct offSymbolInfo symInfo;
+
+  *address = strtoul(str, &endptr, 0);
+  if ((endptr != str) && (*endptr == '\0'))
+    return (1);
+
+  if (!findSymbolOFF(ws->offWorkspace_p, str, 0, &symInfo))
+    return (0);
+
+  *address = symInfo.address;
+
+  return (1);
+} /* resolveAddress() */
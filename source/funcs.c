@@ -0,0 +1,831 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module recovers the functions of a file which has no symbols.
+ * Function starts are taken from the entry point, the targets of
+ * relative calls, the address ranges of the .eh_frame unwind table and
+ * the usual "push ebp; mov ebp, esp" prologue. Each function then runs
+ * up to the next start, unless .eh_frame gives its size. The result is
+ * handed to libOFF as synthetic "sub_XXXXXXXX" symbols.
+ *
+ * Every executable byte is decoded once and the starts are kept in a
+ * bitmap, so the time taken grows linearly with the size of the code.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "defs.h"
+#include "funcs.h"
+#include "insnindex.h"
+#include "main.h"
+#include "print.h"
+#include "xref.h"
+
+#include "libDASM.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+#define OP_CALLREL      0xE8   /* call rel32 */
+#define OP_PUSHEBP      0x55   /* push ebp */
+
+/*
+ * Pointer encodings used in .eh_frame (DW_EH_PE_xxx)
+ */
+#define EH_PE_OMIT      0xFF
+#define EH_PE_FORMAT    0x0F   /* mask: format of value */
+#define EH_PE_ABSPTR    0x00
+#define EH_PE_ULEB128   0x01
+#define EH_PE_UDATA2    0x02
+#define EH_PE_UDATA4    0x03
+#define EH_PE_UDATA8    0x04
+#define EH_PE_SLEB128   0x09
+#define EH_PE_SDATA2    0x0A
+#define EH_PE_SDATA4    0x0B
+#define EH_PE_SDATA8    0x0C
+#define EH_PE_APPLY     0x70   /* mask: how value is applied */
+#define EH_PE_PCREL     0x10
+#define EH_PE_INDIRECT  0x80
+
+/*
+ * An executable section being analyzed
+ */
+struct funcSection
+{
+  unsigned long address;             /* section address */
+  unsigned long size;                /* section size */
+  unsigned char *starts;             /* bit set at each function start */
+};
+
+/*
+ * A function range from .eh_frame
+ */
+struct funcRange
+{
+  unsigned long address;
+  unsigned long size;
+};
+
+struct funcBuild
+{
+  struct aldWorkspace *ws;
+
+  struct funcSection *sections;
+  int nsections;
+  int maxsections;
+
+  struct funcRange *ranges;
+  long nranges;
+  long maxranges;
+
+  int failed;                        /* malloc failed */
+};
+
+static void callbackFuncSection(void *args, struct offSectionInfo *secinfo,
+                                int exec);
+static void markStart(struct funcBuild *build, unsigned long address);
+static void sweepSection(struct funcBuild *build, struct funcSection *sec);
+static void readEhFrame(struct funcBuild *build);
+static int parseCIE(unsigned char *cie, unsigned char *end,
+                    unsigned char *encoding);
+static int readEncoded(unsigned char **ptr, unsigned char *end,
+                       unsigned char encoding, unsigned long pcaddr,
+                       unsigned long *value);
+static unsigned long readULEB(unsigned char **ptr, unsigned char *end);
+static unsigned long read32(unsigned char *ptr);
+static int compareFuncSection(const void *a, const void *b);
+static int compareFuncRange(const void *a, const void *b);
+
+/*
+recoverFunctions()
+  Find the functions of the loaded file and supply them to libOFF
+as synthetic symbols. Call this when the file has no symbols.
+
+Inputs: ws - ald workspace
+
+Return: number of functions found
+*/
+
+unsigned long
+recoverFunctions(struct aldWorkspace *ws)
+
+{
+  struct funcBuild build;
+  struct funcSection *sec;
+  struct offSyntheticSymbol *syms;
+  unsigned long count,
+                offset,
+                ii;
+  long rr;
+  int jj;
+
+  memset(&build, '\0', sizeof(build));
+  build.ws = ws;
+
+  traverseSectionsOFF(ws->offWorkspace_p, callbackFuncSection, &build);
+
+  syms = 0;
+  count = 0;
+
+  if (build.nsections && !build.failed)
+  {
+    qsort(build.sections,
+          build.nsections,
+          sizeof(struct funcSection),
+          compareFuncSection);
+
+    markStart(&build, ws->virtualEntryPoint);
+
+    readEhFrame(&build);
+
+    for (jj = 0; jj < build.nsections; ++jj)
+      sweepSection(&build, build.sections + jj);
+
+    for (jj = 0; jj < build.nsections; ++jj)
+    {
+      sec = build.sections + jj;
+      for (offset = 0; offset < sec->size; ++offset)
+      {
+        if (sec->starts[offset >> 3] & (1 << (offset & 7)))
+          ++count;
+      }
+    }
+  }
+
+  if (count && !build.failed)
+  {
+    syms = (struct offSyntheticSymbol *)
+           malloc(sizeof(struct offSyntheticSymbol) * count);
+    if (!syms)
+      build.failed = 1;
+  }
+
+  if (build.failed)
+  {
+    Print(ws, P_ERROR, "recoverFunctions: malloc failed: %s", strerror(errno));
+    count = 0;
+  }
+  else if (count)
+  {
+    if (build.nranges)
+    {
+      qsort(build.ranges,
+            build.nranges,
+            sizeof(struct funcRange),
+            compareFuncRange);
+    }
+
+    /*
+     * Sections are sorted, so the functions come out in order
+     */
+    ii = 0;
+    rr = 0;
+    for (jj = 0; jj < build.nsections; ++jj)
+    {
+      sec = build.sections + jj;
+      for (offset = 0; offset < sec->size; ++offset)
+      {
+        if (!(sec->starts[offset >> 3] & (1 << (offset & 7))))
+          continue;
+
+        Snprintf(syms[ii].name,
+                 OFF_SYNTHNAMELEN,
+                 "%s%08lX",
+                 FUNC_PREFIX,
+                 sec->address + offset);
+        syms[ii].address = sec->address + offset;
+
+        /*
+         * Until the end of the section - shortened below if another
+         * function follows
+         */
+        syms[ii].size = sec->size - offset;
+
+        if (ii && (syms[ii - 1].address + syms[ii - 1].size > syms[ii].address))
+          syms[ii - 1].size = syms[ii].address - syms[ii - 1].address;
+
+        ++ii;
+      }
+    }
+
+    /*
+     * .eh_frame knows the real extent of a function, which leaves out
+     * any padding before the next one
+     */
+    for (ii = 0; ii < count; ++ii)
+    {
+      while ((rr < build.nranges) && (build.ranges[rr].address < syms[ii].address))
+        ++rr;
+
+      if ((rr < build.nranges) && (build.ranges[rr].address == syms[ii].address))
+        syms[ii].size = build.ranges[rr].size;
+    }
+
+    setSyntheticSymbolsOFF(ws->offWorkspace_p, syms, count);
+
+    /*
+     * These were anchored on the symbols we had before
+     */
+    freeXrefIndex(ws);
+    freeInsnIndex(ws);
+  }
+
+  for (jj = 0; jj < build.nsections; ++jj)
+    free(build.sections[jj].starts);
+
+  if (build.sections)
+    free(build.sections);
+
+  if (build.ranges)
+    free(build.ranges);
+
+  return (count);
+} /* recoverFunctions() */
+
+/*
+callbackFuncSection()
+  Called by traverseSectionsOFF() - remember executable sections
+which lie within the mapped file
+*/
+
+static void
+callbackFuncSection(void *args, struct offSectionInfo *secinfo, int exec)
+
+{
+  struct funcBuild *build;
+  struct funcSection *sec;
+  struct aldWorkspace *ws;
+
+  build = (struct funcBuild *) args;
+  ws = build->ws;
+
+  if (!exec || !secinfo->size || build->failed)
+    return;
+
+  if ((secinfo->address < ws->virtualFileAddress) ||
+      ((secinfo->address - ws->virtualFileAddress) + secinfo->size >
+       ws->MappedSize))
+    return;
+
+  if (build->nsections == build->maxsections)
+  {
+    build->maxsections += 8;
+    sec = (struct funcSection *)
+          realloc(build->sections,
+                  sizeof(struct funcSection) * build->maxsections);
+    if (!sec)
+    {
+      build->failed = 1;
+      return;
+    }
+
+    build->sections = sec;
+  }
+
+  sec = build->sections + build->nsections;
+
+  sec->address = secinfo->address;
+  sec->size = secinfo->size;
+  sec->starts = (unsigned char *) calloc((secinfo->size + 7) / 8, 1);
+  if (!sec->starts)
+  {
+    build->failed = 1;
+    return;
+  }
+
+  ++(build->nsections);
+} /* callbackFuncSection() */
+
+/*
+markStart()
+  Record a function start, if it lies in one of our sections
+
+Inputs: build   - analysis state
+        address - function address
+*/
+
+static void
+markStart(struct funcBuild *build, unsigned long address)
+
+{
+  struct funcSection *sec;
+  unsigned long offset;
+  int low,
+      high,
+      mid;
+
+  low = 0;
+  high = build->nsections - 1;
+
+  while (low <= high)
+  {
+    mid = (low + high) / 2;
+    sec = build->sections + mid;
+
+    if (address < sec->address)
+      high = mid - 1;
+    else if (address >= sec->address + sec->size)
+      low = mid + 1;
+    else
+    {
+      offset = address - sec->address;
+      sec->starts[offset >> 3] |= 1 << (offset & 7);
+      return;
+    }
+  }
+} /* markStart() */
+
+/*
+sweepSection()
+  Decode a section from start to end, marking the targets of
+relative calls and every instruction which begins with the standard
+frame setup "push ebp; mov ebp, esp"
+
+Inputs: build - analysis state
+        sec   - section to sweep
+*/
+
+static void
+sweepSection(struct funcBuild *build, struct funcSection *sec)
+
+{
+  struct aldWorkspace *ws;
+  unsigned char *code,
+                *ptr;
+  unsigned char spill[MAX_OPCODE_LEN + 1];
+  char buffer[MAXLINE];
+  unsigned long offset;
+  unsigned int target;
+  long len,
+       ii;
+
+  ws = build->ws;
+  code = (unsigned char *) ws->MapPtr + (sec->address - ws->virtualFileAddress);
+
+  offset = 0;
+  while (offset < sec->size)
+  {
+    if ((offset + MAX_OPCODE_LEN) >= sec->size)
+    {
+      memset((void *) spill, 0, sizeof(spill));
+      memcpy(spill, code + offset, sec->size - offset);
+      ptr = spill;
+    }
+    else
+      ptr = code + offset;
+
+    /*
+     * push ebp; mov ebp, esp (either encoding of the mov)
+     */
+    if ((ptr[0] == OP_PUSHEBP) &&
+        (((ptr[1] == 0x89) && (ptr[2] == 0xE5)) ||
+         ((ptr[1] == 0x8B) && (ptr[2] == 0xEC))))
+      sec->starts[offset >> 3] |= 1 << (offset & 7);
+
+    len = procDisasm(ws->disasmWorkspace_p,
+                     ptr,
+                     buffer,
+                     (unsigned int) (sec->address + offset));
+    if (len <= 0)
+    {
+      ++offset;
+      continue;
+    }
+
+    target = ws->disasmWorkspace_p->effectiveAddress;
+    if (target)
+    {
+      ii = 0;
+      while ((ii < len - 1) &&
+             ((ptr[ii] == 0x2E) || (ptr[ii] == 0x3E) || (ptr[ii] == 0x66) ||
+              (ptr[ii] == 0x67) || (ptr[ii] == 0xF2) || (ptr[ii] == 0xF3)))
+        ++ii;
+
+      if (ptr[ii] == OP_CALLREL)
+        markStart(build, (unsigned long) target);
+    }
+
+    offset += len;
+  }
+} /* sweepSection() */
+
+/*
+readEhFrame()
+  Mark the start of every function described by a Frame Description
+Entry (FDE) of the .eh_frame section, and remember its size
+*/
+
+static void
+readEhFrame(struct funcBuild *build)
+
+{
+  struct aldWorkspace *ws;
+  struct offSectionInfo secInfo;
+  struct funcRange *range;
+  unsigned char *base,
+                *end,
+                *ptr,
+                *rec,
+                *next;
+  unsigned char encoding;
+  unsigned long len,
+                id,
+                start,
+                size;
+
+  ws = build->ws;
+
+  if (!findSectionOFF(ws->offWorkspace_p, ".eh_frame", 0, &secInfo))
+    return;
+
+  if ((secInfo.address < ws->virtualFileAddress) ||
+      ((secInfo.address - ws->virtualFileAddress) + secInfo.size >
+       ws->MappedSize))
+    return;
+
+  base = (unsigned char *) ws->MapPtr + (secInfo.address - ws->virtualFileAddress);
+  end = base + secInfo.size;
+
+  ptr = base;
+  while (ptr + 8 <= end)
+  {
+    len = read32(ptr);
+    if ((len == 0) || (len == 0xFFFFFFFFUL))
+      break; /* terminator, or a 64 bit record */
+
+    rec = ptr + 4;
+    if ((len < 4) || (len > (unsigned long) (end - rec)))
+      break;
+
+    next = rec + len;
+    id = read32(rec);
+
+    /*
+     * A CIE has an id of 0; an FDE stores the distance back to
+     * its CIE
+     */
+    if (id && (id <= (unsigned long) (rec - base)) &&
+        parseCIE(rec - id, end, &encoding))
+    {
+      ptr = rec + 4;
+      if (readEncoded(&ptr,
+                      next,
+                      encoding,
+                      secInfo.address + (ptr - base),
+                      &start) &&
+          readEncoded(&ptr,
+                      next,
+                      encoding & EH_PE_FORMAT,
+                      0,
+                      &size) &&
+          size)
+      {
+        markStart(build, start);
+
+        if (build->nranges == build->maxranges)
+        {
+          build->maxranges = build->maxranges ? build->maxranges * 2 : 256;
+          range = (struct funcRange *)
+                  realloc(build->ranges,
+                          sizeof(struct funcRange) * build->maxranges);
+          if (!range)
+          {
+            build->failed = 1;
+            return;
+          }
+
+          build->ranges = range;
+        }
+
+        build->ranges[build->nranges].address = start;
+        build->ranges[build->nranges].size = size;
+        ++(build->nranges);
+      }
+    }
+
+    ptr = next;
+  }
+} /* readEhFrame() */
+
+/*
+parseCIE()
+  Find the pointer encoding used by the FDEs of a Common Information
+Entry (CIE)
+
+Inputs: cie      - start of CIE (its length field)
+        end      - end of .eh_frame
+        encoding - modified to contain the encoding
+
+Return: 1 if successful
+        0 if the CIE cannot be understood
+*/
+
+static int
+parseCIE(unsigned char *cie, unsigned char *end, unsigned char *encoding)
+
+{
+  unsigned char *ptr,
+                *aug,
+                *cieend;
+  unsigned char version,
+                penc;
+  unsigned long len,
+                dummy;
+
+  if (cie + 9 > end)
+    return (0);
+
+  len = read32(cie);
+  if ((len < 5) || (len > (unsigned long) (end - cie - 4)) || read32(cie + 4))
+    return (0);
+
+  cieend = cie + 4 + len;
+  version = cie[8];
+
+  aug = cie + 9;
+  for (ptr = aug; (ptr < cieend) && *ptr; ++ptr)
+    ;
+
+  if (ptr >= cieend)
+    return (0);
+
+  ++ptr;
+
+  readULEB(&ptr, cieend);            /* code alignment */
+  readULEB(&ptr, cieend);            /* data alignment (signed) */
+
+  if (version == 1)
+    ++ptr;                           /* return address register */
+  else
+    readULEB(&ptr, cieend);
+
+  *encoding = EH_PE_ABSPTR;
+
+  if (*aug == '\0')
+    return (1);
+
+  if (*aug != 'z')
+    return (0);
+
+  readULEB(&ptr, cieend);            /* augmentation data length */
+
+  for (++aug; *aug; ++aug)
+  {
+    if (ptr >= cieend)
+      return (0);
+
+    switch (*aug)
+    {
+      case 'R':
+      {
+        *encoding = *ptr;
+        return (1);
+      }
+
+      case 'P':
+      {
+        penc = *ptr++;
+        if (!readEncoded(&ptr, cieend, penc & ~EH_PE_INDIRECT, 0, &dummy))
+          return (0);
+
+        break;
+      }
+
+      case 'L':
+      {
+        ++ptr;
+        break;
+      }
+
+      case 'S':
+      case 'B':
+      {
+        break;
+      }
+
+      default:
+      {
+        return (0);
+      }
+    }
+  }
+
+  return (1);
+} /* parseCIE() */
+
+/*
+readEncoded()
+  Read a pointer stored in one of the .eh_frame encodings. Only
+absolute and pc-relative values are understood, which is what i386
+compilers produce.
+
+Inputs: ptr      - position of value, advanced past it
+        end      - end of the record
+        encoding - EH_PE_xxx
+        pcaddr   - address of the value, for pc-relative values
+        value    - where to store the value
+
+Return: 1 if successful
+        0 if the encoding is not understood
+*/
+
+static int
+readEncoded(unsigned char **ptr, unsigned char *end, unsigned char encoding,
+            unsigned long pcaddr, unsigned long *value)
+
+{
+  unsigned char *p;
+  unsigned long val;
+
+  if ((encoding == EH_PE_OMIT) || (encoding & EH_PE_INDIRECT))
+    return (0);
+
+  p = *ptr;
+
+  switch (encoding & EH_PE_FORMAT)
+  {
+    case EH_PE_ABSPTR:
+    case EH_PE_UDATA4:
+    case EH_PE_SDATA4:
+    {
+      if (p + 4 > end)
+        return (0);
+
+      val = read32(p);
+      p += 4;
+      break;
+    }
+
+    case EH_PE_UDATA8:
+    case EH_PE_SDATA8:
+    {
+      if (p + 8 > end)
+        return (0);
+
+      val = read32(p);
+      p += 8;
+      break;
+    }
+
+    case EH_PE_UDATA2:
+    case EH_PE_SDATA2:
+    {
+      if (p + 2 > end)
+        return (0);
+
+      val = (unsigned long) p[0] | ((unsigned long) p[1] << 8);
+      if (((encoding & EH_PE_FORMAT) == EH_PE_SDATA2) && (val & 0x8000))
+        val |= 0xFFFF0000UL;
+
+      p += 2;
+      break;
+    }
+
+    case EH_PE_ULEB128:
+    case EH_PE_SLEB128:
+    {
+      val = readULEB(&p, end);
+      break;
+    }
+
+    default:
+    {
+      return (0);
+    }
+  }
+
+  switch (encoding & EH_PE_APPLY)
+  {
+    case 0:
+    {
+      break;
+    }
+
+    case EH_PE_PCREL:
+    {
+      val += pcaddr;
+      break;
+    }
+
+    default:
+    {
+      return (0);
+    }
+  }
+
+  *ptr = p;
+  *value = val & 0xFFFFFFFFUL;
+
+  return (1);
+} /* readEncoded() */
+
+/*
+readULEB()
+  Read an unsigned LEB128 number (signed numbers are read the same
+way when only their length matters)
+*/
+
+static unsigned long
+readULEB(unsigned char **ptr, unsigned char *end)
+
+{
+  unsigned char *p;
+  unsigned long val;
+  int shift;
+
+  val = 0;
+  shift = 0;
+
+  for (p = *ptr; p < end; ++p)
+  {
+    if (shift < 32)
+      val |= (unsigned long) (*p & 0x7F) << shift;
+
+    shift += 7;
+
+    if (!(*p & 0x80))
+    {
+      ++p;
+      break;
+    }
+  }
+
+  *ptr = p;
+
+  return (val);
+} /* readULEB() */
+
+/*
+read32()
+  Read a little endian 32 bit value
+*/
+
+static unsigned long
+read32(unsigned char *ptr)
+
+{
+  return ((unsigned long) ptr[0] |
+          ((unsigned long) ptr[1] << 8) |
+          ((unsigned long) ptr[2] << 16) |
+          ((unsigned long) ptr[3] << 24));
+} /* read32() */
+
+/*
+compareFuncSection()
+  qsort() comparison - order sections by address
+*/
+
+static int
+compareFuncSection(const void *a, const void *b)
+
+{
+  const struct funcSection *sa,
+                           *sb;
+
+  sa = (const struct funcSection *) a;
+  sb = (const struct funcSection *) b;
+
+  if (sa->address < sb->address)
+    return (-1);
+  else if (sa->address > sb->address)
+    return (1);
+
+  return (0);
+} /* compareFuncSection() */
+
+/*
+compareFuncRange()
+  qsort() comparison - order ranges by address
+*/
+
+static int
+compareFuncRange(const void *a, const void *b)
+
+{
+  const struct funcRange *ra,
+                         *rb;
+
+  ra = (const struct funcRange *) a;
+  rb = (const struct funcRange *) b;
+
+  if (ra->address < rb->address)
+    return (-1);
+  else if (ra->address > rb->address)
+    return (1);
+
+  return (0);
+} /* compareFuncRange() */
@@ -31,6 +31,19 @@ static void PrintHelpCommand(struct aldWorkspace *ws, struct HelpCmd *hptr);
 static void PrintHelpCommands(struct aldWorkspace *ws, struct HelpCmd *array);
 
 static struct HelpCmd GeneralHelp[] = {
+  {
+    "advance",
+    "Continue execution until an address is reached",
+    "<address | symbol>\n\
+\n\
+<address | symbol> - location to run to\n\
+\n\
+ A temporary breakpoint is placed at the location, and another at the\n\
+return address of the current function, and the program continues at\n\
+full speed until one of them is reached (or a breakpoint is hit).\n\
+\n\
+See also: finish, until",
+  },
   {
     "attach",
     "Attach to a running process",
@@ -44,6 +57,41 @@ static struct HelpCmd GeneralHelp[] = {
     "\n\
 \n\
 Alias: c",
+  },
+  {
+    "core",
+    "Examine a core file of the loaded program",
+    "<filename | -unload>\n\
+\n\
+<filename> - core file dumped by the program loaded with \"load\"\n\
+-unload    - forget the current core file\n\
+\n\
+ While no process is running, \"register\", \"examine\" and \"disassemble\"\n\
+show the registers and memory of the dumped process. Memory is read\n\
+directly from the mapped core file; memory which is not in the core\n\
+file, such as program text, is taken from the loaded program.\n\
+ Starting the program does not unload the core file - it is used again\n\
+once the process has exited. With no arguments, the name of the current\n\
+core file is shown.",
+  },
+  {
+    "coverage",
+    "Record which basic blocks of the program are executed",
+    "<start [section | function] | report | stop>\n\
+\n\
+start  - find the basic blocks of a section or function (default:\n\
+         .text) and start recording\n\
+report - show the blocks executed so far\n\
+stop   - show the report and stop recording\n\
+\n\
+ A one-shot breakpoint is placed at the start of every basic block. It\n\
+is removed the first time the block runs, so each block costs at most\n\
+one trap and the program otherwise runs at full speed. The report lists\n\
+each function with the number of its blocks executed, followed by a\n\
+bitmap of its blocks ('#' executed, '.' not). It is also shown when the\n\
+program exits.\n\
+ Blocks are found by disassembling from the start of the range, so data\n\
+embedded in the code may be mistaken for instructions.",
   },
   {
     "detach",
@@ -51,16 +99,34 @@ Alias: c",
     "\n\
 \n\
   Detaches the debugger from the current process (see help attach)",
+  },
+  {
+    "diff",
+    "Show memory which has changed since a snapshot was taken",
+    "<name> [-update]\n\
+\n\
+<name>    - snapshot name (see help snapshot)\n\
+[-update] - retake the snapshot afterwards, so the next diff shows\n\
+            only newer changes\n\
+\n\
+ Each run of changed bytes is shown with its address, the nearest\n\
+symbol and the old and new contents. Unchanged memory is compared a\n\
+block at a time, so large mostly-unchanged regions are diffed quickly.\n\
+\n\
+See also: snapshot",
   },
   {
     "disassemble",
     "Disassembles machine code into assembly language instructions",
-    "[start [stop]] [-num <number>] [flags]\n\
+    "[start [stop]] [-num <number>] [-back <number>] [flags]\n\
 \n\
 [start [stop]] - Starting and stopping memory locations - All opcodes\n\
                  inside this range will be disassembled. For this to\n\
                  work, you must be working with an executable file.\n\
 [-num <num>]   - Number of instructions to disassemble (default: all)\n\
+[-back <num>]  - Move back <num> instructions from the starting address\n\
+                 (or the current file offset) and disassemble <num>\n\
+                 instructions from there, unless -num is given\n\
 [flags]        - Various flags\n\
 \n\
 Flags:\n\
@@ -77,6 +143,10 @@ The output of this command is as follows:\n\
 \n\
  Disassembly begins at the address specified by \"set file-offset\",\n\
 unless a start/stop memory address is given.\n\
+ The first time it is needed, the executable sections of the file are\n\
+decoded to find where each instruction begins, starting over at every\n\
+symbol. A starting address which falls inside an instruction is moved\n\
+back to the start of that instruction, and -back uses the same index.\n\
 \n\
 Alias: d",
   },
@@ -158,6 +228,41 @@ syminfo [sym]  - Output information about the file's symbols, if any.\n\
                  If [sym] is given, output information about that\n\
                  specific symbol.",
   },
+  {
+    "finish",
+    "Continue execution until the current function returns",
+    "\n\
+\n\
+ A temporary breakpoint is placed at the return address of the current\n\
+function, and the program continues at full speed. The return address\n\
+is found at [esp] at function entry, and at [ebp + 4] once the usual\n\
+\"push ebp; mov ebp, esp\" frame has been set up. Returns reached by\n\
+deeper, recursive calls of the function are skipped.\n\
+\n\
+See also: advance, until",
+  },
+  {
+    "handle",
+    "Set what is done when the program receives a signal",
+    "[<signal | all> [keyword ...]]\n\
+\n\
+  signal  - Signal name (such as SIGALRM or ALRM) or number\n\
+  all     - All signals except SIGINT and those used by the debugger\n\
+  keyword - One of:\n\
+              stop    - Stop the program (implies print)\n\
+              nostop  - Let the program keep running\n\
+              print   - Print a message when the signal is received\n\
+              noprint - Do not print a message (implies nostop)\n\
+              pass    - Deliver the signal to the program\n\
+              nopass  - Discard the signal\n\
+\n\
+ Signals which do not stop the program are dealt with inside the\n\
+continue loop, so the program runs at close to full speed. Without\n\
+arguments, the policy for every signal is shown, with the number of\n\
+times each was received without stopping. By default SIGALRM, SIGCHLD,\n\
+SIGURG, SIGWINCH, SIGVTALRM, SIGPROF and SIGIO are passed silently, and\n\
+SIGINT stops the program without being passed.",
+  },
   {
     "help",
     "Displays commands, or gives specific help on commands",
@@ -175,7 +280,12 @@ See also: display, undisplay"
     "Loads a new file into memory for debugging",
     "<filename>\n\
 \n\
- Previous file, if any, is unloaded first",
+ Previous file, if any, is unloaded first.\n\
+ If the file has no symbols, its functions are recovered from the entry\n\
+point, the targets of calls, the .eh_frame unwind table and the usual\n\
+\"push ebp; mov ebp, esp\" prologue. They are named sub_XXXXXXXX after\n\
+their address and can be used like any other symbol (see \"file\n\
+syminfo\").",
   },
   {
     "next",
@@ -185,12 +295,36 @@ See also: display, undisplay"
 [num] - number of instructions to step over (default: 1)\n\
 \n\
 Alias: n",
+  },
+  {
+    "profile",
+    "Sample where the running process spends its time",
+    "[seconds] [hz]\n\
+\n\
+[seconds] - how long to profile (default: 5)\n\
+[hz]      - samples per second (default: 100)\n\
+\n\
+ The process is continued and stopped briefly at regular intervals to\n\
+record the instruction pointer and the return addresses found by\n\
+following the saved frame pointers (ebp). Afterwards the hottest\n\
+functions and addresses are listed. \"Self\" counts samples taken\n\
+inside a function, \"Total\" also counts samples taken in the\n\
+functions it called. Breakpoints are not honored while profiling,\n\
+and the process is left stopped after the last sample.",
   },
   {
     "quit",
     "Exit the debugger",
     "",
   },
+  {
+    "rcontinue",
+    "Run backwards to the previous breakpoint",
+    "\n\
+\n\
+ Goes back through the history recorded with \"set record on\" until\n\
+an enabled breakpoint is reached, or the start of the history.",
+  },
   {
     "register",
     "Display and/or manipulate the process' registers",
@@ -202,6 +336,18 @@ Alias: n",
 \n\
 With no arguments, the most common registers are displayed\n\
 along with their values.",
+  },
+  {
+    "rstep",
+    "Step backwards one instruction",
+    "[num]\n\
+\n\
+[num] - number of instructions to step back (default: 1)\n\
+\n\
+ Undoes instructions run by \"step\" and \"next\" while \"set record\"\n\
+was on, restoring the registers and memory they changed. Anything\n\
+which ran at full speed (continue, a system call, a signal) starts\n\
+the history afresh.",
   },
   {
     "run",
@@ -212,6 +358,45 @@ along with their values.",
               the arguments given with \"set args\" are used.\n\
 \n\
 Alias: r",
+  },
+  {
+    "search",
+    "Search the memory of the debugged process for a pattern",
+    "<start> <end> <pattern>\n\
+       search -maps <pattern>\n\
+\n\
+<start> <end> - address range to search (numbers or symbols)\n\
+-maps         - search every readable region of the process instead\n\
+\n\
+<pattern> is one of:\n\
+-string <text>              - a character string (quote it if it\n\
+                              contains spaces)\n\
+-bytes <hex bytes>          - bytes such as \"55 89 e5\" or 5589e5; ?? matches\n\
+                              any byte\n\
+-value <number> [-size <n>] - an integer of n bytes (b, h, w, d, g or a\n\
+                              number - default 4) at an address aligned\n\
+                              to its size\n\
+\n\
+ Memory is read in large blocks rather than a word at a time, so whole\n\
+regions can be searched quickly. The address of every match is shown.",
+  },
+  {
+    "snapshot",
+    "Save the contents of memory regions for a later diff",
+    "[<name> <range...> | -delete <name | all>]\n\
+\n\
+<name>     - snapshot name; an existing snapshot of that name is replaced\n\
+<range...> - one or more of:\n\
+               <section>     - an entire section, such as .data\n\
+               <symbol>      - a symbol whose size is known\n\
+               <start> <end> - an address range (end is exclusive)\n\
+-delete    - delete a snapshot, or all of them\n\
+\n\
+ With no arguments, the current snapshots are listed. Each range is\n\
+read from the process in a single transfer and kept inside the\n\
+debugger until deleted.\n\
+\n\
+See also: diff",
   },
   {
     "set",
@@ -221,6 +406,8 @@ Alias: r",
 Options:\n\
 \n\
   args\n\
+  capture-output\n\
+  catch-log\n\
   disasm-show-syms\n\
   entry-point\n\
   file-offset\n\
@@ -230,6 +417,8 @@ Options:\n\
   step-display-regs\n\
   step-display-fpregs\n\
   step-display-mmxregs\n\
+  step-display-mode\n\
+  step-granularity\n\
 \n\
 Type \"help set <option>\" for more information on <option>",
   },
@@ -241,6 +430,35 @@ Type \"help set <option>\" for more information on <option>",
 [num] - number of instructions to step through (default: 1)\n\
 \n\
 Alias: s",
+  },
+  {
+    "stepb",
+    "Step one basic block, stopping after the next taken branch",
+    "[num]\n\
+\n\
+[num] - number of blocks to step through (default: 1)\n\
+\n\
+ The program runs until it takes a jump, call or return, and stops at\n\
+the branch target. The step display is shown at the start of each\n\
+block, so control flow can be followed without stopping at every\n\
+instruction. Breakpoints inside a block are still honored.\n\
+This uses the processor's branch trap flag and is only available on\n\
+Linux.",
+  },
+  {
+    "strings",
+    "Show the printable strings of the file",
+    "[-section <name>] [-min <length>] [-match <text>]\n\
+\n\
+[-section <name>] - only show strings in section <name>\n\
+[-min <length>]   - shortest string to show (default: 4)\n\
+[-match <text>]   - only show strings containing <text>\n\
+\n\
+ Each string is shown with its address and section. The first time it\n\
+is needed, the whole file is scanned once and every run of printable\n\
+characters is recorded, so later searches do not read the file again.\n\
+The \"xref -from\" command uses the same index to show the strings a\n\
+function refers to.",
   },
   {
     "undisplay",
@@ -257,6 +475,42 @@ See also: display, ldisplay"
     "Unloads the current debug file from memory",
     "",
   },
+  {
+    "until",
+    "Continue execution until the current loop is left",
+    "[address | symbol]\n\
+\n\
+[address | symbol] - location to run to (optional)\n\
+\n\
+ With no argument, the loop around the current instruction is found\n\
+by searching forward for a jump back to (or before) it. Temporary\n\
+breakpoints are placed at every address where control leaves that\n\
+loop and at the function's return address, and the program continues\n\
+at full speed. If the current instruction is not inside a loop, this\n\
+behaves like \"next\".\n\
+ With an argument, the program runs until that location is reached in\n\
+the current function, or until the function returns.\n\
+\n\
+See also: advance, finish",
+  },
+  {
+    "xref",
+    "Show cross references of an address",
+    "<address | symbol> [-from]\n\
+\n\
+<address | symbol> - location to look up\n\
+[-from]            - show the references made by the code of a\n\
+                     function (or a single instruction) instead\n\
+\n\
+ Lists every call, jump and address operand in the executable sections\n\
+of the file which refers to the location. The first time it is needed,\n\
+the file is disassembled once and the references are kept in sorted\n\
+tables, so later lookups are immediate. Any 32 bit operand which falls\n\
+inside the file is counted as a data reference, so a constant which\n\
+happens to look like an address may show up as well. Calls through\n\
+registers or memory are not known until the program runs, and are not\n\
+listed.",
+  },
 
   { 0, 0, 0 },
 };
@@ -278,13 +532,36 @@ static struct HelpCmd BreakHelp[] = {
               such as the name of a function. The executable must\n\
               have been compiled with debugging symbols enabled.",
   },
+  {
+    "catch",
+    "Catch system calls",
+    "[syscall <name | number> ...]\n\
+       catch clear\n\
+\n\
+  syscall <name | number> - Add system calls to the catch list. Only\n\
+                            these calls stop the program; all others\n\
+                            run at full speed.\n\
+  clear                   - Empty the catch list.\n\
+\n\
+With no arguments, the catch list is shown. Depending on\n\
+\"set catch-log\", the program either stops at each caught call,\n\
+showing its arguments (the return value is shown when it continues),\n\
+or keeps running while each call is printed with its return value.\n\
+Use \"syscall\" in batch script conditions to test for a caught call.\n\
+\n\
+Calls are selected by a seccomp filter put into the program when the\n\
+\"run\" command starts it, so the list takes effect at the next run\n\
+and does not apply to attached processes. The filter cannot be\n\
+removed: after \"detach\", caught calls fail with ENOSYS.",
+  },
   {
     "dbreak",
     "Delete a breakpoint",
     "<number | all>\n\
 \n\
-  number - Breakpoint number (can be obtained from \"lbreak\")\n\
-  all    - Delete all breakpoints\n\
+  number - Breakpoint or watchpoint number (can be obtained from\n\
+           \"lbreak\")\n\
+  all    - Delete all breakpoints and watchpoints\n\
 \n\
 Alias: delete",
   },
@@ -308,6 +585,24 @@ reactivated using the \"enable\" command.",
   all    - Enable all breakpoints\n\
 \n\
  This reverses the effect of the \"disable\" command.",
+  },
+  {
+    "ftrace",
+    "Set a fast tracepoint",
+    "<address | symbol> [collect <item> ...]\n\
+\n\
+  <address> - Tracepoint address\n\
+  <symbol>  - Alternatively, a debugging symbol\n\
+  <item>    - What to collect, as for \"trace\"\n\
+\n\
+ A fast tracepoint collects the same frames as \"trace\", but without\n\
+stopping the program: the instructions at the address are replaced by\n\
+a jump to code put into the program, which collects into a ring the\n\
+debugger reads when \"tstatus\", \"tdump\" or \"tsave\" is used. The\n\
+first 5 bytes of instructions at the address may not contain relative\n\
+branches or be jumped into. Only the general registers, eflags and eip\n\
+may be collected, and unreadable memory crashes the program. Fast\n\
+tracepoints are removed by \"dbreak\", or when a new program is run.",
   },
   {
     "ignore",
@@ -322,7 +617,7 @@ triggered until it has been hit <count> times.",
   },
   {
     "lbreak",
-    "List all breakpoints",
+    "List all breakpoints and watchpoints",
     "",
   },
   {
@@ -334,6 +629,114 @@ triggered until it has been hit <count> times.",
 \n\
  A temporary breakpoint is cleared after the first time it is hit.",
   },
+  {
+    "tdump",
+    "Show the frames collected by tracepoints",
+    "[number]\n\
+\n\
+  number - Show only the frames of this tracepoint\n\
+\n\
+ Frames are shown oldest first, with the registers and memory the\n\
+tracepoint was asked to collect.",
+  },
+  {
+    "trace",
+    "Set a tracepoint",
+    "<address | symbol> [collect <item> ...]\n\
+\n\
+  <address> - Tracepoint address\n\
+  <symbol>  - Alternatively, a debugging symbol\n\
+  <item>    - What to collect each time the tracepoint is hit:\n\
+                <register>   - a general register, such as eax\n\
+                regs         - all general registers\n\
+                [<register | address>+offset]:size\n\
+                             - size bytes of memory (default: 4, at\n\
+                               most 256), such as [esp+4]:8\n\
+\n\
+ Unlike a breakpoint, a tracepoint does not stop the program: the\n\
+items are stored in a buffer (see \"set trace-size\") and the program\n\
+continues right away. Up to 8 memory ranges may be collected. Use\n\
+\"tstatus\", \"tdump\" and \"tsave\" to examine the frames collected,\n\
+and \"dbreak\" to remove a tracepoint.",
+  },
+  {
+    "tsave",
+    "Save the frames collected by tracepoints to a file",
+    "<file> [number]\n\
+\n\
+  file   - File to write\n\
+  number - Save only the frames of this tracepoint\n\
+\n\
+ Each frame is written on one line: the frame number, tracepoint\n\
+number and address, then register=value for each register and\n\
+address=bytes (in hexadecimal) for each memory range. Memory which\n\
+could not be read is written as '?'.",
+  },
+  {
+    "tstatus",
+    "Show tracepoints and the state of the trace buffer",
+    "",
+  },
+  {
+    "watch",
+    "Stop when the program writes to a range of memory",
+    "<address | symbol> [size]\n\
+\n\
+  <address> - Start of the range to watch\n\
+  <symbol>  - Alternatively, a debugging symbol - all of the object\n\
+              is watched if its size is known\n\
+  [size]    - Length of the range in bytes (default: 4)\n\
+\n\
+ The program stops after each instruction which changes the range, and\n\
+the old and new contents are shown. There is no limit on the number or\n\
+length of watched ranges: the pages holding them are made read-only in\n\
+the program, and each write to those pages is single stepped and\n\
+checked, so writes near a watched range slow the program down.\n\
+Writes made by the kernel on behalf of the program (such as read()\n\
+into a watched buffer) fail with EFAULT instead of being reported.\n\
+Use \"dbreak\" to remove a watchpoint.",
+  },
+
+  { 0, 0, 0 }
+};
+
+/*
+ * Checkpoint related help
+ */
+static struct HelpCmd CheckpointHelp[] = {
+  {
+    "checkpoint",
+    "Take a snapshot of the process",
+    "\n\
+\n\
+ Makes a frozen copy of the process as it is right now. Use\n\
+\"restart\" to resume debugging from that point later on, without\n\
+running the program from the beginning.",
+  },
+  {
+    "dcheckpoint",
+    "Delete a checkpoint",
+    "<number | all>\n\
+\n\
+  number - Checkpoint number (can be obtained from \"lcheckpoint\")\n\
+  all    - Delete all checkpoints",
+  },
+  {
+    "lcheckpoint",
+    "List all checkpoints",
+    "",
+  },
+  {
+    "restart",
+    "Resume debugging from a checkpoint",
+    "<number>\n\
+\n\
+  number - Checkpoint number (can be obtained from \"lcheckpoint\")\n\
+\n\
+ The current process is killed and replaced by a copy of the\n\
+checkpoint. The checkpoint itself is kept, so it may be restarted\n\
+any number of times. Breakpoints and displays are not affected.",
+  },
 
   { 0, 0, 0 }
 };
@@ -347,6 +750,27 @@ static struct HelpCmd SetHelp[] = {
     "Set runtime arguments passed to program",
     "[arguments]",
   },
+  {
+    "set capture-output",
+    "Capture output written by the program",
+    "<on | off>\n\
+\n\
+ When this option is enabled, anything the program writes to stdout\n\
+or stderr is collected by the debugger and displayed each time the\n\
+program stops, instead of going to the terminal. If \"set output\"\n\
+is in effect, the program's output is copied to that file as well.\n\
+The new setting takes effect the next time the program is started.",
+  },
+  {
+    "set catch-log",
+    "Log caught system calls instead of stopping",
+    "<on | off>\n\
+\n\
+ When this option is enabled, the program does not stop at system\n\
+calls selected with the \"catch\" command. Instead each call is\n\
+printed with its arguments and return value, strace-style, and the\n\
+program keeps running.",
+  },
   {
     "set disasm-show-syms",
     "Display symbol information while disassembling",
@@ -390,7 +814,8 @@ disassembled output, etc.",
  When this option is enabled, commands which display a large amount\n\
 of information at one time will prompt the user to continue\n\
 displaying after each pageful. Otherwise all the data will be dumped\n\
-to the screen with no pauses.",
+to the screen with no pauses. Output is never paused when it is not\n\
+going to a terminal.",
   },
   {
     "set prompt",
@@ -399,6 +824,24 @@ to the screen with no pauses.",
 \n\
  Sets the command line prompt to <new prompt>. Use quotes if\n\
 <new prompt> contains spaces.",
+  },
+  {
+    "set record",
+    "Record execution history for reverse stepping",
+    "<on | off>\n\
+\n\
+ When this option is enabled, every instruction run by \"step\" and\n\
+\"next\" is recorded, so \"rstep\" and \"rcontinue\" can go back\n\
+through it. \"next\" steps through called subroutines instead of\n\
+running them at full speed, so it is slower.",
+  },
+  {
+    "set record-size",
+    "Limit the memory used to record execution history",
+    "<bytes>\n\
+\n\
+ Once the history fills this many bytes, the oldest instructions are\n\
+forgotten. The default is 1048576.",
   },
   {
     "set step-display-regs",
@@ -424,6 +867,37 @@ be displayed by the \"step\" and \"next\" commands.",
  When this option is enabled, mmx registers will be displayed by the\n\
 \"step\" and \"next\" commands.",
   },
+  {
+    "set step-display-mode",
+    "Choose how much to display after single stepping",
+    "<full | changed | none>\n\
+\n\
+ full    - display all registers selected with the step-display-*regs\n\
+           options and all \"display\" memory ranges (default)\n\
+ changed - display only the registers and lines of memory whose\n\
+           contents changed since they were last displayed\n\
+ none    - display only the next instruction\n\
+\n\
+ Using \"changed\" or \"none\" greatly reduces output when stepping\n\
+through long stretches of code.",
+  },
+  {
+    "set step-granularity",
+    "Choose whether step advances by instruction or by block",
+    "<instruction | block>\n\
+\n\
+ With \"block\", the \"step\" command behaves like \"stepb\": each step\n\
+runs the program until it takes a branch, and stops at the start of\n\
+the next basic block. The default is \"instruction\".",
+  },
+  {
+    "set trace-size",
+    "Set the size of the buffer holding tracepoint frames",
+    "<bytes>\n\
+\n\
+ Once the buffer is full, the oldest frames are discarded. Changing\n\
+the size discards all frames. The default is 1048576.",
+  },
 
   { 0, 0, 0 }
 };
@@ -431,6 +905,7 @@ be displayed by the \"step\" and \"next\" commands.",
 static struct HelpCmd *AllHelp[] = {
   GeneralHelp,
   BreakHelp,
+  CheckpointHelp,
   SetHelp,
   0
 };
@@ -485,6 +960,11 @@ GiveHelp(struct aldWorkspace *ws, int ac, char **av)
           "\nBreakpoint related commands");
     PrintHelpCommands(ws, BreakHelp);
 
+    Print(ws,
+          P_COMMAND,
+          "\nCheckpoint related commands");
+    PrintHelpCommands(ws, CheckpointHelp);
+
     endPrintBurst(ws->printWorkspace_p);
 
     return;
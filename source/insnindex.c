@@ -0,0 +1,555 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module records where each instruction of the executable
+ * sections of the loaded file begins, so the disassembler can snap an
+ * arbitrary address to an instruction boundary and move backwards
+ * without decoding from the start of the section again. The index is
+ * built the first time it is needed and discarded with the file.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "defs.h"
+#include "insnindex.h"
+#include "main.h"
+#include "print.h"
+
+#include "libDASM.h"
+#include "libOFF.h"
+
+/*
+ * Things we collect from libOFF before decoding
+ */
+struct insnIndexBuild
+{
+  struct aldWorkspace *ws;
+
+  struct insnIndexSection *sections;
+  int nsections;
+  int maxsections;
+
+  unsigned long *symbols;            /* symbol addresses */
+  long nsymbols;
+  long maxsymbols;
+
+  int failed;                        /* malloc failed */
+};
+
+static void callbackIndexSection(void *args, struct offSectionInfo *secinfo,
+                                 int exec);
+static int callbackIndexSymbol(void *args, struct offSymbolInfo *syminfo);
+static void indexSection(struct aldWorkspace *ws,
+                         struct insnIndexSection *sec,
+                         unsigned long *symbols, long nsymbols);
+static int compareIndexSection(const void *a, const void *b);
+static int compareAddress(const void *a, const void *b);
+
+/*
+getInsnIndex()
+  Return the instruction boundary index of the loaded file, building
+it if this is the first time it is needed
+
+Inputs: ws - ald workspace
+
+Return: pointer to index
+        0 if no file is loaded or memory is exhausted
+*/
+
+struct insnIndex *
+getInsnIndex(struct aldWorkspace *ws)
+
+{
+  struct insnIndexBuild build;
+  struct insnIndex *index;
+  long ii,
+       nsyms;
+  int jj;
+
+  if (ws->insnIndex_p)
+    return (ws->insnIndex_p);
+
+  if (!awIsFileLoaded(ws))
+    return (0);
+
+  memset(&build, '\0', sizeof(build));
+  build.ws = ws;
+
+  traverseSectionsOFF(ws->offWorkspace_p, callbackIndexSection, &build);
+  traverseSymbolsOFF(ws->offWorkspace_p, callbackIndexSymbol, &build);
+
+  index = (struct insnIndex *) malloc(sizeof(struct insnIndex));
+  if (!index || build.failed)
+  {
+    Print(ws, P_ERROR, "getInsnIndex: malloc failed: %s", strerror(errno));
+
+    if (index)
+      free(index);
+
+    for (jj = 0; jj < build.nsections; ++jj)
+      free(build.sections[jj].bitmap);
+
+    if (build.sections)
+      free(build.sections);
+
+    if (build.symbols)
+      free(build.symbols);
+
+    return (0);
+  }
+
+  /*
+   * Sort and remove duplicate symbol addresses
+   */
+  nsyms = 0;
+  if (build.nsymbols)
+  {
+    qsort(build.symbols,
+          build.nsymbols,
+          sizeof(unsigned long),
+          compareAddress);
+
+    for (ii = 0; ii < build.nsymbols; ++ii)
+    {
+      if (!nsyms || (build.symbols[nsyms - 1] != build.symbols[ii]))
+        build.symbols[nsyms++] = build.symbols[ii];
+    }
+  }
+
+  if (build.nsections)
+  {
+    qsort(build.sections,
+          build.nsections,
+          sizeof(struct insnIndexSection),
+          compareIndexSection);
+  }
+
+  for (jj = 0; jj < build.nsections; ++jj)
+    indexSection(ws, build.sections + jj, build.symbols, nsyms);
+
+  if (build.symbols)
+    free(build.symbols);
+
+  index->sections = build.sections;
+  index->nsections = build.nsections;
+
+  ws->insnIndex_p = index;
+
+  return (index);
+} /* getInsnIndex() */
+
+/*
+freeInsnIndex()
+  Discard the instruction boundary index (the file is being unloaded)
+
+Inputs: ws - ald workspace
+*/
+
+void
+freeInsnIndex(struct aldWorkspace *ws)
+
+{
+  int ii;
+
+  if (!ws->insnIndex_p)
+    return;
+
+  for (ii = 0; ii < ws->insnIndex_p->nsections; ++ii)
+    free(ws->insnIndex_p->sections[ii].bitmap);
+
+  if (ws->insnIndex_p->sections)
+    free(ws->insnIndex_p->sections);
+
+  free(ws->insnIndex_p);
+  ws->insnIndex_p = 0;
+} /* freeInsnIndex() */
+
+/*
+findInsnIndexSection()
+  Binary search for the indexed section containing an address
+
+Inputs: index   - instruction index
+        address - address to look up
+
+Return: pointer to section
+        0 if the address is not in an indexed section
+*/
+
+struct insnIndexSection *
+findInsnIndexSection(struct insnIndex *index, unsigned long address)
+
+{
+  struct insnIndexSection *sec;
+  int low,
+      high,
+      mid;
+
+  low = 0;
+  high = index->nsections - 1;
+
+  while (low <= high)
+  {
+    mid = (low + high) / 2;
+    sec = index->sections + mid;
+
+    if (address < sec->address)
+      high = mid - 1;
+    else if (address >= sec->address + sec->size)
+      low = mid + 1;
+    else
+      return (sec);
+  }
+
+  return (0);
+} /* findInsnIndexSection() */
+
+/*
+snapInsnIndex()
+  Find the start of the instruction which contains an address
+
+Inputs: ws      - ald workspace
+        address - address to snap
+        result  - modified to contain the instruction start
+
+Return: 1 if address is in an indexed section
+        0 if not (result is set to address)
+*/
+
+int
+snapInsnIndex(struct aldWorkspace *ws, unsigned long address,
+              unsigned long *result)
+
+{
+  struct insnIndex *index;
+  struct insnIndexSection *sec;
+  unsigned long offset;
+
+  *result = address;
+
+  index = getInsnIndex(ws);
+  if (!index)
+    return (0);
+
+  sec = findInsnIndexSection(index, address);
+  if (!sec)
+    return (0);
+
+  offset = address - sec->address;
+  while (offset && !insnIndexIsStart(sec, offset))
+    --offset;
+
+  *result = sec->address + offset;
+
+  return (1);
+} /* snapInsnIndex() */
+
+/*
+backInsnIndex()
+  Move back a number of instructions from an address. An address
+just past the end of a section counts as part of that section, so
+one can page back from wherever a forward disassembly stopped.
+
+Inputs: ws      - ald workspace
+        address - address to start from
+        count   - number of instructions to move back
+        result  - modified to contain the new address
+
+Return: number of instructions moved back, which is less than count
+        if the start of the section was reached
+        -1 if address is not in an indexed section
+*/
+
+long
+backInsnIndex(struct aldWorkspace *ws, unsigned long address,
+              long count, unsigned long *result)
+
+{
+  struct insnIndex *index;
+  struct insnIndexSection *sec;
+  unsigned long offset;
+  long moved;
+
+  *result = address;
+
+  index = getInsnIndex(ws);
+  if (!index)
+    return (-1);
+
+  sec = findInsnIndexSection(index, address);
+  if (!sec && address)
+    sec = findInsnIndexSection(index, address - 1);
+
+  if (!sec)
+    return (-1);
+
+  offset = address - sec->address;
+  moved = 0;
+
+  while ((moved < count) && offset)
+  {
+    /*
+     * Skip whole bytes of the bitmap which have no instruction
+     * starts (runs of data or padding)
+     */
+    if (!(offset & 7) && (offset >= 8) && !sec->bitmap[(offset >> 3) - 1])
+    {
+      offset -= 8;
+      continue;
+    }
+
+    --offset;
+    if (insnIndexIsStart(sec, offset))
+      ++moved;
+  }
+
+  *result = sec->address + offset;
+
+  return (moved);
+} /* backInsnIndex() */
+
+/*
+callbackIndexSection()
+  Called by traverseSectionsOFF() - remember executable sections
+which lie within the mapped file
+*/
+
+static void
+callbackIndexSection(void *args, struct offSectionInfo *secinfo, int exec)
+
+{
+  struct insnIndexBuild *build;
+  struct insnIndexSection *sec;
+  struct aldWorkspace *ws;
+
+  build = (struct insnIndexBuild *) args;
+  ws = build->ws;
+
+  if (!exec || !secinfo->size || build->failed)
+    return;
+
+  if ((secinfo->address < ws->virtualFileAddress) ||
+      ((secinfo->address - ws->virtualFileAddress) + secinfo->size >
+       ws->MappedSize))
+    return;
+
+  if (build->nsections == build->maxsections)
+  {
+    build->maxsections += 8;
+    sec = (struct insnIndexSection *)
+          realloc(build->sections,
+                  sizeof(struct insnIndexSection) * build->maxsections);
+    if (!sec)
+    {
+      build->failed = 1;
+      return;
+    }
+
+    build->sections = sec;
+  }
+
+  sec = build->sections + build->nsections;
+
+  sec->address = secinfo->address;
+  sec->size = secinfo->size;
+  sec->bitmap = (unsigned char *) calloc((secinfo->size + 7) / 8, 1);
+  if (!sec->bitmap)
+  {
+    build->failed = 1;
+    return;
+  }
+
+  ++(build->nsections);
+} /* callbackIndexSection() */
+
+/*
+callbackIndexSymbol()
+  Called by traverseSymbolsOFF() - remember symbol addresses, which
+we use to resynchronize decoding
+
+Return: ST_CONTINUE
+        ST_STOP if memory is exhausted
+*/
+
+static int
+callbackIndexSymbol(void *args, struct offSymbolInfo *syminfo)
+
+{
+  struct insnIndexBuild *build;
+  unsigned long *ptr;
+
+  build = (struct insnIndexBuild *) args;
+
+  if (build->nsymbols == build->maxsymbols)
+  {
+    build->maxsymbols += 256;
+    ptr = (unsigned long *) realloc(build->symbols,
+                                    sizeof(unsigned long) * build->maxsymbols);
+    if (!ptr)
+    {
+      build->failed = 1;
+      return (ST_STOP);
+    }
+
+    build->symbols = ptr;
+  }
+
+  build->symbols[build->nsymbols++] = syminfo->address;
+
+  return (ST_CONTINUE);
+} /* callbackIndexSymbol() */
+
+/*
+indexSection()
+  Decode a section from the mapped file and set the bit of each
+instruction start. Decoding starts over at every symbol address, so
+data or padding which decodes into instructions running past the
+start of a function cannot put us out of step for the rest of the
+section.
+
+Inputs: ws       - ald workspace
+        sec      - section to index
+        symbols  - sorted symbol addresses
+        nsymbols - number of symbols
+*/
+
+static void
+indexSection(struct aldWorkspace *ws, struct insnIndexSection *sec,
+             unsigned long *symbols, long nsymbols)
+
+{
+  unsigned char *code;
+  unsigned char spill[MAX_OPCODE_LEN + 1];
+  char buffer[MAXLINE];
+  unsigned long offset,
+                nextsym;
+  long low,
+       high,
+       mid,
+       symidx;
+  long len;
+
+  code = (unsigned char *) ws->MapPtr + (sec->address - ws->virtualFileAddress);
+
+  /*
+   * Find the first symbol after the section start
+   */
+  low = 0;
+  high = nsymbols;
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    if (symbols[mid] <= sec->address)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  symidx = low;
+
+  offset = 0;
+  while (offset < sec->size)
+  {
+    if ((symidx < nsymbols) && (symbols[symidx] < sec->address + sec->size))
+      nextsym = symbols[symidx] - sec->address;
+    else
+      nextsym = sec->size;
+
+    if (offset >= nextsym)
+    {
+      /*
+       * We reached (or decoded past) a symbol - start over from it
+       */
+      if (offset > nextsym)
+        offset = nextsym;
+
+      ++symidx;
+      continue;
+    }
+
+    sec->bitmap[offset >> 3] |= 1 << (offset & 7);
+
+    if ((offset + MAX_OPCODE_LEN) >= sec->size)
+    {
+      /*
+       * Near the end of the section - the disassembler might read
+       * beyond it, so decode from a copy
+       */
+      memset((void *) spill, 0, sizeof(spill));
+      memcpy(spill, code + offset, sec->size - offset);
+
+      len = procDisasm(ws->disasmWorkspace_p,
+                       spill,
+                       buffer,
+                       (unsigned int) (sec->address + offset));
+    }
+    else
+    {
+      len = procDisasm(ws->disasmWorkspace_p,
+                       code + offset,
+                       buffer,
+                       (unsigned int) (sec->address + offset));
+    }
+
+    if (len <= 0)
+      len = 1;
+
+    offset += len;
+  }
+} /* indexSection() */
+
+/*
+compareIndexSection()
+  qsort() comparison - order sections by address
+*/
+
+static int
+compareIndexSection(const void *a, const void *b)
+
+{
+  const struct insnIndexSection *sa,
+                                *sb;
+
+  sa = (const struct insnIndexSection *) a;
+  sb = (const struct insnIndexSection *) b;
+
+  if (sa->address < sb->address)
+    return (-1);
+  else if (sa->address > sb->address)
+    return (1);
+
+  return (0);
+} /* compareIndexSection() */
+
+/*
+compareAddress()
+  qsort() comparison - order addresses
+*/
+
+static int
+compareAddress(const void *a, const void *b)
+
+{
+  unsigned long aa,
+                bb;
+
+  aa = *(const unsigned long *) a;
+  bb = *(const unsigned long *) b;
+
+  if (aa < bb)
+    return (-1);
+  else if (aa > bb)
+    return (1);
+
+  return (0);
+} /* compareAddress() */
@@ -22,10 +22,15 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include "core.h"
+#include "funcs.h"
+#include "insnindex.h"
 #include "load.h"
 #include "main.h"
 #include "misc.h"
 #include "print.h"
+#include "strindex.h"
+#include "xref.h"
 
 #include "libDebug.h"
 
@@ -171,6 +176,21 @@ loadFile(struct aldWorkspace *ws, char *filename)
      * Go to 32 bit mode
      */
     flagsDisasm(ws->disasmWorkspace_p, DA_32BITMODE);
+
+    if (!symcnt)
+    {
+      /*
+       * A stripped file - find its functions ourselves
+       */
+      RawPrint(ws, P_COMMAND, "Recovering functions...");
+
+      symcnt = recoverFunctions(ws);
+
+      if (symcnt)
+        Print(ws, P_COMMAND, "(%lu functions found)", symcnt);
+      else
+        Print(ws, P_COMMAND, "(none found)");
+    }
   }
 
   ws->objectFileName = Strdup(filename);
@@ -193,6 +213,12 @@ unloadFile(struct aldWorkspace *ws)
   assert(ws->MapPtr != 0);
   assert(ws->objectFileDescriptor != (-1));
 
+  /*
+   * A core file is only meaningful together with its program
+   */
+  if (awIsCoreLoaded(ws))
+    unloadCore(ws);
+
   if (munmap(ws->MapPtr, ws->MappedSize) == (-1))
   {
     Print(ws,
@@ -210,6 +236,10 @@ unloadFile(struct aldWorkspace *ws)
 
   ws->MapPtr = 0;
 
+  freeXrefIndex(ws);
+  freeStrIndex(ws);
+  freeInsnIndex(ws);
+
   awClearFileLoaded(ws);
 
   unloadSymbolsOFF(ws->offWorkspace_p);
@@ -17,13 +17,17 @@
 #include <string.h>
 
 #include "alddefs.h"
+#include "batch.h"
 #include "command.h"
 #include "defs.h"
+#include "display.h"
+#include "list.h"
 #include "load.h"
 #include "main.h"
 #include "misc.h"
 #include "set.h"
 #include "signals.h"
+#include "systrace.h"
 #include "terminal.h"
 #include "version.h"
 
@@ -56,12 +60,46 @@ static int
 ParseCommandLine(struct aldWorkspace *ws, int ac, char *av[], char **filename)
 
 {
-  while (--ac)
+  int ii;
+
+  for (ii = 1; ii < ac; ++ii)
   {
-    if (*av[ac] == '-')
+    if (*av[ii] == '-')
     {
-      switch (*(av[ac] + 1))
+      switch (*(av[ii] + 1))
       {
+        /*
+         * Run a command script
+         */
+        case 'b':
+        {
+          if (++ii >= ac)
+          {
+            fprintf(stderr, "%s: -batch requires a script file\n", av[0]);
+            return (0);
+          }
+
+          ws->batchFile = av[ii];
+
+          break;
+        } /* case 'b' */
+
+        /*
+         * Batch output file
+         */
+        case 'o':
+        {
+          if (++ii >= ac)
+          {
+            fprintf(stderr, "%s: -o requires an output file\n", av[0]);
+            return (0);
+          }
+
+          ws->batchOutput = av[ii];
+
+          break;
+        } /* case 'o' */
+
         /*
          * Give help output
          */
@@ -70,12 +108,23 @@ ParseCommandLine(struct aldWorkspace *ws, int ac, char *av[], char **filename)
           fprintf(stdout,
             "Usage: %s [options] [filename]\n\
 \n\
-  [filename]  : Path to executable file to debug\n\
+  [filename]      : Path to executable file to debug\n\
 \n\
 Options:\n\
 \n\
-  -h          : Output this help screen\n\
-  -v          : Output version information\n",
+  -batch <script> : Run the commands in <script> without user\n\
+                    interaction, then exit (see below)\n\
+  -o <file>       : With -batch, write all output to <file>\n\
+  -h              : Output this help screen\n\
+  -v              : Output version information\n\
+\n\
+Batch scripts contain ald commands, one per line, and may use\n\
+\"if <condition> ... [else ...] end\", \"while <condition> ... end\",\n\
+\"print <text>\" and \"exit [code]\". Conditions are running, exited,\n\
+breakpoint [n], watchpoint [n], signal [name], syscall [name] and failed,\n\
+optionally preceded by \"not\".\n\
+The exit code is 0 if every command succeeded, 1 if any failed, 2 for\n\
+a bad script, 3 if interrupted and 4 if the program could not be loaded.\n",
             av[0]);
 
           return (0);
@@ -115,10 +164,17 @@ Options:\n\
       /*
        * No "-" switch, must be the filename
        */
-      *filename = av[ac];
+      if (!*filename)
+        *filename = av[ii];
     }
   }
 
+  if (ws->batchOutput && !ws->batchFile)
+  {
+    fprintf(stderr, "%s: -o is only valid with -batch\n", av[0]);
+    return (0);
+  }
+
   return (1);
 } /* ParseCommandLine() */
 
@@ -216,6 +272,9 @@ initALD(int argc, char *argv[])
     return (0);
   }
 
+  setSignalNotify(ws->debugWorkspace_p, NotifySignal, (void *) ws);
+  setCatchNotify(ws->debugWorkspace_p, NotifySyscall, (void *) ws);
+
   /*
    * Initialize disasm workspace: default to 16 bit mode
    */
@@ -246,6 +305,7 @@ initALD(int argc, char *argv[])
   SetDisasmShowSyms(ws);
 
   ws->stepDisplayFlags = DB_REGFL_DISPLAY_GENERAL;
+  ws->stepDisplayMode = STEPDISP_FULL;
 
   SetStepDisplayRegs(ws);
 
@@ -307,6 +367,14 @@ termALD(struct aldWorkspace *ws)
   if (ws->offWorkspace_p)
     termOFF(ws->offWorkspace_p);
 
+  if (ws->coreWorkspace_p)
+    termOFF(ws->coreWorkspace_p);
+
+  if (ws->stepRegisters)
+    free(ws->stepRegisters);
+
+  freeList(&(ws->snapshotList));
+
   free(ws);
 } /* termALD() */
 
@@ -338,32 +406,73 @@ main(int argc, char *argv[])
 
 {
   struct aldWorkspace *mainWorkspace_p;
-
-  fprintf(stdout, "Assembly Language Debugger %s\n", aVersion);
-  fprintf(stdout, "Copyright (C) 2000-2004 Patrick Alken\n\n");
+  int status;
 
   mainWorkspace_p = initALD(argc, argv);
   if (!mainWorkspace_p)
     exit(1);
 
+  if (mainWorkspace_p->batchOutput)
+  {
+    if (!freopen(mainWorkspace_p->batchOutput, "w", stdout))
+    {
+      fprintf(stderr,
+              "Unable to open %s: %s\n",
+              mainWorkspace_p->batchOutput,
+              strerror(errno));
+      termALD(mainWorkspace_p);
+      exit(1);
+    }
+  }
+
+  if (!mainWorkspace_p->batchFile)
+  {
+    fprintf(stdout, "Assembly Language Debugger %s\n", aVersion);
+    fprintf(stdout, "Copyright (C) 2000-2004 Patrick Alken\n\n");
+  }
+
   /*
    * Load runtime configuration file
    */
   readRC(mainWorkspace_p);
 
+  if (mainWorkspace_p->batchFile)
+  {
+    /*
+     * Nobody is there to answer the pager
+     */
+    mainWorkspace_p->printWorkspace_p->PausePrint = 0;
+    mainWorkspace_p->printWorkspace_p->IsTTY = 0;
+  }
+
   /*
    * If a filename was specified on the command line, get it
    * ready for debugging
    */
   if (mainWorkspace_p->filename)
   {
-    loadFile(mainWorkspace_p, mainWorkspace_p->filename);
+    if ((loadFile(mainWorkspace_p, mainWorkspace_p->filename) < 0) &&
+        mainWorkspace_p->batchFile)
+    {
+      termALD(mainWorkspace_p);
+      exit(BATCH_NOPROGRAM);
+    }
+
     startDebug(mainWorkspace_p->debugWorkspace_p,
                mainWorkspace_p->filename,
-               0);
+               IsSetCaptureOutput(mainWorkspace_p) ? 1 : 0);
     awSetFileLoaded(mainWorkspace_p);
   }
 
+  if (mainWorkspace_p->batchFile)
+  {
+    status = runBatch(mainWorkspace_p, mainWorkspace_p->batchFile);
+
+    termALD(mainWorkspace_p);
+
+    return (status);
+  }
+
   procALD(mainWorkspace_p);
 
   termALD(mainWorkspace_p);
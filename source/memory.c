@@ -11,7 +11,9 @@
  * $Id: memory.c,v 1.3 2004/07/21 16:36:06 pa33 Exp $
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include "alddefs.h"
@@ -24,7 +26,7 @@ struct MemFormat OutputFormats[] = {
   { 'x', "hex", "%02X ", 16, 2 },         /* MF_1HEX */
   { 'x', "hex", "%04X ", 8, 4 },         /* MF_2HEX */
   { 'x', "hex", "%08X ", 4, 8 },          /* MF_4HEX */
-  { 'x', "hex", "%016X ", 16, 16 },       /* MF_8HEX */
+  { 'x', "hex", "%016X ", 2, 16 },        /* MF_8HEX */
   { 'o', "octal", "%03o ", 8, 3 },       /* MF_1OCTAL */
   { 'o', "octal", "%06o ", 6, 6 },       /* MF_2OCTAL */
   { 'o', "octal", "%011o ", 4, 11 },     /* MF_4OCTAL */
@@ -35,10 +37,22 @@ struct MemFormat OutputFormats[] = {
   { 0, 0, 0, 0, 0 }
 };
 
+/*
+ * Hex digits, indexed by nibble
+ */
+static const char HexDigits[] = "0123456789ABCDEF";
+
 static struct MemFormat *GetOutputFormat(unsigned char output,
                                          long elsize);
 static unsigned long GetMemoryValue(unsigned char *buf, long size,
                                     int *err);
+static long FormatMemoryLine(struct MemFormat *fptr, unsigned char *buf,
+                             unsigned long addr, long bytes, long size,
+                             char *line);
+static int OutputMemoryLine(struct aldWorkspace *ws, struct MemFormat *fptr,
+                            unsigned char *buf, unsigned long addr,
+                            long bytes, long size, char *block,
+                            long *used);
 
 /*
 GetOutputFormat()
@@ -49,7 +63,7 @@ Inputs: output - character representing a base output
 
 Return: pointer to index of OutputFormats[] corresponding to 'output'.
         If 'output' does not match any known formats, default to
-        hexadecimal.
+        hexadecimal. 8 byte elements are always shown in hexadecimal.
 */
 
 static struct MemFormat *
@@ -66,6 +80,8 @@ GetOutputFormat(unsigned char output, long elsize)
       idx = MF_2OCTAL;
     else if (elsize == 4)
       idx = MF_4OCTAL;
+    else if (elsize == 8)
+      idx = MF_8HEX;
   }
   else if (output == 'd')
   {
@@ -75,6 +91,8 @@ GetOutputFormat(unsigned char output, long elsize)
       idx = MF_2DECIMAL;
     else if (elsize == 4)
       idx = MF_4DECIMAL;
+    else if (elsize == 8)
+      idx = MF_8HEX;
   }
   else
   {
@@ -258,6 +276,158 @@ GetMemoryValue(unsigned char *buf, long size, int *err)
   return (ret);
 } /* GetMemoryValue() */
 
+/*
+FormatMemoryLine()
+  Format one line of a memory dump: the address, up to fptr->epl
+elements and their ascii equivalent. Hexadecimal elements of any
+supported size (including 8 byte giants) are converted a byte at a
+time through HexDigits[], so only octal and decimal elements need
+sprintf().
+
+Inputs: fptr  - output format
+        buf   - buffer containing bytes of memory for this line
+        addr  - address of first byte in buf
+        bytes - number of bytes in buf
+        size  - size of each element in buf
+        line  - where to store the line (at least MEM_MAXLINE bytes)
+
+Return: length of line, including the trailing \n
+        -1 if the element size is not supported
+*/
+
+static long
+FormatMemoryLine(struct MemFormat *fptr, unsigned char *buf,
+                 unsigned long addr, long bytes, long size, char *line)
+
+{
+  unsigned char *bufptr;
+  unsigned char *end;
+  char *lptr;
+  long element;        /* current element we are printing */
+  int ecnt;            /* number of elements we have printed so far */
+  int ii,              /* looping */
+      err;             /* has an error occurred? */
+
+  if ((size != 1) && (size != 2) && (size != 4) && (size != 8))
+    return (-1);
+
+  end = buf + bytes;
+  ecnt = 0;
+
+  lptr = line + sprintf(line, "%08lX:  ", addr);
+
+  for (bufptr = buf; (bufptr + size) <= end; bufptr += size)
+  {
+    if (fptr->delim == 'x')
+    {
+      /*
+       * Little endian - most significant byte comes last
+       */
+      for (ii = size - 1; ii >= 0; --ii)
+      {
+        *lptr++ = HexDigits[bufptr[ii] >> 4];
+        *lptr++ = HexDigits[bufptr[ii] & 0x0F];
+      }
+
+      *lptr++ = ' ';
+    }
+    else
+    {
+      err = 0;
+      element = GetMemoryValue(bufptr, size, &err);
+      if (err)
+        return (-1);
+
+      lptr += sprintf(lptr, fptr->fmt, element);
+    }
+
+    ++ecnt;
+  }
+
+  if (ecnt < fptr->epl)
+  {
+    /*
+     * We have partially completed the last line - fill the
+     * rest up with spaces so we can line our ascii printout
+     * up correctly.
+     */
+    ii = (fptr->epl - ecnt) * (fptr->cpe + 1);
+    memset(lptr, ' ', (size_t) ii);
+    lptr += ii;
+  }
+
+  memcpy(lptr, "   ", 3);
+  lptr += 3;
+
+  /*
+   * Output the ascii equivalent of the bytes we just
+   * printed
+   */
+  for (ii = 0; ii < (ecnt * size); ++ii)
+  {
+    if ((buf[ii] >= ' ') && (buf[ii] < 127))
+      *lptr++ = (char) buf[ii];
+    else
+      *lptr++ = '.';
+  }
+
+  *lptr++ = '\n';
+
+  return ((long) (lptr - line));
+} /* FormatMemoryLine() */
+
+/*
+OutputMemoryLine()
+  Add one line of a memory dump to a block of output, writing the
+block out first if the line will not fit
+
+Inputs: ws    - main workspace
+        fptr  - output format
+        buf   - buffer containing bytes of memory for this line
+        addr  - address of first byte in buf
+        bytes - number of bytes in buf
+        size  - size of each element in buf
+        block - output block (MEM_BLOCKSIZE bytes)
+        used  - number of bytes used in block - updated
+
+Return: 1 if successful
+        0 if the element size is not supported
+*/
+
+static int
+OutputMemoryLine(struct aldWorkspace *ws, struct MemFormat *fptr,
+                 unsigned char *buf, unsigned long addr, long bytes,
+                 long size, char *block, long *used)
+
+{
+  long len;
+
+  if ((*used + MEM_MAXLINE) > MEM_BLOCKSIZE)
+  {
+    PrintBlock(ws, P_MEMORY, block, *used);
+    *used = 0;
+  }
+
+  len = FormatMemoryLine(fptr, buf, addr, bytes, size, block + *used);
+  if (len < 0)
+  {
+    /*
+     * Should not happen
+     */
+    PrintBlock(ws, P_MEMORY, block, *used);
+    *used = 0;
+
+    Print(ws,
+          P_ERROR,
+          "OutputMemory: currently only sizes of 1, 2, 4 or 8 bytes are supported");
+    return (0);
+  }
+
+  *used += len;
+
+  return (1);
+} /* OutputMemoryLine() */
+
 /*
 OutputMemory()
   Output a memory dump in a readable format
@@ -276,26 +446,18 @@ OutputMemory(struct aldWorkspace *ws, unsigned char *buf,
              unsigned char output)
 
 {
-  unsigned char *bufptr;
-  long element;        /* current element we are printing */
-  unsigned char *end;
   struct MemFormat *fptr;
-  unsigned long addr;  /* current address we are printing */
-  char abuf[MAXLINE];  /* ascii buffer */
-  char *aptr;
-  int ecnt;            /* number of elements we have printed so far */
-  int extranl;
-  int ii,              /* looping */
-      err;             /* has an error occurred? */
-#if 0
-  int ascii;           /* set to 1 if we should print ascii */
-#endif
+  char block[MEM_BLOCKSIZE];
+  long used;           /* bytes used in block */
+  long linesize;       /* number of bytes per line */
+  long offset;         /* offset of current line in buf */
+  long len;
 
   fptr = GetOutputFormat(output, size);
   assert(fptr != 0);
 
-  end = buf + bytes;
-  bufptr = buf;
+  linesize = fptr->epl * size;
+  used = 0;
 
   startPrintBurst(ws->printWorkspace_p);
 
@@ -306,118 +468,98 @@ OutputMemory(struct aldWorkspace *ws, unsigned char *buf,
         start,
         fptr->desc);
 
-  ecnt = 0;
-  addr = start;
-  aptr = abuf;
-  extranl = 1;
+  for (offset = 0; offset < bytes; offset += linesize)
+  {
+    len = bytes - offset;
+    if (len > linesize)
+      len = linesize;
 
-  /*
-   * There is little point in printing ascii characters if our
-   * elements are more than 1 byte.
-   */
-#if 0
-  if (size != 1)
-    ascii = 0;
-  else
-    ascii = 1;
-#endif
+    if (!OutputMemoryLine(ws, fptr, buf + offset, start + offset, len, size,
+                          block, &used))
+      break;
+  }
+
+  if (used)
+    PrintBlock(ws, P_MEMORY, block, used);
+
+  endPrintBurst(ws->printWorkspace_p);
+} /* OutputMemory() */
+
+/*
+OutputChangedMemory()
+  Output only those lines of a memory dump which differ from a
+previous copy of the same memory
+
+Inputs: ws        - main workspace
+        buf       - buffer containing bytes of memory
+        prev      - previous contents of the same memory
+        prevbytes - number of bytes in 'prev'
+        start     - address of first byte in memory
+        bytes     - number of bytes in 'buf'
+        size      - size of each element in 'buf'
+        output    - output format (hex, dec, etc)
+
+Return: number of lines output
+*/
 
-  RawPrint(ws, P_MEMORY, "%08lX:  ", start);
+long
+OutputChangedMemory(struct aldWorkspace *ws, unsigned char *buf,
+                    unsigned char *prev, long prevbytes,
+                    unsigned long start, long bytes, long size,
+                    unsigned char output)
 
-  while (bufptr < end)
+{
+  struct MemFormat *fptr;
+  char block[MEM_BLOCKSIZE];
+  long used;           /* bytes used in block */
+  long linesize;       /* number of bytes per line */
+  long offset;         /* offset of current line in buf */
+  long len;
+  long lines;          /* number of lines output */
+
+  fptr = GetOutputFormat(output, size);
+  assert(fptr != 0);
+
+  linesize = fptr->epl * size;
+  lines = 0;
+  used = 0;
+
+  for (offset = 0; offset < bytes; offset += linesize)
   {
-    err = 0;
-    element = GetMemoryValue(bufptr, size, &err);
-    if (err)
-    {
-      /*
-       * Should not happen
-       */
-      Print(ws,
-            P_ERROR,
-            "OutputMemory: currently only sizes of 1, 2, or 4 bytes are supported");
-      endPrintBurst(ws->printWorkspace_p);
-      return;
-    }
+    len = bytes - offset;
+    if (len > linesize)
+      len = linesize;
 
     /*
-     * Print the current element with it's correct formatting
+     * memcmp() compares a word (or more) at a time, so unchanged
+     * lines are cheap to skip
      */
-    RawPrint(ws, P_MEMORY, fptr->fmt, element);
+    if ((offset + len <= prevbytes) &&
+        (memcmp(buf + offset, prev + offset, (size_t) len) == 0))
+      continue;
 
-    addr += size;
-
-#if 0
-    if (ascii)
+    if (lines++ == 0)
     {
-#endif
-      /*
-       * Keep our ascii buffer updated, as well as advance bufptr
-       * by 'size' bytes
-       */
-      for (ii = 0; ii < size; ++ii)
-        *aptr++ = *bufptr++;
-#if 0
-    }
-    else
-      bufptr += size;
-#endif
-
-    if ((++ecnt == fptr->epl) || (bufptr >= end))
-    {
-    #if 0
-      if (ascii)
-      {
-    #endif
-        if (bufptr >= end)
-        {
-          /*
-           * We have partially completed the last line - fill the
-           * rest up with spaces so we can line our ascii printout
-           * up correctly.
-           */
-          RawPrint(ws,
-                   P_MEMORY,
-                   "%*s",
-                   (fptr->epl - ecnt) * (fptr->cpe + 1),
-                   "");
-        }
-
-        RawPrint(ws, P_MEMORY, "   ");
-
-        /*
-         * Output the ascii equivalent of the bytes we just
-         * printed
-         */
-        aptr = abuf;
-        /*for (ii = 0; ii < ecnt; ++ii)*/
-        for (ii = 0; ii < (ecnt * size); ++ii)
-        {
-          if ((*(aptr + ii) >= ' ') && (*(aptr + ii) < 127))
-            RawPrint(ws, P_MEMORY, "%c", (unsigned char) *(aptr + ii));
-          else
-            RawPrint(ws, P_MEMORY, "%c", '.');
-        }
-    #if 0
-      } /* if (ascii) */
-    #endif
-
-      /*
-       * We have reached the last element in the line so output
-       * a newline character and continue
-       */
-      RawPrint(ws, P_MEMORY, "\n");
-      if (bufptr < end)
-        RawPrint(ws, P_MEMORY, "%08lX:  ", addr);
-      else
-        extranl = 0;
+      startPrintBurst(ws->printWorkspace_p);
 
-      ecnt = 0;
+      Print(ws,
+            P_MEMORY,
+            "Changes in %ld bytes of memory starting at 0x%08lX in %s",
+            bytes,
+            start,
+            fptr->desc);
     }
+
+    if (!OutputMemoryLine(ws, fptr, buf + offset, start + offset, len, size,
+                          block, &used))
+      break;
   }
 
-  if (extranl)
-    RawPrint(ws, P_MEMORY, "\n");
+  if (used)
+    PrintBlock(ws, P_MEMORY, block, used);
 
-  endPrintBurst(ws->printWorkspace_p);
-} /* OutputMemory() */
+  if (lines)
+    endPrintBurst(ws->printWorkspace_p);
+
+  return (lines);
+} /* OutputChangedMemory() */
@@ -16,6 +16,7 @@
 #include <stdarg.h>
 
 #include "alddefs.h"
+#include "blocks.h"
 #include "config.h"
 #include "defs.h"
 #include "load.h"
@@ -34,6 +35,15 @@ endProcess(struct aldWorkspace *ws)
 
 {
   awClearAttached(ws);
+
+  /*
+   * Report block coverage of the run which just ended
+   */
+  if (ws->debugWorkspace_p->coverage.count)
+  {
+    reportCoverage(ws);
+    clearCoverage(ws->debugWorkspace_p);
+  }
 } /* endProcess() */
 
 /*
@@ -18,6 +18,7 @@
 #include <string.h>
 #include <setjmp.h>
 #include <signal.h>
+#include <unistd.h>
 
 #include "alddefs.h"
 #include "command.h"
@@ -31,6 +32,10 @@
  */
 #include "Strn.h"
 
+static void PrintOutput(struct printWorkspace *ws, const char *buf,
+                        long len);
+static void PrintPause(struct aldWorkspace *main_p);
+
 /*
 initPrint()
   Initialize a print workspace
@@ -60,6 +65,18 @@ initPrint()
   ws->file_p = 0;
   ws->filename = 0;
 
+  /*
+   * There is nobody to answer a pause prompt when output goes to a
+   * pipe or a file, so print bursts never pause in that case
+   */
+  ws->IsTTY = isatty(STDOUT_FILENO);
+
+  /*
+   * If this fails, output is simply not buffered
+   */
+  ws->OutBuf = (char *) malloc(PRINT_BUFSIZE);
+  ws->OutLen = 0;
+
   return (ws);
 } /* initPrint() */
 
@@ -85,6 +102,9 @@ termPrint(struct printWorkspace *ws)
   if (ws->filename)
     free(ws->filename);
 
+  if (ws->OutBuf)
+    free(ws->OutBuf);
+
   free(ws);
 } /* termPrint() */
 
@@ -93,14 +113,17 @@ startPrintBurst()
   This function should be called when we are about to print a lot
 of lines of information. It will set up the necessary variables to
 pause the printing when a pageful of information has been printed,
-so the user can decide whether to continue or stop.
+so the user can decide whether to continue or stop. Output is
+buffered until the burst ends or the screen fills up.
 */
 
 void
 startPrintBurst(struct printWorkspace *ws)
 
 {
-  if (ws->PausePrint)
+  ws->Buffering = 1;
+
+  if (ws->PausePrint && ws->IsTTY)
   {
     ws->PrintBurst = 1;
     ws->PrintLineCnt = 0;
@@ -117,8 +140,71 @@ endPrintBurst(struct printWorkspace *ws)
 
 {
   ws->PrintBurst = 0;
+  ws->Buffering = 0;
+
+  flushPrint(ws);
 } /* endPrintBurst() */
 
+/*
+flushPrint()
+  Write out any buffered output
+
+Inputs: ws - print workspace
+*/
+
+void
+flushPrint(struct printWorkspace *ws)
+
+{
+  if (ws->OutLen)
+  {
+    fwrite(ws->OutBuf, sizeof(char), (size_t) ws->OutLen, stdout);
+
+    if (ws->file_p)
+      fwrite(ws->OutBuf, sizeof(char), (size_t) ws->OutLen, ws->file_p);
+
+    ws->OutLen = 0;
+  }
+
+  fflush(stdout);
+
+  if (ws->file_p)
+    fflush(ws->file_p);
+} /* flushPrint() */
+
+/*
+PrintOutput()
+  Send formatted output to stdout and the "set output" file, or
+to the output buffer during a print burst
+
+Inputs: ws  - print workspace
+        buf - output
+        len - length of buf
+*/
+
+static void
+PrintOutput(struct printWorkspace *ws, const char *buf, long len)
+
+{
+  if (ws->Buffering && ws->OutBuf)
+  {
+    if ((ws->OutLen + len) > PRINT_BUFSIZE)
+      flushPrint(ws);
+
+    if (len <= PRINT_BUFSIZE)
+    {
+      memcpy(ws->OutBuf + ws->OutLen, buf, (size_t) len);
+      ws->OutLen += len;
+      return;
+    }
+  }
+
+  fwrite(buf, sizeof(char), (size_t) len, stdout);
+
+  if (ws->file_p)
+    fwrite(buf, sizeof(char), (size_t) len, ws->file_p);
+} /* PrintOutput() */
+
 /*
 Print()
  Print the specified string to the appropriate window
@@ -181,67 +267,154 @@ PrintWindow(struct aldWorkspace *main_p, int raw,
 
 {
   struct printWorkspace *printWorkspace_p = main_p->printWorkspace_p;
-  char rawbuf[MAXLINE]; /* raw buffer (format + args) */
-  int rawlen;           /* length of raw buffer */
+  char rawbuf[MAXLINE + 1]; /* raw buffer (format + args + \n) */
+  int rawlen;               /* length of raw buffer */
+  int newline;              /* does rawbuf contain a \n? */
 
 /*  rawlen = vsprintf(rawbuf, format, args); */
-  rawlen = vSnprintf(rawbuf, sizeof(rawbuf), (char *) format, args);
+  rawlen = vSnprintf(rawbuf, MAXLINE, (char *) format, args);
+
+  if (raw)
+    newline = (strchr(rawbuf, '\n') != 0);
+  else
+  {
+    rawbuf[rawlen++] = '\n';
+    newline = 1;
+  }
 
   /*
    * We are in console mode - just print it to stdout
    */
-  fwrite(rawbuf, sizeof(char), rawlen, stdout);
-  if (!raw)
-    fputc((unsigned char) '\n', stdout);
-  else
-    fflush(stdout);
+  PrintOutput(printWorkspace_p, rawbuf, rawlen);
 
-  if (printWorkspace_p->file_p)
-  {
-    fwrite(rawbuf, sizeof(char), rawlen, printWorkspace_p->file_p);
-    if (!raw)
-      fputc((unsigned char) '\n', printWorkspace_p->file_p);
-    else
-      fflush(printWorkspace_p->file_p);
-  }
+  /*
+   * Partial lines are usually prompts, so make sure they are seen,
+   * unless a burst is in progress and more output is on its way
+   */
+  if (raw && !printWorkspace_p->Buffering)
+    flushPrint(printWorkspace_p);
 
   if (printWorkspace_p->PrintBurst)
   {
-    if (raw)
-    {
-      if (strchr(rawbuf, '\n'))
-        ++(printWorkspace_p->PrintLineCnt);
-    }
-    else
+    if (newline)
       ++(printWorkspace_p->PrintLineCnt);
 
     if (printWorkspace_p->PrintLineCnt ==
         (unsigned long) (main_p->terminalWorkspace_p->LinesPerPage - 1))
-    {
-      char str[MAXLINE];
+      PrintPause(main_p);
+  } /* if (printWorkspace_p->PrintBurst) */
+} /* PrintWindow() */
+
+/*
+PrintBlock()
+  Print a block of lines which have already been formatted, such as
+a memory dump. The block is written with as few calls as possible,
+stopping only to pause after each pageful during a print burst.
+
+Inputs: main_p - main workspace
+        flags  - for curses mode, to specify what window to print to
+        buf    - lines to print, each terminated by \n
+        len    - length of buf
+
+Return: none
+*/
+
+void
+PrintBlock(struct aldWorkspace *main_p, int flags, const char *buf, long len)
 
+{
+  struct printWorkspace *printWorkspace_p = main_p->printWorkspace_p;
+  const char *end,
+             *ptr,
+             *nl;
+  int pause;
+
+  end = buf + len;
+
+  while (buf < end)
+  {
+    ptr = end;
+    pause = 0;
+
+    if (printWorkspace_p->PrintBurst)
+    {
       /*
-       * We have filled up the screen, so pause and let the user
-       * hit a key to continue
+       * Write up to the line which fills the screen
        */
-      fprintf(stdout, "Hit <return> to continue, or <q> to quit");
-
-      fgets(str, MAXLINE, stdin);
-      if (*str == 'q')
-      {
-        /*
-         * They want to stop printing - cleanup and simulate a SIGINT
-         */
-        printWorkspace_p->PrintBurst = 0;
-        longjmp(main_p->commandWorkspace_p->CmdParserEnv, SIGINT);
-      }
-      else
+      for (ptr = buf; ptr < end; )
       {
-        /*
-         * They want to continue printing
-         */
-        printWorkspace_p->PrintLineCnt = 0;
+        nl = (const char *) memchr(ptr, '\n', (size_t) (end - ptr));
+        if (!nl)
+        {
+          ptr = end;
+          break;
+        }
+
+        ptr = nl + 1;
+
+        if (++(printWorkspace_p->PrintLineCnt) ==
+            (unsigned long) (main_p->terminalWorkspace_p->LinesPerPage - 1))
+        {
+          pause = 1;
+          break;
+        }
       }
     }
-  } /* if (printWorkspace_p->PrintBurst) */
-} /* PrintWindow() */
+
+    PrintOutput(printWorkspace_p, buf, (long) (ptr - buf));
+
+    buf = ptr;
+
+    if (pause)
+      PrintPause(main_p);
+  }
+
+  if (!printWorkspace_p->Buffering)
+    flushPrint(printWorkspace_p);
+} /* PrintBlock() */
+
+/*
+PrintPause()
+  Called when a print burst has filled the screen - wait for the
+user to ask for more, or abort the command if they have seen enough
+
+Inputs: main_p - main workspace
+
+Return: none (does not return if the user quits)
+*/
+
+static void
+PrintPause(struct aldWorkspace *main_p)
+
+{
+  struct printWorkspace *printWorkspace_p = main_p->printWorkspace_p;
+  char str[MAXLINE];
+
+  /*
+   * The screen is full, so show what has been buffered so far
+   */
+  flushPrint(printWorkspace_p);
+
+  /*
+   * We have filled up the screen, so pause and let the user
+   * hit a key to continue
+   */
+  fprintf(stdout, "Hit <return> to continue, or <q> to quit");
+  fflush(stdout);
+
+  if (!fgets(str, MAXLINE, stdin) || (*str == 'q'))
+  {
+    /*
+     * They want to stop printing - cleanup and simulate a SIGINT
+     */
+    printWorkspace_p->PrintBurst = 0;
+    longjmp(main_p->commandWorkspace_p->CmdParserEnv, SIGINT);
+  }
+  else
+  {
+    /*
+     * They want to continue printing
+     */
+    printWorkspace_p->PrintLineCnt = 0;
+  }
+} /* PrintPause() */
@@ -21,10 +21,13 @@
 
 #include "alddefs.h"
 #include "command.h"
+#include "display.h"
 #include "rc.h"
 #include "set.h"
 #include "version.h"
 
+#include "libDebug.h"
+
 /*
  * libString includes
  */
@@ -182,6 +185,12 @@ writeRC(struct aldWorkspace *ws)
   fprintf(fp,
           "# Generated by ald %s. Do not edit.\n",
           aVersion);
+  fprintf(fp,
+          "set capture-output %s\n",
+          IsSetCaptureOutput(ws) ? "on" : "off");
+  fprintf(fp,
+          "set catch-log %s\n",
+          ws->debugWorkspace_p->catch.log ? "on" : "off");
   fprintf(fp,
           "set disasm-show-syms %s\n",
           IsSetDisasmShowSyms(ws) ? "on" : "off");
@@ -191,6 +200,12 @@ writeRC(struct aldWorkspace *ws)
   fprintf(fp,
           "set prompt \"%s\"\n",
           ws->commandWorkspace_p->CmdPrompt);
+  fprintf(fp,
+          "set record-size %lu\n",
+          ws->debugWorkspace_p->record.size);
+  fprintf(fp,
+          "set record %s\n",
+          ws->debugWorkspace_p->record.enabled ? "on" : "off");
   fprintf(fp,
           "set step-display-regs %s\n",
           IsSetStepDisplayRegs(ws) ? "on" : "off");
@@ -200,6 +215,16 @@ writeRC(struct aldWorkspace *ws)
   fprintf(fp,
           "set step-display-mmxregs %s\n",
           IsSetStepDisplayMmxRegs(ws) ? "on" : "off");
+  fprintf(fp,
+          "set step-display-mode %s\n",
+          (ws->stepDisplayMode == STEPDISP_CHANGED) ? "changed" :
+          (ws->stepDisplayMode == STEPDISP_NONE) ? "none" : "full");
+  fprintf(fp,
+          "set step-granularity %s\n",
+          IsSetStepBlock(ws) ? "block" : "instruction");
+  fprintf(fp,
+          "set trace-size %lu\n",
+          ws->debugWorkspace_p->trace.size);
 
   fclose(fp);
 
@@ -12,6 +12,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include <assert.h>
 #include <errno.h>
@@ -33,6 +34,7 @@
 
 static void displayRegsNormalCallback(struct debugRegisterInfo *regInfo, void *args);
 static void displayRegsCompactCallback(struct debugRegisterInfo *regInfo, void *args);
+static void displayRegsChangedCallback(struct debugRegisterInfo *regInfo, void *args);
 
 /*
 displayRegisters()
@@ -109,6 +111,96 @@ displayRegisters(struct aldWorkspace *ws, int regindex, int compact, unsigned in
   }
 } /* displayRegisters() */
 
+/*
+displayChangedRegisters()
+  Display, in compact form, those registers whose contents have
+changed since the last time this function was called. The first
+time a register class is displayed, all of its registers are shown.
+
+Inputs: ws   - main workspace
+        flgs - register classes to consider (DB_REGFL_xxx)
+
+Return: none
+*/
+
+void
+displayChangedRegisters(struct aldWorkspace *ws, unsigned int flgs)
+
+{
+  static unsigned int classFlags[] = {
+    DB_REGFL_DISPLAY_GENERAL,     /* SNAP_GENERAL */
+    DB_REGFL_DISPLAY_FPREGS,      /* SNAP_FPU */
+    DB_REGFL_DISPLAY_MMXREGS      /* SNAP_MMX */
+  };
+  struct callbackArgs displayArgs;
+  struct registerSnapshot *snap;
+  char flags[MAXLINE];
+  int ret;
+  int ii;
+
+  snap = ws->stepRegisters;
+  if (!snap)
+  {
+    snap = (struct registerSnapshot *) malloc(sizeof(struct registerSnapshot));
+    if (!snap)
+    {
+      displayRegisters(ws, NOREG, 1, flgs);
+      return;
+    }
+
+    memset(snap, '\0', sizeof(struct registerSnapshot));
+    ws->stepRegisters = snap;
+  }
+
+  displayArgs.main_p = ws;
+  displayArgs.regcount = 0;
+  displayArgs.snapshot = snap;
+  displayArgs.flagschanged = 0;
+
+  for (ii = 0; ii < SNAP_CLASSES; ++ii)
+  {
+    if (!(flgs & classFlags[ii]))
+    {
+      /*
+       * Not displayed - show the whole class again if it is
+       * turned back on later
+       */
+      snap->valid[ii] = 0;
+      continue;
+    }
+
+    displayArgs.snapclass = ii;
+    displayArgs.snapindex = 0;
+
+    ret = printRegistersDebug(ws->debugWorkspace_p,
+                              NOREG,
+                              classFlags[ii],
+                              displayRegsChangedCallback,
+                              (void *) &displayArgs);
+
+    if (ret == 0)
+    {
+      /*
+       * ptrace error
+       */
+      Print(ws, P_ERROR, MSG_PTERR, strerror(errno));
+      return;
+    }
+
+    snap->valid[ii] = 1;
+  }
+
+  if (displayArgs.regcount != 0)
+    RawPrint(ws, P_REGISTER, "\n");
+
+  if (displayArgs.flagschanged)
+  {
+    ret = getFlagsDebug(ws->debugWorkspace_p, flags);
+    if (ret)
+      Print(ws, P_COMMAND, "Flags: %s", flags);
+  }
+} /* displayChangedRegisters() */
+
 /*
 displayRegsNormalCallback()
   This function is called from getRegistersCallbackDebug() with the name and
@@ -257,3 +349,68 @@ displayRegsCompactCallback(struct debugRegisterInfo *regInfo, void *args)
     cargs->regcount = 0;
   }
 } /* displayRegsCompactCallback() */
+
+/*
+displayRegsChangedCallback()
+  This function is called from printRegistersDebug() with the name and
+contents of a specific register - compare it with the snapshot and, if
+it changed, record the new value and output it in compact form
+
+Inputs: regInfo - register information
+        args    - callback arguments
+
+Return: none
+*/
+
+static void
+displayRegsChangedCallback(struct debugRegisterInfo *regInfo, void *args)
+
+{
+  struct callbackArgs *cargs = (struct callbackArgs *) args;
+  struct registerSnapshot *snap = cargs->snapshot;
+  int cls = cargs->snapclass;
+  int idx;
+  int changed;
+  size_t len;
+
+  if (regInfo->flags & DB_RI_BREAK)
+    return;
+
+  idx = cargs->snapindex++;
+  if (idx >= SNAP_MAXREGS)
+  {
+    /*
+     * No room to remember it - always display
+     */
+    displayRegsCompactCallback(regInfo, args);
+    return;
+  }
+
+  if (regInfo->flags & (DB_RI_FPU_DATA | DB_RI_MMX))
+  {
+    changed = !snap->valid[cls] ||
+              strcmp(snap->hexvalues[cls][idx], regInfo->hexvalue);
+    if (changed)
+    {
+      len = strlen(regInfo->hexvalue);
+      if (len > SNAP_HEXLEN - 1)
+        len = SNAP_HEXLEN - 1;
+
+      memcpy(snap->hexvalues[cls][idx], regInfo->hexvalue, len);
+      snap->hexvalues[cls][idx][len] = '\0';
+    }
+  }
+  else
+  {
+    changed = !snap->valid[cls] || (snap->values[cls][idx] != regInfo->value);
+    snap->values[cls][idx] = regInfo->value;
+  }
+
+  if (!changed)
+    return;
+
+  if ((cls == SNAP_GENERAL) && !strcmp(regInfo->name, "eflags"))
+    cargs->flagschanged = 1;
+
+  displayRegsCompactCallback(regInfo, args);
+} /* displayRegsChangedCallback() */
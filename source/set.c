@@ -17,6 +17,7 @@
 
 #include "alddefs.h"
 #include "command.h"
+#include "display.h"
 #include "load.h"
 #include "main.h"
 #include "misc.h"
@@ -33,6 +34,10 @@
 
 static int setArgs(struct aldWorkspace *ws, int ac, char **av,
                    unsigned int pwin, char *str);
+static int setCaptureOutput(struct aldWorkspace *ws, int ac, char **av,
+                            unsigned int pwin, char *str);
+static int setCatchLogging(struct aldWorkspace *ws, int ac, char **av,
+                           unsigned int pwin, char *str);
 static int setDisasmShowSyms(struct aldWorkspace *ws, int ac, char **av,
                              unsigned int pwin, char *str);
 static int setEntryPoint(struct aldWorkspace *ws, int ac, char **av,
@@ -45,15 +50,27 @@ static int setPausePrint(struct aldWorkspace *ws, int ac, char **av, unsigned in
                          char *str);
 static int setPrompt(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
                      char *str);
+static int setRecordHistory(struct aldWorkspace *ws, int ac, char **av,
+                            unsigned int pwin, char *str);
+static int setRecordHistorySize(struct aldWorkspace *ws, int ac, char **av,
+                                unsigned int pwin, char *str);
 static int setStepDisplayRegs(struct aldWorkspace *ws, int ac, char **av,
                                unsigned int pwin, char *str);
 static int setStepDisplayFpRegs(struct aldWorkspace *ws, int ac, char **av,
                                  unsigned int pwin, char *str);
 static int setStepDisplayMmxRegs(struct aldWorkspace *ws, int ac, char **av,
                                   unsigned int pwin, char *str);
+static int setStepDisplayMode(struct aldWorkspace *ws, int ac, char **av,
+                              unsigned int pwin, char *str);
+static int setStepGranularity(struct aldWorkspace *ws, int ac, char **av,
+                              unsigned int pwin, char *str);
+static int setTraceBufferSize(struct aldWorkspace *ws, int ac, char **av,
+                              unsigned int pwin, char *str);
 
 static struct Command setCmds[] = {
   { "args", setArgs, 0 },
+  { "capture-output", setCaptureOutput, 0 },
+  { "catch-log", setCatchLogging, 0 },
   { "disasm-show-syms", setDisasmShowSyms, 0 },
   { "entry-point", setEntryPoint, 0 },
   { "file-offset", setFileOffset, 0 },
@@ -61,23 +78,35 @@ static struct Command setCmds[] = {
   { "output", setOutput, 0 },
   { "pause-print", setPausePrint, 0 },
   { "prompt", setPrompt, 0 },
+  { "record", setRecordHistory, 0 },
+  { "record-size", setRecordHistorySize, 0 },
   { "step-display-regs", setStepDisplayRegs, 0 },
   { "step-display-fpregs", setStepDisplayFpRegs, 0 },
   { "step-display-mmxregs", setStepDisplayMmxRegs, 0 },
+  { "step-display-mode", setStepDisplayMode, 0 },
+  { "step-granularity", setStepGranularity, 0 },
+  { "trace-size", setTraceBufferSize, 0 },
   { 0, 0, 0 }
 };
 
 static char *setCmdsSyntax[] = {
   "",                                     /* SETSYN_ARGS */
+  "set capture-output <on | off>",        /* SETSYN_CAPTURE_OUTPUT */
+  "set catch-log <on | off>",             /* SETSYN_CATCH_LOG */
   "set disasm-show-syms <on | off>",      /* SETSYN_DISASM_SHOW_SYMS */
   "set entry-point <address>",            /* SETSYN_ENTRY */
   "set file-offset <address>",            /* SETSYN_OFFSET */
   "set output <filename>",                /* SETSYN_OUTPUT */
   "set pause-print <on | off>",           /* SETSYN_PAUSEPRINT */
   "set prompt <new prompt>",              /* SETSYN_PROMPT */
+  "set record <on | off>",                /* SETSYN_RECORD */
+  "set record-size <bytes>",              /* SETSYN_RECORD_SIZE */
   "set step-display-regs <on | off>",     /* SETSYN_STEP_DISP_REGS */
   "set step-display-fpregs <on | off>",   /* SETSYN_STEP_DISP_FPREGS */
-  "set step-display-mmxregs <on | off>"   /* SETSYN_STEP_DISP_MMXREGS */
+  "set step-display-mmxregs <on | off>",  /* SETSYN_STEP_DISP_MMXREGS */
+  "set step-display-mode <full | changed | none>", /* SETSYN_STEP_DISP_MODE */
+  "set step-granularity <instruction | block>",   /* SETSYN_STEP_GRANULARITY */
+  "set trace-size <bytes>"                /* SETSYN_TRACE_SIZE */
 };
 
 /*
@@ -171,6 +200,82 @@ setArgs(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
   return (2);
 } /* setArgs() */
 
+/*
+setCaptureOutput()
+  Capture the stdout and stderr of the debugged process instead of
+letting it write to the terminal. The captured output is displayed
+whenever the process stops, and is copied to the "set output" file
+if one is given. Takes effect the next time the process is started.
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setCaptureOutput(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
+                 char *str)
+
+{
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%s",
+            IsSetCaptureOutput(ws) ? "on" : "off");
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_CAPTURE_OUTPUT]);
+    return (1);
+  }
+
+  if (StrToBool(av[2]))
+    SetCaptureOutput(ws);
+  else
+    UnsetCaptureOutput(ws);
+
+  setRedirectDebug(ws->debugWorkspace_p, IsSetCaptureOutput(ws) ? 1 : 0);
+
+  return (2);
+} /* setCaptureOutput() */
+
+/*
+setCatchLogging()
+  Set whether caught system calls (see the "catch" command) stop the
+program, or are printed with their return values while the program
+keeps running
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setCatchLogging(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
+                char *str)
+
+{
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%s",
+            ws->debugWorkspace_p->catch.log ? "on" : "off");
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_CATCH_LOG]);
+    return (1);
+  }
+
+  setCatchLog(ws->debugWorkspace_p, StrToBool(av[2]) ? 1 : 0);
+
+  return (2);
+} /* setCatchLogging() */
+
 /*
 setDisasmShowSyms()
   Show symbols in disassembled output
@@ -328,9 +433,17 @@ setOutput(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
     return (0);
   }
 
+  /*
+   * Captured process output is written straight to the underlying
+   * descriptor, so do not let stdio hold on to our own lines
+   */
+  setvbuf(fp, 0, _IOLBF, 0);
+
   ws->printWorkspace_p->file_p = fp;
   ws->printWorkspace_p->filename = Strdup(av[2]);
 
+  setOutputLogDebug(ws->debugWorkspace_p, fileno(fp));
+
   return (2);
 } /* setOutput() */
 
@@ -402,6 +515,104 @@ setPrompt(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
   return (2);
 } /* setPrompt() */
 
+/*
+setRecordHistory()
+  Record what each instruction run by "step" and "next" changes,
+so "rstep" and "rcontinue" can go back through it
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setRecordHistory(struct aldWorkspace *ws, int ac, char **av,
+                 unsigned int pwin, char *str)
+
+{
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%s",
+            ws->debugWorkspace_p->record.enabled ? "on" : "off");
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_RECORD]);
+    return (1);
+  }
+
+  if (!setRecord(ws->debugWorkspace_p, StrToBool(av[2])))
+  {
+    Sprintf(str,
+            "Unable to allocate history buffer: %s",
+            strerror(errno));
+    return (0);
+  }
+
+  return (2);
+} /* setRecordHistory() */
+
+/*
+setRecordHistorySize()
+  Set the most memory used to record execution history - the oldest
+instructions are forgotten to stay within it
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setRecordHistorySize(struct aldWorkspace *ws, int ac, char **av,
+                     unsigned int pwin, char *str)
+
+{
+  unsigned long size;
+  char *endptr;
+
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%lu",
+            ws->debugWorkspace_p->record.size);
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_RECORD_SIZE]);
+    return (1);
+  }
+
+  size = strtoul(av[2], &endptr, 0);
+  if ((endptr == av[2]) || (*endptr != '\0'))
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_RECORD_SIZE]);
+    return (1);
+  }
+
+  if (size < RECORD_MINSIZE)
+  {
+    Sprintf(str,
+            "History buffer must be at least %d bytes",
+            RECORD_MINSIZE);
+    return (0);
+  }
+
+  if (!setRecordSize(ws->debugWorkspace_p, size))
+  {
+    Sprintf(str,
+            "Unable to allocate history buffer: %s",
+            strerror(errno));
+    return (0);
+  }
+
+  return (2);
+} /* setRecordHistorySize() */
+
 /*
 setStepDisplayRegs()
   Display register contents after a single step
@@ -527,3 +738,163 @@ setStepDisplayMmxRegs(struct aldWorkspace *ws, int ac, char **av, unsigned int p
 
   return (2);
 } /* setStepDisplayMmxRegs() */
+
+/*
+setStepDisplayMode()
+  Choose what is displayed each time the program stops: all selected
+registers and memory, only those which changed, or nothing but the
+next instruction
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setStepDisplayMode(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
+                   char *str)
+
+{
+  static char *modes[] = {
+    "full",           /* STEPDISP_FULL */
+    "changed",        /* STEPDISP_CHANGED */
+    "none"            /* STEPDISP_NONE */
+  };
+  unsigned int ii;
+
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%s",
+            modes[ws->stepDisplayMode]);
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_STEP_DISP_MODE]);
+    return (1);
+  }
+
+  for (ii = 0; ii < sizeof(modes) / sizeof(modes[0]); ++ii)
+  {
+    if (!Strcasecmp(av[2], modes[ii]))
+      break;
+  }
+
+  if (ii == sizeof(modes) / sizeof(modes[0]))
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_STEP_DISP_MODE]);
+    return (1);
+  }
+
+  /*
+   * Start comparing afresh from the next display
+   */
+  if (ii != ws->stepDisplayMode)
+    resetStepDisplay(ws);
+
+  ws->stepDisplayMode = ii;
+
+  return (2);
+} /* setStepDisplayMode() */
+
+/*
+setStepGranularity()
+  Choose whether "step" advances one instruction or one basic
+block at a time
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setStepGranularity(struct aldWorkspace *ws, int ac, char **av, unsigned int pwin,
+                   char *str)
+
+{
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%s",
+            IsSetStepBlock(ws) ? "block" : "instruction");
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_STEP_GRANULARITY]);
+    return (1);
+  }
+
+  if (!Strcasecmp(av[2], "block"))
+    SetStepBlock(ws);
+  else if (!Strcasecmp(av[2], "instruction"))
+    UnsetStepBlock(ws);
+  else
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_STEP_GRANULARITY]);
+    return (1);
+  }
+
+  return (2);
+} /* setStepGranularity() */
+
+/*
+setTraceBufferSize()
+  Set the size of the buffer holding the frames collected by
+tracepoints - the oldest frames are discarded to stay within it
+
+Return: 0 upon failure (error goes in str)
+        1 upon syntax error (syntax goes in str)
+        2 upon success
+*/
+
+static int
+setTraceBufferSize(struct aldWorkspace *ws, int ac, char **av,
+                   unsigned int pwin, char *str)
+
+{
+  unsigned long size;
+  char *endptr;
+
+  if (pwin != 0)
+  {
+    Sprintf(str,
+            "%lu",
+            ws->debugWorkspace_p->trace.size);
+    return (2);
+  }
+
+  if (ac < 3)
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_TRACE_SIZE]);
+    return (1);
+  }
+
+  size = strtoul(av[2], &endptr, 0);
+  if ((endptr == av[2]) || (*endptr != '\0'))
+  {
+    Sprintf(str, "%s", setCmdsSyntax[SETSYN_TRACE_SIZE]);
+    return (1);
+  }
+
+  if (size < TRACE_MINSIZE)
+  {
+    Sprintf(str,
+            "Trace buffer must be at least %d bytes",
+            TRACE_MINSIZE);
+    return (0);
+  }
+
+  if (!setTraceSize(ws->debugWorkspace_p, size))
+  {
+    Sprintf(str,
+            "Unable to allocate trace buffer: %s",
+            strerror(errno));
+    return (0);
+  }
+
+  return (2);
+} /* setTraceBufferSize() */
@@ -12,12 +12,23 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <signal.h>
 #include <setjmp.h>
 
 #include "command.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
 #include "signals.h"
 
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
 struct aSignal Signals[] = {
   { "0",          "Signal 0" },                          /**/
   { "SIGHUP",     "Hangup" },                            /* 1 */
@@ -51,6 +62,8 @@ struct aSignal Signals[] = {
   { "SIGLOST",    "Resource lost" },                     /* 29 */
   { "SIGUSR1",    "User defined signal 1" },             /* 30 */
   { "SIGUSR2",    "User defined signal 2" },             /* 31 */
+  { "SIGPWR",     "Power failure" },                     /* 32 */
+  { "SIGPOLL",    "Pollable event" },                    /* 33 */
 };
 
 /*
@@ -237,6 +250,94 @@ GetSignal(int signum)
   return (0);
 } /* GetSignal() */
 
+/*
+FindSignal()
+  Find a signal by name or number
+
+Inputs: name - signal name, with or without the SIG prefix, or
+               number
+
+Return: signal number
+        0 if not found
+*/
+
+int
+FindSignal(char *name)
+
+{
+  struct aSignal *sptr;
+  char *endptr;
+  int signum;
+
+  signum = (int) strtol(name, &endptr, 0);
+  if ((endptr != name) && (*endptr == '\0'))
+  {
+    if ((signum <= 0) || (signum >= SP_MAXSIG))
+      return (0);
+
+    return (signum);
+  }
+
+  for (signum = 1; signum < SP_MAXSIG; ++signum)
+  {
+    sptr = GetSignal(signum);
+    if (!sptr)
+      continue;
+
+    if (!Strcasecmp(sptr->name, name) ||
+        !Strcasecmp(sptr->name + 3, name))
+      return (signum);
+  }
+
+  return (0);
+} /* FindSignal() */
+
+/*
+NotifySignal()
+  Called by libDebug when the program receives a signal it is not
+stopped for, if the signal is to be printed
+
+Inputs: args - ald workspace
+        sig  - signal number
+*/
+
+void
+NotifySignal(void *args, int sig)
+
+{
+  struct aldWorkspace *ws;
+  struct aSignal *sptr;
+  char *passed;
+
+  ws = (struct aldWorkspace *) args;
+
+  if (getSignalPolicy(ws->debugWorkspace_p, sig) & SP_PASS)
+    passed = "passed";
+  else
+    passed = "not passed";
+
+  sptr = GetSignal(sig);
+  if (sptr)
+  {
+    Print(ws,
+          P_COMMAND,
+          MSG_PASSSIGNAL,
+          sptr->name,
+          sptr->desc,
+          getAddressDebug(ws->debugWorkspace_p),
+          passed);
+  }
+  else
+  {
+    Print(ws,
+          P_COMMAND,
+          MSG_PASSUNKNOWNSIG,
+          sig,
+          getAddressDebug(ws->debugWorkspace_p),
+          passed);
+  }
+} /* NotifySignal() */
+
 /*
 SetupSignals()
   Setup various signal handlers for the debugger on startup
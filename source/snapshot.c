@@ -0,0 +1,344 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module saves copies of memory regions of the debugged process
+ * and later reports which bytes have changed since.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "list.h"
+#include "main.h"
+#include "msg.h"
+#include "print.h"
+#include "snapshot.h"
+
+#include "libDebug.h"
+#include "libOFF.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static void showChange(struct aldWorkspace *ws, unsigned long address,
+                       unsigned char *old, unsigned char *new,
+                       unsigned long len);
+
+/*
+findSnapshot()
+  Find a snapshot by name
+
+Inputs: ws   - main workspace
+        name - snapshot name
+
+Return: list node of snapshot
+        0 if not found
+*/
+
+struct genericList *
+findSnapshot(struct aldWorkspace *ws, char *name)
+
+{
+  struct genericList *node;
+  struct snapshot *snap;
+
+  for (node = ws->snapshotList; node; node = node->next)
+  {
+    snap = (struct snapshot *) node->ptr;
+    if (!Strcasecmp(snap->name, name))
+      return (node);
+  }
+
+  return (0);
+} /* findSnapshot() */
+
+/*
+takeSnapshot()
+  Save the contents of memory regions under a given name, replacing
+an older snapshot of the same name
+
+Inputs: ws       - main workspace
+        name     - snapshot name
+        regions  - regions to save (data fields are ignored)
+        nregions - number of regions
+
+Return: pointer to new snapshot
+        0 if unsuccessful (an error has been printed)
+*/
+
+struct snapshot *
+takeSnapshot(struct aldWorkspace *ws, char *name,
+             struct snapshotRegion *regions, int nregions)
+
+{
+  struct snapshot *snap;
+  struct genericList *node;
+  unsigned char *data;
+  unsigned long total;
+  long got;
+  int ii;
+
+  total = 0;
+  for (ii = 0; ii < nregions; ++ii)
+  {
+    total += regions[ii].size;
+    if (total < regions[ii].size)
+    {
+      Print(ws, P_ERROR, "error: integer overflow");
+      return (0);
+    }
+  }
+
+  snap = (struct snapshot *) malloc(sizeof(struct snapshot) +
+                                    nregions * sizeof(struct snapshotRegion) +
+                                    total);
+  if (!snap)
+  {
+    Print(ws, P_ERROR, "takeSnapshot: malloc failed: %s", strerror(errno));
+    return (0);
+  }
+
+  memset(snap, '\0', sizeof(struct snapshot));
+  strncpy(snap->name, name, SNAPSHOT_NAMELEN);
+  snap->nregions = nregions;
+  snap->regions = (struct snapshotRegion *) (snap + 1);
+
+  data = (unsigned char *) (snap->regions + nregions);
+
+  for (ii = 0; ii < nregions; ++ii)
+  {
+    snap->regions[ii].start = regions[ii].start;
+    snap->regions[ii].size = regions[ii].size;
+    snap->regions[ii].data = data;
+
+    got = readMemoryDebug(ws->debugWorkspace_p,
+                          regions[ii].start,
+                          data,
+                          regions[ii].size);
+    if ((unsigned long) got < regions[ii].size)
+    {
+      Print(ws,
+            P_ERROR,
+            MSG_NOACCESS,
+            regions[ii].start + got,
+            strerror(errno));
+      free(snap);
+      return (0);
+    }
+
+    data += regions[ii].size;
+  }
+
+  node = findSnapshot(ws, name);
+  if (node)
+  {
+    free(node->ptr);
+    deleteList(&(ws->snapshotList), node);
+  }
+
+  if (!insertList(&(ws->snapshotList), (void *) snap))
+  {
+    free(snap);
+    return (0);
+  }
+
+  return (snap);
+} /* takeSnapshot() */
+
+/*
+diffSnapshot()
+  Compare a snapshot against the current memory contents and print
+each run of changed bytes. Unchanged memory is skipped a block at a
+time with memcmp(), so large regions which barely changed are cheap
+to compare.
+
+Inputs: ws   - main workspace
+        snap - snapshot
+
+Return: number of bytes changed
+*/
+
+unsigned long
+diffSnapshot(struct aldWorkspace *ws, struct snapshot *snap)
+
+{
+  struct snapshotRegion *rptr;
+  struct genericList *bufnode;
+  unsigned char *buf;
+  unsigned long pos,
+                runstart,
+                lastdiff,
+                changed,
+                runs;
+  long got;
+  int inrun;
+  int ii;
+
+  changed = runs = 0;
+
+  for (ii = 0; ii < snap->nregions; ++ii)
+  {
+    rptr = snap->regions + ii;
+
+    buf = (unsigned char *) malloc(rptr->size);
+    if (!buf)
+    {
+      Print(ws, P_ERROR, "diffSnapshot: malloc failed: %s", strerror(errno));
+      break;
+    }
+
+    /*
+     * The user may stop the output, in which case we will not get
+     * to free buf (see c_examine)
+     */
+    bufnode = insertList(&(ws->toBeFreed), (void *) buf);
+
+    got = readMemoryDebug(ws->debugWorkspace_p, rptr->start, buf, rptr->size);
+    if ((unsigned long) got < rptr->size)
+    {
+      Print(ws,
+            P_ERROR,
+            MSG_NOACCESS,
+            rptr->start + got,
+            strerror(errno));
+    }
+
+    inrun = 0;
+    runstart = lastdiff = 0;
+    pos = 0;
+
+    while (pos < (unsigned long) got)
+    {
+      if (!inrun &&
+          ((pos + SNAPSHOT_BLOCKSIZE) <= (unsigned long) got) &&
+          !memcmp(buf + pos, rptr->data + pos, SNAPSHOT_BLOCKSIZE))
+      {
+        pos += SNAPSHOT_BLOCKSIZE;
+        continue;
+      }
+
+      if (buf[pos] != rptr->data[pos])
+      {
+        if (!inrun)
+        {
+          inrun = 1;
+          runstart = pos;
+        }
+
+        lastdiff = pos;
+        ++changed;
+      }
+      else if (inrun && ((pos - lastdiff) >= SNAPSHOT_MAXGAP))
+      {
+        showChange(ws,
+                   rptr->start + runstart,
+                   rptr->data + runstart,
+                   buf + runstart,
+                   lastdiff - runstart + 1);
+        ++runs;
+        inrun = 0;
+      }
+
+      ++pos;
+    }
+
+    if (inrun)
+    {
+      showChange(ws,
+                 rptr->start + runstart,
+                 rptr->data + runstart,
+                 buf + runstart,
+                 lastdiff - runstart + 1);
+      ++runs;
+    }
+
+    free(buf);
+    deleteList(&(ws->toBeFreed), bufnode);
+  }
+
+  if (changed)
+  {
+    Print(ws,
+          P_COMMAND,
+          "%lu byte%s changed in %lu run%s",
+          changed,
+          (changed == 1) ? "" : "s",
+          runs,
+          (runs == 1) ? "" : "s");
+  }
+  else
+    Print(ws, P_COMMAND, "No changes since snapshot %s", snap->name);
+
+  return (changed);
+} /* diffSnapshot() */
+
+/*
+showChange()
+  Print a run of changed bytes
+
+Inputs: ws      - main workspace
+        address - address of run
+        old     - bytes in snapshot
+        new     - current bytes
+        len     - length of run
+*/
+
+static void
+showChange(struct aldWorkspace *ws, unsigned long address,
+           unsigned char *old, unsigned char *new, unsigned long len)
+
+{
+  struct offSymbolInfo symInfo;
+  char oldstr[SNAPSHOT_SHOWBYTES * 3 + 4];
+  char newstr[SNAPSHOT_SHOWBYTES * 3 + 4];
+  unsigned long ii;
+
+  for (ii = 0; (ii < len) && (ii < SNAPSHOT_SHOWBYTES); ++ii)
+  {
+    sprintf(oldstr + ii * 3, "%02X ", old[ii]);
+    sprintf(newstr + ii * 3, "%02X ", new[ii]);
+  }
+
+  if (len > SNAPSHOT_SHOWBYTES)
+  {
+    strcat(oldstr, "...");
+    strcat(newstr, "...");
+  }
+
+  if (findSymbolOFF(ws->offWorkspace_p, 0, address, &symInfo))
+  {
+    Print(ws,
+          P_COMMAND,
+          "0x%08lX <%s+%u>: %lu byte%s",
+          address,
+          symInfo.name,
+          symInfo.offset,
+          len,
+          (len == 1) ? "" : "s");
+  }
+  else
+  {
+    Print(ws,
+          P_COMMAND,
+          "0x%08lX: %lu byte%s",
+          address,
+          len,
+          (len == 1) ? "" : "s");
+  }
+
+  Print(ws, P_COMMAND, "  old: %s", oldstr);
+  Print(ws, P_COMMAND, "  new: %s", newstr);
+} /* showChange() */
@@ -0,0 +1,395 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module records every run of printable characters in the
+ * loaded file, along with the section it belongs to, so the "strings"
+ * command does not have to scan the file each time. The index is built
+ * the first time it is needed and discarded with the file.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "main.h"
+#include "print.h"
+#include "strindex.h"
+
+#include "libOFF.h"
+
+struct strIndexBuild
+{
+  struct aldWorkspace *ws;
+  struct strSection *sections;
+  int nsections;
+  int maxsections;
+  int failed;                        /* malloc failed */
+};
+
+/*
+ * Printable[c] is 1 if c may be part of a string
+ */
+static unsigned char Printable[256];
+static int PrintableReady = 0;
+
+static void callbackStrSection(void *args, struct offSectionInfo *secinfo,
+                               int exec);
+static int addString(struct strIndex *index, long *max,
+                     unsigned long offset, unsigned long length);
+static int compareStrSection(const void *a, const void *b);
+
+/*
+getStrIndex()
+  Return the string index of the loaded file, building it if this is
+the first time it is needed. The mapping is scanned once: words of
+zero bytes, which are common in object files, are skipped a word at
+a time, and everything else is classified through a lookup table.
+
+Inputs: ws - ald workspace
+
+Return: pointer to index
+        0 if no file is loaded or memory is exhausted
+*/
+
+struct strIndex *
+getStrIndex(struct aldWorkspace *ws)
+
+{
+  struct strIndexBuild build;
+  struct strIndex *index;
+  struct strEntry *eptr;
+  unsigned char *data;
+  unsigned long offset,
+                start,
+                size,
+                address;
+  long max,
+       ii;
+  int sidx;
+  int c;
+
+  if (ws->strIndex_p)
+    return (ws->strIndex_p);
+
+  if (!awIsFileLoaded(ws))
+    return (0);
+
+  if (!PrintableReady)
+  {
+    for (c = 0; c < 256; ++c)
+      Printable[c] = ((c >= 0x20) && (c < 0x7F)) || (c == '\t');
+
+    PrintableReady = 1;
+  }
+
+  memset(&build, '\0', sizeof(build));
+  build.ws = ws;
+
+  traverseSectionsOFF(ws->offWorkspace_p, callbackStrSection, &build);
+
+  index = (struct strIndex *) malloc(sizeof(struct strIndex));
+  if (!index || build.failed)
+  {
+    Print(ws, P_ERROR, "getStrIndex: malloc failed: %s", strerror(errno));
+
+    if (index)
+      free(index);
+
+    if (build.sections)
+      free(build.sections);
+
+    return (0);
+  }
+
+  memset(index, '\0', sizeof(struct strIndex));
+
+  if (build.nsections)
+  {
+    qsort(build.sections,
+          build.nsections,
+          sizeof(struct strSection),
+          compareStrSection);
+  }
+
+  index->sections = build.sections;
+  index->nsections = build.nsections;
+
+  data = (unsigned char *) ws->MapPtr;
+  size = ws->MappedSize;
+  max = 0;
+
+  offset = 0;
+  while (offset < size)
+  {
+    /*
+     * The mapping is page aligned, so offset alignment is address
+     * alignment
+     */
+    if (!(offset % sizeof(unsigned long)) &&
+        ((offset + sizeof(unsigned long)) <= size) &&
+        !*(unsigned long *) (data + offset))
+    {
+      offset += sizeof(unsigned long);
+      continue;
+    }
+
+    if (!Printable[data[offset]])
+    {
+      ++offset;
+      continue;
+    }
+
+    start = offset;
+    while ((offset < size) && Printable[data[offset]])
+      ++offset;
+
+    if ((offset - start) < STR_MINLEN)
+      continue;
+
+    if (!addString(index, &max, start, offset - start))
+    {
+      Print(ws, P_ERROR, "getStrIndex: malloc failed: %s", strerror(errno));
+
+      ws->strIndex_p = index;
+      freeStrIndex(ws);
+
+      return (0);
+    }
+  }
+
+  /*
+   * Strings are in offset order, and so are the sections
+   */
+  sidx = 0;
+  for (ii = 0; ii < index->count; ++ii)
+  {
+    eptr = index->entries + ii;
+    address = ws->virtualFileAddress + eptr->offset;
+
+    while ((sidx < index->nsections) &&
+           (index->sections[sidx].address + index->sections[sidx].size <=
+            address))
+      ++sidx;
+
+    if ((sidx < index->nsections) &&
+        (index->sections[sidx].address <= address))
+      eptr->section = sidx;
+    else
+      eptr->section = (-1);
+  }
+
+  ws->strIndex_p = index;
+
+  return (index);
+} /* getStrIndex() */
+
+/*
+freeStrIndex()
+  Discard the string index (the file is being unloaded)
+
+Inputs: ws - ald workspace
+*/
+
+void
+freeStrIndex(struct aldWorkspace *ws)
+
+{
+  if (!ws->strIndex_p)
+    return;
+
+  if (ws->strIndex_p->entries)
+    free(ws->strIndex_p->entries);
+
+  if (ws->strIndex_p->sections)
+    free(ws->strIndex_p->sections);
+
+  free(ws->strIndex_p);
+  ws->strIndex_p = 0;
+} /* freeStrIndex() */
+
+/*
+findStringIndex()
+  Binary search for the first string which ends after a file offset
+
+Inputs: index  - string index
+        offset - file offset
+
+Return: index of string (index->count if there is none)
+*/
+
+long
+findStringIndex(struct strIndex *index, unsigned long offset)
+
+{
+  long low,
+       high,
+       mid;
+
+  low = 0;
+  high = index->count;
+
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    if (index->entries[mid].offset + index->entries[mid].length <= offset)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return (low);
+} /* findStringIndex() */
+
+/*
+findString()
+  Find the string containing an address
+
+Inputs: ws      - ald workspace
+        address - virtual address
+
+Return: pointer to string entry
+        0 if address is not inside a string
+*/
+
+struct strEntry *
+findString(struct aldWorkspace *ws, unsigned long address)
+
+{
+  struct strIndex *index;
+  unsigned long offset;
+  long ii;
+
+  index = getStrIndex(ws);
+  if (!index || (address < ws->virtualFileAddress))
+    return (0);
+
+  offset = address - ws->virtualFileAddress;
+
+  ii = findStringIndex(index, offset);
+  if ((ii < index->count) && (index->entries[ii].offset <= offset))
+    return (index->entries + ii);
+
+  return (0);
+} /* findString() */
+
+/*
+callbackStrSection()
+  Called by traverseSectionsOFF() - remember sections which lie
+within the mapped file
+*/
+
+static void
+callbackStrSection(void *args, struct offSectionInfo *secinfo, int exec)
+
+{
+  struct strIndexBuild *build;
+  struct strSection *sec;
+  struct aldWorkspace *ws;
+
+  build = (struct strIndexBuild *) args;
+  ws = build->ws;
+
+  if (!secinfo->size || !*secinfo->name || build->failed)
+    return;
+
+  if ((secinfo->address < ws->virtualFileAddress) ||
+      ((secinfo->address - ws->virtualFileAddress) + secinfo->size >
+       ws->MappedSize))
+    return;
+
+  if (build->nsections == build->maxsections)
+  {
+    build->maxsections += 16;
+    sec = (struct strSection *)
+          realloc(build->sections,
+                  sizeof(struct strSection) * build->maxsections);
+    if (!sec)
+    {
+      build->failed = 1;
+      return;
+    }
+
+    build->sections = sec;
+  }
+
+  sec = build->sections + build->nsections;
+
+  sec->name = secinfo->name;
+  sec->address = secinfo->address;
+  sec->size = secinfo->size;
+
+  ++(build->nsections);
+} /* callbackStrSection() */
+
+/*
+addString()
+  Append a string to the index
+
+Inputs: index  - string index
+        max    - allocated size of index->entries
+        offset - file offset of string
+        length - length of string
+
+Return: 1 if successful
+        0 if memory is exhausted
+*/
+
+static int
+addString(struct strIndex *index, long *max,
+          unsigned long offset, unsigned long length)
+
+{
+  struct strEntry *ptr;
+
+  if (index->count == *max)
+  {
+    *max = *max ? *max * 2 : 1024;
+    ptr = (struct strEntry *) realloc(index->entries,
+                                      sizeof(struct strEntry) * *max);
+    if (!ptr)
+      return (0);
+
+    index->entries = ptr;
+  }
+
+  ptr = index->entries + index->count;
+  ptr->offset = offset;
+  ptr->length = length;
+  ptr->section = (-1);
+
+  ++(index->count);
+
+  return (1);
+} /* addString() */
+
+/*
+compareStrSection()
+  qsort() comparison - order sections by address
+*/
+
+static int
+compareStrSection(const void *a, const void *b)
+
+{
+  const struct strSection *sa,
+                          *sb;
+
+  sa = (const struct strSection *) a;
+  sb = (const struct strSection *) b;
+
+  if (sa->address < sb->address)
+    return (-1);
+  else if (sa->address > sb->address)
+    return (1);
+
+  return (0);
+} /* compareStrSection() */
@@ -0,0 +1,164 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "print.h"
+#include "systrace.h"
+
+#include "libDebug.h"
+
+/*
+ * libString includes
+ */
+#include "Strn.h"
+
+static char *formatValue(long value, char *buf);
+
+/*
+FindSyscall()
+  Find a system call by name or number
+
+Inputs: ws   - ald workspace
+        name - system call name or number
+
+Return: system call number
+        -1 if not found
+*/
+
+int
+FindSyscall(struct aldWorkspace *ws, char *name)
+
+{
+  char *endptr;
+  long number;
+
+  number = strtol(name, &endptr, 0);
+  if ((endptr != name) && (*endptr == '\0'))
+  {
+    if ((number < 0) || (number >= CATCH_MAXSYSCALL))
+      return (-1);
+
+    return ((int) number);
+  }
+
+  return (findSyscallDebug(ws->debugWorkspace_p, name));
+} /* FindSyscall() */
+
+/*
+formatValue()
+  Format a system call argument or return value: small values in
+decimal, anything else in hex
+
+Inputs: value - value
+        buf   - where to store the string
+
+Return: buf
+*/
+
+static char *
+formatValue(long value, char *buf)
+
+{
+  if ((value > -SYSTRACE_DECIMAL) && (value < SYSTRACE_DECIMAL))
+    Sprintf(buf, "%ld", value);
+  else
+    Sprintf(buf, "0x%08lX", (unsigned long) value);
+
+  return (buf);
+} /* formatValue() */
+
+/*
+FormatSyscall()
+  Format a system call strace-style, as name(arg, ...), followed by
+" = result" if it has returned. Failed calls show the error.
+
+Inputs: ws    - ald workspace
+        event - system call
+        buf   - where to store the string (MAXLINE bytes)
+
+Return: buf
+*/
+
+char *
+FormatSyscall(struct aldWorkspace *ws, struct syscallEvent *event,
+              char *buf)
+
+{
+  char value[MAXLINE];
+  char *name;
+  int nargs,
+      ii;
+
+  name = getSyscallNameDebug(ws->debugWorkspace_p, event->number);
+  if (name)
+    Sprintf(buf, "%s(", name);
+  else
+    Sprintf(buf, "syscall_%d(", event->number);
+
+  nargs = getSyscallArgsDebug(ws->debugWorkspace_p, event->number);
+  for (ii = 0; (ii < nargs) && (ii < CATCH_MAXARGS); ++ii)
+  {
+    if (ii)
+      strcat(buf, ", ");
+
+    strcat(buf, formatValue(event->args[ii], value));
+  }
+
+  strcat(buf, ")");
+
+  if (event->done)
+  {
+    /*
+     * The kernel returns -errno on failure
+     */
+    if ((event->result < 0) && (event->result >= -4095))
+    {
+      Sprintf(value,
+              " = -1 (%s)",
+              strerror((int) -event->result));
+    }
+    else
+    {
+      strcpy(value, " = ");
+      formatValue(event->result, value + 3);
+    }
+
+    strcat(buf, value);
+  }
+
+  return (buf);
+} /* FormatSyscall() */
+
+/*
+NotifySyscall()
+  Called by libDebug when a caught system call returns
+
+Inputs: args  - ald workspace
+        event - system call
+*/
+
+void
+NotifySyscall(void *args, struct syscallEvent *event)
+
+{
+  struct aldWorkspace *ws;
+  char buf[MAXLINE];
+
+  ws = (struct aldWorkspace *) args;
+
+  Print(ws, P_COMMAND, "%s", FormatSyscall(ws, event, buf));
+} /* NotifySyscall() */
@@ -11,6 +11,7 @@
  * $Id: traceresult.c,v 1.1.1.1 2004/04/26 00:40:41 pa33 Exp $
  */
 
+#include <stdio.h>
 #include <errno.h>
 #include <string.h>
 
@@ -19,6 +20,18 @@
 #include "msg.h"
 #include "print.h"
 #include "signals.h"
+#include "systrace.h"
+#include "traceresult.h"
+
+#include "libDebug.h"
+
+/*
+ * Most bytes of a changed watched range which are shown
+ */
+#define WATCH_SHOWBYTES  16
+
+static char *formatWatchBytes(unsigned char *bytes, unsigned long len,
+                              char *buf);
 
 /*
 analyzeTraceResult()
@@ -48,6 +61,14 @@ analyzeTraceResult(struct aldWorkspace *ws, int result, int data)
 
   ret = 1;
 
+  ws->lastTraceResult = result;
+  ws->lastTraceData = data;
+
+  /*
+   * Show anything the program wrote before it stopped
+   */
+  DisplayProcessOutput(ws);
+
   switch (result)
   {
     /*
@@ -179,8 +200,127 @@ analyzeTraceResult(struct aldWorkspace *ws, int result, int data)
       break;
     }
 
+    /*
+     * program wrote to a watched range
+     */
+    case 8:
+    {
+      struct Watchpoint *wptr;
+      char buf[WATCH_SHOWBYTES * 3 + 4];
+
+      wptr = findWatchpointByNumber(ws->debugWorkspace_p,
+                                    (unsigned int) data);
+      if (!wptr)
+        break;
+
+      Print(ws,
+            P_COMMAND,
+            MSG_WATCHHIT,
+            data,
+            wptr->address + wptr->changed,
+            wptr->pc);
+      Print(ws,
+            P_COMMAND,
+            "Old value: %s",
+            formatWatchBytes(wptr->old + wptr->changed, wptr->length, buf));
+      Print(ws,
+            P_COMMAND,
+            "New value: %s",
+            formatWatchBytes(wptr->value + wptr->changed, wptr->length, buf));
+
+      break;
+    }
+
+    /*
+     * program made a caught system call
+     */
+    case 9:
+    {
+      char buf[MAXLINE];
+
+      Print(ws,
+            P_COMMAND,
+            MSG_CATCHSYSCALL,
+            FormatSyscall(ws, getCatchEvent(ws->debugWorkspace_p), buf),
+            getCatchEvent(ws->debugWorkspace_p)->address);
+
+      break;
+    }
+
     default: break;
   } /* switch (result) */
 
   return (ret);
 } /* analyzeTraceResult() */
+
+/*
+DisplayProcessOutput()
+  Display output captured from the debugged process since the last
+time this was called (see "set capture-output"). The output is not
+sent to the "set output" file, since libDebug already logs it there.
+
+Inputs: ws - main workspace
+*/
+
+void
+DisplayProcessOutput(struct aldWorkspace *ws)
+
+{
+  char buf[MAXLINE];
+  char last;
+  size_t len,
+         dropped;
+
+  last = 0;
+
+  while ((len = readOutputDebug(ws->debugWorkspace_p,
+                                buf,
+                                sizeof(buf),
+                                &dropped)) > 0)
+  {
+    if (dropped)
+      Print(ws, P_OUTPUT, MSG_OUTPUTDROPPED, (unsigned long) dropped);
+
+    fwrite(buf, sizeof(char), len, stdout);
+    last = buf[len - 1];
+  }
+
+  if (last)
+  {
+    /*
+     * Keep our own messages on a line of their own
+     */
+    if (last != '\n')
+      fputc((unsigned char) '\n', stdout);
+
+    fflush(stdout);
+  }
+} /* DisplayProcessOutput() */
+
+/*
+formatWatchBytes()
+  Format the changed bytes of a watched range as hex
+
+Inputs: bytes - changed bytes
+        len   - number of bytes
+        buf   - buffer of WATCH_SHOWBYTES * 3 + 4 characters
+
+Return: buf
+*/
+
+static char *
+formatWatchBytes(unsigned char *bytes, unsigned long len, char *buf)
+
+{
+  unsigned long ii;
+  char *ptr;
+
+  ptr = buf;
+  for (ii = 0; (ii < len) && (ii < WATCH_SHOWBYTES); ++ii)
+    ptr += sprintf(ptr, "%s%02X", ii ? " " : "", bytes[ii]);
+
+  if (len > WATCH_SHOWBYTES)
+    strcpy(ptr, " ...");
+
+  return (buf);
+} /* formatWatchBytes() */
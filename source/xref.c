@@ -0,0 +1,481 @@
+/*
+ * Assembly Language Debugger
+ *
+ * Copyright (C) 2000 Patrick Alken
+ * This program comes with absolutely NO WARRANTY
+ *
+ * Should you choose to use and/or modify this source code, please
+ * do so under the terms of the GNU General Public License under which
+ * this program is distributed.
+ *
+ * $Id$
+ *
+ * This module records the calls, jumps and absolute address operands
+ * of every instruction in the executable sections of the loaded file,
+ * so the "xref" command can answer who refers to an address without
+ * disassembling the file again. The index is built the first time it
+ * is needed and discarded with the file.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+#include "defs.h"
+#include "insnindex.h"
+#include "main.h"
+#include "print.h"
+#include "xref.h"
+
+#include "libDASM.h"
+
+/*
+ * Opcodes of relative calls - everything else with a relative
+ * target is a jump
+ */
+#define OP_CALLREL      0xE8   /* call rel32 */
+
+char *XrefKindNames[] = {
+  "call",
+  "jump",
+  "data"
+};
+
+static int addXref(struct xref **refs, long *count, long *max,
+                   unsigned long source, unsigned long target, int kind);
+static void indexXrefs(struct aldWorkspace *ws, struct insnIndexSection *sec,
+                       struct xref **refs, long *count, long *max);
+static long lowerBound(struct xref *refs, long count, unsigned long address,
+                       int bytarget);
+static int compareXrefTarget(const void *a, const void *b);
+static int compareXrefSource(const void *a, const void *b);
+
+/*
+getXrefIndex()
+  Return the cross reference index of the loaded file, building it
+if this is the first time it is needed
+
+Inputs: ws - ald workspace
+
+Return: pointer to index
+        0 if no file is loaded or memory is exhausted
+*/
+
+struct xrefIndex *
+getXrefIndex(struct aldWorkspace *ws)
+
+{
+  struct insnIndex *insns;
+  struct xrefIndex *index;
+  struct xref *refs;
+  long count,
+       max,
+       ii,
+       num;
+  int jj;
+
+  if (ws->xrefIndex_p)
+    return (ws->xrefIndex_p);
+
+  insns = getInsnIndex(ws);
+  if (!insns)
+    return (0);
+
+  refs = 0;
+  count = max = 0;
+
+  for (jj = 0; jj < insns->nsections; ++jj)
+  {
+    indexXrefs(ws, insns->sections + jj, &refs, &count, &max);
+    if (count < 0)
+      break;
+  }
+
+  index = 0;
+  if (count >= 0)
+    index = (struct xrefIndex *) malloc(sizeof(struct xrefIndex));
+
+  if (!index)
+  {
+    Print(ws, P_ERROR, "getXrefIndex: malloc failed: %s", strerror(errno));
+
+    if (refs)
+      free(refs);
+
+    return (0);
+  }
+
+  index->byTarget = refs;
+  index->bySource = 0;
+  index->count = 0;
+
+  if (count)
+  {
+    qsort(refs, count, sizeof(struct xref), compareXrefTarget);
+
+    /*
+     * An absolute address may appear twice in one instruction
+     */
+    num = 0;
+    for (ii = 0; ii < count; ++ii)
+    {
+      if (num &&
+          (refs[num - 1].target == refs[ii].target) &&
+          (refs[num - 1].source == refs[ii].source))
+        continue;
+
+      refs[num++] = refs[ii];
+    }
+
+    index->bySource = (struct xref *) malloc(sizeof(struct xref) * num);
+    if (!index->bySource)
+    {
+      Print(ws, P_ERROR, "getXrefIndex: malloc failed: %s", strerror(errno));
+      free(refs);
+      free(index);
+      return (0);
+    }
+
+    memcpy(index->bySource, refs, sizeof(struct xref) * num);
+    qsort(index->bySource, num, sizeof(struct xref), compareXrefSource);
+
+    index->count = num;
+  }
+
+  ws->xrefIndex_p = index;
+
+  return (index);
+} /* getXrefIndex() */
+
+/*
+freeXrefIndex()
+  Discard the cross reference index (the file is being unloaded)
+
+Inputs: ws - ald workspace
+*/
+
+void
+freeXrefIndex(struct aldWorkspace *ws)
+
+{
+  if (!ws->xrefIndex_p)
+    return;
+
+  if (ws->xrefIndex_p->byTarget)
+    free(ws->xrefIndex_p->byTarget);
+
+  if (ws->xrefIndex_p->bySource)
+    free(ws->xrefIndex_p->bySource);
+
+  free(ws->xrefIndex_p);
+  ws->xrefIndex_p = 0;
+} /* freeXrefIndex() */
+
+/*
+findXrefsTo()
+  Find the references to an address range
+
+Inputs: ws    - ald workspace
+        start - start of range
+        end   - end of range (exclusive)
+        refs  - modified to point to the first reference, ordered
+                by target
+
+Return: number of references
+        -1 if the index could not be built
+*/
+
+long
+findXrefsTo(struct aldWorkspace *ws, unsigned long start,
+            unsigned long end, struct xref **refs)
+
+{
+  struct xrefIndex *index;
+  long first,
+       last;
+
+  *refs = 0;
+
+  index = getXrefIndex(ws);
+  if (!index)
+    return (-1);
+
+  first = lowerBound(index->byTarget, index->count, start, 1);
+  last = lowerBound(index->byTarget, index->count, end, 1);
+
+  *refs = index->byTarget + first;
+
+  return (last - first);
+} /* findXrefsTo() */
+
+/*
+findXrefsFrom()
+  Find the references made by the instructions in an address range
+
+Inputs: ws    - ald workspace
+        start - start of range
+        end   - end of range (exclusive)
+        refs  - modified to point to the first reference, ordered
+                by source
+
+Return: number of references
+        -1 if the index could not be built
+*/
+
+long
+findXrefsFrom(struct aldWorkspace *ws, unsigned long start,
+              unsigned long end, struct xref **refs)
+
+{
+  struct xrefIndex *index;
+  long first,
+       last;
+
+  *refs = 0;
+
+  index = getXrefIndex(ws);
+  if (!index)
+    return (-1);
+
+  first = lowerBound(index->bySource, index->count, start, 0);
+  last = lowerBound(index->bySource, index->count, end, 0);
+
+  *refs = index->bySource + first;
+
+  return (last - first);
+} /* findXrefsFrom() */
+
+/*
+addXref()
+  Append a reference to a growing array
+
+Inputs: refs   - array
+        count  - number of references in array
+        max    - allocated size of array
+        source - address of instruction
+        target - address referenced
+        kind   - XREF_xxx
+
+Return: 1 if successful
+        0 if memory is exhausted
+*/
+
+static int
+addXref(struct xref **refs, long *count, long *max,
+        unsigned long source, unsigned long target, int kind)
+
+{
+  struct xref *ptr;
+
+  if (*count == *max)
+  {
+    *max = *max ? *max * 2 : 1024;
+    ptr = (struct xref *) realloc(*refs, sizeof(struct xref) * *max);
+    if (!ptr)
+      return (0);
+
+    *refs = ptr;
+  }
+
+  ptr = *refs + *count;
+  ptr->source = source;
+  ptr->target = target;
+  ptr->kind = kind;
+
+  ++(*count);
+
+  return (1);
+} /* addXref() */
+
+/*
+indexXrefs()
+  Decode every instruction of a section (using the instruction
+index for the boundaries) and record its references. A relative
+operand gives a call or jump; otherwise every 32 bit value in the
+instruction bytes following the opcode which falls inside the file's
+address range is taken to be a data reference.
+
+Inputs: ws    - ald workspace
+        sec   - indexed section
+        refs  - array of references
+        count - number of references in array (set to -1 if memory
+                is exhausted)
+        max   - allocated size of array
+*/
+
+static void
+indexXrefs(struct aldWorkspace *ws, struct insnIndexSection *sec,
+           struct xref **refs, long *count, long *max)
+
+{
+  unsigned char *code,
+                *ptr;
+  unsigned char spill[MAX_OPCODE_LEN + 1];
+  char buffer[MAXLINE];
+  unsigned long offset,
+                address,
+                value,
+                low,
+                high;
+  unsigned int target;
+  long len,
+       ii;
+  int ret;
+
+  code = (unsigned char *) ws->MapPtr + (sec->address - ws->virtualFileAddress);
+  low = ws->virtualFileAddress;
+  high = ws->virtualFileAddress + ws->MappedSize;
+
+  for (offset = 0; offset < sec->size; ++offset)
+  {
+    if (!insnIndexIsStart(sec, offset))
+      continue;
+
+    address = sec->address + offset;
+
+    if ((offset + MAX_OPCODE_LEN) >= sec->size)
+    {
+      memset((void *) spill, 0, sizeof(spill));
+      memcpy(spill, code + offset, sec->size - offset);
+      ptr = spill;
+    }
+    else
+      ptr = code + offset;
+
+    len = procDisasm(ws->disasmWorkspace_p,
+                     ptr,
+                     buffer,
+                     (unsigned int) address);
+    if (len <= 0)
+      continue;
+
+    ret = 1;
+    target = ws->disasmWorkspace_p->effectiveAddress;
+
+    if (target)
+    {
+      /*
+       * Skip prefixes (branch hints etc) to find the opcode
+       */
+      ii = 0;
+      while ((ii < len - 1) &&
+             ((ptr[ii] == 0x2E) || (ptr[ii] == 0x3E) || (ptr[ii] == 0x66) ||
+              (ptr[ii] == 0x67) || (ptr[ii] == 0xF2) || (ptr[ii] == 0xF3)))
+        ++ii;
+
+      ret = addXref(refs,
+                    count,
+                    max,
+                    address,
+                    (unsigned long) target,
+                    (ptr[ii] == OP_CALLREL) ? XREF_CALL : XREF_JUMP);
+    }
+    else
+    {
+      for (ii = 1; ret && (ii + 4 <= len); ++ii)
+      {
+        value = (unsigned long) ptr[ii] |
+                ((unsigned long) ptr[ii + 1] << 8) |
+                ((unsigned long) ptr[ii + 2] << 16) |
+                ((unsigned long) ptr[ii + 3] << 24);
+
+        if ((value >= low) && (value < high))
+          ret = addXref(refs, count, max, address, value, XREF_DATA);
+      }
+    }
+
+    if (!ret)
+    {
+      *count = -1;
+      return;
+    }
+  }
+} /* indexXrefs() */
+
+/*
+lowerBound()
+  Binary search for the first reference whose target (or source) is
+not below an address
+
+Inputs: refs     - sorted references
+        count    - number of references
+        address  - address to look for
+        bytarget - 1 if refs is sorted by target, 0 if by source
+
+Return: index of reference (count if there is none)
+*/
+
+static long
+lowerBound(struct xref *refs, long count, unsigned long address,
+           int bytarget)
+
+{
+  long low,
+       high,
+       mid;
+  unsigned long value;
+
+  low = 0;
+  high = count;
+
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    value = bytarget ? refs[mid].target : refs[mid].source;
+
+    if (value < address)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return (low);
+} /* lowerBound() */
+
+/*
+compareXrefTarget()
+  qsort() comparison - order references by target, then source
+*/
+
+static int
+compareXrefTarget(const void *a, const void *b)
+
+{
+  const struct xref *ra,
+                    *rb;
+
+  ra = (const struct xref *) a;
+  rb = (const struct xref *) b;
+
+  if (ra->target != rb->target)
+    return ((ra->target < rb->target) ? -1 : 1);
+
+  if (ra->source != rb->source)
+    return ((ra->source < rb->source) ? -1 : 1);
+
+  return (0);
+} /* compareXrefTarget() */
+
+/*
+compareXrefSource()
+  qsort() comparison - order references by source, then target
+*/
+
+static int
+compareXrefSource(const void *a, const void *b)
+
+{
+  const struct xref *ra,
+                    *rb;
+
+  ra = (const struct xref *) a;
+  rb = (const struct xref *) b;
+
+  if (ra->source != rb->source)
+    return ((ra->source < rb->source) ? -1 : 1);
+
+  if (ra->target != rb->target)
+    return ((ra->target < rb->target) ? -1 : 1);
+
+  return (0);
+} /* compareXrefSource() */